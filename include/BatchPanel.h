@@ -0,0 +1,56 @@
+#pragma once
+
+#include <wx/wx.h>
+#include <wx/listctrl.h>
+#include <functional>
+#include <vector>
+#include "BatchRunner.h"
+
+// 批量运行结果面板：结果按完成顺序流入可排序的表格
+class BatchPanel : public wxPanel
+{
+public:
+    BatchPanel(wxWindow* parent, wxWindowID id = wxID_ANY);
+    virtual ~BatchPanel();
+
+    bool RunDirectory(const wxString& directory, const wxString& commandTemplate, int jobs = 0);
+    void Cancel();
+    bool IsRunning() const { return m_runner.IsRunning(); }
+
+    // 切换界面语言后更新表头和结果文字
+    void UpdateLabels();
+
+    // 设置状态回调（用于状态栏）
+    void SetStatusCallback(std::function<void(const wxString&)> callback) { m_statusCallback = callback; }
+
+private:
+    // 事件处理
+    void OnColumnClick(wxListEvent& event);
+    void OnItemSelected(wxListEvent& event);
+
+    // 主线程中处理运行结果
+    void AddResult(const BatchResult& result);
+    void OnFinished();
+
+    bool CompareResults(const BatchResult& a, const BatchResult& b) const;
+    void InsertRow(size_t index);
+    void RefreshList();
+    void UpdateSummary();
+
+private:
+    wxListCtrl* m_list;
+    wxTextCtrl* m_details;
+
+    BatchRunner m_runner;
+    wxString m_directory;
+    std::vector<BatchResult> m_results;
+    size_t m_passed;
+    wxLongLong m_startTime;
+
+    int m_sortColumn;
+    bool m_sortAscending;
+
+    std::function<void(const wxString&)> m_statusCallback;
+
+    wxDECLARE_EVENT_TABLE();
+};
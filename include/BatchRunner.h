@@ -0,0 +1,73 @@
+#pragma once
+
+#include <wx/wx.h>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 单个脚本的批量运行结果
+struct BatchResult
+{
+    wxString script;        // 脚本完整路径
+    wxString output;        // 标准输出
+    wxString errors;        // 标准错误
+    int exitCode = -1;
+    double seconds = 0.0;   // 运行耗时
+    bool hasExpected = false;
+    bool passed = false;    // 退出码为 0 且与 .expected 一致
+};
+
+// 并发运行目录下所有 .lm 脚本的批量运行引擎，IDE 与命令行工具共用
+class BatchRunner
+{
+public:
+    BatchRunner();
+    ~BatchRunner();
+
+    // 开始运行，jobs <= 0 时使用 CPU 核心数
+    bool Start(const wxString& directory, const wxString& commandTemplate, int jobs = 0);
+
+    // 不再调度新的脚本，已启动的脚本会运行结束
+    void Cancel();
+
+    // 等待所有工作线程结束
+    void Wait();
+
+    bool IsRunning() const { return m_running; }
+    size_t GetScriptCount() const { return m_scripts.size(); }
+
+    // 回调在工作线程中调用，界面代码需要自行切回主线程
+    void SetResultCallback(std::function<void(const BatchResult&)> callback) { m_resultCallback = callback; }
+    void SetFinishedCallback(std::function<void()> callback) { m_finishedCallback = callback; }
+
+    // 查找目录下所有 .lm 脚本（递归）
+    static wxArrayString CollectScripts(const wxString& directory);
+
+private:
+    void WorkerLoop();
+    BatchResult RunScript(const wxString& script) const;
+
+    // 历史耗时，用于按最长耗时优先调度
+    void LoadHistory();
+    void SaveHistory();
+
+private:
+    wxString m_directory;
+    wxString m_commandTemplate;
+    std::vector<wxString> m_scripts;
+    std::vector<std::thread> m_workers;
+    std::atomic<size_t> m_nextScript;
+    std::atomic<size_t> m_activeWorkers;
+    std::atomic<bool> m_cancelled;
+    std::atomic<bool> m_running;
+
+    std::mutex m_historyMutex;
+    std::map<wxString, double> m_history;
+
+    // 回调函数
+    std::function<void(const BatchResult&)> m_resultCallback;
+    std::function<void()> m_finishedCallback;
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 一处文本替换，位置为 UTF-8 字节偏移，与 Scintilla 的位置一致
+struct TextEdit
+{
+    size_t start;
+    size_t length;      // 被替换的字节数
+    std::string text;   // 替换后的内容
+};
+
+// 批量编辑的计算，不依赖界面，可在后台线程中运行。
+// 编辑列表按位置升序排列且互不重叠
+class BulkEdit
+{
+public:
+    // 查找全部匹配并生成替换编辑
+    static std::vector<TextEdit> FindReplace(std::string_view text, std::string_view find, std::string_view replacement,
+                                             bool matchCase, bool wholeWord);
+
+    // 把编辑应用到文本的 [begin, end) 范围，返回该范围替换后的内容
+    static std::string Apply(std::string_view text, const std::vector<TextEdit>& edits,
+                             size_t begin = 0, size_t end = std::string_view::npos);
+
+    // 编辑之后原位置对应的新位置，落在被替换范围内的位置移到替换内容之后
+    static size_t MapPosition(const std::vector<TextEdit>& edits, size_t position);
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <wx/wx.h>
+#include <wx/stc/stc.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "LineDiff.h"
+
+class LaminaEditor;
+struct GutterBaseline;
+
+// 行变更标记：与基准版本（文件在 git 仓库中时为 HEAD 中的版本，否则为上次读取或保存的版本）比较，
+// 在页边标出新增、修改和删除的行。差异在后台线程中计算，编辑后只重新比较受影响的区域
+class ChangeGutter : public wxEvtHandler
+{
+public:
+    ChangeGutter(LaminaEditor* editor, int margin);
+    ~ChangeGutter();
+
+    // 文档被重新载入或保存后重新读取基准版本
+    void ResetBaseline();
+
+private:
+    void OnEditorModified(wxStyledTextEvent& event);
+    void OnDiffTimer(wxTimerEvent& event);
+
+    // 一次只运行一个后台任务，任务结束后再开始下一个
+    void StartNextJob();
+    void StartBaselineJob();
+    void StartDiffJob();
+    void FinishBaselineJob(unsigned generation, std::shared_ptr<const GutterBaseline> baseline);
+    void FinishDiffJob(unsigned generation, std::vector<LineHunk> hunks);
+
+    // 把一次编辑并入待比较区域：编辑前的 [firstLine, endLine)，增加了 lineDelta 行
+    void MarkDirty(size_t firstLine, size_t endLine, long lineDelta);
+
+    void ClearMarkers(size_t firstLine, size_t lastLine);
+    void AddMarkers(const std::vector<LineHunk>& hunks);
+
+    static std::shared_ptr<const GutterBaseline> LoadBaseline(const wxString& path, const std::string& eol);
+
+private:
+    LaminaEditor* m_editor;
+    wxTimer m_diffTimer;
+
+    std::shared_ptr<const GutterBaseline> m_baseline;
+    unsigned m_generation;          // 重新读取基准版本时递增，过期的结果被丢弃
+    bool m_baselinePending;
+
+    // 上次比较时的差异（行号基于当时的文档）
+    std::vector<LineHunk> m_hunks;
+
+    // 上次比较之后的编辑覆盖的区域：当前文档中的 [m_dirtyFirst, m_dirtyEnd)
+    // 对应上次比较时的 [m_dirtyFirst, m_dirtyEnd - m_dirtyDelta)
+    bool m_dirty;
+    size_t m_dirtyFirst;
+    size_t m_dirtyEnd;
+    long m_dirtyDelta;
+
+    // 正在运行的比较任务
+    std::thread m_thread;
+    bool m_running;
+    size_t m_jobFirst;              // 比较区域的起始行
+    size_t m_jobPreviousEnd;        // 区域在上次比较时的结束行
+    long m_jobDelta;
+    size_t m_jobFirstHunk;          // 被替换的差异 [m_jobFirstHunk, m_jobEndHunk)
+    size_t m_jobEndHunk;
+};
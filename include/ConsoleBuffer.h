@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 控制台输出的来源
+enum class ConsoleStream : uint8_t
+{
+    Output = 0,     // 标准输出
+    Error,          // 标准错误
+    Info,           // IDE 自己的提示（开始运行、退出码）
+    Input,          // 用户输入的回显
+    Count
+};
+
+// 控制台查询：文本（或正则表达式）与来源同时满足的行
+struct ConsoleQuery
+{
+    std::string text;           // UTF-8，为空时匹配所有行
+    bool regex = false;         // ECMAScript 语法
+    bool matchCase = false;     // 仅对 ASCII 忽略大小写
+    uint8_t streams = 0xff;     // 按位选择，第 i 位对应 ConsoleStream(i)
+
+    static uint8_t StreamBit(ConsoleStream stream) { return 1 << (int)stream; }
+};
+
+// 控制台的全部输出与行索引（每行的起始偏移与来源），输出到达时增量建立。
+// 查询把行分成若干块并行扫描，用于在上千万行中查找与过滤
+class ConsoleBuffer
+{
+public:
+    // 追加输出；最后一行未结束时，同一来源的输出接在该行后面
+    void Append(ConsoleStream stream, std::string_view text);
+    void Clear();
+
+    size_t GetLineCount() const { return m_lineStarts.size(); }
+
+    // 已经以换行结束的行数，之后的行还可能变长
+    size_t GetCompleteLineCount() const { return m_lastLineOpen ? m_lineStarts.size() - 1 : m_lineStarts.size(); }
+
+    // 不含换行符
+    std::string_view GetLine(size_t line) const;
+    ConsoleStream GetStream(size_t line) const { return static_cast<ConsoleStream>(m_streams[line]); }
+
+    size_t GetTextSize() const { return m_text.size(); }
+
+    // 文本与行索引实际分配的字节数
+    size_t GetMemoryUsage() const;
+
+    // 把 [firstLine, lastLine) 中满足查询的行号按顺序追加到 matches。
+    // 正则表达式无效时返回 false；cancel 被置位后尽快返回，结果不完整
+    bool Find(const ConsoleQuery& query, size_t firstLine, size_t lastLine, std::vector<size_t>& matches,
+              const std::atomic<bool>* cancel = nullptr) const;
+
+private:
+    void FindRange(const ConsoleQuery& query, const std::regex* regex, size_t firstLine, size_t lastLine,
+                   std::vector<size_t>& matches, const std::atomic<bool>* cancel) const;
+
+private:
+    std::string m_text;                 // 各行依次存放，行之间以 '\n' 分隔
+    std::vector<size_t> m_lineStarts;   // 每行在 m_text 中的起始偏移
+    std::vector<uint8_t> m_streams;     // 每行的 ConsoleStream
+    bool m_lastLineOpen = false;        // 最后一行还没有换行符
+};
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <wx/wx.h>
+#include <wx/listctrl.h>
+#include <wx/file.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "ConsoleBuffer.h"
+
+class ConsoleLineList;
+class ProcessManager;
+
+// 控制台面板：输出存入带行索引的 ConsoleBuffer，由虚拟列表显示。
+// 支持查找、正则过滤和只显示标准错误，新输出到达时只查询新增的行。
+// 查询在后台线程进行，期间到达的输出先暂存，查询结束后再追加到缓冲区
+class ConsolePanel : public wxPanel
+{
+public:
+    ConsolePanel(wxWindow* parent, wxWindowID id = wxID_ANY);
+    ~ConsolePanel();
+
+    void AppendText(ConsoleStream stream, const wxString& text);
+    void Clear();
+
+    // 界面语言变化后更新控件文字
+    void UpdateLabels();
+
+    // 输入行写入该进程的标准输入
+    void SetProcessManager(ProcessManager* processManager) { m_processManager = processManager; }
+
+    // 进程开始或结束时启用或禁用输入，禁用时丢弃尚未写入的输入
+    void SetInputEnabled(bool enabled);
+
+    // 把等待中的输入交给进程，直到它的队列满为止
+    void FeedInput();
+
+    // 输出缓冲区与查询结果占用的字节数
+    size_t GetMemoryUsage() const { return m_buffer.GetMemoryUsage() + (m_visible.capacity() + m_matches.capacity()) * sizeof(size_t); }
+
+private:
+    friend class ConsoleLineList;
+
+    void OnFindTextChanged(wxCommandEvent& event);
+    void OnFindTextEnter(wxCommandEvent& event);
+    void OnOptionChanged(wxCommandEvent& event);
+    void OnQueryTimer(wxTimerEvent& event);
+    void OnListKeyDown(wxListEvent& event);
+    void OnInputEnter(wxCommandEvent& event);
+    void OnInputKeyDown(wxKeyEvent& event);
+    void OnInputPaste(wxClipboardTextEvent& event);
+    void OnSendFile(wxCommandEvent& event);
+
+    // 回显并排队发送到标准输入
+    void SendInput(const wxString& text);
+    void EndInput();
+    void FinishInputFile();
+
+    // 查询条件变化后取消正在进行的查询，在后台重新计算全部结果
+    void RunQuery();
+
+    // 刷新列表，有新到达的行时在后台查询它们
+    void RefreshView();
+    void UpdateMatchCount();
+
+    // 在后台查询 m_scannedLines 之后的行，结果由 FinishQueryJob 合并
+    void StartQueryJob();
+    void FinishQueryJob(unsigned generation, size_t scannedLines, std::vector<size_t> visible, std::vector<size_t> matches);
+    void CancelQuery();
+
+    // 把查询期间暂存的输出追加到缓冲区
+    void FlushHeldOutput();
+
+    // 重新查询后选中原来的行，或者第一个匹配行
+    void RestoreSelection();
+
+    bool NeedsScan() const { return !m_showAll || (HasTextQuery() && !m_filter->GetValue()); }
+
+    // 选中下一个（上一个）匹配行，inclusive 时包括当前选中的行
+    void FindMatch(bool forward, bool inclusive);
+    void SelectRow(long row);
+    void CopySelection();
+
+    bool HasTextQuery() const { return m_queryValid && !m_query.text.empty(); }
+    long GetRowCount() const;
+    size_t RowToLine(long row) const;
+    long LineToRow(size_t line) const;
+
+    wxString GetRowText(long row) const;
+    wxItemAttr* GetRowAttr(long row) const;
+
+private:
+    ConsoleBuffer m_buffer;
+
+    ConsoleLineList* m_list;
+    wxTextCtrl* m_findText;
+    wxCheckBox* m_regex;
+    wxCheckBox* m_matchCase;
+    wxCheckBox* m_filter;
+    wxCheckBox* m_errorsOnly;
+    wxStaticText* m_matchCount;
+    wxTimer m_queryTimer;
+    wxTextCtrl* m_inputText;
+    wxButton* m_sendFile;
+
+    ProcessManager* m_processManager;
+    std::string m_pendingInput;     // 进程的输入队列已满，尚未交出的数据
+    bool m_endInputPending;         // 等待中的数据交出后关闭标准输入
+    wxFile m_inputFile;             // 正在发送的文件
+    wxString m_inputFileName;
+    wxFileOffset m_inputFileSent;
+    wxLongLong m_inputFileStart;
+
+    ConsoleQuery m_query;
+    bool m_queryValid;
+
+    // 过滤时只显示 m_visible 中的行；m_matches 是未过滤时需要高亮的匹配行
+    bool m_showAll;
+    std::vector<size_t> m_visible;
+    std::vector<size_t> m_matches;
+    size_t m_scannedLines;      // 已经查询过的完整行数
+
+    std::thread m_queryThread;
+    std::atomic<bool> m_cancelQuery;
+    unsigned m_queryGeneration;     // 重新查询或清空时递增，过期的结果被丢弃
+    bool m_queryRunning;
+    bool m_scanPending;             // 缓冲区有尚未查询的输出
+    bool m_restorePending;          // 重新查询的结果到达后恢复选中的行
+    size_t m_restoreLine;
+    std::vector<std::pair<ConsoleStream, std::string>> m_heldOutput;
+
+    bool m_refreshPending;
+
+    mutable wxItemAttr m_attrs[(int)ConsoleStream::Count];
+    mutable wxItemAttr m_matchAttrs[(int)ConsoleStream::Count];
+
+    wxDECLARE_EVENT_TABLE();
+};
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+// 快速的非加密内容哈希（xxHash64），用于判断文件内容是否真的变化
+class ContentHash
+{
+public:
+    static uint64_t Compute(std::string_view data, uint64_t seed = 0);
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <wx/wx.h>
+#include <wx/file.h>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+enum class JournalRecordType : uint8_t
+{
+    Insert = 1,
+    Delete = 2,
+    Checkpoint = 3  // 文档全文，之后的记录基于它重放
+};
+
+struct JournalRecord
+{
+    JournalRecordType type;
+    uint64_t position;
+    uint64_t length;
+    const char* data;   // 删除记录为空
+};
+
+// 日志文件头：记录所基于的磁盘文件
+struct JournalHeader
+{
+    wxString documentPath;  // 未命名文档为空
+    uint64_t baseSize = 0;
+    int64_t baseTime = 0;
+};
+
+// 崩溃恢复用的追加式编辑日志：编辑记录先缓存在内存中，
+// 后台线程按组写入并 fsync；日志增长到与文档同等大小时压缩为检查点
+class EditJournal
+{
+public:
+    EditJournal();
+    ~EditJournal();
+
+    // 以磁盘上的文件为基准开始新的日志，旧日志被丢弃
+    void Reset(const wxString& documentPath);
+
+    // 关闭日志，discard 为 true 时删除日志文件（正常关闭）
+    void Close(bool discard);
+
+    void RecordInsert(uint64_t position, const char* text, uint64_t length);
+    void RecordDelete(uint64_t position, uint64_t length);
+
+    // 日志是否需要压缩为检查点
+    bool NeedsCheckpoint(uint64_t documentSize) const;
+    void Checkpoint(std::string&& text);
+
+    // 恢复
+    static wxString GetRecoveryDir();
+    static wxArrayString FindJournals();
+    static bool ReadHeader(const wxString& journalPath, JournalHeader& header);
+    static bool Replay(const wxString& journalPath, const std::function<void(const JournalRecord&)>& apply);
+
+private:
+    void WriterLoop();
+    void StartJournal();
+    void AppendRecord(JournalRecordType type, uint64_t position, const char* data, uint64_t length);
+    bool WriteCheckpoint(const wxString& path, const std::string& header, const std::string& text);
+
+    static wxString GetJournalPath(const wxString& documentPath);
+
+private:
+    wxString m_journalPath;
+    std::string m_header;           // 编码后的文件头，首次写入时使用
+    bool m_started;                 // 日志文件是否已创建
+    uint64_t m_journalBytes;        // 上次检查点之后的日志大小
+
+    wxFile m_file;                  // 仅由写线程访问
+    std::thread m_writer;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::string m_buffer;           // 尚未写入的记录
+    std::string m_checkpoint;       // 待写入的检查点
+    bool m_hasCheckpoint;
+    bool m_truncate;                // 下次写入前重建日志文件
+    bool m_writing;
+    bool m_stop;
+};
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <wx/wx.h>
+#include <string>
+
+// 文件读写辅助函数，按原始字节处理，与 Scintilla 的 UTF-8 缓冲区一致
+class FileUtils
+{
+public:
+    static bool ReadBytes(const wxString& path, std::string& data);
+    static bool WriteBytes(const wxString& path, const std::string& data);
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <wx/wx.h>
+#include <wx/fswatcher.h>
+#include <functional>
+#include <map>
+#include <memory>
+
+// 文件变化监视（Linux 上基于 inotify，Windows 上基于 ReadDirectoryChangesW），
+// 监视文件所在目录以便捕获"写临时文件再重命名"式的保存
+class FileWatcher : public wxEvtHandler
+{
+public:
+    static FileWatcher& Get();
+
+    // 监视文件，文件被修改、创建或替换时在主线程中回调，返回监视句柄
+    int Watch(const wxString& path, std::function<void(const wxString&)> callback);
+    void Unwatch(int handle);
+
+private:
+    FileWatcher();
+    ~FileWatcher();
+
+    void OnFileSystemEvent(wxFileSystemWatcherEvent& event);
+    void Dispatch(const wxFileName& path);
+
+    static wxString NormalizePath(const wxString& path);
+
+private:
+    struct WatchEntry
+    {
+        wxString path;
+        wxString directory;
+        std::function<void(const wxString&)> callback;
+    };
+
+    // 需要活动的事件循环，首次监视时才创建
+    std::unique_ptr<wxFileSystemWatcher> m_watcher;
+    std::map<int, WatchEntry> m_entries;
+    std::map<wxString, int> m_directoryRefs;
+    int m_nextHandle;
+
+    static FileWatcher* s_instance;
+
+    wxDECLARE_EVENT_TABLE();
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// 工作区的 include 关系图。路径由调用者解析为绝对路径（UTF-8），内部以编号表示，
+// 每个文件同时保存出边（它包含的文件）与入边（包含它的文件）。
+// 更新一个文件只替换它自己的出边；查询按编号遍历，返回的路径指向图内部保存的字符串，
+// 在 Clear 之前一直有效。不是线程安全的
+class IncludeGraph
+{
+public:
+    IncludeGraph();
+
+    // 设置文件直接包含的文件，替换之前的出边
+    void SetIncludes(std::string_view file, const std::vector<std::string>& includes);
+
+    // 文件被删除：去掉出边，包含它的文件仍指向它
+    void RemoveFile(std::string_view file);
+
+    void Clear();
+
+    // 已设置过出边的文件
+    bool HasFile(std::string_view file) const;
+
+    std::vector<std::string_view> GetIncludes(std::string_view file) const;
+    std::vector<std::string_view> GetIncluders(std::string_view file) const;
+
+    // 修改 file 后受影响的文件：直接或间接包含它的所有文件，不含自身
+    std::vector<std::string_view> GetAffected(std::string_view file) const;
+
+    // file 直接或间接包含的所有文件，不含自身
+    std::vector<std::string_view> GetDependencies(std::string_view file) const;
+
+    // 经过 file 的最短包含环 [file, ..., file]，不在环上时为空
+    std::vector<std::string_view> FindCycle(std::string_view file) const;
+
+    size_t GetFileCount() const { return m_fileCount; }
+    size_t GetEdgeCount() const { return m_edgeCount; }
+
+private:
+    struct Node
+    {
+        const std::string* path = nullptr;  // m_ids 中的键，插入其他键时不会移动
+        std::vector<uint32_t> includes;
+        std::vector<uint32_t> includers;
+        bool scanned = false;
+    };
+
+    uint32_t Intern(std::string_view path);
+    uint32_t Find(std::string_view path) const;
+    void ClearIncludes(uint32_t node);
+
+    // 从 start 沿出边或入边遍历可达的节点，不含 start
+    std::vector<std::string_view> Collect(uint32_t start, bool forward) const;
+
+    // 遍历用的访问标记：每次遍历递增 m_visitStamp，不必清空数组
+    bool Visit(uint32_t node) const;
+
+private:
+    std::vector<Node> m_nodes;
+    std::unordered_map<std::string, uint32_t> m_ids;
+    size_t m_fileCount;
+    size_t m_edgeCount;
+
+    mutable std::vector<uint32_t> m_visited;
+    mutable std::vector<uint32_t> m_parent;
+    mutable uint32_t m_visitStamp;
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <wx/wx.h>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "IncludeGraph.h"
+#include "LaminaLinter.h"
+
+// 预读并分析过的 .lm 文件
+struct IncludedFileInfo
+{
+    std::vector<LintSymbol> symbols;        // 顶层的 func 与 var
+    std::vector<std::string> includes;      // 解析后的 include 路径（UTF-8 绝对路径）
+};
+
+// 工作区（打开的文件所在的目录树）的 include 关系图与文件分析缓存。
+// 打开文件时后台线程先预读它递归包含的文件，再扫描整个目录树；修改时间未变的文件不重新读取，
+// 关系图中只更新内容变化的文件的出边。关系图只在主线程中访问
+class IncludeIndex : public wxEvtHandler
+{
+public:
+    static IncludeIndex& Get();
+
+    // 打开文件后调用，开始（或重新开始）后台扫描
+    void Open(const wxString& file);
+
+    // 文件内容已知（保存之后），立即更新它的出边
+    void Update(const wxString& file, std::string_view source);
+
+    // 停止后台扫描并清除回调，程序退出前调用
+    void Stop();
+
+    // 修改 file 后受影响的脚本：直接或间接包含它的文件
+    wxArrayString GetAffected(const wxString& file) const;
+
+    // 经过 file 的最短包含环，首尾都是 file，不在环上时为空
+    wxArrayString FindCycle(const wxString& file) const;
+
+    // file 直接或间接包含、且已经分析过的文件，不含自身；只查询关系图，不读取磁盘
+    wxArrayString GetDependencies(const wxString& file) const;
+
+    size_t GetFileCount() const { return m_graph.GetFileCount(); }
+    bool IsScanning() const { return m_running; }
+
+    // 线程安全：文件的分析结果，缓存未命中或文件已被修改时读取并分析，文件不存在时返回空
+    std::shared_ptr<const IncludedFileInfo> GetFileInfo(const wxString& path);
+
+    // 一次扫描完成后调用
+    void SetScanCallback(std::function<void()> callback) { m_scanCallback = callback; }
+
+private:
+    IncludeIndex();
+    ~IncludeIndex();
+
+    struct ScannedFile
+    {
+        wxString path;
+        std::shared_ptr<const IncludedFileInfo> info;
+    };
+
+    void StartScan();
+    void FinishScan(unsigned generation, wxString root, std::vector<ScannedFile> files, bool complete);
+    void Install(const wxString& path, std::shared_ptr<const IncludedFileInfo> info);
+
+    static std::shared_ptr<const IncludedFileInfo> Analyze(const wxString& path, std::string_view source);
+    static wxArrayString ToPaths(const std::vector<std::string_view>& paths);
+
+private:
+    struct CacheEntry
+    {
+        wxDateTime modified;
+        std::shared_ptr<const IncludedFileInfo> info;
+    };
+    std::mutex m_cacheMutex;
+    std::map<wxString, CacheEntry> m_cache;
+
+    // 主线程
+    IncludeGraph m_graph;
+    std::map<wxString, std::shared_ptr<const IncludedFileInfo>> m_installed;    // 关系图中各文件出边的来源
+
+    std::thread m_thread;
+    std::atomic<bool> m_cancel;
+    bool m_running;
+    unsigned m_generation;
+    wxString m_pendingFile;         // 扫描期间又打开的文件
+
+    std::function<void()> m_scanCallback;
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <wx/wx.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Lamina include 语句的提取与路径解析
+class IncludeScanner
+{
+public:
+    // 提取 include "..." 中的路径，注释和字符串中的内容不计
+    static std::vector<std::string> Scan(std::string_view source);
+
+    // 相对于包含者所在目录解析路径，缺少扩展名时补 .lm
+    static wxString Resolve(const wxString& fromFile, const std::string& include);
+
+    // 文件本身及其递归包含的所有已存在的文件
+    static wxArrayString CollectTransitive(const wxString& file);
+};
@@ -1,11 +1,29 @@
 #pragma once
 
 #include <wx/wx.h>
+#include <wx/cmdline.h>
+#include <memory>
+#include "PerfSuite.h"
 
 class LaminaApp : public wxApp
 {
 public:
     virtual bool OnInit() override;
+    virtual int OnRun() override;
+    virtual int OnExit() override;
+    
+    // --perf-suite、--startup-benchmark 等性能测试选项
+    virtual void OnInitCmdLine(wxCmdLineParser& parser) override;
+    virtual bool OnCmdLineParsed(wxCmdLineParser& parser) override;
+    
+private:
+    bool m_runPerfSuite = false;
+    PerfSuiteOptions m_perfOptions;
+    std::unique_ptr<PerfSuite> m_perfSuite;
+    
+    // --startup-benchmark：启动完成后打印各阶段耗时并退出
+    bool m_startupBenchmark = false;
+    wxString m_benchmarkDir;
 };
 
 wxDECLARE_APP(LaminaApp);
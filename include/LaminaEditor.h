@@ -2,7 +2,52 @@
 
 #include <wx/wx.h>
 #include <wx/stc/stc.h>
+#include <climits>
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "BulkEdit.h"
+#include "UndoLedger.h"
+
+struct DocumentState;
+struct UndoReplayStep;
+class EditJournal;
+class ChangeGutter;
+class LintIndicators;
+
+// 主题解析后的单个样式
+struct EditorStyle
+{
+    wxColour foreground;
+    wxColour background;
+    bool bold = false;
+    bool italic = false;
+
+    bool operator==(const EditorStyle& other) const
+    {
+        return foreground == other.foreground && background == other.background
+            && bold == other.bold && italic == other.italic;
+    }
+    bool operator!=(const EditorStyle& other) const { return !(*this == other); }
+};
+
+// 主题解析出的全部样式，按样式编号索引，与 StyleClearAll 之后逐项设置的结果相同
+struct EditorStyleSet
+{
+    std::vector<EditorStyle> styles;    // 为空表示尚未应用任何主题
+    wxColour caretLine;
+};
+
+// 文档各部分占用的内存（字节，估算）
+struct EditorMemoryUsage
+{
+    size_t text = 0;        // 文本与行索引
+    size_t styles = 0;      // 每个字符的样式字节与每行的词法状态、折叠级别
+    size_t undo = 0;        // 撤销与重做历史
+    size_t markers = 0;     // 行标记
+};
 
 class LaminaEditor : public wxStyledTextCtrl
 {
@@ -12,7 +57,49 @@ public:
     
     // 文件操作
     bool LoadFile(const wxString& filename);
+    
+    // Scintilla 的位置是 int，文档必须小于 2 GB
+    static bool IsFileTooLarge(wxFileOffset length) { return length >= INT_MAX; }
     bool SaveFile(const wxString& filename);
+    void NewDocument();
+    
+    // 从崩溃恢复日志重建未保存的内容
+    bool RecoverFromJournal(const wxString& journalPath);
+    
+    // 批量编辑：一次应用全部编辑，只产生一个撤销步骤和一次变化通知。
+    // coalesce 为 true 时编辑很多的情况下合并为一次整体替换（不保留范围内的折叠和标记）
+    void ApplyEdits(const std::vector<TextEdit>& edits, bool coalesce = true);
+    
+    // 格式化整个文档或选中的行
+    void FormatDocument();
+    void FormatSelection();
+    
+    // 外部修改检测：磁盘内容的哈希与上次读写时不同才算变化，
+    // 差异在后台线程中计算，变化时调用回调
+    void CheckDiskChange();
+    void SetDiskChangeCallback(std::function<void()> callback) { m_diskChangeCallback = callback; }
+    
+    // 只应用变化的行，撤销历史、光标和折叠都得以保留
+    bool ApplyDiskChange();
+    
+    // 保留编辑器中的内容，以磁盘上的新内容为基准
+    void DiscardDiskChange();
+    
+    // 同步检查磁盘内容是否已被其他程序修改（保存前确认）。大小和修改时间与上次读写时相同、
+    // 且没有收到变化通知（changeReported）时不读取文件，否则比较内容的哈希
+    bool IsDiskContentChanged(bool changeReported = false) const;
+    
+    // 撤销历史的内存上限（字节），超过时丢弃最旧的撤销步骤；0 表示不限制
+    void SetUndoBudget(size_t bytes) { m_undoBudget = bytes; }
+    size_t GetUndoBudget() const { return m_undoBudget; }
+    
+    EditorMemoryUsage GetMemoryUsage();
+    
+    // 静态检查标记更新后以出现问题的行调用
+    void SetLintCallback(std::function<void(const std::vector<int>& lines)> callback);
+    
+    // 文档内容每次变化时递增，用于判断后台计算所基于的内容是否过期
+    unsigned long GetChangeCount() const { return m_changeCount; }
     
     // 编辑器设置
     void SetupLaminaSyntax();
@@ -21,30 +108,94 @@ public:
     // 状态查询
     bool IsModified() const;
     wxString GetCurrentFile() const { return m_currentFile; }
+    bool IsLargeFileMode() const { return m_largeFileMode || m_longLineMode; }
     
     // 设置变化回调
     void SetChangeCallback(std::function<void()> callback) { m_changeCallback = callback; }
     
     // 主题配置
-    void ApplyTheme(const wxString& themeName = wxEmptyString);
+    // 应用主题，只设置与当前不同的样式，返回变化的样式数
+    size_t ApplyTheme(const wxString& themeName = wxEmptyString);
+    
+    // 视图状态（光标、滚动位置、折叠），用于会话保存与恢复
+    void SaveViewState(DocumentState& state);
+    void RestoreViewState(const DocumentState& state);
     
 private:
     // 事件处理
     void OnTextChanged(wxStyledTextEvent& event);
+    void OnModified(wxStyledTextEvent& event);
     void OnMarginClick(wxStyledTextEvent& event);
     
     // 语法高亮设置
-    void SetLexerColors();
     void SetLexerKeywords();
     
     // 编辑器配置
-    void SetEditorStyles();
+    EditorStyleSet ResolveStyles() const;
+    size_t ApplyStyles(const EditorStyleSet& styles);
     void SetMargins();
     void SetFolding();
+    void UpdateLineNumberMargin();
+    
+    // 大文件模式：按文件大小或最长行自动关闭或降级高开销的功能
+    void SetLargeFileMode(bool largeFile, bool longLines);
+    
+    // 按载入文件时的方式把磁盘上的字节放入文档：大文件保留原始字节，
+    // 其余去掉 BOM 并转换编码。崩溃恢复日志中的位置基于这样得到的内容
+    void SetTextFromBytes(const std::string& bytes);
+    
+    void FormatLines(size_t firstLine, size_t lastLine);
+    
+    // 撤销历史超出上限时只保留最新的几组
+    void ResetUndoHistory();
+    void CompactUndoHistory();
+    
+    void FinishDiskCheck(std::shared_ptr<std::vector<TextEdit>> edits, uint64_t hash, unsigned long changeCount);
+    
+    // 记下磁盘文件当前的大小和修改时间；clear 为 true 时清除，下次检查比较哈希
+    void RecordDiskStat(bool clear = false);
     
 private:
     wxString m_currentFile;
     std::function<void()> m_changeCallback;
     
+    // 崩溃恢复日志
+    std::unique_ptr<EditJournal> m_journal;
+    bool m_journalSuspended;
+    
+    bool m_largeFileMode;
+    bool m_longLineMode;
+    int m_lineNumberDigits;
+    
+    unsigned long m_changeCount;
+    bool m_bulkEditing;     // 批量编辑期间合并变化通知
+    
+    // 外部修改检测
+    uint64_t m_diskHash;            // 上次读取或写入时磁盘内容的哈希
+    wxULongLong m_diskSize;         // 同时记录的大小和修改时间，未变化时不必重新哈希
+    wxDateTime m_diskModified;
+    std::thread m_diskThread;
+    bool m_diskCheckRunning;
+    bool m_diskCheckAgain;          // 检查期间又收到变化通知
+    std::shared_ptr<std::vector<TextEdit>> m_diskEdits;    // 待应用的差异
+    uint64_t m_diskEditsHash;
+    unsigned long m_diskEditsChangeCount;
+    std::function<void()> m_diskChangeCallback;
+    
+    // 行变更标记
+    std::unique_ptr<ChangeGutter> m_changeGutter;
+    
+    // 静态检查
+    std::unique_ptr<LintIndicators> m_lint;
+    
+    // 当前已应用的样式，用于只更新变化的部分
+    EditorStyleSet m_appliedStyles;
+    
+    // 撤销历史的内存上限
+    UndoLedger m_undoLedger;
+    size_t m_undoBudget;
+    bool m_undoCompactPending;
+    std::vector<UndoReplayStep>* m_undoCapture;     // 压缩期间记录被撤销的组
+    
     wxDECLARE_EVENT_TABLE();
 };
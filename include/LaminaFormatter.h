@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "BulkEdit.h"
+
+struct FormatOptions
+{
+    int indentWidth = 4;
+    bool useTabs = false;
+};
+
+// Lamina 代码格式化：缩进、K&R 括号风格、运算符与逗号周围的空格。
+// 结果是针对原文本的最小编辑列表，每个改变的行只产生一处编辑，未改变的行不受影响
+class LaminaFormatter
+{
+public:
+    // 只为 [firstLine, lastLine] 范围内的行生成编辑，缩进层级仍从文档开头计算
+    static std::vector<TextEdit> Format(std::string_view source, const FormatOptions& options = FormatOptions(),
+                                        size_t firstLine = 0, size_t lastLine = std::string_view::npos);
+
+    // 返回格式化后的全文
+    static std::string FormatText(std::string_view source, const FormatOptions& options = FormatOptions());
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Lamina 记号类型
+enum class TokenKind : uint8_t
+{
+    Identifier,
+    Keyword,
+    Number,
+    String,
+    Comment,
+    Operator,
+    LeftParen,
+    RightParen,
+    LeftBrace,
+    RightBrace,
+    LeftBracket,
+    RightBracket,
+    Comma,
+    Semicolon,
+    Unknown
+};
+
+struct LaminaToken
+{
+    TokenKind kind;
+    size_t start;   // UTF-8 字节偏移，与 Scintilla 位置一致
+    size_t length;
+    size_t line;    // 从 0 开始的行号
+};
+
+// 无界面的 Lamina 词法分析器，直接在 UTF-8 字节上工作，不分配内存
+class LaminaLexer
+{
+public:
+    explicit LaminaLexer(std::string_view source, size_t startLine = 0);
+
+    // 读取下一个记号，返回 false 表示结束
+    bool Next(LaminaToken& token);
+
+    std::string_view Text(const LaminaToken& token) const { return m_source.substr(token.start, token.length); }
+
+    static std::vector<LaminaToken> Tokenize(std::string_view source);
+    static bool IsKeyword(std::string_view word);
+
+private:
+    void SkipWhitespace();
+    size_t ScanOperator() const;
+
+private:
+    std::string_view m_source;
+    size_t m_pos;
+    size_t m_line;
+};
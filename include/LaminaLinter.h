@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// 静态检查的规则
+enum class LintRule : uint8_t
+{
+    UndefinedName = 0,      // 未定义的变量或函数
+    UnusedVariable,         // 函数中声明后从未读取的 var
+    UnreachableCode,        // return、break、continue 之后的语句
+    BadInclude,             // 无法解析的 include 路径
+    ArityMismatch,          // 调用 func 时参数个数不符
+    Count
+};
+
+struct LintFinding
+{
+    LintRule rule;
+    size_t start;           // UTF-8 字节偏移，与 Scintilla 位置一致
+    size_t length;
+    size_t line;            // 从 0 开始的行号
+    std::string name;       // 涉及的名称或 include 路径
+    int expected = 0;       // 参数个数不符时：定义的参数个数
+    int actual = 0;         // 参数个数不符时：实际传入的个数
+
+    bool IsError() const { return rule != LintRule::UnusedVariable && rule != LintRule::UnreachableCode; }
+};
+
+// 全局名称：func 的参数个数，或 -1 表示变量
+struct LintSymbol
+{
+    std::string name;
+    int arity;
+};
+
+// 最近一次检查的统计
+struct LintStats
+{
+    size_t units = 0;       // 文档中的顶层单元数（每个 func 一个，其间的顶层语句一个）
+    size_t parsed = 0;      // 新出现、需要解析的单元数
+    size_t checked = 0;     // 重新检查的单元数
+    double milliseconds = 0;
+};
+
+// Lamina 静态检查。文档按顶层单元（func 定义及其间的顶层语句）切分，
+// 每个单元解析为语句级的语法树后检查；结果按单元内容的哈希与全局名称表的哈希缓存，
+// 编辑后只有内容变化的单元重新解析和检查。同一对象不能在多个线程中同时使用
+class LaminaLinter
+{
+public:
+    // 解析 include 路径：文件存在时返回 true，并追加该文件（及其递归包含的文件）中的全局名称
+    using IncludeResolver = std::function<bool(const std::string& path, std::vector<LintSymbol>& symbols)>;
+
+    LaminaLinter();
+    ~LaminaLinter();
+
+    // 检查整个文档，结果按位置排列
+    std::vector<LintFinding> Lint(std::string_view source, const IncludeResolver& resolveInclude);
+
+    const LintStats& GetStats() const { return m_stats; }
+
+    // 清空缓存
+    void Clear();
+
+    // 文件中的顶层定义（func 与顶层 var），供包含该文件的文档使用
+    static std::vector<LintSymbol> CollectSymbols(std::string_view source);
+
+    // 英文说明，供命令行工具使用
+    static std::string Describe(const LintFinding& finding);
+
+private:
+    struct UnitEntry;
+
+    std::unordered_map<uint64_t, std::unique_ptr<UnitEntry>> m_cache;     // 按单元内容的哈希
+    unsigned m_run;                                     // 本次检查的序号，未用到的缓存项被移除
+    std::unordered_map<std::string, int> m_globals;     // 名称 -> 参数个数，变量为 -1
+    uint64_t m_globalsHash;
+    LintStats m_stats;
+};
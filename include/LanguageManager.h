@@ -1,10 +1,19 @@
 #pragma once
 
 #include <wx/wx.h>
-#include <wx/intl.h>
-#include <map>
-#include <memory>
+#include <array>
 
+// 界面文本的标识，由 Messages.def 生成，同时是查找表的下标
+enum MessageId
+{
+#define LAMINA_MESSAGE(id, english, chinese) id,
+#include "Messages.def"
+#undef LAMINA_MESSAGE
+    MSG_COUNT
+};
+
+// 界面语言：文本在编译时生成为每种语言一张表，切换语言时转换为 wxString，
+// 之后每次查找只是一次数组访问，不分配内存
 class LanguageManager
 {
 public:
@@ -16,32 +25,33 @@ public:
     };
 
     static LanguageManager& GetInstance();
-    
+
+    // 读取保存的语言设置并生成文本
     bool Initialize();
     bool SetLanguage(Language lang);
     Language GetCurrentLanguage() const { return m_currentLanguage; }
-    
-    wxString GetText(const wxString& key) const;
-    wxString _(const wxString& key) const { return GetText(key); }
-    
+
+    const wxString& GetText(MessageId id) const { return m_texts[id]; }
+
     wxArrayString GetAvailableLanguages() const;
     wxString GetLanguageName(Language lang) const;
-    
+
     void LoadSettings();
     void SaveSettings();
-    
+
 private:
     LanguageManager() = default;
     ~LanguageManager() = default;
     LanguageManager(const LanguageManager&) = delete;
     LanguageManager& operator=(const LanguageManager&) = delete;
-    
-    void InitializeTranslations();
-    void InitializeEnglish();
-    void InitializeChineseSimplified();
-    
+
 private:
     Language m_currentLanguage = LANG_ENGLISH;
-    std::unique_ptr<wxLocale> m_locale;
-    std::map<Language, std::map<wxString, wxString>> m_translations;
+    std::array<wxString, MSG_COUNT> m_texts;
 };
+
+// 当前语言的界面文本
+inline const wxString& Tr(MessageId id)
+{
+    return LanguageManager::GetInstance().GetText(id);
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+#include "BulkEdit.h"
+
+// 一处不同的行：旧文本中的 [oldLine, oldLine + oldCount) 对应新文本中的 [newLine, newLine + newCount)
+struct LineHunk
+{
+    size_t oldLine;
+    size_t oldCount;
+    size_t newLine;
+    size_t newCount;
+};
+
+// 按行比较两段文本，生成把旧文本变为新文本的编辑（位置基于旧文本）。
+// 先跳过相同的开头和结尾，只对中间不同的部分做 Myers 差异计算
+class LineDiff
+{
+public:
+    static std::vector<TextEdit> Compute(std::string_view oldText, std::string_view newText);
+    
+    // 同样的比较，以行号的形式返回不同的部分（用于行变更标记）
+    static std::vector<LineHunk> ComputeHunks(std::string_view oldText, std::string_view newText);
+};
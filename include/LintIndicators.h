@@ -0,0 +1,56 @@
+#pragma once
+
+#include <wx/wx.h>
+#include <wx/stc/stc.h>
+#include <functional>
+#include <thread>
+#include <vector>
+#include "LaminaLinter.h"
+
+class LaminaEditor;
+
+// 编辑器中的静态检查标记：停止输入后在后台线程中检查文档，
+// 结果以波浪线指示器标出，鼠标悬停时显示说明。LaminaLinter 缓存每个顶层单元的结果，
+// 一次编辑后只重新检查被修改的函数
+class LintIndicators : public wxEvtHandler
+{
+public:
+    explicit LintIndicators(LaminaEditor* editor);
+    ~LintIndicators();
+
+    // 文档被重新载入或保存后立即检查（include 路径相对于文件所在的目录）
+    void Recheck();
+
+    // 标记更新后以出现问题的行调用
+    void SetLinesCallback(std::function<void(const std::vector<int>& lines)> callback) { m_linesCallback = callback; }
+
+    const std::vector<LintFinding>& GetFindings() const { return m_findings; }
+
+private:
+    void OnEditorModified(wxStyledTextEvent& event);
+    void OnLintTimer(wxTimerEvent& event);
+    void OnDwellStart(wxStyledTextEvent& event);
+    void OnDwellEnd(wxStyledTextEvent& event);
+
+    void StartJob();
+    void FinishJob(unsigned long changeCount, std::vector<LintFinding> findings);
+    void ApplyIndicators();
+
+    // 在后台线程中调用：被包含的文件及其递归包含的文件中的全局名称，分析结果来自 IncludeIndex 的缓存
+    bool ResolveInclude(const wxString& fromFile, const std::string& include, std::vector<LintSymbol>& symbols);
+
+    static wxString Describe(const LintFinding& finding);
+
+private:
+    LaminaEditor* m_editor;
+    wxTimer m_lintTimer;
+
+    LaminaLinter m_linter;          // 只在后台线程中使用
+
+    std::thread m_thread;
+    bool m_running;
+    bool m_pending;                 // 检查期间文档又有变化
+
+    std::vector<LintFinding> m_findings;
+    std::function<void(const std::vector<int>&)> m_linesCallback;
+};
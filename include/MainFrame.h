@@ -3,10 +3,24 @@
 #include <wx/wx.h>
 #include <wx/stc/stc.h>
 #include <wx/aui/aui.h>
+#include <wx/fdrepdlg.h>
+#include <functional>
+#include <future>
 #include <memory>
+#include <thread>
+#include <vector>
+#include "SessionStore.h"
+#include "BulkEdit.h"
+#include "RunCache.h"
 
 class LaminaEditor;
 class ProcessManager;
+class BatchPanel;
+class MinimapPanel;
+class OutlinePanel;
+class ConsolePanel;
+class PlotPanel;
+class ReplSession;
 
 // Menu IDs
 enum {
@@ -16,17 +30,62 @@ enum {
     ID_SETTINGS,
     ID_EDITOR,
     ID_CONSOLE,
+    ID_RUN_DIRECTORY,
+    ID_RUN_WITH_INPUT,
+    ID_RUN_FORCE,
+    ID_RUN_CACHE,
+    ID_REPL_START,
+    ID_REPL_EXECUTE,
+    ID_REPL_INTERRUPT,
+    ID_REPL_STOP,
+    ID_WATCH_MODE,
+    ID_WATCH_TIMER,
+    ID_SESSION_TIMER,
+    ID_SESSION_FILE_START,
+    ID_SESSION_FILE_END = ID_SESSION_FILE_START + SessionStore::MAX_DOCUMENTS,
+    ID_GOTO_LINE,
+    ID_MINIMAP,
+    ID_OUTLINE,
+    ID_PLOT,
+    ID_FORMAT_DOCUMENT,
+    ID_FORMAT_SELECTION,
+    ID_FORMAT_ON_SAVE,
+    ID_DISK_CHANGE_TIMER,
+    ID_THEME_RELOAD_TIMER,
+    ID_MEMORY_USAGE,
+    ID_AFFECTED_SCRIPTS,
+    ID_STARTUP_TIMER,
+    ID_LANGUAGE_START,
+    ID_LANGUAGE_END = ID_LANGUAGE_START + 10,
     ID_THEME_START,
     ID_THEME_END = ID_THEME_START + 100 // 支持最多100个主题
 };
 
+// 启动时在后台线程中读取的设置
+struct FrameSettings
+{
+    wxPoint position = wxDefaultPosition;
+    wxSize size = wxSize(800, 600);
+    wxString interpreterPath;
+    bool formatOnSave = false;
+    long undoBudgetMB = 0;
+    bool runCache = false;
+    long runCacheMB = 0;
+};
+
 class MainFrame : public wxFrame
 {
 public:
     MainFrame();
     virtual ~MainFrame();
+    
+    // 第一次绘制后延后的启动阶段全部完成时调用
+    void SetReadyCallback(std::function<void()> callback) { m_readyCallback = callback; }
 
 private:
+    // 性能测试直接驱动编辑器、打开文件和运行脚本
+    friend class PerfSuite;
+    
     // 事件处理
     void OnNew(wxCommandEvent& event);
     void OnOpen(wxCommandEvent& event);
@@ -40,11 +99,42 @@ private:
     void OnCopy(wxCommandEvent& event);
     void OnPaste(wxCommandEvent& event);
     void OnFind(wxCommandEvent& event);
+    void OnReplace(wxCommandEvent& event);
+    void OnGotoLine(wxCommandEvent& event);
+    void OnMinimap(wxCommandEvent& event);
+    void OnOutline(wxCommandEvent& event);
+    void OnPlot(wxCommandEvent& event);
+    void OnFormatDocument(wxCommandEvent& event);
+    void OnFormatSelection(wxCommandEvent& event);
+    void OnFormatOnSave(wxCommandEvent& event);
+    
+    // 查找替换对话框
+    void OnFindDialogNext(wxFindDialogEvent& event);
+    void OnFindDialogReplace(wxFindDialogEvent& event);
+    void OnFindDialogReplaceAll(wxFindDialogEvent& event);
+    void OnFindDialogClose(wxFindDialogEvent& event);
     
     void OnRun(wxCommandEvent& event);
     void OnStop(wxCommandEvent& event);
+    void OnRunDirectory(wxCommandEvent& event);
+    void OnRunWithInput(wxCommandEvent& event);
+    void OnRunForce(wxCommandEvent& event);
+    void OnRunCache(wxCommandEvent& event);
+    void OnReplStart(wxCommandEvent& event);
+    void OnReplExecute(wxCommandEvent& event);
+    void OnReplInterrupt(wxCommandEvent& event);
+    void OnReplStop(wxCommandEvent& event);
+    void OnWatchMode(wxCommandEvent& event);
+    void OnWatchTimer(wxTimerEvent& event);
+    void OnDiskChangeTimer(wxTimerEvent& event);
+    void OnThemeReloadTimer(wxTimerEvent& event);
+    void OnMemoryUsage(wxCommandEvent& event);
+    void OnAffectedScripts(wxCommandEvent& event);
+    void OnSessionFile(wxCommandEvent& event);
+    void OnSessionTimer(wxTimerEvent& event);
     void OnSettings(wxCommandEvent& event);
     void OnTheme(wxCommandEvent& event);
+    void OnLanguage(wxCommandEvent& event);
     
     void OnAbout(wxCommandEvent& event);
     
@@ -59,6 +149,19 @@ private:
     void CreateConsole();
     
     void CreateThemeMenu(wxMenu* viewMenu);
+    void RebuildThemeMenu();
+    void CreateLanguageMenu(wxMenu* viewMenu);
+    
+    // 分阶段启动：构造函数只创建第一次绘制需要的窗口，
+    // 其余阶段在第一次绘制之后每个空闲事件执行一个
+    void OnStartupPaint(wxPaintEvent& event);
+    void OnStartupIdle(wxIdleEvent& event);
+    void OnStartupTimer(wxTimerEvent& event);
+    void BeginStartupStages();
+    void RunNextStartupStage();
+    void FinishStartup();
+    void ApplyLoadedTheme();
+    void StartWatchers();
     
     // 文本编辑器事件
     void OnTextChange(wxStyledTextEvent& event);
@@ -66,19 +169,56 @@ private:
     
     // 实用函数
     bool CheckSaveChanges();
+    bool SaveEditorFile(const wxString& filename);
+    
+    // 打开文件并恢复其上次的视图状态
+    bool OpenFile(const wxString& filename);
+    
+    // 会话管理
+    void CheckRecovery();
+    void RestoreSession();
+    void CaptureSession();
+    int TrackSessionDocument(const wxString& filename);
+    void RebuildSessionMenu();
+    
+    // 替换全部：后台线程计算编辑，主线程一次应用
+    bool FindNextMatch();
+    void FinishReplaceAll(const std::vector<TextEdit>& edits, unsigned long changeCount);
+    
+    // 运行当前文件（不保存）。启用运行缓存且 useCache 时，命中的结果直接回放到控制台
+    void StartScript(const wxString& inputFile = wxEmptyString, bool useCache = true);
+    bool ReplayCachedRun(uint64_t key);
+    
+    // 启动（或重启）REPL 会话，解释器命令去掉脚本路径
+    bool StartRepl();
+    
+    // 监视模式：当前文件及其 include 的文件保存后自动重新运行
+    void UpdateWatchedFiles();
+    void OnWatchedFileChanged();
+    
+    // 当前文件被其他程序修改：未修改时直接重新载入，否则询问
+    void OnDiskContentChanged();
     
-    // 配置管理
-    void LoadSettings();
+    // 文件处于包含环上时在状态栏与控制台中提示，同一个环只提示一次
+    void CheckIncludeCycle(const wxString& file);
+    
+    // 配置管理：读取不涉及窗口，可在后台线程中进行
+    static FrameSettings ReadSettings();
+    void ApplySettings(const FrameSettings& settings);
     void SaveSettings();
     
     // 更新界面
     void UpdateTitle();
+    void UpdateFileModeStatus();
     
 private:
     // UI 组件
     wxAuiManager m_auiManager;
     LaminaEditor* m_editor;
-    wxTextCtrl* m_console;
+    MinimapPanel* m_minimap;
+    OutlinePanel* m_outline;
+    ConsolePanel* m_console;
+    PlotPanel* m_plot;
     
     // 文件信息
     wxString m_currentFile;
@@ -87,9 +227,70 @@ private:
     // 解释器配置
     wxString m_interpreterPath;
     
+    // 保存 .lm 文件前自动格式化
+    bool m_formatOnSave;
+    
     // 进程管理
     ProcessManager* m_processManager;
     
+    // 常驻的解释器会话，执行选中的代码
+    ReplSession* m_repl;
+    
+    // 批量运行结果面板
+    BatchPanel* m_batchPanel;
+    
+    // 运行结果缓存，默认关闭
+    RunCache m_runCache;
+    bool m_runCacheEnabled;
+    
+    // 监视模式
+    bool m_watchMode;
+    std::vector<int> m_watchHandles;
+    wxTimer m_watchTimer;
+    wxStopWatch m_watchLatency;
+    bool m_watchLatencyPending;
+    
+    // 外部修改检测
+    int m_fileWatchHandle;
+    wxTimer m_diskChangeTimer;
+    
+    // 主题文件热重载
+    int m_themeWatchHandle;
+    wxTimer m_themeReloadTimer;
+    bool m_diskPromptOpen;
+    
+    // 上次提示的包含环
+    wxString m_lastIncludeCycle;
+    
+    // 查找替换
+    wxFindReplaceData m_findData;
+    wxFindReplaceDialog* m_findDialog;
+    std::thread m_replaceThread;
+    bool m_replaceRunning;
+    
+    // 会话：工作集中的文件只保存视图状态，选中时才加载
+    SessionStore m_sessionStore;
+    SessionSnapshot m_session;
+    wxTimer m_sessionTimer;
+    bool m_sessionDirty;
+    wxMenu* m_sessionMenu;
+    wxMenu* m_themeMenu;
+    
+    // 启动阶段
+    struct StartupTask
+    {
+        const char* name;
+        std::function<void()> run;
+    };
+    std::vector<StartupTask> m_startupTasks;
+    size_t m_startupTask;
+    bool m_firstPaintDone;
+    bool m_startupStarted;
+    wxTimer m_startupTimer;                 // 窗口最小化或不可见、一直没有绘制时仍然开始
+    std::function<void()> m_readyCallback;
+    SessionSnapshot m_loadedSession;
+    std::future<bool> m_sessionLoad;        // 后台读取会话文件，结果写入 m_loadedSession
+    
     // 事件ID
     enum
     {
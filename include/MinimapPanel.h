@@ -0,0 +1,105 @@
+#pragma once
+
+#include <wx/wx.h>
+#include <wx/stc/stc.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class LaminaEditor;
+
+// 叠加在缩略图上的标记
+enum class MinimapOverlay
+{
+    SearchHit = 0,
+    Diagnostic,
+    Count
+};
+
+// 渲染任务：一个图块覆盖的行的文本与样式快照，在主线程中生成
+struct MinimapJob
+{
+    size_t tile;
+    unsigned generation;
+    std::string cells;                  // 文本与样式字节交替排列
+    std::vector<size_t> lineStarts;     // 每行在 cells 中的起始偏移
+    std::vector<uint32_t> palette;      // 样式号对应的前景色（RGB）
+    uint32_t background;
+    int tabWidth;
+};
+
+// 文档缩略图：按固定行数分块缓存缩小后的位图，编辑时只失效受影响的图块，
+// 图块在后台线程中渲染
+class MinimapPanel : public wxWindow
+{
+public:
+    MinimapPanel(wxWindow* parent, LaminaEditor* editor, wxWindowID id = wxID_ANY);
+    virtual ~MinimapPanel();
+
+    // 设置叠加标记所在的行，替换该类标记之前的内容
+    void SetOverlay(MinimapOverlay overlay, std::vector<int> lines);
+
+private:
+    struct Tile
+    {
+        wxBitmap bitmap;
+        unsigned generation = 0;
+        bool dirty = true;
+        bool pending = false;
+        unsigned long lastUsed = 0;
+    };
+
+    // 事件处理
+    void OnPaint(wxPaintEvent& event);
+    void OnSize(wxSizeEvent& event);
+    void OnMouseDown(wxMouseEvent& event);
+    void OnMouseMove(wxMouseEvent& event);
+    void OnMouseUp(wxMouseEvent& event);
+    void OnCaptureLost(wxMouseCaptureLostEvent& event);
+    void OnUpdateTimer(wxTimerEvent& event);
+    void OnEditorModified(wxStyledTextEvent& event);
+    void OnEditorUpdateUI(wxStyledTextEvent& event);
+
+    void InvalidateLines(int firstLine, int lastLine);
+    void InvalidateAll();
+    void SyncTileCount();
+    bool UpdatePalette();
+
+    // 缩略图顶部对应的像素偏移
+    int GetScrollOffset() const;
+    void ScrollToPoint(int y);
+
+    void RequestTile(size_t tile);
+    void OnTileRendered(size_t tile, unsigned generation, const std::vector<unsigned char>& pixels);
+    void EvictTiles();
+
+    // 后台线程：渲染为 RGB 像素，位图在主线程中创建
+    void WorkerLoop();
+    static std::vector<unsigned char> RenderTile(const MinimapJob& job);
+
+private:
+    LaminaEditor* m_editor;
+    std::vector<Tile> m_tiles;
+    unsigned long m_useCounter;
+
+    std::vector<uint32_t> m_palette;
+    uint32_t m_background;
+
+    std::vector<int> m_overlays[(int)MinimapOverlay::Count];
+
+    wxTimer m_updateTimer;
+    bool m_dragging;
+    bool m_colourising;     // 自身触发的着色不再使图块失效
+
+    std::thread m_worker;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<MinimapJob> m_jobs;
+    bool m_stop;
+
+    wxDECLARE_EVENT_TABLE();
+};
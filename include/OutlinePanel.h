@@ -0,0 +1,65 @@
+#pragma once
+
+#include <wx/wx.h>
+#include <wx/treectrl.h>
+#include <wx/stc/stc.h>
+#include <cstdint>
+#include <vector>
+#include "OutlineScanner.h"
+
+class LaminaEditor;
+
+// 文档结构面板：include、func 定义与顶层 var，点击跳转。
+// 编辑后只重新扫描改动的行（块注释状态变化时继续向后扫描），并就地修改树中受影响的节点
+class OutlinePanel : public wxPanel
+{
+public:
+    OutlinePanel(wxWindow* parent, LaminaEditor* editor, wxWindowID id = wxID_ANY);
+    virtual ~OutlinePanel();
+
+    // 界面语言变化后更新分组名称
+    void UpdateLabels();
+
+private:
+    struct Entry
+    {
+        size_t line;
+        std::string name;
+        wxTreeItemId item;
+    };
+
+    void OnEditorModified(wxStyledTextEvent& event);
+    void OnEditorUpdateUI(wxStyledTextEvent& event);
+    void OnSelectionChanged(wxTreeEvent& event);
+    void OnItemActivated(wxTreeEvent& event);
+
+    // 处理积累的编辑，每次界面刷新前最多一次
+    void Update();
+
+    // 用扫描结果替换一类符号中的 [first, last) 部分，保留前后相同的节点
+    void PatchKind(OutlineKind kind, size_t first, size_t last, std::vector<Entry>& replacement);
+
+    bool FindEntry(const wxTreeItemId& item, size_t& line) const;
+
+private:
+    LaminaEditor* m_editor;
+    wxTreeCtrl* m_tree;
+    wxTreeItemId m_groups[(int)OutlineKind::Count];
+
+    // 每一类符号按行号排列
+    std::vector<Entry> m_entries[(int)OutlineKind::Count];
+
+    // 每一行开头是否位于块注释中
+    std::vector<uint8_t> m_lineStates;
+
+    // 上次更新之后的编辑覆盖的区域：当前文档中的 [m_dirtyFirst, m_dirtyEnd)，
+    // 对应更新前的 [m_dirtyFirst, m_dirtyEnd - m_dirtyDelta)
+    bool m_dirty;
+    size_t m_dirtyFirst;
+    size_t m_dirtyEnd;
+    long m_dirtyDelta;
+
+    bool m_patching;    // 修改树期间的选中变化不跳转
+
+    wxDECLARE_EVENT_TABLE();
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class OutlineKind : uint8_t
+{
+    Include = 0,
+    Function,
+    Variable,   // 只包括顶层（行首无缩进）的 var
+    Count
+};
+
+struct OutlineSymbol
+{
+    OutlineKind kind;
+    size_t line;
+    std::string name;
+};
+
+// 文档结构扫描：在若干整行上找出 include、func 定义和顶层 var。
+// 扫描可以从任意一行开始，只需知道该行开头是否位于块注释中，用于编辑后的局部重新扫描
+class OutlineScanner
+{
+public:
+    // text 从第 firstLine 行开头开始，由整行组成。lineStates 返回每一行开头是否位于块注释中：
+    // 第 i 个对应第 firstLine + i 行，共 text 中换行符的个数加一个（最后一个对应范围之后的一行）
+    static void Scan(std::string_view text, size_t firstLine, bool startsInComment,
+                     std::vector<OutlineSymbol>& symbols, std::vector<uint8_t>& lineStates);
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 一个场景的测量结果，指标名带单位后缀（如 duration_ms、peak_rss_mb）
+struct PerfResult
+{
+    std::string scenario;
+    std::map<std::string, double> metrics;
+};
+
+// 指标允许的增长：测量值不超过 基准 × ratio + slack
+struct PerfTolerance
+{
+    double ratio = 1.25;
+    double slack = 0;
+};
+
+// 性能基准：各场景各指标的基准值与容差，以 JSON 保存：
+// {"tolerance": {"<指标>": {"ratio": r, "slack": s}}, "scenarios": {"<场景>": {"<指标>": v}}}
+// 其他键（如说明文字）读取时忽略
+class PerfBaseline
+{
+public:
+    bool Parse(std::string_view json, std::string& error);
+    std::string ToJson() const;
+
+    // 用测量结果替换基准值，容差保持不变
+    void Update(const std::vector<PerfResult>& results);
+
+    // 超出容差的指标，每项一行说明；基准中没有的场景和指标不比较
+    std::vector<std::string> Compare(const std::vector<PerfResult>& results) const;
+
+    bool GetValue(const std::string& scenario, const std::string& metric, double& value) const;
+    PerfTolerance GetTolerance(const std::string& metric) const;
+
+    // 最近秩法计算分位数，percentile 取 0 到 100
+    static double Percentile(std::vector<double> samples, double percentile);
+
+private:
+    std::map<std::string, PerfTolerance> m_tolerance;
+    std::map<std::string, std::map<std::string, double>> m_scenarios;
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <wx/wx.h>
+#include <chrono>
+#include <functional>
+#include <vector>
+#include "PerfBaseline.h"
+
+class MainFrame;
+
+// 性能回归测试的选项
+struct PerfSuiteOptions
+{
+    wxString baselinePath;
+    wxString outputPath;        // 为空时不写出结果
+    wxString workDir;           // 生成的测试文件所在的临时目录，结束时删除
+    bool updateBaseline = false;
+};
+
+// 在真实的 MainFrame 中按脚本执行场景：打开 1/100/500 MB 的文件、输入一万个字符、从头滚动到尾、
+// 切换主题、运行输出一千万行的脚本。记录事件循环的最长停顿、每次操作的延迟分位数和峰值常驻内存，
+// 与基准比较后关闭主窗口，超出容差时退出码为 1
+class PerfSuite : public wxEvtHandler
+{
+public:
+    PerfSuite(MainFrame* frame, const PerfSuiteOptions& options);
+    ~PerfSuite();
+
+    void Start();
+
+    int GetExitCode() const { return m_exitCode; }
+
+private:
+    struct Scenario
+    {
+        std::string name;
+        // 每个心跳调用一次，返回 true 表示场景的操作已经完成
+        std::function<bool()> step;
+    };
+
+    void AddScenarios();
+    bool GenerateFiles();
+
+    void OnHeartbeat(wxTimerEvent& event);
+    void BeginScenario();
+    void EndScenario();
+    void Finish();
+
+    // 执行一次操作并把耗时记为一个延迟样本
+    void Measure(const std::function<void()>& action);
+
+    bool TypeCharacter(size_t index);
+    bool ScrollFrame(int& line);
+    bool SwitchTheme(size_t index);
+
+private:
+    MainFrame* m_frame;
+    PerfSuiteOptions m_options;
+    wxTimer m_heartbeat;
+    int m_exitCode;
+
+    std::vector<Scenario> m_scenarios;
+    size_t m_current;
+    bool m_settling;            // 操作已完成，继续观察后台任务引起的停顿
+    std::vector<PerfResult> m_results;
+    wxString m_originalTheme;
+
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point m_scenarioStart;
+    Clock::time_point m_stepsDone;
+    Clock::time_point m_lastBeat;
+    double m_stallMax;          // 毫秒
+    std::vector<double> m_latencies;
+};
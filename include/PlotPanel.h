@@ -0,0 +1,60 @@
+#pragma once
+
+#include <wx/wx.h>
+#include <cstdint>
+#include <vector>
+#include "PlotSeries.h"
+
+// 运行中脚本的数值输出曲线：标准输出按块送入 PlotParser 流式解析，
+// 绘制时每个像素列只取该列样本的最小值与最大值，样本数不影响绘制时间。
+// 解析只做追加，重绘由定时器合并，不会拖慢读取输出
+class PlotPanel : public wxWindow
+{
+public:
+    PlotPanel(wxWindow* parent, wxWindowID id = wxID_ANY);
+
+    // 标准输出的原始字节，可在任意位置分块
+    void AppendData(const char* data, size_t size);
+
+    // 输出结束，最后一行没有换行符时也计入
+    void Finish();
+
+    // 新的运行开始
+    void Clear();
+
+    size_t GetMemoryUsage() const { return m_parser.GetMemoryUsage(); }
+
+private:
+    void OnPaint(wxPaintEvent& event);
+    void OnSize(wxSizeEvent& event);
+    void OnRefreshTimer(wxTimerEvent& event);
+    void OnMouseWheel(wxMouseEvent& event);
+    void OnMouseDown(wxMouseEvent& event);
+    void OnMouseMove(wxMouseEvent& event);
+    void OnMouseUp(wxMouseEvent& event);
+    void OnCaptureLost(wxMouseCaptureLostEvent& event);
+    void OnDoubleClick(wxMouseEvent& event);
+
+    void ScheduleRefresh();
+
+    // 当前显示的样本范围 [first, last)；跟随时显示全部样本
+    void GetView(uint64_t& first, uint64_t& last) const;
+    wxRect GetPlotArea() const;
+
+private:
+    PlotParser m_parser;
+    wxTimer m_refreshTimer;
+    bool m_dirty;
+
+    bool m_follow;              // 新样本到达时显示全部
+    uint64_t m_viewFirst;
+    uint64_t m_viewLast;
+
+    bool m_dragging;
+    int m_dragX;
+    uint64_t m_dragFirst;
+
+    std::vector<PlotRange> m_columns[PlotParser::MAX_COLUMNS];     // 绘制时复用
+
+    wxDECLARE_EVENT_TABLE();
+};
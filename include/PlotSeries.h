@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 一段样本的最小值与最大值，没有有效样本时 min > max
+struct PlotRange
+{
+    float min;
+    float max;
+
+    bool IsEmpty() const { return min > max; }
+};
+
+// 一列数值，按样本序号分桶只保存每桶的最小值与最大值。
+// 桶数达到上限时相邻两桶合并、每桶的样本数加倍，因此内存有上限，
+// 任意多的样本都能按像素列取出准确的包络（最小/最大值抽取）
+class PlotSeries
+{
+public:
+    PlotSeries();
+
+    // 追加一个样本，非有限值（nan、inf）作为空缺
+    void Append(double value);
+
+    // 追加 count 个空缺的样本，不逐个处理
+    void AppendEmpty(uint64_t count);
+
+    // 把样本 [first, last) 平均分成 columns 列，返回每列的范围。
+    // 放大到每列不足一桶时只有部分列有值，其余为空
+    void Decimate(uint64_t first, uint64_t last, size_t columns, std::vector<PlotRange>& ranges) const;
+
+    uint64_t GetCount() const { return m_count; }
+    uint64_t GetBucketSize() const { return m_bucketSize; }
+    size_t GetMemoryUsage() const { return m_buckets.capacity() * sizeof(PlotRange); }
+
+    // 全部样本的范围
+    PlotRange GetBounds() const { return m_bounds; }
+
+    void Clear();
+
+private:
+    // 开始一个新桶，已满时先两两合并
+    void OpenBucket();
+
+private:
+    std::vector<PlotRange> m_buckets;
+    uint64_t m_bucketSize;          // 每桶的样本数，2 的幂
+    uint64_t m_count;
+    PlotRange m_bounds;
+};
+
+// 从进程的标准输出中流式解析数值列。一行中用空白、逗号或分号分隔的字段都是数字时
+// 是一行数据，第 n 个字段进入第 n 列，其他行（提示文字、空行）忽略。
+// 数据可以在任意位置分块送入；当前行的状态保存在定长缓冲区中，不按行分配内存
+class PlotParser
+{
+public:
+    static const size_t MAX_COLUMNS = 8;
+
+    PlotParser();
+
+    void Feed(const char* data, size_t size);
+
+    // 输出结束：最后一行没有换行符时也作为一行
+    void Finish();
+
+    void Clear();
+
+    const std::vector<PlotSeries>& GetSeries() const { return m_series; }
+    uint64_t GetRowCount() const { return m_rows; }
+    size_t GetMemoryUsage() const;
+
+private:
+    void EndField();
+    void EndLine();
+
+private:
+    static const size_t MAX_FIELD = 64;
+
+    char m_field[MAX_FIELD];
+    size_t m_fieldLength;
+    bool m_fieldTooLong;
+
+    double m_values[MAX_COLUMNS];
+    size_t m_valueCount;
+    bool m_lineValid;           // 当前行到目前为止的字段都是数字
+
+    std::vector<PlotSeries> m_series;
+    uint64_t m_rows;
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 已启动的子进程：父进程一端的管道描述符
+struct LaunchedProcess
+{
+    int pid = 0;
+    int input = -1;         // 子进程的标准输入（非阻塞写入）
+    int output = -1;        // 子进程的标准输出
+    int error = -1;         // 子进程的标准错误
+};
+
+// 运行结束的子进程的输出，保持原始字节
+struct ProcessOutput
+{
+    int exitCode = -1;      // 被信号终止时为负的信号编号，与 wxProcess 一致
+    std::string output;
+    std::string errors;
+};
+
+// 解释器命令的拆分与启动。命令先拆分为参数再替换 %lmfilepath%，
+// 路径中的空格和引号不会改变参数的划分
+class ProcessLauncher
+{
+public:
+    // 按空白拆分参数。双引号和单引号内的空白属于参数；
+    // 反斜杠只转义紧随的双引号，其余保持原样，Windows 路径无需转义
+    static std::vector<std::string> SplitCommand(std::string_view command);
+
+    // 拆分后在每个参数中把 %lmfilepath% 替换为 filePath。
+    // filePath 为空时去掉只由占位符组成的参数（如 REPL 会话不需要脚本路径）
+    static std::vector<std::string> ExpandCommand(std::string_view commandTemplate, std::string_view filePath);
+
+    // 当前平台能否用 posix_spawn 启动并在子进程中切换工作目录
+    static bool IsSpawnSupported();
+
+    // 用 posix_spawn 启动子进程：不复制父进程的地址空间，工作目录和重定向都在子进程中设置，
+    // 父进程的工作目录保持不变。失败时返回 false，errorCode 为 errno
+    static bool Spawn(const std::vector<std::string>& args, const std::string& workingDir,
+                      LaunchedProcess& process, int& errorCode);
+
+    // 启动子进程并等待它结束，读取全部标准输出与标准错误，标准输入为空。
+    // 不依赖事件循环，可在任意线程中调用（wxExecute 只能在主线程中调用）。
+    // 无法启动时返回 false，errorCode 为系统错误码
+    static bool Run(const std::vector<std::string>& args, const std::string& workingDir,
+                    ProcessOutput& result, int& errorCode);
+};
@@ -2,8 +2,24 @@
 
 #include <wx/wx.h>
 #include <wx/process.h>
+#include <wx/file.h>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <string>
+#include <vector>
+
+struct InputChannel;
+
+// 标准输入文件的发送进度
+struct InputFileProgress
+{
+    uint64_t sent = 0;
+    uint64_t total = 0;
+    double seconds = 0;
+    bool done = false;          // 文件已全部写入或发送中止
+    bool failed = false;        // 读取失败或子进程提前关闭了标准输入
+};
 
 class ProcessManager : public wxEvtHandler
 {
@@ -11,38 +27,89 @@ public:
     ProcessManager();
     virtual ~ProcessManager();
     
-    // 运行命令
-    bool RunCommand(const wxString& command, const wxString& workingDir = wxEmptyString);
+    // 运行解释器命令。命令模板先拆分为参数，再把 %lmfilepath% 替换为 filePath，
+    // 工作目录只对子进程生效。inputFile 非空时它成为本次运行的标准输入，
+    // 由写入线程送入管道，控制台输入随之关闭
+    bool RunCommand(const wxString& commandTemplate, const wxString& filePath,
+                    const wxString& workingDir = wxEmptyString, const wxString& inputFile = wxEmptyString);
     
     // 停止当前进程
     void StopProcess();
     
+    // 向进程发送 SIGINT，中断当前的计算而不结束进程。平台不支持时返回 false
+    bool Interrupt();
+    
     // 查询状态
     bool IsRunning() const { return m_process != nullptr; }
     
+    // 读取输出的间隔（毫秒），等待交互结果时调小以降低延迟
+    void SetPollInterval(int milliseconds);
+    
+    // 写入标准输入，不阻塞：返回接受的字节数，队列已满时少于 size。
+    // 之后队列腾出空间时调用输入空间回调
+    size_t WriteInput(const char* data, size_t size);
+    
+    // 已排队的输入写完后关闭标准输入，子进程读到 EOF
+    void CloseInput();
+    
+    // 进程正在运行且标准输入尚未关闭
+    bool IsInputOpen() const;
+    
+    // 本次运行是否从控制台收到过输入（这样的运行结果不可复用）
+    bool HasReceivedInput() const { return m_inputReceived; }
+    
     // 设置输出回调
     void SetOutputCallback(std::function<void(const wxString&)> callback) { m_outputCallback = callback; }
     void SetErrorCallback(std::function<void(const wxString&)> callback) { m_errorCallback = callback; }
+    
+    // 标准输出的原始字节，在按行回调之前以读到的整块调用，块边界可能在行中间
+    void SetOutputDataCallback(std::function<void(const char*, size_t)> callback) { m_outputDataCallback = callback; }
     void SetFinishedCallback(std::function<void(int)> callback) { m_finishedCallback = callback; }
+    void SetInputSpaceCallback(std::function<void()> callback) { m_inputSpaceCallback = callback; }
+    void SetInputFileCallback(std::function<void(const InputFileProgress&)> callback) { m_inputFileCallback = callback; }
     
 private:
     // 事件处理
     void OnProcessTerminate(wxProcessEvent& event);
     void OnTimer(wxTimerEvent& event);
     
+    // 启动子进程：Linux 上使用 posix_spawn，其他平台使用 wxExecute
+    bool Launch(const std::vector<std::string>& args, const wxString& workingDir);
+    void CheckSpawnedExit();
+    
     // 读取输出
     void ReadOutput();
     void ReadError();
+    void ReadStream(wxInputStream* stream, const std::function<void(const wxString&)>& callback,
+                    const std::function<void(const char*, size_t)>& dataCallback);
+    
+    // 接管标准输入管道并启动写入线程，inputFile 非空时先写入该文件
+    void StartInput(std::unique_ptr<wxFile> inputFile);
+    void StopInput();
+    void OnInputSpace();
+    
+    // 报告标准输入文件的进度，发送结束后只再报告一次。
+    // finished 表示进程已结束，未发送完的文件算作中止
+    void ReportInputFile(bool finished);
     
 private:
     std::unique_ptr<wxProcess> m_process;
     wxTimer m_timer;
     int m_pid;
+    int m_pollInterval;
+    bool m_spawned;             // 由 posix_spawn 启动，需要自行回收
+    std::shared_ptr<InputChannel> m_input;
+    bool m_inputFileReported;
+    bool m_inputReceived;
+    std::vector<char> m_readBuffer;
     
     // 回调函数
     std::function<void(const wxString&)> m_outputCallback;
     std::function<void(const wxString&)> m_errorCallback;
+    std::function<void(const char*, size_t)> m_outputDataCallback;
     std::function<void(int)> m_finishedCallback;
+    std::function<void()> m_inputSpaceCallback;
+    std::function<void(const InputFileProgress&)> m_inputFileCallback;
     
     wxDECLARE_EVENT_TABLE();
 };
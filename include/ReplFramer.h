@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 解释器输出中的一段：属于请求 id 的输出，或请求 id 执行完毕
+struct ReplEvent
+{
+    enum Kind : uint8_t
+    {
+        Output = 0,
+        Done
+    };
+
+    Kind kind;
+    uint64_t id;        // 0 表示不属于任何请求（如解释器的启动信息）
+    std::string text;
+};
+
+// REPL 会话的分帧协议：每段代码之后追加一条打印哨兵的语句，
+// 标准输出中出现该请求的哨兵行时它执行完毕，之前的输出都属于它。
+// 哨兵包含每个会话随机的标记，脚本自己的输出不会误配
+class ReplFramer
+{
+public:
+    explicit ReplFramer(std::string token);
+
+    // 生成发送给解释器的文本，并把请求加入等待队列
+    std::string Frame(uint64_t id, std::string_view code);
+
+    // 处理一段标准输出，依次追加事件。完整的行立即处理；
+    // 未结束的行只保留可能是哨兵开头的部分，其余立即输出
+    void Feed(std::string_view text, std::vector<ReplEvent>& events);
+
+    // 正在执行的请求（最早的未完成请求），没有时返回 0
+    uint64_t GetCurrentId() const { return m_pending.empty() ? 0 : m_pending.front(); }
+    size_t GetPendingCount() const { return m_pending.size(); }
+
+    // 解释器重启后丢弃等待中的请求和未处理的输出
+    void Reset();
+
+private:
+    void ProcessLine(std::string_view line, std::vector<ReplEvent>& events);
+    void AddOutput(std::string_view text, std::vector<ReplEvent>& events);
+
+    std::string m_marker;           // 哨兵中编号之前的部分
+    std::string m_partial;          // 尚未结束且可能包含哨兵的输出
+    std::deque<uint64_t> m_pending;
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <wx/wx.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include "ConsoleBuffer.h"
+#include "ReplFramer.h"
+
+class ProcessManager;
+
+// 常驻的解释器进程：代码片段经标准输入按 ReplFramer 的协议发送，
+// 每段的输出和完成都对应到它的请求编号，解释器状态在多次执行之间保留
+class ReplSession
+{
+public:
+    ReplSession();
+    ~ReplSession();
+
+    // 启动解释器，命令模板中只由 %lmfilepath% 组成的参数被去掉
+    bool Start(const wxString& commandTemplate, const wxString& workingDir);
+    void Stop();
+    bool IsRunning() const;
+
+    // 发送一段代码，返回请求编号，会话未运行时返回 0
+    uint64_t Execute(const wxString& code);
+
+    // 中断正在执行的代码，会话保留
+    bool Interrupt();
+
+    size_t GetPendingCount() const { return m_framer.GetPendingCount(); }
+
+    // 请求的输出；id 为 0 的输出不属于任何请求
+    void SetOutputCallback(std::function<void(uint64_t id, ConsoleStream stream, const wxString& text)> callback) { m_outputCallback = callback; }
+    // 请求执行完毕，milliseconds 从发送算起
+    void SetDoneCallback(std::function<void(uint64_t id, long milliseconds, bool interrupted)> callback) { m_doneCallback = callback; }
+    // 解释器进程结束，未完成的请求被丢弃
+    void SetEndedCallback(std::function<void(int exitCode)> callback) { m_endedCallback = callback; }
+
+private:
+    void OnOutput(const wxString& text);
+    void OnError(const wxString& text);
+    void OnFinished(int exitCode);
+    void FeedInput();
+    void UpdatePollInterval();
+
+    struct Request
+    {
+        wxLongLong start;
+        bool interrupted = false;
+    };
+
+    std::unique_ptr<ProcessManager> m_process;
+    ReplFramer m_framer;
+    uint64_t m_nextId;
+    std::map<uint64_t, Request> m_requests;
+    std::string m_pendingInput;     // 解释器的输入队列已满，尚未交出的数据
+
+    std::function<void(uint64_t, ConsoleStream, const wxString&)> m_outputCallback;
+    std::function<void(uint64_t, long, bool)> m_doneCallback;
+    std::function<void(int)> m_endedCallback;
+};
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <wx/wx.h>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "ConsoleBuffer.h"
+
+// 一次运行的输出记录
+struct CachedRun
+{
+    int exitCode = 0;
+    wxDateTime recorded;
+};
+
+// 脚本运行结果的磁盘缓存。键是脚本及其递归包含的文件的内容、解释器程序的内容、
+// 展开后的命令行与工作目录的哈希，任何一项变化都不会命中。
+// 每条记录是一个文件，按最近使用的顺序淘汰，总大小不超过上限；回放时映射到内存，不复制文件内容。
+// 只在主线程中使用
+class RunCache
+{
+public:
+    explicit RunCache(const wxString& dir = GetDefaultDir());
+
+    // 计算一次运行的键，脚本无法读取时返回 false
+    bool ComputeKey(const wxString& commandTemplate, const wxString& filePath, const wxString& workingDir, uint64_t& key);
+
+    // 命中时按原顺序把输出交给 sink，并返回退出码与记录时间
+    bool Replay(uint64_t key, const std::function<void(ConsoleStream, std::string_view)>& sink, CachedRun& run);
+
+    // 记录一次运行的输出，进程正常结束后 Commit 写入磁盘。
+    // 输出超过单条记录的上限时放弃记录
+    void BeginRecording(uint64_t key);
+    void Record(ConsoleStream stream, const wxString& text);
+    void Commit(int exitCode);
+    void CancelRecording();
+    bool IsRecording() const { return m_recording; }
+
+    // 总大小上限，超出时立即淘汰最久未使用的记录
+    void SetBudget(uint64_t bytes);
+
+    // 删除全部记录
+    void Clear();
+
+    size_t GetEntryCount() const { return m_entries.size(); }
+    uint64_t GetTotalSize() const { return m_totalSize; }
+
+    static wxString GetDefaultDir();
+
+private:
+    struct Entry
+    {
+        uint64_t size = 0;
+        std::list<uint64_t>::iterator use;      // 在 m_uses 中的位置
+    };
+
+    // 读取目录中已有的记录，按修改时间恢复使用顺序
+    void LoadEntries();
+    void Touch(uint64_t key);
+    void Remove(uint64_t key);
+    void Evict();
+
+    wxString GetEntryPath(uint64_t key) const;
+
+    // 解释器程序的内容哈希，按路径、大小和修改时间缓存
+    uint64_t HashProgram(const std::string& program);
+
+private:
+    wxString m_dir;
+    uint64_t m_budget;
+    uint64_t m_totalSize;
+    bool m_loaded;
+
+    std::unordered_map<uint64_t, Entry> m_entries;
+    std::list<uint64_t> m_uses;                 // 最近使用的在前
+
+    struct ProgramHash
+    {
+        wxULongLong size;
+        wxDateTime modified;
+        uint64_t hash = 0;
+    };
+    std::map<wxString, ProgramHash> m_programs;
+
+    // 正在记录的运行
+    bool m_recording;
+    uint64_t m_recordingKey;
+    std::string m_data;
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <wx/wx.h>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 单个文档的视图状态
+struct DocumentState
+{
+    wxString path;
+    int caretPos = 0;
+    int anchorPos = 0;
+    int firstVisibleLine = 0;
+    std::vector<int> foldedLines;   // 已折叠的折叠头所在行
+};
+
+// 会话快照：工作集中的文档、当前文档与主题
+struct SessionSnapshot
+{
+    wxString theme;
+    int activeIndex = -1;
+    std::vector<DocumentState> documents;
+};
+
+// 紧凑二进制会话文件，由后台线程合并写入
+class SessionStore
+{
+public:
+    SessionStore();
+    ~SessionStore();
+
+    // 会话最多保留的文件数，超出的文件无法在菜单中分配命令标识
+    static const size_t MAX_DOCUMENTS = 100;
+
+    // 读取上次保存的会话
+    bool Load(SessionSnapshot& snapshot) const;
+
+    // 提交最新快照，不阻塞调用者；连续提交只写入最后一次
+    void Submit(const SessionSnapshot& snapshot);
+
+    // 等待已提交的快照写入磁盘
+    void Flush();
+
+    static wxString GetSessionPath();
+
+private:
+    void WriterLoop();
+    bool WriteFile(const std::string& data) const;
+
+    static void Encode(const SessionSnapshot& snapshot, std::string& data);
+    static bool Decode(const std::string& data, SessionSnapshot& snapshot);
+
+private:
+    wxString m_path;
+    std::thread m_writer;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::string m_pending;      // 待写入的编码数据
+    std::string m_written;      // 最近一次写入的数据，内容未变时跳过写入
+    bool m_hasPending;
+    bool m_writing;
+    bool m_stop;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 启动过程中各阶段的耗时记录。时间从进程的静态初始化算起，
+// 后台线程中的阶段与主线程的阶段并行，分别标出
+class StartupTimeline
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // 第一次调用必须在主线程中、启动任何后台线程之前
+    static StartupTimeline& Get();
+
+    // 记录一个已完成的阶段，可在任意线程中调用
+    void Record(const char* stage, Clock::time_point start, Clock::time_point end);
+
+    // 主窗口第一次绘制完成并开始处理事件
+    void MarkFirstFrame();
+
+    // 延后的阶段全部完成
+    void MarkReady();
+
+    // 距进程开始的毫秒数，尚未到达时为负数
+    double GetFirstFrameMs() const;
+    double GetReadyMs() const;
+
+    // 每个阶段一行：开始时间、耗时、所在线程
+    std::string Format() const;
+
+private:
+    StartupTimeline();
+
+    double ToMs(Clock::time_point time) const;
+
+private:
+    struct Stage
+    {
+        std::string name;
+        Clock::time_point start;
+        Clock::time_point end;
+        bool background;
+    };
+
+    std::thread::id m_mainThread;
+    mutable std::mutex m_mutex;
+    std::vector<Stage> m_stages;
+    Clock::time_point m_firstFrame;
+    Clock::time_point m_ready;
+
+    static StartupTimeline* s_instance;
+};
+
+// 在作用域结束时把从构造到析构的时间记为一个阶段
+class StartupStage
+{
+public:
+    explicit StartupStage(const char* stage)
+        : m_stage(stage)
+        , m_start(StartupTimeline::Clock::now())
+    {
+    }
+
+    ~StartupStage()
+    {
+        StartupTimeline::Get().Record(m_stage, m_start, StartupTimeline::Clock::now());
+    }
+
+    StartupStage(const StartupStage&) = delete;
+    StartupStage& operator=(const StartupStage&) = delete;
+
+private:
+    const char* m_stage;
+    StartupTimeline::Clock::time_point m_start;
+};
@@ -5,16 +5,31 @@
 #include <wx/stdpaths.h>
 #include <wx/filename.h>
 #include <map>
+#include <atomic>
 #include <string>
+#include <thread>
 
 class ThemeConfig
 {
 public:
     static ThemeConfig& Get();
 
+    // 在后台线程中读取并解析主题文件；之后的 Get() 在解析完成前等待
+    static void Preload();
+    
+    // 等待预加载线程结束，在 wx 清理之前调用
+    static void WaitForPreload();
+
+    // 主题文件已经解析完成，Get() 不会等待
+    static bool IsLoaded();
+
     bool LoadTheme(const wxString& themeName = wxEmptyString);
     bool SaveTheme();
     
+    // 重新读取主题文件（被外部修改后），文件无法解析时保留原来的配置
+    bool Reload();
+    const wxString& GetConfigPath() const { return m_configPath; }
+    
     wxColour GetColor(const wxString& category, const wxString& element = wxEmptyString) const;
     bool IsBold(const wxString& category, const wxString& element = wxEmptyString) const;
     bool IsItalic(const wxString& category, const wxString& element = wxEmptyString) const;
@@ -26,8 +41,11 @@ private:
     ThemeConfig();
     ~ThemeConfig();
 
+    static void Load();
+
     bool LoadConfigFile();
-    bool ParseThemeConfig(wxXmlNode* root);
+    // 读取当前主题与主题列表，不修改成员；没有可用的主题时返回 false
+    bool ParseThemeConfig(wxXmlNode* root, wxString& currentTheme, wxArrayString& themes) const;
     wxColour ParseColor(const wxString& colorStr) const;
     bool GetNodeValueBool(wxXmlNode* node, const wxString& childName, bool defaultValue = false) const;
     wxString GetNodeValueStr(wxXmlNode* node, const wxString& childName, const wxString& defaultValue = wxEmptyString) const;
@@ -41,4 +59,6 @@ private:
     wxXmlDocument m_config;
     
     static ThemeConfig* s_instance;
+    static std::atomic<bool> s_loaded;
+    static std::thread s_preloadThread;
 };
\ No newline at end of file
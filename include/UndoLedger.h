@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+
+// 撤销历史的内存账本：按撤销组记录编辑器撤销缓冲区占用的字节数（估算），
+// 跟随撤销、重做移动当前位置，用于判断何时需要压缩撤销历史
+class UndoLedger
+{
+public:
+    // 新的撤销组，丢弃可以重做的组
+    void BeginGroup();
+
+    // 当前组增加一步插入或删除，length 为文本字节数
+    void AddStep(size_t length);
+
+    void Undo();
+    void Redo();
+    void Reset();
+
+    size_t GetUndoCount() const { return m_current; }
+    size_t GetRedoCount() const { return m_groups.size() - m_current; }
+
+    // 可以撤销的组占用的字节数；GetTotalBytes 还包括可以重做的组
+    size_t GetUndoBytes() const { return m_undoBytes; }
+    size_t GetTotalBytes() const { return m_totalBytes; }
+
+    // 压缩到 budget 以内时保留最新的几个可撤销组：总大小不超过 budget 的一半，
+    // 留出余量避免每次编辑都重新压缩；最新的一组本身不超过 budget 时至少保留它
+    size_t GroupsToKeep(size_t budget) const;
+
+private:
+    std::deque<size_t> m_groups;    // 每个组的字节数，从旧到新
+    size_t m_current = 0;           // [0, m_current) 可以撤销，其余可以重做
+    size_t m_undoBytes = 0;
+    size_t m_totalBytes = 0;
+};
@@ -0,0 +1,214 @@
+#include "BatchPanel.h"
+#include "LanguageManager.h"
+#include <wx/filename.h>
+#include <algorithm>
+
+enum
+{
+    COLUMN_SCRIPT = 0,
+    COLUMN_RESULT,
+    COLUMN_EXIT_CODE,
+    COLUMN_TIME
+};
+
+static const MessageId COLUMN_LABELS[] = {
+    MSG_BATCH_COLUMN_SCRIPT,
+    MSG_BATCH_COLUMN_RESULT,
+    MSG_BATCH_COLUMN_EXIT_CODE,
+    MSG_BATCH_COLUMN_TIME
+};
+
+wxBEGIN_EVENT_TABLE(BatchPanel, wxPanel)
+    EVT_LIST_COL_CLICK(wxID_ANY, BatchPanel::OnColumnClick)
+    EVT_LIST_ITEM_SELECTED(wxID_ANY, BatchPanel::OnItemSelected)
+wxEND_EVENT_TABLE()
+
+BatchPanel::BatchPanel(wxWindow* parent, wxWindowID id)
+    : wxPanel(parent, id)
+    , m_passed(0)
+    , m_sortColumn(COLUMN_SCRIPT)
+    , m_sortAscending(true)
+{
+    m_list = new wxListCtrl(this, wxID_ANY, wxDefaultPosition, wxDefaultSize,
+                            wxLC_REPORT | wxLC_SINGLE_SEL);
+    m_list->AppendColumn(Tr(COLUMN_LABELS[COLUMN_SCRIPT]), wxLIST_FORMAT_LEFT, 300);
+    m_list->AppendColumn(Tr(COLUMN_LABELS[COLUMN_RESULT]), wxLIST_FORMAT_LEFT, 80);
+    m_list->AppendColumn(Tr(COLUMN_LABELS[COLUMN_EXIT_CODE]), wxLIST_FORMAT_RIGHT, 80);
+    m_list->AppendColumn(Tr(COLUMN_LABELS[COLUMN_TIME]), wxLIST_FORMAT_RIGHT, 90);
+
+    // 选中脚本的输出
+    m_details = new wxTextCtrl(this, wxID_ANY, "", wxDefaultPosition, wxDefaultSize,
+                               wxTE_MULTILINE | wxTE_READONLY | wxTE_RICH2);
+    m_details->SetFont(wxFont(10, wxFONTFAMILY_TELETYPE, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+
+    wxBoxSizer* sizer = new wxBoxSizer(wxHORIZONTAL);
+    sizer->Add(m_list, 1, wxEXPAND);
+    sizer->Add(m_details, 1, wxEXPAND | wxLEFT, 2);
+    SetSizer(sizer);
+
+    // 工作线程中的回调转到主线程处理
+    m_runner.SetResultCallback([this](const BatchResult& result) {
+        CallAfter([this, result]() { AddResult(result); });
+    });
+    m_runner.SetFinishedCallback([this]() {
+        CallAfter(&BatchPanel::OnFinished);
+    });
+}
+
+BatchPanel::~BatchPanel()
+{
+    m_runner.Cancel();
+}
+
+bool BatchPanel::RunDirectory(const wxString& directory, const wxString& commandTemplate, int jobs)
+{
+    if (m_runner.IsRunning())
+        return false;
+
+    m_list->DeleteAllItems();
+    m_details->Clear();
+    m_results.clear();
+    m_passed = 0;
+    m_directory = directory;
+    m_startTime = wxGetLocalTimeMillis();
+
+    if (!m_runner.Start(directory, commandTemplate, jobs))
+        return false;
+
+    UpdateSummary();
+    return true;
+}
+
+void BatchPanel::Cancel()
+{
+    m_runner.Cancel();
+}
+
+void BatchPanel::UpdateLabels()
+{
+    for (int column = 0; column < m_list->GetColumnCount(); ++column)
+    {
+        wxListItem item;
+        item.SetMask(wxLIST_MASK_TEXT);
+        item.SetText(Tr(COLUMN_LABELS[column]));
+        m_list->SetColumn(column, item);
+    }
+    RefreshList();
+    UpdateSummary();
+}
+
+void BatchPanel::AddResult(const BatchResult& result)
+{
+    // 按当前排序插入，避免整表刷新
+    auto pos = std::upper_bound(m_results.begin(), m_results.end(), result,
+        [this](const BatchResult& a, const BatchResult& b) { return CompareResults(a, b); });
+    size_t index = pos - m_results.begin();
+    m_results.insert(pos, result);
+
+    if (result.passed)
+        ++m_passed;
+
+    InsertRow(index);
+    UpdateSummary();
+}
+
+void BatchPanel::OnFinished()
+{
+    UpdateSummary();
+}
+
+bool BatchPanel::CompareResults(const BatchResult& a, const BatchResult& b) const
+{
+    int order = 0;
+    switch (m_sortColumn)
+    {
+    case COLUMN_RESULT:
+        order = (int)a.passed - (int)b.passed;
+        break;
+    case COLUMN_EXIT_CODE:
+        order = a.exitCode < b.exitCode ? -1 : (a.exitCode > b.exitCode ? 1 : 0);
+        break;
+    case COLUMN_TIME:
+        order = a.seconds < b.seconds ? -1 : (a.seconds > b.seconds ? 1 : 0);
+        break;
+    default:
+        order = a.script.Cmp(b.script);
+        break;
+    }
+    return m_sortAscending ? order < 0 : order > 0;
+}
+
+void BatchPanel::InsertRow(size_t index)
+{
+    const BatchResult& result = m_results[index];
+
+    wxFileName name(result.script);
+    name.MakeRelativeTo(m_directory);
+
+    MessageId status = result.passed ? MSG_BATCH_PASS : MSG_BATCH_FAIL;
+    if (result.exitCode == 0 && result.hasExpected && !result.passed)
+        status = MSG_BATCH_MISMATCH;
+
+    long item = m_list->InsertItem(index, name.GetFullPath());
+    m_list->SetItem(item, COLUMN_RESULT, Tr(status));
+    m_list->SetItem(item, COLUMN_EXIT_CODE, wxString::Format("%d", result.exitCode));
+    m_list->SetItem(item, COLUMN_TIME, wxString::Format("%.3f", result.seconds));
+    if (!result.passed)
+        m_list->SetItemTextColour(item, wxColour(200, 0, 0));
+}
+
+void BatchPanel::RefreshList()
+{
+    m_list->Freeze();
+    m_list->DeleteAllItems();
+    for (size_t i = 0; i < m_results.size(); ++i)
+        InsertRow(i);
+    m_list->Thaw();
+}
+
+void BatchPanel::UpdateSummary()
+{
+    if (!m_statusCallback)
+        return;
+
+    double elapsed = (wxGetLocalTimeMillis() - m_startTime).ToDouble() / 1000.0;
+    m_statusCallback(wxString::Format(Tr(m_runner.IsRunning() ? MSG_BATCH_RUNNING : MSG_BATCH_FINISHED),
+        m_results.size(), m_runner.GetScriptCount(),
+        m_passed, m_results.size() - m_passed, elapsed));
+}
+
+void BatchPanel::OnColumnClick(wxListEvent& event)
+{
+    int column = event.GetColumn();
+    if (column < 0)
+        return;
+
+    if (column == m_sortColumn)
+        m_sortAscending = !m_sortAscending;
+    else
+    {
+        m_sortColumn = column;
+        m_sortAscending = true;
+    }
+
+    std::stable_sort(m_results.begin(), m_results.end(),
+        [this](const BatchResult& a, const BatchResult& b) { return CompareResults(a, b); });
+    RefreshList();
+}
+
+void BatchPanel::OnItemSelected(wxListEvent& event)
+{
+    long index = event.GetIndex();
+    if (index < 0 || index >= (long)m_results.size())
+        return;
+
+    const BatchResult& result = m_results[index];
+    m_details->Clear();
+    m_details->SetDefaultStyle(wxTextAttr(*wxBLACK));
+    m_details->AppendText(result.output);
+    if (!result.errors.IsEmpty())
+    {
+        m_details->SetDefaultStyle(wxTextAttr(wxColour(200, 0, 0)));
+        m_details->AppendText(result.errors);
+    }
+}
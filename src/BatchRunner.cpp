@@ -0,0 +1,232 @@
+#include "BatchRunner.h"
+#include "FileUtils.h"
+#include "ProcessLauncher.h"
+#include <wx/dir.h>
+#include <wx/file.h>
+#include <wx/filename.h>
+#include <wx/textfile.h>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+// 历史耗时文件，保存在被运行的目录中
+static const char* HISTORY_FILE_NAME = ".lmbatch_history";
+
+static wxString MakeHistoryKey(const wxString& directory, const wxString& script)
+{
+    wxFileName name(script);
+    name.MakeRelativeTo(directory);
+    return name.GetFullPath(wxPATH_UNIX);
+}
+
+static std::string ToUtf8(const wxString& text)
+{
+    wxScopedCharBuffer buffer = text.utf8_str();
+    return std::string(buffer.data(), buffer.length());
+}
+
+// 输出按 UTF-8 解码，不是合法的 UTF-8 时按字节解码
+static wxString DecodeOutput(const std::string& data)
+{
+    wxString text = wxString::FromUTF8(data.data(), data.size());
+    if (text.IsEmpty() && !data.empty())
+        text = wxString::From8BitData(data.data(), data.size());
+    return text;
+}
+
+// 按字节比较，忽略 \r\n 与 \n 的差异和末尾的换行
+static std::string NormalizeOutput(const std::string& data)
+{
+    std::string text;
+    text.reserve(data.size());
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        if (data[i] == '\r' && i + 1 < data.size() && data[i + 1] == '\n')
+            continue;
+        text += data[i];
+    }
+    while (!text.empty() && text.back() == '\n')
+        text.pop_back();
+    return text;
+}
+
+BatchRunner::BatchRunner()
+    : m_nextScript(0)
+    , m_activeWorkers(0)
+    , m_cancelled(false)
+    , m_running(false)
+{
+}
+
+BatchRunner::~BatchRunner()
+{
+    Cancel();
+    Wait();
+}
+
+wxArrayString BatchRunner::CollectScripts(const wxString& directory)
+{
+    wxArrayString scripts;
+    if (wxDirExists(directory))
+        wxDir::GetAllFiles(directory, &scripts, "*.lm", wxDIR_FILES | wxDIR_DIRS);
+    scripts.Sort();
+    return scripts;
+}
+
+bool BatchRunner::Start(const wxString& directory, const wxString& commandTemplate, int jobs)
+{
+    if (m_running)
+        return false;
+
+    // 回收上一轮的工作线程
+    Wait();
+
+    wxArrayString scripts = CollectScripts(directory);
+    if (scripts.IsEmpty())
+        return false;
+
+    m_directory = directory;
+    m_commandTemplate = commandTemplate;
+    m_scripts.assign(scripts.begin(), scripts.end());
+
+    // 最长历史耗时优先调度以缩短总耗时，没有历史记录的脚本视为最长
+    LoadHistory();
+    auto estimate = [this](const wxString& script) {
+        auto it = m_history.find(MakeHistoryKey(m_directory, script));
+        return it != m_history.end() ? it->second : std::numeric_limits<double>::max();
+    };
+    std::stable_sort(m_scripts.begin(), m_scripts.end(),
+        [&estimate](const wxString& a, const wxString& b) { return estimate(a) > estimate(b); });
+
+    if (jobs <= 0)
+        jobs = wxThread::GetCPUCount();
+    if (jobs <= 0)
+        jobs = 1;
+    jobs = std::min<int>(jobs, m_scripts.size());
+
+    m_nextScript = 0;
+    m_activeWorkers = jobs;
+    m_cancelled = false;
+    m_running = true;
+
+    for (int i = 0; i < jobs; ++i)
+        m_workers.emplace_back(&BatchRunner::WorkerLoop, this);
+
+    return true;
+}
+
+void BatchRunner::Cancel()
+{
+    m_cancelled = true;
+}
+
+void BatchRunner::Wait()
+{
+    for (std::thread& worker : m_workers)
+    {
+        if (worker.joinable())
+            worker.join();
+    }
+    m_workers.clear();
+}
+
+void BatchRunner::WorkerLoop()
+{
+    while (!m_cancelled)
+    {
+        size_t index = m_nextScript++;
+        if (index >= m_scripts.size())
+            break;
+
+        BatchResult result = RunScript(m_scripts[index]);
+        {
+            std::lock_guard<std::mutex> lock(m_historyMutex);
+            m_history[MakeHistoryKey(m_directory, result.script)] = result.seconds;
+        }
+
+        if (m_resultCallback)
+            m_resultCallback(result);
+    }
+
+    // 最后一个结束的线程负责收尾
+    if (--m_activeWorkers == 0)
+    {
+        SaveHistory();
+        m_running = false;
+
+        if (m_finishedCallback)
+            m_finishedCallback();
+    }
+}
+
+BatchResult BatchRunner::RunScript(const wxString& script) const
+{
+    BatchResult result;
+    result.script = script;
+
+    // 命令先拆分为参数再替换路径，路径中的引号、$ 和反斜杠原样传给解释器。
+    // 工作线程中不能调用 wxExecute；每个脚本在自己的目录中运行，不修改 IDE 的工作目录
+    std::vector<std::string> args = ProcessLauncher::ExpandCommand(ToUtf8(m_commandTemplate), ToUtf8(script));
+    ProcessOutput output;
+    int errorCode = 0;
+    auto start = std::chrono::steady_clock::now();
+    bool started = ProcessLauncher::Run(args, ToUtf8(wxFileName(script).GetPath()), output, errorCode);
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.exitCode = output.exitCode;
+
+    result.output = DecodeOutput(output.output);
+    if (started)
+        result.errors = DecodeOutput(output.errors);
+    else
+        result.errors = wxString::Format("Cannot start %s: %s\n",
+            args.empty() ? wxString() : wxString::FromUTF8(args[0]), wxSysErrorMsgStr(errorCode));
+
+    // 与同名的 .expected 文件比较
+    wxFileName expectedName(script);
+    expectedName.SetExt("expected");
+    bool matches = true;
+    if (expectedName.FileExists())
+    {
+        std::string expected;
+        result.hasExpected = FileUtils::ReadBytes(expectedName.GetFullPath(), expected);
+        matches = result.hasExpected && NormalizeOutput(expected) == NormalizeOutput(output.output);
+    }
+
+    result.passed = result.exitCode == 0 && matches;
+    return result;
+}
+
+void BatchRunner::LoadHistory()
+{
+    std::lock_guard<std::mutex> lock(m_historyMutex);
+    m_history.clear();
+
+    wxFileName historyName(m_directory, HISTORY_FILE_NAME);
+    wxTextFile file;
+    if (!historyName.FileExists() || !file.Open(historyName.GetFullPath()))
+        return;
+
+    // 每行格式：毫秒数<Tab>相对路径
+    for (size_t i = 0; i < file.GetLineCount(); ++i)
+    {
+        const wxString& line = file[i];
+        long milliseconds;
+        wxString name = line.AfterFirst('\t');
+        if (!name.IsEmpty() && line.BeforeFirst('\t').ToLong(&milliseconds))
+            m_history[name] = milliseconds / 1000.0;
+    }
+}
+
+void BatchRunner::SaveHistory()
+{
+    wxString content;
+    {
+        std::lock_guard<std::mutex> lock(m_historyMutex);
+        for (const auto& entry : m_history)
+            content += wxString::Format("%ld\t%s\n", static_cast<long>(entry.second * 1000), entry.first);
+    }
+
+    wxFile file(wxFileName(m_directory, HISTORY_FILE_NAME).GetFullPath(), wxFile::write);
+    if (file.IsOpened())
+        file.Write(content);
+}
@@ -0,0 +1,102 @@
+#include "BulkEdit.h"
+#include <algorithm>
+#include <functional>
+
+static unsigned char ToLowerAscii(unsigned char ch)
+{
+    return (ch >= 'A' && ch <= 'Z') ? ch + ('a' - 'A') : ch;
+}
+
+static bool IsWordChar(unsigned char ch)
+{
+    // 与 LaminaLexer 的标识符规则一致，非 ASCII 字节视为标识符的一部分
+    return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') || ch == '_' || ch >= 0x80;
+}
+
+static bool IsWholeWord(std::string_view text, size_t start, size_t length)
+{
+    return (start == 0 || !IsWordChar(text[start - 1])) &&
+           (start + length >= text.size() || !IsWordChar(text[start + length]));
+}
+
+std::vector<TextEdit> BulkEdit::FindReplace(std::string_view text, std::string_view find, std::string_view replacement,
+                                            bool matchCase, bool wholeWord)
+{
+    std::vector<TextEdit> edits;
+    if (find.empty())
+        return edits;
+
+    auto addMatch = [&](size_t start) {
+        if (!wholeWord || IsWholeWord(text, start, find.size()))
+            edits.push_back(TextEdit{ start, find.size(), std::string(replacement) });
+    };
+
+    if (matchCase)
+    {
+        // string_view::find 基于 memchr，大文件中也足够快
+        for (size_t pos = text.find(find); pos != std::string_view::npos; pos = text.find(find, pos + find.size()))
+            addMatch(pos);
+    }
+    else
+    {
+        // 仅对 ASCII 忽略大小写；哈希与比较规则保持一致
+        auto hash = [](char ch) { return std::hash<unsigned char>()(ToLowerAscii(ch)); };
+        auto equal = [](char a, char b) { return ToLowerAscii(a) == ToLowerAscii(b); };
+        std::boyer_moore_horspool_searcher searcher(find.begin(), find.end(), hash, equal);
+
+        auto it = text.begin();
+        for (;;)
+        {
+            auto match = searcher(it, text.end());
+            if (match.first == text.end())
+                break;
+            addMatch(match.first - text.begin());
+            it = match.second;
+        }
+    }
+
+    return edits;
+}
+
+std::string BulkEdit::Apply(std::string_view text, const std::vector<TextEdit>& edits, size_t begin, size_t end)
+{
+    end = std::min(end, text.size());
+
+    size_t size = end - begin;
+    for (const TextEdit& edit : edits)
+        size += edit.text.size() - edit.length;
+
+    std::string result;
+    result.reserve(size);
+
+    size_t cursor = begin;
+    for (const TextEdit& edit : edits)
+    {
+        result.append(text.data() + cursor, edit.start - cursor);
+        result.append(edit.text);
+        cursor = edit.start + edit.length;
+    }
+    result.append(text.data() + cursor, end - cursor);
+
+    return result;
+}
+
+size_t BulkEdit::MapPosition(const std::vector<TextEdit>& edits, size_t position)
+{
+    // 二分查找最后一个起始位置不超过 position 的编辑
+    auto it = std::upper_bound(edits.begin(), edits.end(), position,
+                               [](size_t pos, const TextEdit& edit) { return pos < edit.start; });
+
+    long long delta = 0;
+    for (auto edit = edits.begin(); edit != it; ++edit)
+        delta += (long long)edit->text.size() - (long long)edit->length;
+
+    if (it != edits.begin())
+    {
+        const TextEdit& last = *(it - 1);
+        if (position < last.start + last.length)
+            return last.start + (delta - ((long long)last.text.size() - (long long)last.length)) + last.text.size();
+    }
+
+    return position + delta;
+}
@@ -0,0 +1,369 @@
+#include "ChangeGutter.h"
+#include "LaminaEditor.h"
+#include "FileUtils.h"
+#include "ProcessLauncher.h"
+#include <wx/filename.h>
+#include <algorithm>
+
+// 标记编号，避开折叠标记（25-31）
+static const int MARKER_ADDED = 20;
+static const int MARKER_MODIFIED = 21;
+static const int MARKER_DELETED = 22;
+static const int MARKER_MASK = (1 << MARKER_ADDED) | (1 << MARKER_MODIFIED) | (1 << MARKER_DELETED);
+
+static const int GUTTER_WIDTH = 6;
+
+// 停止输入后再比较，连续输入只计算一次
+static const int DIFF_DELAY_MS = 300;
+
+// 基准版本的全文与每行的起始位置（最后附加全文长度）
+struct GutterBaseline
+{
+    std::string text;
+    std::vector<size_t> lineStarts;
+};
+
+ChangeGutter::ChangeGutter(LaminaEditor* editor, int margin)
+    : m_editor(editor)
+    , m_diffTimer(this)
+    , m_generation(0)
+    , m_baselinePending(false)
+    , m_dirty(false)
+    , m_dirtyFirst(0)
+    , m_dirtyEnd(0)
+    , m_dirtyDelta(0)
+    , m_running(false)
+    , m_jobFirst(0)
+    , m_jobPreviousEnd(0)
+    , m_jobDelta(0)
+    , m_jobFirstHunk(0)
+    , m_jobEndHunk(0)
+{
+    m_editor->SetMarginType(margin, wxSTC_MARGIN_SYMBOL);
+    m_editor->SetMarginMask(margin, MARKER_MASK);
+    m_editor->SetMarginWidth(margin, GUTTER_WIDTH);
+    m_editor->SetMarginSensitive(margin, false);
+
+    m_editor->MarkerDefine(MARKER_ADDED, wxSTC_MARK_LEFTRECT, wxColour(80, 170, 80), wxColour(80, 170, 80));
+    m_editor->MarkerDefine(MARKER_MODIFIED, wxSTC_MARK_LEFTRECT, wxColour(60, 130, 210), wxColour(60, 130, 210));
+    m_editor->MarkerDefine(MARKER_DELETED, wxSTC_MARK_SHORTARROW, wxColour(210, 60, 60), wxColour(210, 60, 60));
+
+    m_editor->Bind(wxEVT_STC_MODIFIED, &ChangeGutter::OnEditorModified, this);
+    Bind(wxEVT_TIMER, &ChangeGutter::OnDiffTimer, this);
+}
+
+ChangeGutter::~ChangeGutter()
+{
+    m_editor->Unbind(wxEVT_STC_MODIFIED, &ChangeGutter::OnEditorModified, this);
+
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+void ChangeGutter::ResetBaseline()
+{
+    ++m_generation;
+    m_baseline.reset();
+    m_hunks.clear();
+    m_dirty = false;
+    m_diffTimer.Stop();
+
+    m_editor->MarkerDeleteAll(MARKER_ADDED);
+    m_editor->MarkerDeleteAll(MARKER_MODIFIED);
+    m_editor->MarkerDeleteAll(MARKER_DELETED);
+
+    // 未命名文档没有基准版本
+    m_baselinePending = !m_editor->GetCurrentFile().IsEmpty();
+    StartNextJob();
+}
+
+void ChangeGutter::OnEditorModified(wxStyledTextEvent& event)
+{
+    int type = event.GetModificationType();
+    if (type & (wxSTC_MOD_INSERTTEXT | wxSTC_MOD_DELETETEXT))
+    {
+        size_t line = m_editor->LineFromPosition(event.GetPosition());
+        long added = event.GetLinesAdded();
+
+        // 删除的行在编辑前为 [line, line + 1 - added)
+        MarkDirty(line, line + 1 + (added < 0 ? -added : 0), added);
+
+        if (m_baseline)
+            m_diffTimer.Start(DIFF_DELAY_MS, wxTIMER_ONE_SHOT);
+    }
+
+    event.Skip();
+}
+
+void ChangeGutter::MarkDirty(size_t firstLine, size_t endLine, long lineDelta)
+{
+    if (!m_dirty)
+    {
+        m_dirty = true;
+        m_dirtyFirst = firstLine;
+        m_dirtyEnd = endLine;
+        m_dirtyDelta = 0;
+    }
+    else
+    {
+        m_dirtyFirst = std::min(m_dirtyFirst, firstLine);
+        m_dirtyEnd = std::max(m_dirtyEnd, endLine);
+    }
+
+    m_dirtyEnd = (size_t)((long)m_dirtyEnd + lineDelta);
+    m_dirtyDelta += lineDelta;
+}
+
+void ChangeGutter::OnDiffTimer(wxTimerEvent& event)
+{
+    StartNextJob();
+}
+
+void ChangeGutter::StartNextJob()
+{
+    if (m_running)
+        return;
+
+    if (m_baselinePending)
+        StartBaselineJob();
+    else if (m_baseline && m_dirty)
+        StartDiffJob();
+}
+
+void ChangeGutter::StartBaselineJob()
+{
+    if (m_thread.joinable())
+        m_thread.join();
+
+    wxString path = m_editor->GetCurrentFile();
+    int eolMode = m_editor->GetEOLMode();
+    std::string eol = eolMode == wxSTC_EOL_CRLF ? "\r\n" : (eolMode == wxSTC_EOL_CR ? "\r" : "\n");
+    unsigned generation = m_generation;
+
+    m_baselinePending = false;
+    m_running = true;
+    m_thread = std::thread([this, path, eol, generation]() {
+        std::shared_ptr<const GutterBaseline> baseline = LoadBaseline(path, eol);
+        CallAfter([this, generation, baseline]() { FinishBaselineJob(generation, baseline); });
+    });
+}
+
+std::shared_ptr<const GutterBaseline> ChangeGutter::LoadBaseline(const wxString& path, const std::string& eol)
+{
+    auto baseline = std::make_shared<GutterBaseline>();
+    std::string& text = baseline->text;
+
+    // 文件在 git 仓库中时以 HEAD 中的版本为基准，通过本地的 git 读取。
+    // 后台线程中不能调用 wxExecute；未安装 git 或文件不在仓库中时退回到磁盘上的内容
+    wxFileName name(path);
+    wxScopedCharBuffer directory = name.GetPath().utf8_str();
+    wxScopedCharBuffer fileName = name.GetFullName().utf8_str();
+    std::vector<std::string> args = { "git", "show", "HEAD:./" + std::string(fileName.data(), fileName.length()) };
+    ProcessOutput output;
+    int errorCode = 0;
+    bool fromGit = ProcessLauncher::Run(args, std::string(directory.data(), directory.length()), output, errorCode) &&
+                   output.exitCode == 0;
+
+    if (fromGit)
+    {
+        // 保持原始字节，最后一行没有换行符时同样没有；
+        // 只有编辑器的换行符不是 \n 时（工作区的换行符被 git 转换过）才转换单独的 \n
+        const std::string& blob = output.output;
+        if (eol == "\n")
+        {
+            text = blob;
+        }
+        else
+        {
+            text.reserve(blob.size());
+            for (size_t i = 0; i < blob.size(); ++i)
+            {
+                if (blob[i] == '\n' && (i == 0 || blob[i - 1] != '\r'))
+                    text.append(eol);
+                else
+                    text += blob[i];
+            }
+        }
+    }
+    else if (!FileUtils::ReadBytes(path, text))
+    {
+        return nullptr;
+    }
+
+    // UTF-8 BOM 在载入时被去掉
+    if (text.compare(0, 3, "\xEF\xBB\xBF") == 0)
+        text.erase(0, 3);
+
+    // 与编辑器的行号一致：最后一个换行符之后还有一行
+    baseline->lineStarts.push_back(0);
+    for (size_t pos = text.find('\n'); pos != std::string::npos; pos = text.find('\n', pos + 1))
+        baseline->lineStarts.push_back(pos + 1);
+    baseline->lineStarts.push_back(text.size());
+
+    return baseline;
+}
+
+void ChangeGutter::FinishBaselineJob(unsigned generation, std::shared_ptr<const GutterBaseline> baseline)
+{
+    m_running = false;
+    if (m_thread.joinable())
+        m_thread.join();
+
+    if (generation == m_generation && baseline)
+    {
+        m_baseline = baseline;
+        m_hunks.clear();
+
+        // 首次比较整个文档：没有差异时文档的每一行都对应基准版本的同一行
+        size_t lineCount = m_editor->GetLineCount();
+        m_dirty = true;
+        m_dirtyFirst = 0;
+        m_dirtyEnd = lineCount;
+        m_dirtyDelta = (long)lineCount - (long)(m_baseline->lineStarts.size() - 1);
+    }
+
+    StartNextJob();
+}
+
+void ChangeGutter::StartDiffJob()
+{
+    if (m_thread.joinable())
+        m_thread.join();
+
+    size_t lineCount = m_editor->GetLineCount();
+    size_t baselineLines = m_baseline->lineStarts.size() - 1;
+
+    // 待比较区域在上次比较时的范围
+    size_t first = m_dirtyFirst;
+    size_t previousEnd = std::min((size_t)((long)m_dirtyEnd - m_dirtyDelta), (size_t)((long)lineCount - m_dirtyDelta));
+
+    // 区域的边界扩展到相同的行上，之前的差异中与区域相交或相邻的部分一起重新计算
+    auto firstHunk = std::lower_bound(m_hunks.begin(), m_hunks.end(), first, [](const LineHunk& hunk, size_t line) {
+        return hunk.newLine + hunk.newCount < line;
+    });
+
+    long before = 0;
+    for (auto it = m_hunks.begin(); it != firstHunk; ++it)
+        before += (long)it->newCount - (long)it->oldCount;
+
+    long inside = 0;
+    auto endHunk = firstHunk;
+    for (; endHunk != m_hunks.end() && endHunk->newLine <= previousEnd; ++endHunk)
+    {
+        first = std::min(first, endHunk->newLine);
+        previousEnd = std::max(previousEnd, endHunk->newLine + endHunk->newCount);
+        inside += (long)endHunk->newCount - (long)endHunk->oldCount;
+    }
+
+    // 区域之外的行与基准版本一一对应
+    size_t baselineFirst = std::min((size_t)((long)first - before), baselineLines);
+    size_t baselineEnd = std::min((size_t)((long)previousEnd - before - inside), baselineLines);
+    baselineEnd = std::max(baselineEnd, baselineFirst);
+    size_t currentEnd = std::min((size_t)((long)previousEnd + m_dirtyDelta), lineCount);
+
+    // 只复制区域内的文本，与文档大小无关
+    int startPos = first >= lineCount ? m_editor->GetTextLength() : m_editor->PositionFromLine(first);
+    int endPos = currentEnd >= lineCount ? m_editor->GetTextLength() : m_editor->PositionFromLine(currentEnd);
+    wxCharBuffer range = m_editor->GetTextRangeRaw(startPos, endPos);
+    std::string current(range.data(), endPos - startPos);
+
+    m_jobFirst = first;
+    m_jobPreviousEnd = previousEnd;
+    m_jobDelta = m_dirtyDelta;
+    m_jobFirstHunk = firstHunk - m_hunks.begin();
+    m_jobEndHunk = endHunk - m_hunks.begin();
+    m_dirty = false;
+    m_running = true;
+
+    std::shared_ptr<const GutterBaseline> baseline = m_baseline;
+    unsigned generation = m_generation;
+    m_thread = std::thread([this, baseline, baselineFirst, baselineEnd, first, current = std::move(current), generation]() {
+        size_t begin = baseline->lineStarts[baselineFirst];
+        std::string_view previous(baseline->text.data() + begin, baseline->lineStarts[baselineEnd] - begin);
+
+        std::vector<LineHunk> hunks = LineDiff::ComputeHunks(previous, current);
+        for (LineHunk& hunk : hunks)
+        {
+            hunk.oldLine += baselineFirst;
+            hunk.newLine += first;
+        }
+
+        CallAfter([this, generation, hunks]() { FinishDiffJob(generation, hunks); });
+    });
+}
+
+void ChangeGutter::FinishDiffJob(unsigned generation, std::vector<LineHunk> hunks)
+{
+    m_running = false;
+    if (m_thread.joinable())
+        m_thread.join();
+
+    if (generation != m_generation)
+    {
+        StartNextJob();
+        return;
+    }
+
+    // 替换区域内的差异，之后的差异按区域增加的行数移动
+    std::vector<LineHunk> merged(m_hunks.begin(), m_hunks.begin() + m_jobFirstHunk);
+    merged.insert(merged.end(), hunks.begin(), hunks.end());
+    for (size_t i = m_jobEndHunk; i < m_hunks.size(); ++i)
+    {
+        LineHunk hunk = m_hunks[i];
+        hunk.newLine = (size_t)((long)hunk.newLine + m_jobDelta);
+        merged.push_back(hunk);
+    }
+    m_hunks.swap(merged);
+
+    size_t currentEnd = (size_t)((long)m_jobPreviousEnd + m_jobDelta);
+    if (!m_dirty)
+    {
+        // 计算期间文档没有变化，只刷新区域内的标记
+        ClearMarkers(m_jobFirst, currentEnd);
+        AddMarkers(hunks);
+    }
+    else
+    {
+        // 计算期间又有编辑，区域并入下一次比较，标记到时一起刷新
+        size_t previousEnd = (size_t)((long)m_dirtyEnd - m_dirtyDelta);
+        m_dirtyFirst = std::min(m_dirtyFirst, m_jobFirst);
+        m_dirtyEnd = (size_t)((long)std::max(previousEnd, currentEnd) + m_dirtyDelta);
+    }
+
+    if (!m_diffTimer.IsRunning())
+        StartNextJob();
+}
+
+void ChangeGutter::ClearMarkers(size_t firstLine, size_t lastLine)
+{
+    int line = m_editor->MarkerNext(firstLine, MARKER_MASK);
+    while (line >= 0 && (size_t)line <= lastLine)
+    {
+        int markers = m_editor->MarkerGet(line);
+        for (int marker : { MARKER_ADDED, MARKER_MODIFIED, MARKER_DELETED })
+        {
+            if (markers & (1 << marker))
+                m_editor->MarkerDelete(line, marker);
+        }
+        line = m_editor->MarkerNext(line + 1, MARKER_MASK);
+    }
+}
+
+void ChangeGutter::AddMarkers(const std::vector<LineHunk>& hunks)
+{
+    size_t lineCount = m_editor->GetLineCount();
+    for (const LineHunk& hunk : hunks)
+    {
+        // 删除的行标在其后的一行上
+        if (hunk.newCount == 0)
+        {
+            m_editor->MarkerAdd(std::min(hunk.newLine, lineCount - 1), MARKER_DELETED);
+            continue;
+        }
+
+        int marker = hunk.oldCount == 0 ? MARKER_ADDED : MARKER_MODIFIED;
+        size_t end = std::min(hunk.newLine + hunk.newCount, lineCount);
+        for (size_t line = hunk.newLine; line < end; ++line)
+            m_editor->MarkerAdd(line, marker);
+    }
+}
@@ -0,0 +1,253 @@
+#include "ConsoleBuffer.h"
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+// 每个线程至少扫描的行数，行数较少时不值得启动线程
+static const size_t MIN_CHUNK_LINES = 65536;
+
+static unsigned char ToLowerAscii(unsigned char ch)
+{
+    return (ch >= 'A' && ch <= 'Z') ? ch + ('a' - 'A') : ch;
+}
+
+// 正则表达式每次匹配都必须包含的最长一段文字，找不到时返回空串。
+// 只分析顶层（括号外）没有 '|' 的表达式，转义、字符类和分组都视为文字的分隔
+static std::string RequiredLiteral(std::string_view pattern)
+{
+    std::string best;
+    std::string current;
+    int depth = 0;
+    auto finish = [&]() {
+        if (current.size() > best.size())
+            best = current;
+        current.clear();
+    };
+
+    for (size_t i = 0; i < pattern.size(); ++i)
+    {
+        char ch = pattern[i];
+        switch (ch)
+        {
+        case '\\':
+            finish();
+            ++i;
+            break;
+        case '[':
+        {
+            finish();
+            // 跳到字符类结束处，开头的 ']' 属于字符类
+            size_t close = i + 1;
+            if (close < pattern.size() && pattern[close] == '^')
+                ++close;
+            if (close < pattern.size() && pattern[close] == ']')
+                ++close;
+            i = pattern.find(']', close);
+            if (i == std::string_view::npos)
+                return std::string();
+            break;
+        }
+        case '(':
+            finish();
+            ++depth;
+            break;
+        case ')':
+            finish();
+            --depth;
+            break;
+        case '|':
+            if (depth == 0)
+                return std::string();
+            finish();
+            break;
+        case '?':
+        case '*':
+        case '{':
+            // 前一个字符可以不出现
+            if (!current.empty())
+                current.pop_back();
+            finish();
+            if (ch == '{')
+            {
+                i = pattern.find('}', i);
+                if (i == std::string_view::npos)
+                    return std::string();
+            }
+            break;
+        case '^':
+        case '$':
+        case '.':
+        case '+':
+            finish();
+            break;
+        default:
+            if (depth == 0)
+                current += ch;
+            else
+                finish();
+            break;
+        }
+    }
+    finish();
+    return best;
+}
+
+void ConsoleBuffer::Append(ConsoleStream stream, std::string_view text)
+{
+    while (!text.empty())
+    {
+        // 未结束的行来自另一个来源时先结束它，保证每行只有一个来源
+        if (m_lastLineOpen && m_streams.back() != (uint8_t)stream)
+        {
+            m_text += '\n';
+            m_lastLineOpen = false;
+        }
+        if (!m_lastLineOpen)
+        {
+            m_lineStarts.push_back(m_text.size());
+            m_streams.push_back((uint8_t)stream);
+            m_lastLineOpen = true;
+        }
+
+        size_t newline = text.find('\n');
+        if (newline == std::string_view::npos)
+        {
+            m_text.append(text);
+            break;
+        }
+        m_text.append(text.data(), newline + 1);
+        m_lastLineOpen = false;
+        text.remove_prefix(newline + 1);
+    }
+}
+
+void ConsoleBuffer::Clear()
+{
+    m_text.clear();
+    m_lineStarts.clear();
+    m_streams.clear();
+    m_lastLineOpen = false;
+}
+
+size_t ConsoleBuffer::GetMemoryUsage() const
+{
+    return m_text.capacity() + m_lineStarts.capacity() * sizeof(size_t) + m_streams.capacity();
+}
+
+std::string_view ConsoleBuffer::GetLine(size_t line) const
+{
+    size_t start = m_lineStarts[line];
+    size_t end = line + 1 < m_lineStarts.size() ? m_lineStarts[line + 1] - 1
+                                                : (m_lastLineOpen ? m_text.size() : m_text.size() - 1);
+    return std::string_view(m_text.data() + start, end - start);
+}
+
+bool ConsoleBuffer::Find(const ConsoleQuery& query, size_t firstLine, size_t lastLine, std::vector<size_t>& matches,
+                         const std::atomic<bool>* cancel) const
+{
+    std::regex regex;
+    const std::regex* pattern = nullptr;
+    if (query.regex && !query.text.empty())
+    {
+        auto flags = std::regex::ECMAScript | std::regex::optimize;
+        if (!query.matchCase)
+            flags |= std::regex::icase;
+        try
+        {
+            regex.assign(query.text, flags);
+        }
+        catch (const std::regex_error&)
+        {
+            return false;
+        }
+        pattern = &regex;
+    }
+
+    lastLine = std::min(lastLine, GetLineCount());
+    if (firstLine >= lastLine)
+        return true;
+
+    // 按行数分块，每块一个线程，结果按块的顺序拼接
+    size_t lineCount = lastLine - firstLine;
+    size_t threads = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()),
+                                      (lineCount + MIN_CHUNK_LINES - 1) / MIN_CHUNK_LINES);
+    if (threads <= 1)
+    {
+        FindRange(query, pattern, firstLine, lastLine, matches, cancel);
+        return true;
+    }
+
+    size_t chunkLines = (lineCount + threads - 1) / threads;
+    std::vector<std::vector<size_t>> results(threads);
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < threads; ++i)
+    {
+        size_t begin = firstLine + i * chunkLines;
+        size_t end = std::min(begin + chunkLines, lastLine);
+        if (begin < end)
+            workers.emplace_back([this, &query, pattern, begin, end, &results, i, cancel]() { FindRange(query, pattern, begin, end, results[i], cancel); });
+    }
+    for (std::thread& worker : workers)
+        worker.join();
+
+    for (const std::vector<size_t>& result : results)
+        matches.insert(matches.end(), result.begin(), result.end());
+    return true;
+}
+
+void ConsoleBuffer::FindRange(const ConsoleQuery& query, const std::regex* regex, size_t firstLine, size_t lastLine,
+                              std::vector<size_t>& matches, const std::atomic<bool>* cancel) const
+{
+    auto cancelled = [cancel]() { return cancel && cancel->load(std::memory_order_relaxed); };
+
+    auto accept = [&](size_t line) {
+        if (!((query.streams >> m_streams[line]) & 1))
+            return false;
+        if (!regex)
+            return true;
+        std::string_view text = GetLine(line);
+        return std::regex_search(text.begin(), text.end(), *regex);
+    };
+
+    // 正则表达式只在包含其必需文字的行上运行
+    std::string needle = regex ? RequiredLiteral(query.text) : query.text;
+    if (needle.empty())
+    {
+        for (size_t line = firstLine; line < lastLine && !cancelled(); ++line)
+        {
+            if (accept(line))
+                matches.push_back(line);
+        }
+        return;
+    }
+
+    // 文字查找在整块文本上进行，命中后从下一行的开头继续
+    std::string_view text(m_text.data(), lastLine < m_lineStarts.size() ? m_lineStarts[lastLine] : m_text.size());
+
+    // 仅对 ASCII 忽略大小写，与查找替换的规则一致
+    auto hash = [](char ch) { return std::hash<unsigned char>()(ToLowerAscii(ch)); };
+    auto equal = [](char a, char b) { return ToLowerAscii(a) == ToLowerAscii(b); };
+    std::boyer_moore_horspool_searcher searcher(needle.begin(), needle.end(), hash, equal);
+
+    size_t line = firstLine;
+    while (line < lastLine && !cancelled())
+    {
+        size_t position;
+        if (query.matchCase)
+        {
+            position = text.find(needle, m_lineStarts[line]);
+        }
+        else
+        {
+            auto match = searcher(text.begin() + m_lineStarts[line], text.end());
+            position = match.first == text.end() ? std::string_view::npos : match.first - text.begin();
+        }
+        if (position == std::string_view::npos)
+            break;
+
+        line = std::upper_bound(m_lineStarts.begin() + line, m_lineStarts.begin() + lastLine, position) - m_lineStarts.begin() - 1;
+        if (accept(line))
+            matches.push_back(line);
+        ++line;
+    }
+}
@@ -0,0 +1,659 @@
+#include "ConsolePanel.h"
+#include "LanguageManager.h"
+#include "ProcessManager.h"
+#include <wx/clipbrd.h>
+#include <algorithm>
+
+// 输入查找文本后等待多久再查询
+static const int QUERY_DELAY_MS = 200;
+
+// 发送文件时每次读取的字节数
+static const size_t INPUT_FILE_CHUNK = 1024 * 1024;
+
+// 粘贴的内容超过该长度时不回显，只显示字节数
+static const size_t MAX_INPUT_ECHO = 64 * 1024;
+
+// 列表只有一列，宽度足够显示较长的输出行
+static const int LINE_COLUMN_WIDTH = 4000;
+
+static const wxColour CONSOLE_BACKGROUND(30, 30, 30);
+static const wxColour MATCH_BACKGROUND(80, 80, 40);
+static const wxColour STREAM_COLOURS[] = {
+    wxColour(200, 200, 200),    // 标准输出
+    wxColour(255, 100, 100),    // 标准错误
+    wxColour(150, 150, 255),    // IDE 提示
+    wxColour(100, 255, 100)     // 用户输入
+};
+
+// 虚拟列表，行的内容与颜色向面板查询
+class ConsoleLineList : public wxListCtrl
+{
+public:
+    ConsoleLineList(ConsolePanel* panel)
+        : wxListCtrl(panel, wxID_ANY, wxDefaultPosition, wxDefaultSize,
+                     wxLC_REPORT | wxLC_VIRTUAL | wxLC_NO_HEADER)
+        , m_panel(panel)
+    {
+    }
+
+protected:
+    wxString OnGetItemText(long item, long WXUNUSED(column)) const override { return m_panel->GetRowText(item); }
+    wxItemAttr* OnGetItemAttr(long item) const override { return m_panel->GetRowAttr(item); }
+
+private:
+    ConsolePanel* m_panel;
+};
+
+wxBEGIN_EVENT_TABLE(ConsolePanel, wxPanel)
+    EVT_CHECKBOX(wxID_ANY, ConsolePanel::OnOptionChanged)
+    EVT_TIMER(wxID_ANY, ConsolePanel::OnQueryTimer)
+    EVT_LIST_KEY_DOWN(wxID_ANY, ConsolePanel::OnListKeyDown)
+wxEND_EVENT_TABLE()
+
+ConsolePanel::ConsolePanel(wxWindow* parent, wxWindowID id)
+    : wxPanel(parent, id)
+    , m_queryTimer(this)
+    , m_queryValid(true)
+    , m_showAll(true)
+    , m_scannedLines(0)
+    , m_cancelQuery(false)
+    , m_queryGeneration(0)
+    , m_queryRunning(false)
+    , m_scanPending(false)
+    , m_restorePending(false)
+    , m_restoreLine(SIZE_MAX)
+    , m_refreshPending(false)
+    , m_processManager(nullptr)
+    , m_endInputPending(false)
+    , m_inputFileSent(0)
+{
+    m_findText = new wxTextCtrl(this, wxID_ANY, "", wxDefaultPosition, wxSize(240, -1), wxTE_PROCESS_ENTER);
+    m_regex = new wxCheckBox(this, wxID_ANY, Tr(MSG_CONSOLE_REGEX));
+    m_matchCase = new wxCheckBox(this, wxID_ANY, Tr(MSG_CONSOLE_MATCH_CASE));
+    m_filter = new wxCheckBox(this, wxID_ANY, Tr(MSG_CONSOLE_FILTER));
+    m_errorsOnly = new wxCheckBox(this, wxID_ANY, Tr(MSG_CONSOLE_ERRORS_ONLY));
+    m_matchCount = new wxStaticText(this, wxID_ANY, "");
+    m_findText->SetHint(Tr(MSG_CONSOLE_FIND_HINT));
+    m_findText->Bind(wxEVT_TEXT, &ConsolePanel::OnFindTextChanged, this);
+    m_findText->Bind(wxEVT_TEXT_ENTER, &ConsolePanel::OnFindTextEnter, this);
+
+    // 运行中脚本的标准输入
+    m_inputText = new wxTextCtrl(this, wxID_ANY, "", wxDefaultPosition, wxDefaultSize, wxTE_PROCESS_ENTER);
+    m_inputText->SetHint(Tr(MSG_CONSOLE_INPUT_HINT));
+    m_inputText->Bind(wxEVT_TEXT_ENTER, &ConsolePanel::OnInputEnter, this);
+    m_inputText->Bind(wxEVT_KEY_DOWN, &ConsolePanel::OnInputKeyDown, this);
+    m_inputText->Bind(wxEVT_TEXT_PASTE, &ConsolePanel::OnInputPaste, this);
+    m_sendFile = new wxButton(this, wxID_ANY, Tr(MSG_CONSOLE_SEND_FILE));
+    m_sendFile->Bind(wxEVT_BUTTON, &ConsolePanel::OnSendFile, this);
+    m_inputText->Disable();
+    m_sendFile->Disable();
+
+    m_list = new ConsoleLineList(this);
+    m_list->AppendColumn(wxEmptyString, wxLIST_FORMAT_LEFT, LINE_COLUMN_WIDTH);
+    m_list->SetFont(wxFont(10, wxFONTFAMILY_TELETYPE, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+    m_list->SetBackgroundColour(CONSOLE_BACKGROUND);
+    m_list->SetTextColour(STREAM_COLOURS[(int)ConsoleStream::Output]);
+
+    for (int stream = 0; stream < (int)ConsoleStream::Count; ++stream)
+    {
+        m_attrs[stream] = wxItemAttr(STREAM_COLOURS[stream], CONSOLE_BACKGROUND, wxNullFont);
+        m_matchAttrs[stream] = wxItemAttr(STREAM_COLOURS[stream], MATCH_BACKGROUND, wxNullFont);
+    }
+
+    wxBoxSizer* findSizer = new wxBoxSizer(wxHORIZONTAL);
+    findSizer->Add(m_findText, 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 8);
+    findSizer->Add(m_regex, 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 8);
+    findSizer->Add(m_matchCase, 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 8);
+    findSizer->Add(m_filter, 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 8);
+    findSizer->Add(m_errorsOnly, 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 8);
+    findSizer->Add(m_matchCount, 1, wxALIGN_CENTER_VERTICAL);
+
+    wxBoxSizer* inputSizer = new wxBoxSizer(wxHORIZONTAL);
+    inputSizer->Add(m_inputText, 1, wxALIGN_CENTER_VERTICAL | wxRIGHT, 8);
+    inputSizer->Add(m_sendFile, 0, wxALIGN_CENTER_VERTICAL);
+
+    wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
+    sizer->Add(findSizer, 0, wxEXPAND | wxALL, 2);
+    sizer->Add(m_list, 1, wxEXPAND);
+    sizer->Add(inputSizer, 0, wxEXPAND | wxALL, 2);
+    SetSizer(sizer);
+}
+
+ConsolePanel::~ConsolePanel()
+{
+    CancelQuery();
+}
+
+void ConsolePanel::AppendText(ConsoleStream stream, const wxString& text)
+{
+    wxScopedCharBuffer utf8 = text.utf8_str();
+    std::string_view data(utf8.data(), utf8.length());
+
+    // 查询线程正在读取缓冲区，输出先暂存
+    if (m_queryRunning)
+    {
+        if (m_heldOutput.empty() || m_heldOutput.back().first != stream)
+            m_heldOutput.emplace_back(stream, std::string());
+        m_heldOutput.back().second.append(data);
+    }
+    else
+    {
+        m_buffer.Append(stream, data);
+    }
+    m_scanPending = true;
+
+    // 一次读取产生的多行输出合并为一次刷新
+    if (!m_refreshPending)
+    {
+        m_refreshPending = true;
+        CallAfter(&ConsolePanel::RefreshView);
+    }
+}
+
+void ConsolePanel::Clear()
+{
+    CancelQuery();
+    m_buffer.Clear();
+    m_restorePending = false;
+    m_scanPending = false;
+    m_visible.clear();
+    m_matches.clear();
+    m_scannedLines = 0;
+
+    m_list->SetItemCount(0);
+    m_list->Refresh();
+    UpdateMatchCount();
+}
+
+void ConsolePanel::UpdateLabels()
+{
+    m_regex->SetLabel(Tr(MSG_CONSOLE_REGEX));
+    m_matchCase->SetLabel(Tr(MSG_CONSOLE_MATCH_CASE));
+    m_filter->SetLabel(Tr(MSG_CONSOLE_FILTER));
+    m_errorsOnly->SetLabel(Tr(MSG_CONSOLE_ERRORS_ONLY));
+    m_findText->SetHint(Tr(MSG_CONSOLE_FIND_HINT));
+    m_inputText->SetHint(Tr(MSG_CONSOLE_INPUT_HINT));
+    m_sendFile->SetLabel(Tr(MSG_CONSOLE_SEND_FILE));
+    UpdateMatchCount();
+    Layout();
+}
+
+void ConsolePanel::SetInputEnabled(bool enabled)
+{
+    m_pendingInput.clear();
+    m_endInputPending = false;
+    if (m_inputFile.IsOpened())
+        m_inputFile.Close();
+
+    if (!enabled)
+        m_inputText->Clear();
+    m_inputText->Enable(enabled);
+    m_sendFile->Enable(enabled);
+}
+
+void ConsolePanel::FeedInput()
+{
+    if (!m_processManager)
+        return;
+
+    for (;;)
+    {
+        if (m_pendingInput.empty() && m_inputFile.IsOpened())
+        {
+            m_pendingInput.resize(INPUT_FILE_CHUNK);
+            ssize_t count = m_inputFile.Read(&m_pendingInput[0], INPUT_FILE_CHUNK);
+            m_pendingInput.resize(count > 0 ? count : 0);
+            if (count > 0)
+                m_inputFileSent += count;
+            else
+                FinishInputFile();
+        }
+        if (m_pendingInput.empty())
+            break;
+
+        size_t accepted = m_processManager->WriteInput(m_pendingInput.data(), m_pendingInput.size());
+        m_pendingInput.erase(0, accepted);
+        if (!m_pendingInput.empty())
+        {
+            // 队列已满时等待进程通知；标准输入已经关闭时丢弃剩余数据
+            if (!m_processManager->IsInputOpen())
+            {
+                m_pendingInput.clear();
+                if (m_inputFile.IsOpened())
+                    FinishInputFile();
+            }
+            return;
+        }
+    }
+
+    if (m_endInputPending)
+    {
+        m_endInputPending = false;
+        m_processManager->CloseInput();
+    }
+}
+
+void ConsolePanel::OnInputEnter(wxCommandEvent& WXUNUSED(event))
+{
+    wxString line = m_inputText->GetValue();
+    m_inputText->Clear();
+    SendInput(line + "\n");
+}
+
+void ConsolePanel::OnInputKeyDown(wxKeyEvent& event)
+{
+    // Ctrl+D 与终端一致：发送输入行中的文字（不加换行）并关闭标准输入
+    if (event.GetModifiers() == wxMOD_CONTROL && event.GetKeyCode() == 'D')
+        EndInput();
+    else
+        event.Skip();
+}
+
+void ConsolePanel::OnInputPaste(wxClipboardTextEvent& event)
+{
+    wxString text;
+    if (wxTheClipboard->Open())
+    {
+        wxTextDataObject data;
+        if (wxTheClipboard->IsSupported(wxDF_UNICODETEXT) && wxTheClipboard->GetData(data))
+            text = data.GetText();
+        wxTheClipboard->Close();
+    }
+
+    // 单行内容照常粘贴到输入行，多行内容连同输入行中已有的文字直接发送
+    if (text.Find('\n') == wxNOT_FOUND)
+    {
+        event.Skip();
+        return;
+    }
+    text.Replace("\r\n", "\n");
+    SendInput(m_inputText->GetValue() + text);
+    m_inputText->Clear();
+}
+
+void ConsolePanel::OnSendFile(wxCommandEvent& WXUNUSED(event))
+{
+    if (!m_processManager || !m_processManager->IsInputOpen() || m_inputFile.IsOpened())
+        return;
+
+    wxFileDialog dialog(this, Tr(MSG_CONSOLE_SEND_FILE_TITLE), "", "", "*.*", wxFD_OPEN | wxFD_FILE_MUST_EXIST);
+    if (dialog.ShowModal() != wxID_OK)
+        return;
+
+    if (!m_inputFile.Open(dialog.GetPath()))
+    {
+        wxMessageBox(Tr(MSG_ERROR_OPEN_FAILED), Tr(MSG_ERROR_TITLE), wxOK | wxICON_ERROR);
+        return;
+    }
+
+    // 文件发送完之前不接受其他输入，避免混在文件内容中间
+    m_inputFileName = dialog.GetFilename();
+    m_inputFileSent = 0;
+    m_inputFileStart = wxGetLocalTimeMillis();
+    m_inputText->Disable();
+    m_sendFile->Disable();
+    AppendText(ConsoleStream::Info, wxString::Format(Tr(MSG_CONSOLE_SENDING_FILE), m_inputFileName) + "\n");
+    FeedInput();
+}
+
+void ConsolePanel::SendInput(const wxString& text)
+{
+    if (!m_processManager || !m_processManager->IsInputOpen())
+        return;
+
+    wxScopedCharBuffer utf8 = text.utf8_str();
+    if (utf8.length() <= MAX_INPUT_ECHO)
+        AppendText(ConsoleStream::Input, text);
+    else
+        AppendText(ConsoleStream::Info, wxString::Format(Tr(MSG_CONSOLE_INPUT_SENT), utf8.length()) + "\n");
+
+    m_pendingInput.append(utf8.data(), utf8.length());
+    FeedInput();
+}
+
+void ConsolePanel::EndInput()
+{
+    if (!m_processManager || !m_processManager->IsInputOpen() || m_inputFile.IsOpened())
+        return;
+
+    wxString text = m_inputText->GetValue();
+    m_inputText->Clear();
+    if (!text.IsEmpty())
+        SendInput(text);
+
+    AppendText(ConsoleStream::Info, Tr(MSG_CONSOLE_END_OF_INPUT) + "\n");
+    m_inputText->Disable();
+    m_sendFile->Disable();
+    m_endInputPending = true;
+    FeedInput();
+}
+
+void ConsolePanel::FinishInputFile()
+{
+    m_inputFile.Close();
+
+    double seconds = std::max(0.001, (wxGetLocalTimeMillis() - m_inputFileStart).ToDouble() / 1000.0);
+    double megabytes = m_inputFileSent / (1024.0 * 1024.0);
+    AppendText(ConsoleStream::Info, wxString::Format(Tr(MSG_CONSOLE_FILE_SENT), m_inputFileName,
+                                                     megabytes, seconds, megabytes / seconds) + "\n");
+
+    bool open = m_processManager && m_processManager->IsInputOpen();
+    m_inputText->Enable(open);
+    m_sendFile->Enable(open);
+}
+
+void ConsolePanel::OnFindTextChanged(wxCommandEvent& WXUNUSED(event))
+{
+    m_queryTimer.StartOnce(QUERY_DELAY_MS);
+}
+
+void ConsolePanel::OnFindTextEnter(wxCommandEvent& WXUNUSED(event))
+{
+    if (m_queryTimer.IsRunning())
+        RunQuery();
+
+    // 重新查询的结果到达后会选中第一个匹配行
+    if (!m_restorePending)
+        FindMatch(!wxGetKeyState(WXK_SHIFT), false);
+}
+
+void ConsolePanel::OnOptionChanged(wxCommandEvent& WXUNUSED(event))
+{
+    RunQuery();
+}
+
+void ConsolePanel::OnQueryTimer(wxTimerEvent& WXUNUSED(event))
+{
+    RunQuery();
+}
+
+void ConsolePanel::OnListKeyDown(wxListEvent& event)
+{
+    if (event.GetKeyCode() == 'C' && wxGetKeyState(WXK_CONTROL))
+        CopySelection();
+    else
+        event.Skip();
+}
+
+void ConsolePanel::RunQuery()
+{
+    m_queryTimer.Stop();
+    CancelQuery();
+
+    // 过滤条件变化后行号对应的位置会变，记住选中的行
+    long selectedRow = m_list->GetNextItem(-1, wxLIST_NEXT_ALL, wxLIST_STATE_SELECTED);
+    m_restoreLine = selectedRow >= 0 ? RowToLine(selectedRow) : SIZE_MAX;
+    for (long row = selectedRow; row >= 0; row = m_list->GetNextItem(row, wxLIST_NEXT_ALL, wxLIST_STATE_SELECTED))
+        m_list->SetItemState(row, 0, wxLIST_STATE_SELECTED | wxLIST_STATE_FOCUSED);
+
+    m_query.text = m_findText->GetValue().utf8_str().data();
+    m_query.regex = m_regex->GetValue();
+    m_query.matchCase = m_matchCase->GetValue();
+    m_query.streams = m_errorsOnly->GetValue() ? ConsoleQuery::StreamBit(ConsoleStream::Error) : 0xff;
+
+    // 空范围的查询只检查正则表达式
+    std::vector<size_t> none;
+    m_queryValid = m_buffer.Find(m_query, 0, 0, none);
+    m_findText->SetBackgroundColour(m_queryValid ? wxNullColour : wxColour(255, 200, 200));
+    m_findText->Refresh();
+
+    m_showAll = !(m_filter->GetValue() && HasTextQuery()) && !m_errorsOnly->GetValue();
+    m_visible.clear();
+    m_matches.clear();
+    m_scannedLines = 0;
+    m_restorePending = NeedsScan();
+    if (m_restorePending)
+        StartQueryJob();
+
+    m_list->SetItemCount(GetRowCount());
+    m_list->Refresh();
+    UpdateMatchCount();
+
+    if (!m_restorePending)
+        RestoreSelection();
+}
+
+void ConsolePanel::RestoreSelection()
+{
+    if (m_restoreLine != SIZE_MAX)
+    {
+        long row = LineToRow(m_restoreLine);
+        if (row < GetRowCount())
+            SelectRow(row);
+    }
+    if (HasTextQuery() && !m_filter->GetValue())
+        FindMatch(true, true);
+}
+
+void ConsolePanel::RefreshView()
+{
+    m_refreshPending = false;
+
+    // 已经显示到末尾时继续跟随新的输出
+    long oldCount = m_list->GetItemCount();
+    bool following = oldCount == 0 || m_list->GetTopItem() + m_list->GetCountPerPage() >= oldCount;
+
+    long count = GetRowCount();
+    m_list->SetItemCount(count);
+    m_list->Refresh();
+    UpdateMatchCount();
+
+    if (following && count > 0)
+        m_list->EnsureVisible(count - 1);
+
+    // 查询正在进行时，新的行等它结束后再查询
+    if (m_scanPending && !m_queryRunning && NeedsScan())
+        StartQueryJob();
+}
+
+void ConsolePanel::StartQueryJob()
+{
+    if (m_queryThread.joinable())
+        m_queryThread.join();
+
+    ConsoleQuery matchQuery = m_query;
+    ConsoleQuery visibleQuery = m_query;
+    if (!m_filter->GetValue() || !HasTextQuery())
+        visibleQuery.text.clear();
+    bool findVisible = !m_showAll;
+    bool findMatches = HasTextQuery() && !m_filter->GetValue();
+
+    // 上次查询时最后一行可能还没有结束，从它开始重新查询
+    size_t firstLine = m_scannedLines;
+    size_t lastLine = m_buffer.GetLineCount();
+    size_t scannedLines = m_buffer.GetCompleteLineCount();
+    unsigned generation = m_queryGeneration;
+
+    m_scanPending = false;
+    m_cancelQuery = false;
+    m_queryRunning = true;
+    m_queryThread = std::thread([this, matchQuery, visibleQuery, findVisible, findMatches, firstLine, lastLine, scannedLines, generation]() {
+        std::vector<size_t> visible;
+        std::vector<size_t> matches;
+        if (findVisible)
+            m_buffer.Find(visibleQuery, firstLine, lastLine, visible, &m_cancelQuery);
+        if (findMatches)
+            m_buffer.Find(matchQuery, firstLine, lastLine, matches, &m_cancelQuery);
+        CallAfter([this, generation, scannedLines, visible, matches]() { FinishQueryJob(generation, scannedLines, visible, matches); });
+    });
+}
+
+void ConsolePanel::FinishQueryJob(unsigned generation, size_t scannedLines, std::vector<size_t> visible, std::vector<size_t> matches)
+{
+    // 被取消的查询在取消时已经等待线程结束
+    if (generation != m_queryGeneration)
+        return;
+
+    m_queryRunning = false;
+    if (m_queryThread.joinable())
+        m_queryThread.join();
+
+    // 去掉上次未结束的最后一行的结果，换成这次查询的结果
+    auto merge = [this](std::vector<size_t>& lines, const std::vector<size_t>& found) {
+        while (!lines.empty() && lines.back() >= m_scannedLines)
+            lines.pop_back();
+        lines.insert(lines.end(), found.begin(), found.end());
+    };
+    merge(m_visible, visible);
+    merge(m_matches, matches);
+    m_scannedLines = scannedLines;
+
+    FlushHeldOutput();
+    RefreshView();
+
+    if (m_restorePending)
+    {
+        m_restorePending = false;
+        RestoreSelection();
+    }
+}
+
+void ConsolePanel::CancelQuery()
+{
+    ++m_queryGeneration;
+    m_cancelQuery = true;
+    if (m_queryThread.joinable())
+        m_queryThread.join();
+    m_queryRunning = false;
+
+    FlushHeldOutput();
+}
+
+void ConsolePanel::FlushHeldOutput()
+{
+    for (const std::pair<ConsoleStream, std::string>& held : m_heldOutput)
+        m_buffer.Append(held.first, held.second);
+    m_heldOutput.clear();
+}
+
+void ConsolePanel::UpdateMatchCount()
+{
+    if (!m_queryValid)
+        m_matchCount->SetLabel(Tr(MSG_CONSOLE_INVALID_REGEX));
+    else if (HasTextQuery())
+        m_matchCount->SetLabel(wxString::Format(Tr(MSG_CONSOLE_MATCHES), m_filter->GetValue() ? m_visible.size() : m_matches.size()));
+    else
+        m_matchCount->SetLabel(wxEmptyString);
+}
+
+void ConsolePanel::FindMatch(bool forward, bool inclusive)
+{
+    long count = GetRowCount();
+    if (!HasTextQuery() || count == 0)
+        return;
+
+    long current = m_list->GetNextItem(-1, wxLIST_NEXT_ALL, wxLIST_STATE_SELECTED);
+    long row;
+    if (m_filter->GetValue())
+    {
+        // 过滤时每一行都是匹配行
+        if (current < 0)
+            row = forward ? 0 : count - 1;
+        else if (inclusive)
+            row = current;
+        else
+            row = forward ? (current + 1) % count : (current + count - 1) % count;
+    }
+    else
+    {
+        if (m_matches.empty())
+            return;
+
+        // 到达末尾后从头继续
+        auto it = m_matches.begin();
+        if (current >= 0)
+        {
+            size_t line = RowToLine(current);
+            if (forward)
+                it = inclusive ? std::lower_bound(m_matches.begin(), m_matches.end(), line)
+                               : std::upper_bound(m_matches.begin(), m_matches.end(), line);
+            else
+                it = inclusive ? std::upper_bound(m_matches.begin(), m_matches.end(), line)
+                               : std::lower_bound(m_matches.begin(), m_matches.end(), line);
+        }
+        else if (!forward)
+        {
+            it = m_matches.end();
+        }
+
+        if (forward && it == m_matches.end())
+            it = m_matches.begin();
+        if (!forward)
+        {
+            if (it == m_matches.begin())
+                it = m_matches.end();
+            --it;
+        }
+        row = LineToRow(*it);
+    }
+
+    SelectRow(row);
+}
+
+void ConsolePanel::SelectRow(long row)
+{
+    for (long selected = m_list->GetNextItem(-1, wxLIST_NEXT_ALL, wxLIST_STATE_SELECTED); selected >= 0;
+         selected = m_list->GetNextItem(selected, wxLIST_NEXT_ALL, wxLIST_STATE_SELECTED))
+    {
+        if (selected != row)
+            m_list->SetItemState(selected, 0, wxLIST_STATE_SELECTED | wxLIST_STATE_FOCUSED);
+    }
+
+    m_list->SetItemState(row, wxLIST_STATE_SELECTED | wxLIST_STATE_FOCUSED, wxLIST_STATE_SELECTED | wxLIST_STATE_FOCUSED);
+    m_list->EnsureVisible(row);
+}
+
+void ConsolePanel::CopySelection()
+{
+    std::string text;
+    for (long row = m_list->GetNextItem(-1, wxLIST_NEXT_ALL, wxLIST_STATE_SELECTED); row >= 0;
+         row = m_list->GetNextItem(row, wxLIST_NEXT_ALL, wxLIST_STATE_SELECTED))
+    {
+        text += m_buffer.GetLine(RowToLine(row));
+        text += '\n';
+    }
+
+    if (!text.empty() && wxTheClipboard->Open())
+    {
+        wxTheClipboard->SetData(new wxTextDataObject(wxString::FromUTF8(text.data(), text.size())));
+        wxTheClipboard->Close();
+    }
+}
+
+long ConsolePanel::GetRowCount() const
+{
+    return m_showAll ? (long)m_buffer.GetLineCount() : (long)m_visible.size();
+}
+
+size_t ConsolePanel::RowToLine(long row) const
+{
+    return m_showAll ? (size_t)row : m_visible[row];
+}
+
+long ConsolePanel::LineToRow(size_t line) const
+{
+    if (m_showAll)
+        return (long)line;
+    return std::lower_bound(m_visible.begin(), m_visible.end(), line) - m_visible.begin();
+}
+
+wxString ConsolePanel::GetRowText(long row) const
+{
+    if (row < 0 || row >= GetRowCount())
+        return wxEmptyString;
+
+    std::string_view line = m_buffer.GetLine(RowToLine(row));
+    return wxString::FromUTF8(line.data(), line.size());
+}
+
+wxItemAttr* ConsolePanel::GetRowAttr(long row) const
+{
+    if (row < 0 || row >= GetRowCount())
+        return nullptr;
+
+    size_t line = RowToLine(row);
+    int stream = (int)m_buffer.GetStream(line);
+    if (!m_matches.empty() && std::binary_search(m_matches.begin(), m_matches.end(), line))
+        return &m_matchAttrs[stream];
+    return &m_attrs[stream];
+}
@@ -0,0 +1,363 @@
+#include "EditJournal.h"
+#include "FileUtils.h"
+#include <wx/dir.h>
+#include <wx/filename.h>
+#include <wx/stdpaths.h>
+#include <algorithm>
+#include <chrono>
+
+// 文件格式：魔数、版本、文件头，随后为记录：类型(1) 位置(8) 长度(8) 数据
+static const char JOURNAL_MAGIC[4] = { 'L', 'M', 'E', 'J' };
+static const uint32_t JOURNAL_VERSION = 1;
+static const size_t RECORD_HEADER_SIZE = 1 + 8 + 8;
+
+// 组提交：每隔一段时间或缓存达到一定大小时写入并 fsync 一次
+static const int GROUP_COMMIT_INTERVAL_MS = 200;
+static const size_t GROUP_COMMIT_BYTES = 1024 * 1024;
+
+// 日志超过该大小且超过文档大小时压缩为检查点，使写入量与编辑量成正比
+static const uint64_t MIN_CHECKPOINT_BYTES = 4 * 1024 * 1024;
+
+static void PutU64(std::string& data, uint64_t value)
+{
+    for (int i = 0; i < 8; ++i)
+        data.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+}
+
+static uint64_t GetU64(const std::string& data, size_t pos)
+{
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i)
+        value |= static_cast<uint64_t>(static_cast<unsigned char>(data[pos + i])) << (i * 8);
+    return value;
+}
+
+static void PutRecordHeader(std::string& data, JournalRecordType type, uint64_t position, uint64_t length)
+{
+    data.push_back(static_cast<char>(type));
+    PutU64(data, position);
+    PutU64(data, length);
+}
+
+// 解析文件头，返回第一条记录的偏移，失败返回 0
+static size_t ParseHeader(const std::string& data, JournalHeader& header)
+{
+    const size_t fixedSize = sizeof(JOURNAL_MAGIC) + 4 + 4;
+    if (data.size() < fixedSize || data.compare(0, sizeof(JOURNAL_MAGIC), JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0)
+        return 0;
+
+    uint64_t words = GetU64(data, sizeof(JOURNAL_MAGIC));
+    uint32_t version = static_cast<uint32_t>(words & 0xFFFFFFFF);
+    uint32_t pathLength = static_cast<uint32_t>(words >> 32);
+    if (version != JOURNAL_VERSION || data.size() < fixedSize + pathLength + 16)
+        return 0;
+
+    header.documentPath = wxString::FromUTF8(data.data() + fixedSize, pathLength);
+    header.baseSize = GetU64(data, fixedSize + pathLength);
+    header.baseTime = static_cast<int64_t>(GetU64(data, fixedSize + pathLength + 8));
+    return fixedSize + pathLength + 16;
+}
+
+// 日志所基于的磁盘文件是否仍是记录时的版本
+static bool IsBaseValid(const JournalHeader& header)
+{
+    if (header.documentPath.IsEmpty())
+        return header.baseSize == 0;
+
+    wxFileName name(header.documentPath);
+    return name.FileExists() &&
+           static_cast<uint64_t>(name.GetSize().GetValue()) == header.baseSize &&
+           name.GetModificationTime().GetTicks() == header.baseTime;
+}
+
+EditJournal::EditJournal()
+    : m_started(false)
+    , m_journalBytes(0)
+    , m_hasCheckpoint(false)
+    , m_truncate(false)
+    , m_writing(false)
+    , m_stop(false)
+{
+    m_writer = std::thread(&EditJournal::WriterLoop, this);
+}
+
+EditJournal::~EditJournal()
+{
+    Close(true);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_condition.notify_all();
+    if (m_writer.joinable())
+        m_writer.join();
+}
+
+wxString EditJournal::GetRecoveryDir()
+{
+    wxFileName dir = wxFileName::DirName(wxStandardPaths::Get().GetUserDataDir());
+    dir.AppendDir("recovery");
+    return dir.GetPath();
+}
+
+wxString EditJournal::GetJournalPath(const wxString& documentPath)
+{
+    // FNV-1a 哈希文档路径作为日志文件名
+    wxScopedCharBuffer utf8 = documentPath.ToUTF8();
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < utf8.length(); ++i)
+    {
+        hash ^= static_cast<unsigned char>(utf8.data()[i]);
+        hash *= 1099511628211ULL;
+    }
+
+    wxString name = wxString::Format("%08x%08x.jrnl", (unsigned)(hash >> 32), (unsigned)(hash & 0xFFFFFFFF));
+    return wxFileName(GetRecoveryDir(), name).GetFullPath();
+}
+
+wxArrayString EditJournal::FindJournals()
+{
+    wxArrayString journals;
+    wxString dir = GetRecoveryDir();
+    if (wxDirExists(dir))
+        wxDir::GetAllFiles(dir, &journals, "*.jrnl", wxDIR_FILES);
+    return journals;
+}
+
+void EditJournal::Reset(const wxString& documentPath)
+{
+    Close(true);
+
+    JournalHeader header;
+    header.documentPath = documentPath;
+    if (!documentPath.IsEmpty() && wxFileExists(documentPath))
+    {
+        wxFileName name(documentPath);
+        header.baseSize = name.GetSize().GetValue();
+        header.baseTime = name.GetModificationTime().GetTicks();
+    }
+
+    std::string encoded(JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+    wxScopedCharBuffer path = documentPath.ToUTF8();
+    PutU64(encoded, JOURNAL_VERSION | (static_cast<uint64_t>(path.length()) << 32));
+    encoded.append(path.data(), path.length());
+    PutU64(encoded, header.baseSize);
+    PutU64(encoded, static_cast<uint64_t>(header.baseTime));
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_journalPath = GetJournalPath(documentPath);
+    m_header.swap(encoded);
+    m_started = false;
+    m_journalBytes = 0;
+}
+
+void EditJournal::Close(bool discard)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    // 保留日志时先等待缓存写完
+    if (!discard)
+        m_condition.wait(lock, [this] { return m_buffer.empty() && !m_hasCheckpoint && !m_writing; });
+    else
+        m_condition.wait(lock, [this] { return !m_writing; });
+
+    m_buffer.clear();
+    m_checkpoint.clear();
+    m_hasCheckpoint = false;
+    m_truncate = false;
+
+    if (m_file.IsOpened())
+        m_file.Close();
+
+    if (discard && m_started && wxFileExists(m_journalPath))
+        wxRemoveFile(m_journalPath);
+
+    m_journalPath.Clear();
+    m_started = false;
+}
+
+void EditJournal::StartJournal()
+{
+    // 首条记录到来时才创建日志文件
+    if (!m_started)
+    {
+        m_started = true;
+        m_truncate = true;
+    }
+}
+
+void EditJournal::AppendRecord(JournalRecordType type, uint64_t position, const char* data, uint64_t length)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_journalPath.IsEmpty())
+        return;
+
+    StartJournal();
+
+    size_t before = m_buffer.size();
+    PutRecordHeader(m_buffer, type, position, length);
+    if (data)
+        m_buffer.append(data, length);
+    m_journalBytes += m_buffer.size() - before;
+
+    if (m_buffer.size() >= GROUP_COMMIT_BYTES)
+        m_condition.notify_all();
+}
+
+void EditJournal::RecordInsert(uint64_t position, const char* text, uint64_t length)
+{
+    AppendRecord(JournalRecordType::Insert, position, text, length);
+}
+
+void EditJournal::RecordDelete(uint64_t position, uint64_t length)
+{
+    AppendRecord(JournalRecordType::Delete, position, nullptr, length);
+}
+
+bool EditJournal::NeedsCheckpoint(uint64_t documentSize) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_started && m_journalBytes > std::max(MIN_CHECKPOINT_BYTES, documentSize);
+}
+
+void EditJournal::Checkpoint(std::string&& text)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_journalPath.IsEmpty())
+        return;
+
+    // 检查点之前的记录不再需要
+    StartJournal();
+    m_buffer.clear();
+    m_checkpoint = std::move(text);
+    m_hasCheckpoint = true;
+    m_journalBytes = 0;
+    m_condition.notify_all();
+}
+
+void EditJournal::WriterLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stop)
+    {
+        m_condition.wait_for(lock, std::chrono::milliseconds(GROUP_COMMIT_INTERVAL_MS), [this] {
+            return m_stop || m_hasCheckpoint || m_buffer.size() >= GROUP_COMMIT_BYTES;
+        });
+
+        if (m_journalPath.IsEmpty() || (m_buffer.empty() && !m_hasCheckpoint && !m_truncate))
+            continue;
+
+        std::string records;
+        records.swap(m_buffer);
+        std::string checkpoint;
+        bool hasCheckpoint = m_hasCheckpoint;
+        if (hasCheckpoint)
+            checkpoint.swap(m_checkpoint);
+        bool truncate = m_truncate;
+        std::string header = m_header;
+        wxString path = m_journalPath;
+        m_hasCheckpoint = false;
+        m_truncate = false;
+        m_writing = true;
+        lock.unlock();
+
+        if (hasCheckpoint)
+        {
+            WriteCheckpoint(path, header, checkpoint);
+        }
+        else if (truncate)
+        {
+            wxFileName::Mkdir(GetRecoveryDir(), wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+            if (m_file.Create(path, true))
+                m_file.Write(header.data(), header.size());
+        }
+
+        if (m_file.IsOpened() || m_file.Open(path, wxFile::write_append))
+        {
+            m_file.Write(records.data(), records.size());
+            m_file.Flush();
+        }
+
+        lock.lock();
+        m_writing = false;
+        m_condition.notify_all();
+    }
+}
+
+bool EditJournal::WriteCheckpoint(const wxString& path, const std::string& header, const std::string& text)
+{
+    if (m_file.IsOpened())
+        m_file.Close();
+
+    wxFileName::Mkdir(GetRecoveryDir(), wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+
+    // 写入临时文件后替换旧日志，崩溃时旧日志仍然完整
+    wxString tempPath = path + ".tmp";
+    {
+        std::string record;
+        PutRecordHeader(record, JournalRecordType::Checkpoint, 0, text.size());
+
+        wxFile file(tempPath, wxFile::write);
+        if (!file.IsOpened() ||
+            file.Write(header.data(), header.size()) != header.size() ||
+            file.Write(record.data(), record.size()) != record.size() ||
+            file.Write(text.data(), text.size()) != text.size() ||
+            !file.Flush())
+        {
+            return false;
+        }
+    }
+
+    if (!wxRenameFile(tempPath, path, true))
+        return false;
+
+    return m_file.Open(path, wxFile::write_append);
+}
+
+bool EditJournal::ReadHeader(const wxString& journalPath, JournalHeader& header)
+{
+    std::string data;
+    return FileUtils::ReadBytes(journalPath, data) && ParseHeader(data, header) != 0;
+}
+
+bool EditJournal::Replay(const wxString& journalPath, const std::function<void(const JournalRecord&)>& apply)
+{
+    std::string data;
+    JournalHeader header;
+    if (!FileUtils::ReadBytes(journalPath, data))
+        return false;
+
+    size_t pos = ParseHeader(data, header);
+    if (pos == 0)
+        return false;
+
+    // 没有检查点时，记录只能在原来的磁盘文件上重放
+    bool startsWithCheckpoint = pos < data.size() &&
+        static_cast<JournalRecordType>(data[pos]) == JournalRecordType::Checkpoint;
+    if (!startsWithCheckpoint && !IsBaseValid(header))
+        return false;
+
+    // 崩溃时末尾可能有不完整的记录，忽略即可
+    while (pos + RECORD_HEADER_SIZE <= data.size())
+    {
+        JournalRecord record;
+        record.type = static_cast<JournalRecordType>(data[pos]);
+        record.position = GetU64(data, pos + 1);
+        record.length = GetU64(data, pos + 9);
+        record.data = nullptr;
+        pos += RECORD_HEADER_SIZE;
+
+        if (record.type != JournalRecordType::Delete)
+        {
+            if (record.length > data.size() - pos)
+                break;
+            record.data = data.data() + pos;
+            pos += record.length;
+        }
+
+        apply(record);
+    }
+
+    return true;
+}
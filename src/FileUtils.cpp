@@ -0,0 +1,30 @@
+#include "FileUtils.h"
+#include <wx/file.h>
+
+bool FileUtils::ReadBytes(const wxString& path, std::string& data)
+{
+    wxFile file(path, wxFile::read);
+    if (!file.IsOpened())
+        return false;
+
+    wxFileOffset length = file.Length();
+    if (length < 0)
+        return false;
+
+    data.resize(static_cast<size_t>(length));
+    if (length == 0)
+        return true;
+
+    ssize_t read = file.Read(&data[0], data.size());
+    if (read < 0)
+        return false;
+
+    data.resize(static_cast<size_t>(read));
+    return true;
+}
+
+bool FileUtils::WriteBytes(const wxString& path, const std::string& data)
+{
+    wxFile file(path, wxFile::write);
+    return file.IsOpened() && file.Write(data.data(), data.size()) == data.size();
+}
@@ -0,0 +1,110 @@
+#include "FileWatcher.h"
+#include <wx/filename.h>
+#include <vector>
+
+FileWatcher* FileWatcher::s_instance = nullptr;
+
+wxBEGIN_EVENT_TABLE(FileWatcher, wxEvtHandler)
+    EVT_FSWATCHER(wxID_ANY, FileWatcher::OnFileSystemEvent)
+wxEND_EVENT_TABLE()
+
+FileWatcher& FileWatcher::Get()
+{
+    if (!s_instance)
+        s_instance = new FileWatcher();
+    return *s_instance;
+}
+
+FileWatcher::FileWatcher()
+    : m_nextHandle(1)
+{
+}
+
+FileWatcher::~FileWatcher()
+{
+    if (s_instance == this)
+        s_instance = nullptr;
+}
+
+wxString FileWatcher::NormalizePath(const wxString& path)
+{
+    wxFileName name(path);
+    name.Normalize(wxPATH_NORM_DOTS | wxPATH_NORM_ABSOLUTE | wxPATH_NORM_LONG);
+    return name.GetFullPath();
+}
+
+int FileWatcher::Watch(const wxString& path, std::function<void(const wxString&)> callback)
+{
+    if (!m_watcher)
+    {
+        m_watcher = std::make_unique<wxFileSystemWatcher>();
+        m_watcher->SetOwner(this);
+    }
+
+    WatchEntry entry;
+    entry.path = NormalizePath(path);
+    entry.directory = wxFileName(entry.path).GetPath();
+    entry.callback = callback;
+
+    // 同一目录只注册一次
+    if (m_directoryRefs[entry.directory]++ == 0)
+    {
+        m_watcher->Add(wxFileName::DirName(entry.directory),
+                       wxFSW_EVENT_CREATE | wxFSW_EVENT_MODIFY | wxFSW_EVENT_RENAME);
+    }
+
+    int handle = m_nextHandle++;
+    m_entries[handle] = entry;
+    return handle;
+}
+
+void FileWatcher::Unwatch(int handle)
+{
+    auto it = m_entries.find(handle);
+    if (it == m_entries.end())
+        return;
+
+    wxString directory = it->second.directory;
+    m_entries.erase(it);
+
+    auto ref = m_directoryRefs.find(directory);
+    if (ref != m_directoryRefs.end() && --ref->second == 0)
+    {
+        m_directoryRefs.erase(ref);
+        if (m_watcher)
+            m_watcher->Remove(wxFileName::DirName(directory));
+    }
+}
+
+void FileWatcher::OnFileSystemEvent(wxFileSystemWatcherEvent& event)
+{
+    switch (event.GetChangeType())
+    {
+    case wxFSW_EVENT_CREATE:
+    case wxFSW_EVENT_MODIFY:
+        Dispatch(event.GetPath());
+        break;
+    case wxFSW_EVENT_RENAME:
+        // 保存时常见的"写临时文件后重命名"
+        Dispatch(event.GetNewPath());
+        break;
+    default:
+        break;
+    }
+}
+
+void FileWatcher::Dispatch(const wxFileName& path)
+{
+    wxString changed = NormalizePath(path.GetFullPath());
+
+    // 回调中可能修改监视列表，先收集再调用
+    std::vector<std::function<void(const wxString&)>> callbacks;
+    for (const auto& entry : m_entries)
+    {
+        if (entry.second.path == changed)
+            callbacks.push_back(entry.second.callback);
+    }
+
+    for (const auto& callback : callbacks)
+        callback(changed);
+}
@@ -0,0 +1,216 @@
+#include "IncludeGraph.h"
+#include <algorithm>
+
+// 不存在的节点
+static const uint32_t NO_NODE = UINT32_MAX;
+
+IncludeGraph::IncludeGraph()
+    : m_fileCount(0)
+    , m_edgeCount(0)
+    , m_visitStamp(0)
+{
+}
+
+uint32_t IncludeGraph::Intern(std::string_view path)
+{
+    auto inserted = m_ids.emplace(std::string(path), (uint32_t)m_nodes.size());
+    if (inserted.second)
+    {
+        m_nodes.emplace_back();
+        m_nodes.back().path = &inserted.first->first;
+    }
+    return inserted.first->second;
+}
+
+uint32_t IncludeGraph::Find(std::string_view path) const
+{
+    auto id = m_ids.find(std::string(path));
+    return id == m_ids.end() ? NO_NODE : id->second;
+}
+
+void IncludeGraph::ClearIncludes(uint32_t node)
+{
+    // 只触及该文件出边指向的节点的入边
+    for (uint32_t target : m_nodes[node].includes)
+    {
+        std::vector<uint32_t>& includers = m_nodes[target].includers;
+        auto found = std::find(includers.begin(), includers.end(), node);
+        if (found != includers.end())
+        {
+            *found = includers.back();
+            includers.pop_back();
+        }
+    }
+    m_edgeCount -= m_nodes[node].includes.size();
+    m_nodes[node].includes.clear();
+}
+
+void IncludeGraph::SetIncludes(std::string_view file, const std::vector<std::string>& includes)
+{
+    uint32_t node = Intern(file);
+    ClearIncludes(node);
+    if (!m_nodes[node].scanned)
+    {
+        m_nodes[node].scanned = true;
+        ++m_fileCount;
+    }
+
+    std::vector<uint32_t> targets;
+    targets.reserve(includes.size());
+    for (const std::string& include : includes)
+        targets.push_back(Intern(include));
+    std::sort(targets.begin(), targets.end());
+    targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+
+    for (uint32_t target : targets)
+        m_nodes[target].includers.push_back(node);
+    m_edgeCount += targets.size();
+    m_nodes[node].includes.swap(targets);
+}
+
+void IncludeGraph::RemoveFile(std::string_view file)
+{
+    uint32_t node = Find(file);
+    if (node == NO_NODE)
+        return;
+
+    ClearIncludes(node);
+    if (m_nodes[node].scanned)
+    {
+        m_nodes[node].scanned = false;
+        --m_fileCount;
+    }
+}
+
+void IncludeGraph::Clear()
+{
+    m_nodes.clear();
+    m_ids.clear();
+    m_fileCount = 0;
+    m_edgeCount = 0;
+    m_visited.clear();
+    m_parent.clear();
+}
+
+bool IncludeGraph::HasFile(std::string_view file) const
+{
+    uint32_t node = Find(file);
+    return node != NO_NODE && m_nodes[node].scanned;
+}
+
+std::vector<std::string_view> IncludeGraph::GetIncludes(std::string_view file) const
+{
+    std::vector<std::string_view> paths;
+    uint32_t node = Find(file);
+    if (node != NO_NODE)
+    {
+        for (uint32_t target : m_nodes[node].includes)
+            paths.push_back(*m_nodes[target].path);
+    }
+    return paths;
+}
+
+std::vector<std::string_view> IncludeGraph::GetIncluders(std::string_view file) const
+{
+    std::vector<std::string_view> paths;
+    uint32_t node = Find(file);
+    if (node != NO_NODE)
+    {
+        for (uint32_t source : m_nodes[node].includers)
+            paths.push_back(*m_nodes[source].path);
+    }
+    return paths;
+}
+
+bool IncludeGraph::Visit(uint32_t node) const
+{
+    if (m_visited[node] == m_visitStamp)
+        return false;
+    m_visited[node] = m_visitStamp;
+    return true;
+}
+
+std::vector<std::string_view> IncludeGraph::Collect(uint32_t start, bool forward) const
+{
+    std::vector<std::string_view> paths;
+    if (start == NO_NODE)
+        return paths;
+
+    m_visited.resize(m_nodes.size(), 0);
+    if (++m_visitStamp == 0)
+    {
+        std::fill(m_visited.begin(), m_visited.end(), 0);
+        m_visitStamp = 1;
+    }
+
+    std::vector<uint32_t> pending{ start };
+    Visit(start);
+    while (!pending.empty())
+    {
+        uint32_t node = pending.back();
+        pending.pop_back();
+        for (uint32_t next : forward ? m_nodes[node].includes : m_nodes[node].includers)
+        {
+            if (Visit(next))
+            {
+                paths.push_back(*m_nodes[next].path);
+                pending.push_back(next);
+            }
+        }
+    }
+    return paths;
+}
+
+std::vector<std::string_view> IncludeGraph::GetAffected(std::string_view file) const
+{
+    return Collect(Find(file), false);
+}
+
+std::vector<std::string_view> IncludeGraph::GetDependencies(std::string_view file) const
+{
+    return Collect(Find(file), true);
+}
+
+std::vector<std::string_view> IncludeGraph::FindCycle(std::string_view file) const
+{
+    std::vector<std::string_view> cycle;
+    uint32_t start = Find(file);
+    if (start == NO_NODE)
+        return cycle;
+
+    m_visited.resize(m_nodes.size(), 0);
+    m_parent.resize(m_nodes.size(), NO_NODE);
+    if (++m_visitStamp == 0)
+    {
+        std::fill(m_visited.begin(), m_visited.end(), 0);
+        m_visitStamp = 1;
+    }
+
+    // 按层遍历，第一次回到起点时的路径最短
+    std::vector<uint32_t> queue{ start };
+    Visit(start);
+    for (size_t head = 0; head < queue.size(); ++head)
+    {
+        uint32_t node = queue[head];
+        for (uint32_t next : m_nodes[node].includes)
+        {
+            if (next == start)
+            {
+                std::vector<uint32_t> path{ start };
+                for (uint32_t step = node; step != start; step = m_parent[step])
+                    path.push_back(step);
+                path.push_back(start);
+                std::reverse(path.begin(), path.end());
+                for (uint32_t step : path)
+                    cycle.push_back(*m_nodes[step].path);
+                return cycle;
+            }
+            if (Visit(next))
+            {
+                m_parent[next] = node;
+                queue.push_back(next);
+            }
+        }
+    }
+    return cycle;
+}
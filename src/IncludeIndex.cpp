@@ -0,0 +1,272 @@
+#include "IncludeIndex.h"
+#include "FileUtils.h"
+#include "IncludeScanner.h"
+#include <wx/dir.h>
+#include <wx/filename.h>
+#include <set>
+
+// 扫描目录树时最多记录的文件数，在主目录等大目录中打开文件时不至于遍历整个磁盘
+static const size_t MAX_WORKSPACE_FILES = 20000;
+
+IncludeIndex& IncludeIndex::Get()
+{
+    // 主线程和静态检查线程都可能第一次调用，局部静态变量的初始化是线程安全的
+    static IncludeIndex* instance = new IncludeIndex();
+    return *instance;
+}
+
+IncludeIndex::IncludeIndex()
+    : m_cancel(false)
+    , m_running(false)
+    , m_generation(0)
+{
+}
+
+IncludeIndex::~IncludeIndex()
+{
+    Stop();
+}
+
+static std::string ToUtf8(const wxString& text)
+{
+    wxScopedCharBuffer buffer = text.utf8_str();
+    return std::string(buffer.data(), buffer.length());
+}
+
+std::shared_ptr<const IncludedFileInfo> IncludeIndex::Analyze(const wxString& path, std::string_view source)
+{
+    auto info = std::make_shared<IncludedFileInfo>();
+    info->symbols = LaminaLinter::CollectSymbols(source);
+    for (const std::string& include : IncludeScanner::Scan(source))
+        info->includes.push_back(ToUtf8(IncludeScanner::Resolve(path, include)));
+    return info;
+}
+
+std::shared_ptr<const IncludedFileInfo> IncludeIndex::GetFileInfo(const wxString& path)
+{
+    wxFileName name(path);
+    if (!name.FileExists())
+        return nullptr;
+
+    wxDateTime modified = name.GetModificationTime();
+    {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        auto cached = m_cache.find(path);
+        if (cached != m_cache.end() && cached->second.modified.IsValid() && cached->second.modified == modified)
+            return cached->second.info;
+    }
+
+    // 读取与分析不持有锁，多个线程偶尔重复分析同一文件，结果相同
+    std::string source;
+    if (!FileUtils::ReadBytes(path, source))
+        return nullptr;
+    std::shared_ptr<const IncludedFileInfo> info = Analyze(path, source);
+
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    m_cache[path] = { modified, info };
+    return info;
+}
+
+void IncludeIndex::Open(const wxString& file)
+{
+    if (file.IsEmpty())
+        return;
+
+    m_pendingFile = file;
+    if (m_running)
+    {
+        // 正在扫描的结果作废，结束后重新开始
+        m_cancel = true;
+        return;
+    }
+    StartScan();
+}
+
+void IncludeIndex::Stop()
+{
+    m_cancel = true;
+    m_pendingFile.Clear();
+    m_scanCallback = nullptr;
+    if (m_thread.joinable())
+        m_thread.join();
+    m_running = false;
+}
+
+void IncludeIndex::StartScan()
+{
+    if (m_thread.joinable())
+        m_thread.join();
+
+    wxString file = m_pendingFile;
+    m_pendingFile.Clear();
+    wxString root = wxFileName(file).GetPath();
+    unsigned generation = ++m_generation;
+
+    m_cancel = false;
+    m_running = true;
+    m_thread = std::thread([this, file, root, generation]() {
+        std::vector<ScannedFile> files;
+        std::set<wxString> seen;
+
+        // 1. 预读打开的文件递归包含的文件，首次检查时它们的分析结果已在缓存中
+        std::vector<wxString> pending{ file };
+        while (!pending.empty() && !m_cancel)
+        {
+            wxString current = pending.back();
+            pending.pop_back();
+            if (!seen.insert(current).second)
+                continue;
+
+            std::shared_ptr<const IncludedFileInfo> info = GetFileInfo(current);
+            if (!info)
+                continue;
+            files.push_back({ current, info });
+            for (const std::string& include : info->includes)
+                pending.push_back(wxString::FromUTF8(include.data(), include.size()));
+        }
+
+        // 2. 目录树中其余的 .lm 文件，跳过隐藏目录
+        class Traverser : public wxDirTraverser
+        {
+        public:
+            Traverser(wxArrayString& files, std::atomic<bool>& cancel)
+                : m_files(files), m_cancel(cancel) {}
+
+            wxDirTraverseResult OnFile(const wxString& filename) override
+            {
+                if (m_cancel || m_files.size() >= MAX_WORKSPACE_FILES)
+                    return wxDIR_STOP;
+                if (wxFileName(filename).GetExt().IsSameAs("lm", false))
+                    m_files.Add(filename);
+                return wxDIR_CONTINUE;
+            }
+
+            wxDirTraverseResult OnDir(const wxString& dirname) override
+            {
+                if (m_cancel)
+                    return wxDIR_STOP;
+                return wxFileName(dirname).GetFullName().StartsWith(".") ? wxDIR_IGNORE : wxDIR_CONTINUE;
+            }
+
+        private:
+            wxArrayString& m_files;
+            std::atomic<bool>& m_cancel;
+        };
+
+        wxArrayString workspace;
+        bool complete = false;
+        wxDir dir(root);
+        if (dir.IsOpened() && !m_cancel)
+        {
+            Traverser traverser(workspace, m_cancel);
+            dir.Traverse(traverser, wxEmptyString, wxDIR_FILES | wxDIR_DIRS);
+            complete = !m_cancel && workspace.size() < MAX_WORKSPACE_FILES;
+        }
+
+        for (const wxString& path : workspace)
+        {
+            if (m_cancel)
+                break;
+            if (!seen.insert(path).second)
+                continue;
+            std::shared_ptr<const IncludedFileInfo> info = GetFileInfo(path);
+            if (info)
+                files.push_back({ path, info });
+        }
+
+        CallAfter([this, generation, root, files = std::move(files), complete]() {
+            FinishScan(generation, root, files, complete);
+        });
+    });
+}
+
+void IncludeIndex::FinishScan(unsigned generation, wxString root, std::vector<ScannedFile> files, bool complete)
+{
+    m_running = false;
+    if (m_thread.joinable())
+        m_thread.join();
+
+    if (generation == m_generation && !m_cancel)
+    {
+        // 只有分析结果变化（文件被修改或首次出现）的文件更新出边
+        std::set<wxString> present;
+        for (const ScannedFile& file : files)
+        {
+            present.insert(file.path);
+            Install(file.path, file.info);
+        }
+
+        // 目录树中已不存在的文件
+        if (complete)
+        {
+            wxString prefix = root + wxFileName::GetPathSeparator();
+            for (auto installed = m_installed.begin(); installed != m_installed.end();)
+            {
+                if (installed->first.StartsWith(prefix) && present.find(installed->first) == present.end())
+                {
+                    m_graph.RemoveFile(ToUtf8(installed->first));
+                    installed = m_installed.erase(installed);
+                }
+                else
+                {
+                    ++installed;
+                }
+            }
+        }
+
+        if (m_scanCallback)
+            m_scanCallback();
+    }
+
+    if (!m_pendingFile.IsEmpty())
+        StartScan();
+}
+
+void IncludeIndex::Install(const wxString& path, std::shared_ptr<const IncludedFileInfo> info)
+{
+    std::shared_ptr<const IncludedFileInfo>& installed = m_installed[path];
+    if (installed == info)
+        return;
+    installed = info;
+    m_graph.SetIncludes(ToUtf8(path), info->includes);
+}
+
+void IncludeIndex::Update(const wxString& file, std::string_view source)
+{
+    std::shared_ptr<const IncludedFileInfo> info = Analyze(file, source);
+    {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        m_cache[file] = { wxFileName(file).GetModificationTime(), info };
+    }
+    Install(file, info);
+}
+
+wxArrayString IncludeIndex::ToPaths(const std::vector<std::string_view>& paths)
+{
+    wxArrayString result;
+    for (std::string_view path : paths)
+        result.Add(wxString::FromUTF8(path.data(), path.size()));
+    return result;
+}
+
+wxArrayString IncludeIndex::GetAffected(const wxString& file) const
+{
+    return ToPaths(m_graph.GetAffected(ToUtf8(file)));
+}
+
+wxArrayString IncludeIndex::FindCycle(const wxString& file) const
+{
+    return ToPaths(m_graph.FindCycle(ToUtf8(file)));
+}
+
+wxArrayString IncludeIndex::GetDependencies(const wxString& file) const
+{
+    // 包含了但不存在的文件只有入边
+    wxArrayString result;
+    for (std::string_view path : m_graph.GetDependencies(ToUtf8(file)))
+    {
+        if (m_graph.HasFile(path))
+            result.Add(wxString::FromUTF8(path.data(), path.size()));
+    }
+    return result;
+}
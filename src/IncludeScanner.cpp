@@ -0,0 +1,66 @@
+#include "IncludeScanner.h"
+#include "FileUtils.h"
+#include "LaminaLexer.h"
+#include <wx/filename.h>
+#include <set>
+
+std::vector<std::string> IncludeScanner::Scan(std::string_view source)
+{
+    std::vector<std::string> includes;
+    LaminaLexer lexer(source);
+    LaminaToken token;
+    bool afterInclude = false;
+
+    while (lexer.Next(token))
+    {
+        if (token.kind == TokenKind::Comment)
+            continue;
+
+        if (afterInclude && token.kind == TokenKind::String)
+        {
+            std::string_view text = lexer.Text(token);
+            if (text.size() >= 2 && text.back() == '"')
+                includes.emplace_back(text.substr(1, text.size() - 2));
+        }
+
+        afterInclude = token.kind == TokenKind::Keyword && lexer.Text(token) == "include";
+    }
+
+    return includes;
+}
+
+wxString IncludeScanner::Resolve(const wxString& fromFile, const std::string& include)
+{
+    wxFileName name(wxString::FromUTF8(include.data(), include.size()));
+    if (!name.HasExt())
+        name.SetExt("lm");
+    name.MakeAbsolute(wxFileName(fromFile).GetPath());
+    name.Normalize(wxPATH_NORM_DOTS);
+    return name.GetFullPath();
+}
+
+wxArrayString IncludeScanner::CollectTransitive(const wxString& file)
+{
+    wxArrayString files;
+    std::set<wxString> visited;
+    std::vector<wxString> pending;
+    pending.push_back(file);
+
+    while (!pending.empty())
+    {
+        wxString current = pending.back();
+        pending.pop_back();
+        if (!visited.insert(current).second)
+            continue;
+
+        std::string source;
+        if (!FileUtils::ReadBytes(current, source))
+            continue;
+
+        files.Add(current);
+        for (const std::string& include : Scan(source))
+            pending.push_back(Resolve(current, include));
+    }
+
+    return files;
+}
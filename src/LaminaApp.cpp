@@ -1,14 +1,130 @@
 #include "LaminaApp.h"
 #include "MainFrame.h"
+#include "LanguageManager.h"
+#include "StartupTimeline.h"
+#include "ThemeConfig.h"
+#include <wx/filename.h>
+#include <wx/stdpaths.h>
+#include <wx/utils.h>
+#include <csignal>
 
-bool LaminaApp::OnInit()
+// 在临时目录中运行：设置、会话和崩溃恢复日志都写到这里，不影响用户的配置
+static bool UseTemporaryHome(const char* prefix, wxString& workDir)
 {
-    if (!wxApp::OnInit())
+    workDir = wxFileName(wxFileName::GetTempDir(), wxString::Format("%s-%lu", prefix, wxGetProcessId())).GetFullPath();
+    if (!wxFileName::Mkdir(workDir, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL))
+    {
+        wxPrintf("Cannot create the test directory %s\n", workDir);
         return false;
+    }
+    wxSetEnv("HOME", workDir);
+    return true;
+}
+
+bool LaminaApp::OnInit()
+{
+    // 启动计时从这里开始记录各阶段，后台线程启动之前先创建
+    StartupTimeline::Get();
+    
+    {
+        StartupStage stage("command line");
+        if (!wxApp::OnInit())
+            return false;
+    }
+    
+    // 主题文件的读取与解析与下面的初始化并行。命令行解析成功之后才启动：
+    // OnInit 失败时不会调用 OnExit，线程无人等待；测试选项还会先改变 HOME
+    ThemeConfig::Preload();
+    
+#ifdef SIGPIPE
+    // 子进程不再读取标准输入时，写入管道应当返回错误而不是结束 IDE
+    signal(SIGPIPE, SIG_IGN);
+#endif
+    
+    // 界面文本在创建菜单之前生成
+    {
+        StartupStage stage("languages");
+        LanguageManager::GetInstance().Initialize();
+    }
     
     // 创建主窗口
-    MainFrame* frame = new MainFrame();
-    frame->Show(true);
+    MainFrame* frame;
+    {
+        StartupStage stage("main window");
+        frame = new MainFrame();
+    }
+    {
+        StartupStage stage("show");
+        frame->Show(true);
+    }
+    
+    if (m_startupBenchmark)
+    {
+        frame->SetReadyCallback([frame]() {
+            StartupTimeline& timeline = StartupTimeline::Get();
+            wxPrintf("%s", timeline.Format());
+            wxPrintf("Time to first interactive frame: %.1f ms, startup complete: %.1f ms\n",
+                     timeline.GetFirstFrameMs(), timeline.GetReadyMs());
+            frame->Close(true);
+        });
+    }
+    
+    if (m_runPerfSuite)
+    {
+        m_perfSuite = std::make_unique<PerfSuite>(frame, m_perfOptions);
+        m_perfSuite->Start();
+    }
     
     return true;
 }
+
+int LaminaApp::OnRun()
+{
+    int exitCode = wxApp::OnRun();
+    return m_perfSuite ? m_perfSuite->GetExitCode() : exitCode;
+}
+
+int LaminaApp::OnExit()
+{
+    ThemeConfig::WaitForPreload();
+    m_perfSuite.reset();
+    if (!m_benchmarkDir.IsEmpty())
+        wxFileName::Rmdir(m_benchmarkDir, wxPATH_RMDIR_RECURSIVE);
+    return wxApp::OnExit();
+}
+
+void LaminaApp::OnInitCmdLine(wxCmdLineParser& parser)
+{
+    wxApp::OnInitCmdLine(parser);
+    parser.AddSwitch("", "perf-suite", "run the scripted performance scenarios and compare them with the baseline");
+    parser.AddOption("", "perf-baseline", "baseline JSON (default: config/perf_baseline.json next to the executable)");
+    parser.AddOption("", "perf-output", "write the measured results to a JSON file");
+    parser.AddSwitch("", "perf-update", "replace the baseline with the measured results");
+    parser.AddSwitch("", "startup-benchmark", "print the time of each startup stage and the time to the first interactive frame, then exit");
+}
+
+bool LaminaApp::OnCmdLineParsed(wxCmdLineParser& parser)
+{
+    if (!wxApp::OnCmdLineParsed(parser))
+        return false;
+    
+    // 启动测试同样使用空的配置，每次测量的条件相同
+    m_startupBenchmark = parser.Found("startup-benchmark");
+    if (m_startupBenchmark)
+        return UseTemporaryHome("lamlab-startup", m_benchmarkDir);
+    
+    m_runPerfSuite = parser.Found("perf-suite");
+    if (!m_runPerfSuite)
+        return true;
+    
+    wxFileName baseline(wxStandardPaths::Get().GetExecutablePath());
+    baseline.AppendDir("config");
+    baseline.SetFullName("perf_baseline.json");
+    m_perfOptions.baselinePath = baseline.GetFullPath();
+    parser.Found("perf-baseline", &m_perfOptions.baselinePath);
+    parser.Found("perf-output", &m_perfOptions.outputPath);
+    m_perfOptions.updateBaseline = parser.Found("perf-update");
+    
+    // 生成的测试文件也放在临时目录中，测试结束时删除
+    return UseTemporaryHome("lamlab-perf", m_perfOptions.workDir);
+}
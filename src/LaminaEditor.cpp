@@ -1,14 +1,94 @@
 #include "LaminaEditor.h"
 #include "ThemeConfig.h"
+#include "SessionStore.h"
+#include "EditJournal.h"
+#include "FileUtils.h"
+#include "LaminaFormatter.h"
+#include "ContentHash.h"
+#include "LineDiff.h"
+#include "ChangeGutter.h"
+#include "LintIndicators.h"
 #include <wx/file.h>
+#include <wx/filename.h>
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// 超过该大小的文件进入大文件模式：关闭词法分析和折叠，按原始字节放入文档
+static const wxFileOffset LARGE_FILE_BYTES = 32 * 1024 * 1024;
+
+// 存在超过该长度的行时自动换行显示
+static const size_t LONG_LINE_BYTES = 1024 * 1024;
+
+// 读入暂存区时每次读取的大小
+static const size_t LOAD_CHUNK_BYTES = 16 * 1024 * 1024;
+
+// 批量编辑超过该数量时合并为对整个范围的一次替换
+static const size_t COALESCE_EDIT_COUNT = 1000;
+
+// 行变更标记所在的边距（0 为行号，1 为折叠）
+static const int CHANGE_MARGIN = 2;
+
+// 压缩撤销历史时重新执行的一步：插入 text，或删除 deleteLength 个字节
+struct UndoReplayStep
+{
+    int position;
+    std::string text;
+    int deleteLength;
+};
+
+// Scintilla 为每个字符保存一个样式字节，每行保存行首位置、词法状态和折叠级别
+static const size_t LINE_INDEX_BYTES = sizeof(int);
+static const size_t LINE_STYLE_BYTES = 2 * sizeof(int);
+
+// 出现过标记后每行一个标记集合指针，每个标记另占一个节点
+static const size_t MARKER_BYTES = 3 * sizeof(int);
+
+// 统计最长行，current 为跨块延续的当前行长度
+static size_t ScanLongestLine(const char* data, size_t length, size_t& current)
+{
+    size_t longest = 0;
+    const char* end = data + length;
+    while (data < end)
+    {
+        const char* newline = static_cast<const char*>(memchr(data, '\n', end - data));
+        if (!newline)
+        {
+            current += end - data;
+            break;
+        }
+        current += newline - data;
+        longest = std::max(longest, current);
+        current = 0;
+        data = newline + 1;
+    }
+    return std::max(longest, current);
+}
 
 wxBEGIN_EVENT_TABLE(LaminaEditor, wxStyledTextCtrl)
     EVT_STC_CHANGE(wxID_ANY, LaminaEditor::OnTextChanged)
+    EVT_STC_MODIFIED(wxID_ANY, LaminaEditor::OnModified)
     EVT_STC_MARGINCLICK(wxID_ANY, LaminaEditor::OnMarginClick)
 wxEND_EVENT_TABLE()
 
 LaminaEditor::LaminaEditor(wxWindow* parent, wxWindowID id)
     : wxStyledTextCtrl(parent, id)
+    , m_journal(std::make_unique<EditJournal>())
+    , m_journalSuspended(false)
+    , m_largeFileMode(false)
+    , m_longLineMode(false)
+    , m_lineNumberDigits(0)
+    , m_changeCount(0)
+    , m_bulkEditing(false)
+    , m_diskHash(0)
+    , m_diskCheckRunning(false)
+    , m_diskCheckAgain(false)
+    , m_diskEditsHash(0)
+    , m_diskEditsChangeCount(0)
+    , m_undoBudget(0)
+    , m_undoCompactPending(false)
+    , m_undoCapture(nullptr)
 {
     // 基本编辑器设置
     SetTechnology(wxSTC_TECHNOLOGY_DEFAULT); // 使用默认渲染技术
@@ -19,12 +99,34 @@ LaminaEditor::LaminaEditor(wxWindow* parent, wxWindowID id)
     SetupEditorPreferences();
     SetupLaminaSyntax();
     
+    // 折叠边距右侧的行变更标记
+    m_changeGutter = std::make_unique<ChangeGutter>(this, CHANGE_MARGIN);
+    m_lint = std::make_unique<LintIndicators>(this);
+    
+    // 未命名文档同样记录日志
+    m_journal->Reset(wxEmptyString);
+    
     // 刷新显示
     Refresh();
 }
 
 LaminaEditor::~LaminaEditor()
 {
+    if (m_diskThread.joinable())
+        m_diskThread.join();
+}
+
+void LaminaEditor::SetLintCallback(std::function<void(const std::vector<int>& lines)> callback)
+{
+    m_lint->SetLinesCallback(callback);
+}
+
+// UTF-8 BOM 在载入时被去掉，比较时同样跳过
+static std::string_view SkipByteOrderMark(std::string_view data)
+{
+    if (data.size() >= 3 && data.compare(0, 3, "\xEF\xBB\xBF") == 0)
+        data.remove_prefix(3);
+    return data;
 }
 
 bool LaminaEditor::LoadFile(const wxString& filename)
@@ -33,14 +135,50 @@ bool LaminaEditor::LoadFile(const wxString& filename)
     if (!file.IsOpened())
         return false;
     
-    wxString content;
-    if (!file.ReadAll(&content))
+    wxFileOffset length = file.Length();
+    if (length < 0)
         return false;
     
-    SetText(content);
+    // 在分配之前拒绝，length + 1 转成 int 会溢出
+    if (IsFileTooLarge(length))
+        return false;
+    
+    // 先完整读入暂存区，读取失败时当前文档、模式和日志都保持不变
+    std::string bytes(static_cast<size_t>(length), '\0');
+    size_t offset = 0;
+    while (offset < bytes.size())
+    {
+        ssize_t read = file.Read(&bytes[offset], std::min(LOAD_CHUNK_BYTES, bytes.size() - offset));
+        if (read <= 0)
+            return false;
+        offset += read;
+    }
+    
+    // 先关闭词法分析再放入文档，避免对整个文档着色
+    if (length >= LARGE_FILE_BYTES)
+        SetLargeFileMode(true, false);
+    
+    m_journalSuspended = true;
+    SetTextFromBytes(bytes);
+    m_journalSuspended = false;
+    
+    size_t currentLine = 0;
+    size_t longestLine = ScanLongestLine(GetCharacterPointer(), GetTextLength(), currentLine);
+    
+    // 哈希磁盘上的原始字节，与编码转换无关
+    m_diskHash = ContentHash::Compute(SkipByteOrderMark(bytes));
+    m_diskEdits.reset();
+    
+    SetLargeFileMode(length >= LARGE_FILE_BYTES, longestLine >= LONG_LINE_BYTES);
+    UpdateLineNumberMargin();
+    
     m_currentFile = filename;
-    EmptyUndoBuffer();
+    RecordDiskStat();
+    ResetUndoHistory();
     SetSavePoint();
+    m_journal->Reset(filename);
+    m_changeGutter->ResetBaseline();
+    m_lint->Recheck();
     
     return true;
 }
@@ -51,16 +189,186 @@ bool LaminaEditor::SaveFile(const wxString& filename)
     if (!file.IsOpened())
         return false;
     
-    wxString content = GetText();
-    if (!file.Write(content))
+    // 直接写出 UTF-8 缓冲区，不经过 wxString 转换
+    size_t length = GetTextLength();
+    if (file.Write(GetCharacterPointer(), length) != length)
         return false;
+    file.Close();
     
     m_currentFile = filename;
     SetSavePoint();
+    m_diskHash = ContentHash::Compute(std::string_view(GetCharacterPointer(), length));
+    RecordDiskStat();
+    m_diskEdits.reset();
+    
+    // 内容已落盘，日志从新的磁盘文件重新开始
+    m_journal->Reset(filename);
+    m_changeGutter->ResetBaseline();
+    m_lint->Recheck();
     
     return true;
 }
 
+void LaminaEditor::NewDocument()
+{
+    m_journalSuspended = true;
+    ClearAll();
+    m_journalSuspended = false;
+    
+    m_currentFile.Clear();
+    ResetUndoHistory();
+    SetSavePoint();
+    m_journal->Reset(wxEmptyString);
+    m_changeGutter->ResetBaseline();
+    m_lint->Recheck();
+    m_diskHash = 0;
+    RecordDiskStat(true);
+    m_diskEdits.reset();
+    
+    SetLargeFileMode(false, false);
+    UpdateLineNumberMargin();
+}
+
+void LaminaEditor::SetLargeFileMode(bool largeFile, bool longLines)
+{
+    bool wasLargeFile = m_largeFileMode;
+    m_largeFileMode = largeFile;
+    m_longLineMode = longLines;
+    bool degraded = largeFile || longLines;
+    
+    // 词法分析与折叠需要从文档开头扫描，大文件中直接关闭
+    if (largeFile && !wasLargeFile)
+    {
+        SetLexer(wxSTC_LEX_NULL);
+        SetProperty("fold", "0");
+        SetMarginWidth(1, 0);
+    }
+    else if (!largeFile && wasLargeFile)
+    {
+        SetupLaminaSyntax();
+        SetProperty("fold", "1");
+        SetMarginWidth(1, 20);
+    }
+    
+    // 只为可见区域着色，并缓存整页的布局以便平滑滚动
+    SetIdleStyling(degraded ? wxSTC_IDLESTYLING_TOVISIBLE : wxSTC_IDLESTYLING_NONE);
+    SetLayoutCache(degraded ? wxSTC_CACHE_PAGE : wxSTC_CACHE_CARET);
+    SetCaretLineVisible(!degraded);
+    
+    // 超长行按字符自动换行显示
+    SetWrapMode(longLines ? wxSTC_WRAP_CHAR : wxSTC_WRAP_NONE);
+}
+
+void LaminaEditor::SetTextFromBytes(const std::string& bytes)
+{
+    if ((wxFileOffset)bytes.size() >= LARGE_FILE_BYTES)
+    {
+        ClearAll();
+        Allocate(bytes.size() + 1);
+        AppendTextRaw(bytes.data(), bytes.size());
+    }
+    else
+    {
+        SetText(wxString(bytes.data(), wxConvAuto(), bytes.size()));
+    }
+}
+
+void LaminaEditor::UpdateLineNumberMargin()
+{
+    // 行号边距宽度随行数位数变化
+    int digits = wxString::Format("%d", GetLineCount()).length();
+    if (digits == m_lineNumberDigits)
+        return;
+    
+    m_lineNumberDigits = digits;
+    SetMarginWidth(0, TextWidth(wxSTC_STYLE_LINENUMBER, wxString('9', std::max(digits, 3) + 1)));
+}
+
+bool LaminaEditor::RecoverFromJournal(const wxString& journalPath)
+{
+    JournalHeader header;
+    if (!EditJournal::ReadHeader(journalPath, header))
+        return false;
+    
+    std::string base;
+    if (!header.documentPath.IsEmpty() && !FileUtils::ReadBytes(header.documentPath, base))
+        base.clear();
+    
+    // 日志记录的是载入后的缓冲区，重放的基准必须以同样的方式解码
+    m_journalSuspended = true;
+    SetTextFromBytes(base);
+    
+    bool recovered = EditJournal::Replay(journalPath, [this](const JournalRecord& record) {
+        switch (record.type)
+        {
+        case JournalRecordType::Checkpoint:
+            ClearAll();
+            AppendTextRaw(record.data, record.length);
+            break;
+        case JournalRecordType::Insert:
+            SetTargetRange(record.position, record.position);
+            ReplaceTargetRaw(record.data, record.length);
+            break;
+        case JournalRecordType::Delete:
+            DeleteRange(record.position, record.length);
+            break;
+        }
+    });
+    m_journalSuspended = false;
+    
+    if (!recovered)
+    {
+        NewDocument();
+        return false;
+    }
+    
+    m_currentFile = header.documentPath;
+    m_diskHash = ContentHash::Compute(SkipByteOrderMark(base));
+    RecordDiskStat();
+    m_diskEdits.reset();
+    ResetUndoHistory();
+    
+    // 恢复的内容仍未保存，以检查点的形式重新写入日志
+    m_journal->Reset(m_currentFile);
+    m_journal->Checkpoint(std::string(GetCharacterPointer(), GetTextLength()));
+    m_changeGutter->ResetBaseline();
+    m_lint->Recheck();
+    
+    return true;
+}
+
+void LaminaEditor::SaveViewState(DocumentState& state)
+{
+    state.caretPos = GetCurrentPos();
+    state.anchorPos = GetAnchor();
+    state.firstVisibleLine = GetFirstVisibleLine();
+    
+    // 只遍历已折叠的行
+    state.foldedLines.clear();
+    for (int line = ContractedFoldNext(0); line >= 0; line = ContractedFoldNext(line + 1))
+        state.foldedLines.push_back(line);
+}
+
+void LaminaEditor::RestoreViewState(const DocumentState& state)
+{
+    if (!state.foldedLines.empty())
+    {
+        // 折叠级别由词法分析器生成，先分析到最后一个折叠行
+        int lastLine = std::min(state.foldedLines.back() + 1, GetLineCount() - 1);
+        Colourise(0, GetLineEndPosition(lastLine));
+        
+        for (int line : state.foldedLines)
+        {
+            if (line < GetLineCount() && (GetFoldLevel(line) & wxSTC_FOLDLEVELHEADERFLAG) && GetFoldExpanded(line))
+                ToggleFold(line);
+        }
+    }
+    
+    int length = GetTextLength();
+    SetSelection(std::min(state.anchorPos, length), std::min(state.caretPos, length));
+    SetFirstVisibleLine(state.firstVisibleLine);
+}
+
 bool LaminaEditor::IsModified() const
 {
     return GetModify();
@@ -90,7 +398,6 @@ void LaminaEditor::SetupEditorPreferences()
     SetProperty("fold.compact", "1");
     SetProperty("fold.comment", "1");
     
-    SetEditorStyles();
     SetMargins();
     SetFolding();
 }
@@ -109,17 +416,19 @@ void LaminaEditor::SetupLaminaSyntax()
     SetProperty("lexer.cpp.track.preprocessor", "0");
     
     SetLexerKeywords();
-    ApplyTheme();
+    
+    // 主题仍在后台解析时不等待，由主窗口在解析完成后应用
+    if (ThemeConfig::IsLoaded())
+        ApplyTheme();
 }
 
-void LaminaEditor::ApplyTheme(const wxString& themeName)
+size_t LaminaEditor::ApplyTheme(const wxString& themeName)
 {
     if (!themeName.IsEmpty())
     {
         ThemeConfig::Get().LoadTheme(themeName);
     }
-    SetLexerColors();
-    SetEditorStyles();
+    return ApplyStyles(ResolveStyles());
 }
 
 void LaminaEditor::SetLexerKeywords()
@@ -140,85 +449,114 @@ void LaminaEditor::SetLexerKeywords()
     SetKeyWords(2, keywords2);
 }
 
-void LaminaEditor::SetLexerColors()
+EditorStyleSet LaminaEditor::ResolveStyles() const
 {
     ThemeConfig& theme = ThemeConfig::Get();
-    // 应用默认样式
-    StyleClearAll();
-    // 首先设置默认风格
-    StyleSetBackground(wxSTC_STYLE_DEFAULT, theme.GetColor("default", "background"));
-    StyleSetForeground(wxSTC_STYLE_DEFAULT, theme.GetColor("default"));
-    SetWhitespaceBackground(true, theme.GetColor("default", "background"));
-    SetWhitespaceForeground(true, theme.GetColor("default"));
-    
-    // 设置选择区域的颜色
-    SetSelBackground(true, wxSystemSettings::GetColour(wxSYS_COLOUR_HIGHLIGHT));
-    SetSelForeground(true, wxSystemSettings::GetColour(wxSYS_COLOUR_HIGHLIGHTTEXT));
     
-    // 注释
-    StyleSetForeground(wxSTC_C_COMMENT, theme.GetColor("comments"));
-    StyleSetForeground(wxSTC_C_COMMENTLINE, theme.GetColor("comments"));
-    StyleSetItalic(wxSTC_C_COMMENT, theme.IsItalic("comments"));
-    StyleSetItalic(wxSTC_C_COMMENTLINE, theme.IsItalic("comments"));
+    // 未单独设置的样式都与默认样式相同
+    EditorStyle base;
+    base.foreground = theme.GetColor("default");
+    base.background = theme.GetColor("default", "background");
     
-    // 控制关键字
-    StyleSetForeground(wxSTC_C_WORD, theme.GetColor("keywords"));
-    StyleSetBold(wxSTC_C_WORD, theme.IsBold("keywords", "control"));
+    EditorStyleSet set;
+    set.styles.assign(wxSTC_STYLE_MAX + 1, base);
+    set.caretLine = theme.GetColor("currentLine", "background");
     
-    // 数据类型
-    StyleSetForeground(wxSTC_C_WORD2, theme.GetColor("keywords", "types"));
-    StyleSetBold(wxSTC_C_WORD2, theme.IsBold("keywords", "types"));
+    auto style = [&](int number, const wxColour& foreground, bool bold = false, bool italic = false) -> EditorStyle& {
+        EditorStyle& entry = set.styles[number];
+        entry.foreground = foreground;
+        entry.bold = bold;
+        entry.italic = italic;
+        return entry;
+    };
     
-    // 字符串
-    StyleSetForeground(wxSTC_C_STRING, theme.GetColor("strings"));
+    // 注释
+    style(wxSTC_C_COMMENT, theme.GetColor("comments"), false, theme.IsItalic("comments"));
+    style(wxSTC_C_COMMENTLINE, theme.GetColor("comments"), false, theme.IsItalic("comments"));
     
-    // 数字
-    StyleSetForeground(wxSTC_C_NUMBER, theme.GetColor("numbers"));
+    // 控制关键字与数据类型
+    style(wxSTC_C_WORD, theme.GetColor("keywords"), theme.IsBold("keywords", "control"));
+    style(wxSTC_C_WORD2, theme.GetColor("keywords", "types"), theme.IsBold("keywords", "types"));
     
-    // 运算符
-    StyleSetForeground(wxSTC_C_OPERATOR, theme.GetColor("operators"));
-    StyleSetBold(wxSTC_C_OPERATOR, theme.IsBold("operators"));
+    // 字符串、数字、运算符
+    style(wxSTC_C_STRING, theme.GetColor("strings"));
+    style(wxSTC_C_NUMBER, theme.GetColor("numbers"));
+    style(wxSTC_C_OPERATOR, theme.GetColor("operators"), theme.IsBold("operators"));
     
     // 特殊常量
-    StyleSetForeground(wxSTC_C_GLOBALCLASS, theme.GetColor("constants"));
-    StyleSetBold(wxSTC_C_GLOBALCLASS, theme.IsBold("constants"));
+    style(wxSTC_C_GLOBALCLASS, theme.GetColor("constants"), theme.IsBold("constants"));
     
-    // 函数名
-    StyleSetForeground(wxSTC_C_IDENTIFIER, theme.GetColor("functions"));
+    // 标识符（函数名没有单独的词法样式，与标识符共用）
+    style(wxSTC_C_IDENTIFIER, theme.GetColor("identifiers"));
     
-    // 标识符
-    StyleSetForeground(wxSTC_C_IDENTIFIER, theme.GetColor("identifiers"));
+    // 行号与缩进参考线
+    style(wxSTC_STYLE_LINENUMBER, theme.GetColor("linenumber")).background = theme.GetColor("linenumber", "background");
+    style(wxSTC_STYLE_INDENTGUIDE, theme.GetColor("linenumber"));
+    
+    // 大括号匹配
+    style(wxSTC_STYLE_BRACELIGHT, theme.GetColor("braceMatch"), theme.IsBold("braceMatch")).background =
+        theme.GetColor("braceMatch", "background");
+    style(wxSTC_STYLE_BRACEBAD, theme.GetColor("braceMismatch"), theme.IsBold("braceMismatch")).background =
+        theme.GetColor("braceMismatch", "background");
+    
+    return set;
 }
 
-void LaminaEditor::SetEditorStyles()
+size_t LaminaEditor::ApplyStyles(const EditorStyleSet& styles)
 {
-    ThemeConfig& theme = ThemeConfig::Get();
+    const EditorStyle& base = styles.styles[wxSTC_STYLE_DEFAULT];
     
-    // 行号样式
-    StyleSetForeground(wxSTC_STYLE_LINENUMBER, theme.GetColor("linenumber"));
-    StyleSetBackground(wxSTC_STYLE_LINENUMBER, theme.GetColor("linenumber", "background"));
-    
-    // 折叠标记样式
-    StyleSetForeground(wxSTC_STYLE_INDENTGUIDE, theme.GetColor("linenumber"));
+    // 主题不包含字体和字号，只有第一次应用时需要 StyleClearAll 把默认样式复制到所有样式。
+    // 之后每次 StyleSet* 都会让 Scintilla 重新计算样式和布局，因此只设置变化的属性
+    bool full = m_appliedStyles.styles.size() != styles.styles.size();
+    if (full)
+    {
+        StyleSetForeground(wxSTC_STYLE_DEFAULT, base.foreground);
+        StyleSetBackground(wxSTC_STYLE_DEFAULT, base.background);
+        StyleClearAll();
+        
+        // 选择区域跟随系统颜色
+        SetSelBackground(true, wxSystemSettings::GetColour(wxSYS_COLOUR_HIGHLIGHT));
+        SetSelForeground(true, wxSystemSettings::GetColour(wxSYS_COLOUR_HIGHLIGHTTEXT));
+    }
     
-    // 当前行高亮
-    SetCaretLineBackground(theme.GetColor("currentLine", "background"));
+    size_t changed = 0;
+    for (int number = 0; number < (int)styles.styles.size(); ++number)
+    {
+        // 第一次应用时所有样式刚从默认样式复制而来
+        const EditorStyle& style = styles.styles[number];
+        const EditorStyle& current = full ? base : m_appliedStyles.styles[number];
+        if (style == current)
+            continue;
+        
+        ++changed;
+        if (style.foreground != current.foreground)
+            StyleSetForeground(number, style.foreground);
+        if (style.background != current.background)
+            StyleSetBackground(number, style.background);
+        if (style.bold != current.bold)
+            StyleSetBold(number, style.bold);
+        if (style.italic != current.italic)
+            StyleSetItalic(number, style.italic);
+    }
     
-    // 大括号匹配
-    StyleSetForeground(wxSTC_STYLE_BRACELIGHT, theme.GetColor("braceMatch"));
-    StyleSetBackground(wxSTC_STYLE_BRACELIGHT, theme.GetColor("braceMatch", "background"));
-    StyleSetBold(wxSTC_STYLE_BRACELIGHT, theme.IsBold("braceMatch"));
+    if (full || base != m_appliedStyles.styles[wxSTC_STYLE_DEFAULT])
+    {
+        SetWhitespaceBackground(true, base.background);
+        SetWhitespaceForeground(true, base.foreground);
+    }
+    if (full || styles.caretLine != m_appliedStyles.caretLine)
+        SetCaretLineBackground(styles.caretLine);
     
-    StyleSetForeground(wxSTC_STYLE_BRACEBAD, theme.GetColor("braceMismatch"));
-    StyleSetBackground(wxSTC_STYLE_BRACEBAD, theme.GetColor("braceMismatch", "background"));
-    StyleSetBold(wxSTC_STYLE_BRACEBAD, theme.IsBold("braceMismatch"));
+    m_appliedStyles = styles;
+    return full ? styles.styles.size() : changed;
 }
 
 void LaminaEditor::SetMargins()
 {
     // 行号边距
     SetMarginType(0, wxSTC_MARGIN_NUMBER);
-    SetMarginWidth(0, 50);
+    UpdateLineNumberMargin();
     SetMarginSensitive(0, false);
     
     // 折叠边距
@@ -251,12 +589,414 @@ void LaminaEditor::SetFolding()
 
 void LaminaEditor::OnTextChanged(wxStyledTextEvent& event)
 {
+    // 批量编辑结束后统一通知一次
+    if (m_bulkEditing)
+        return;
+    
     if (m_changeCallback)
         m_changeCallback();
     
     event.Skip();
 }
 
+void LaminaEditor::ApplyEdits(const std::vector<TextEdit>& edits, bool coalesce)
+{
+    if (edits.empty())
+        return;
+    
+    size_t caret = BulkEdit::MapPosition(edits, GetCurrentPos());
+    size_t anchor = BulkEdit::MapPosition(edits, GetAnchor());
+    size_t firstVisible = BulkEdit::MapPosition(edits, PositionFromLine(DocLineFromVisible(GetFirstVisibleLine())));
+    
+    // 期间只保留插入和删除通知（崩溃恢复日志需要），样式等其他通知暂停
+    int eventMask = GetModEventMask();
+    SetModEventMask(wxSTC_MOD_INSERTTEXT | wxSTC_MOD_DELETETEXT);
+    m_bulkEditing = true;
+    BeginUndoAction();
+    
+    if (coalesce && edits.size() >= COALESCE_EDIT_COUNT)
+    {
+        // 编辑很多时，在后台生成的编辑基础上拼出整个范围的新内容，一次替换
+        size_t begin = edits.front().start;
+        size_t end = edits.back().start + edits.back().length;
+        std::string_view text(GetCharacterPointer(), GetTextLength());
+        std::string replaced = BulkEdit::Apply(text, edits, begin, end);
+        
+        SetTargetRange(begin, end);
+        ReplaceTargetRaw(replaced.data(), replaced.size());
+    }
+    else
+    {
+        // 从后往前应用，前面编辑的位置不受影响
+        for (auto it = edits.rbegin(); it != edits.rend(); ++it)
+        {
+            SetTargetRange(it->start, it->start + it->length);
+            ReplaceTargetRaw(it->text.data(), it->text.size());
+        }
+    }
+    
+    EndUndoAction();
+    m_bulkEditing = false;
+    SetModEventMask(eventMask);
+    
+    // 保持光标与滚动位置
+    SetAnchor(anchor);
+    SetCurrentPos(caret);
+    SetFirstVisibleLine(VisibleFromDocLine(LineFromPosition(firstVisible)));
+    
+    // 合并后的一次变化通知
+    wxStyledTextEvent changeEvent(wxEVT_STC_CHANGE, GetId());
+    changeEvent.SetEventObject(this);
+    GetEventHandler()->ProcessEvent(changeEvent);
+}
+
+void LaminaEditor::CheckDiskChange()
+{
+    if (m_currentFile.IsEmpty())
+        return;
+    
+    // 同一时间只运行一次检查，期间的通知合并为检查结束后的再一次检查
+    if (m_diskCheckRunning)
+    {
+        m_diskCheckAgain = true;
+        return;
+    }
+    if (m_diskThread.joinable())
+        m_diskThread.join();
+    
+    std::string text(GetCharacterPointer(), GetTextLength());
+    wxString path = m_currentFile;
+    uint64_t knownHash = m_diskHash;
+    unsigned long changeCount = m_changeCount;
+    m_diskCheckRunning = true;
+    
+    m_diskThread = std::thread([this, text = std::move(text), path, knownHash, changeCount]() {
+        std::string bytes;
+        std::shared_ptr<std::vector<TextEdit>> edits;
+        uint64_t hash = knownHash;
+        
+        // 只是被 touch 或写入了相同内容时哈希不变，不做任何事
+        if (FileUtils::ReadBytes(path, bytes))
+        {
+            std::string_view content = SkipByteOrderMark(bytes);
+            hash = ContentHash::Compute(content);
+            if (hash != knownHash)
+                edits = std::make_shared<std::vector<TextEdit>>(LineDiff::Compute(text, content));
+        }
+        
+        CallAfter([this, edits, hash, changeCount]() { FinishDiskCheck(edits, hash, changeCount); });
+    });
+}
+
+void LaminaEditor::FinishDiskCheck(std::shared_ptr<std::vector<TextEdit>> edits, uint64_t hash, unsigned long changeCount)
+{
+    m_diskCheckRunning = false;
+    if (m_diskThread.joinable())
+        m_diskThread.join();
+    
+    if (m_diskCheckAgain)
+    {
+        m_diskCheckAgain = false;
+        CheckDiskChange();
+        return;
+    }
+    
+    if (!edits)
+        return;
+    
+    m_diskEdits = edits;
+    m_diskEditsHash = hash;
+    m_diskEditsChangeCount = changeCount;
+    
+    if (m_diskChangeCallback)
+        m_diskChangeCallback();
+}
+
+bool LaminaEditor::ApplyDiskChange()
+{
+    if (!m_diskEdits)
+        return false;
+    
+    // 差异计算期间文档又被编辑过，重新计算
+    if (m_diskEditsChangeCount != m_changeCount)
+    {
+        m_diskEdits.reset();
+        CheckDiskChange();
+        return false;
+    }
+    
+    std::shared_ptr<std::vector<TextEdit>> edits = m_diskEdits;
+    m_diskEdits.reset();
+    
+    // 逐处应用，不合并为整体替换，其余部分的折叠和标记不受影响
+    ApplyEdits(*edits, false);
+    SetSavePoint();
+    m_diskHash = m_diskEditsHash;
+    // 差异计算之后文件可能又被修改，下次检查比较哈希
+    RecordDiskStat(true);
+    m_journal->Reset(m_currentFile);
+    m_changeGutter->ResetBaseline();
+    m_lint->Recheck();
+    return true;
+}
+
+void LaminaEditor::DiscardDiskChange()
+{
+    if (!m_diskEdits)
+        return;
+    
+    m_diskEdits.reset();
+    m_diskHash = m_diskEditsHash;
+    // 差异计算之后文件可能又被修改，下次检查比较哈希
+    RecordDiskStat(true);
+}
+
+void LaminaEditor::RecordDiskStat(bool clear)
+{
+    m_diskSize = wxInvalidSize;
+    m_diskModified = wxInvalidDateTime;
+    if (clear || m_currentFile.IsEmpty())
+        return;
+    
+    wxFileName name(m_currentFile);
+    m_diskSize = wxFileName::GetSize(m_currentFile);
+    m_diskModified = name.GetModificationTime();
+}
+
+bool LaminaEditor::IsDiskContentChanged(bool changeReported) const
+{
+    // 先比较大小和修改时间，只有它们变化或收到过变化通知时才读取整个文件
+    if (!changeReported && !m_diskEdits && !m_currentFile.IsEmpty() && m_diskModified.IsValid()
+        && wxFileName::GetSize(m_currentFile) == m_diskSize
+        && wxFileName(m_currentFile).GetModificationTime() == m_diskModified)
+        return false;
+    
+    std::string bytes;
+    if (m_currentFile.IsEmpty() || !FileUtils::ReadBytes(m_currentFile, bytes))
+        return false;
+    
+    return ContentHash::Compute(SkipByteOrderMark(bytes)) != m_diskHash;
+}
+
+void LaminaEditor::FormatDocument()
+{
+    FormatLines(0, GetLineCount() - 1);
+}
+
+void LaminaEditor::FormatSelection()
+{
+    FormatLines(LineFromPosition(GetSelectionStart()), LineFromPosition(GetSelectionEnd()));
+}
+
+void LaminaEditor::FormatLines(size_t firstLine, size_t lastLine)
+{
+    FormatOptions options;
+    options.indentWidth = GetIndent() > 0 ? GetIndent() : GetTabWidth();
+    options.useTabs = GetUseTabs();
+    
+    // 只应用改变的行，撤销历史、折叠和标记都得以保留
+    std::string_view text(GetCharacterPointer(), GetTextLength());
+    ApplyEdits(LaminaFormatter::Format(text, options, firstLine, lastLine), false);
+}
+
+void LaminaEditor::ResetUndoHistory()
+{
+    EmptyUndoBuffer();
+    m_undoLedger.Reset();
+}
+
+// 同一行内连续输入的两组：前一组只插入了一段不以换行结束的文本，后一组紧接着插入
+static bool IsTypingContinuation(const std::vector<UndoReplayStep>& previous, const std::vector<UndoReplayStep>& next)
+{
+    if (previous.size() != 1 || next.size() != 1)
+        return false;
+    
+    const UndoReplayStep& first = previous.front();
+    const UndoReplayStep& second = next.front();
+    return first.deleteLength == 0 && second.deleteLength == 0 && !first.text.empty()
+        && first.text.back() != '\n' && second.position == first.position + (int)first.text.size();
+}
+
+void LaminaEditor::CompactUndoHistory()
+{
+    m_undoCompactPending = false;
+    
+    // 还可以重做时不压缩，等下一次编辑
+    if (m_undoBudget == 0 || m_undoLedger.GetRedoCount() > 0 || m_undoLedger.GetUndoBytes() <= m_undoBudget)
+        return;
+    
+    // Scintilla 不能只丢弃最旧的撤销步骤：先撤销要保留的几组并记下它们，
+    // 清空撤销缓冲区后重新执行。文档内容最终不变，期间不写日志也不发变化通知
+    size_t keep = m_undoLedger.GroupsToKeep(m_undoBudget);
+    bool modified = GetModify();
+    int caret = GetCurrentPos();
+    int anchor = GetAnchor();
+    int firstVisible = GetFirstVisibleLine();
+    unsigned long changeCount = m_changeCount;
+    
+    Freeze();
+    m_journalSuspended = true;
+    m_bulkEditing = true;
+    
+    // 保存点落在保留的历史中时，记下它在重新执行第几组之后
+    size_t savedAfter = modified ? SIZE_MAX : keep;
+    
+    // 按撤销的顺序记录，即从最新的组到最旧的组、组内从最后一步到第一步
+    std::vector<std::vector<UndoReplayStep>> undone(keep);
+    for (size_t i = 0; i < keep; ++i)
+    {
+        m_undoCapture = &undone[i];
+        Undo();
+        if (savedAfter == SIZE_MAX && !GetModify())
+            savedAfter = keep - i - 1;
+    }
+    m_undoCapture = nullptr;
+    ResetUndoHistory();
+    
+    // 从最旧的组开始重新执行，同一行内连续输入的组合并为一组，但不跨过保存点
+    std::vector<std::vector<UndoReplayStep>> replay;
+    size_t savedReplay = savedAfter == 0 ? 0 : SIZE_MAX;
+    size_t applied = 0;
+    for (auto group = undone.rbegin(); group != undone.rend(); ++group)
+    {
+        if (!group->empty())
+        {
+            std::reverse(group->begin(), group->end());
+            if (!replay.empty() && applied != savedAfter && IsTypingContinuation(replay.back(), *group))
+                replay.back().front().text += group->front().text;
+            else
+                replay.push_back(std::move(*group));
+        }
+        if (++applied == savedAfter)
+            savedReplay = replay.size();
+    }
+    
+    if (savedReplay == 0)
+        SetSavePoint();
+    for (size_t i = 0; i < replay.size(); ++i)
+    {
+        BeginUndoAction();
+        for (const UndoReplayStep& step : replay[i])
+        {
+            if (step.deleteLength > 0)
+            {
+                DeleteRange(step.position, step.deleteLength);
+            }
+            else
+            {
+                SetTargetRange(step.position, step.position);
+                ReplaceTargetRaw(step.text.data(), step.text.size());
+            }
+        }
+        EndUndoAction();
+        if (i + 1 == savedReplay)
+            SetSavePoint();
+    }
+    
+    m_bulkEditing = false;
+    m_journalSuspended = false;
+    m_changeCount = changeCount;
+    
+    SetAnchor(anchor);
+    SetCurrentPos(caret);
+    SetFirstVisibleLine(firstVisible);
+    Thaw();
+}
+
+EditorMemoryUsage LaminaEditor::GetMemoryUsage()
+{
+    EditorMemoryUsage usage;
+    size_t length = GetTextLength();
+    size_t lines = GetLineCount();
+    usage.text = length + lines * LINE_INDEX_BYTES;
+    usage.styles = length + lines * LINE_STYLE_BYTES;
+    usage.undo = m_undoLedger.GetTotalBytes();
+    
+    // 只遍历有标记的行
+    size_t markers = 0;
+    for (int line = MarkerNext(0, ~0); line >= 0; line = MarkerNext(line + 1, ~0))
+    {
+        for (unsigned mask = MarkerGet(line); mask != 0; mask &= mask - 1)
+            ++markers;
+    }
+    if (markers > 0)
+        usage.markers = lines * sizeof(void*) + markers * MARKER_BYTES;
+    
+    return usage;
+}
+
+void LaminaEditor::OnModified(wxStyledTextEvent& event)
+{
+    int type = event.GetModificationType();
+    if (type & (wxSTC_MOD_INSERTTEXT | wxSTC_MOD_DELETETEXT))
+    {
+        ++m_changeCount;
+        
+        // 账本跟随撤销缓冲区：每组的第一步带有 STARTACTION，撤销和重做在最后一步移动位置
+        if ((type & wxSTC_PERFORMED_USER) && GetUndoCollection())
+        {
+            if (type & wxSTC_STARTACTION)
+                m_undoLedger.BeginGroup();
+            m_undoLedger.AddStep(event.GetLength());
+            
+            // 通知期间不能修改文档，稍后压缩
+            if (m_undoBudget > 0 && !m_undoCompactPending && m_undoLedger.GetUndoBytes() > m_undoBudget)
+            {
+                m_undoCompactPending = true;
+                CallAfter(&LaminaEditor::CompactUndoHistory);
+            }
+        }
+        else if (type & wxSTC_LASTSTEPINUNDOREDO)
+        {
+            if (type & wxSTC_PERFORMED_UNDO)
+                m_undoLedger.Undo();
+            else
+                m_undoLedger.Redo();
+        }
+    }
+    
+    // 压缩撤销历史时记录被撤销的步骤：撤销删掉的文本重新执行时插入，撤销插入的文本重新执行时删除
+    if (m_undoCapture && (type & wxSTC_PERFORMED_UNDO))
+    {
+        int position = event.GetPosition();
+        int length = event.GetLength();
+        if (type & wxSTC_MOD_BEFOREDELETE)
+        {
+            wxCharBuffer text = GetTextRangeRaw(position, position + length);
+            m_undoCapture->push_back({ position, std::string(text.data(), length), 0 });
+        }
+        else if (type & wxSTC_MOD_INSERTTEXT)
+        {
+            m_undoCapture->push_back({ position, std::string(), length });
+        }
+    }
+    
+    if (!m_journalSuspended && (type & (wxSTC_MOD_INSERTTEXT | wxSTC_MOD_DELETETEXT)))
+    {
+        int position = event.GetPosition();
+        int length = event.GetLength();
+        
+        // 只记录变化的部分，开销与编辑量成正比而与文档大小无关
+        if (type & wxSTC_MOD_INSERTTEXT)
+        {
+            wxCharBuffer text = GetTextRangeRaw(position, position + length);
+            m_journal->RecordInsert(position, text.data(), length);
+        }
+        else
+        {
+            m_journal->RecordDelete(position, length);
+        }
+        
+        if (m_journal->NeedsCheckpoint(GetTextLength()))
+            m_journal->Checkpoint(std::string(GetCharacterPointer(), GetTextLength()));
+    }
+    
+    if (event.GetLinesAdded() != 0)
+        UpdateLineNumberMargin();
+    
+    event.Skip();
+}
+
 void LaminaEditor::OnMarginClick(wxStyledTextEvent& event)
 {
     if (event.GetMargin() == 1)
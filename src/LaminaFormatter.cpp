@@ -0,0 +1,350 @@
+#include "LaminaFormatter.h"
+#include "LaminaLexer.h"
+#include <algorithm>
+#include <iterator>
+
+// 两侧各留一个空格的二元运算符
+static const std::string_view BINARY_OPERATORS[] = {
+    "=", "==", "!=", "<", ">", "<=", ">=", "+", "-", "*", "/", "%", "^", "**",
+    "&&", "||", "+=", "-=", "*=", "/=", "->"
+};
+
+// 运算符在上下文中的角色，决定两侧的空格
+enum class OperatorRole
+{
+    None,       // 不是运算符
+    Binary,
+    Unary,
+    Tight,      // 成员访问 "."，两侧不留空格
+    Other       // 无法确定（如 "++"、"?"、":"），保留原样
+};
+
+// 格式化单元：一个记号，或紧挨着的一串运算符（如 "=" ">"）
+struct FormatItem
+{
+    TokenKind kind;
+    size_t start;
+    size_t end;             // 跨行注释截止到本行末尾
+    std::string_view text;
+    OperatorRole role;
+};
+
+// 一个或多个合并后的行的格式化结果，写出时与原文比较生成编辑
+struct PendingLine
+{
+    bool active = false;
+    size_t line = 0;
+    size_t start = 0;
+    size_t end = 0;
+    std::string text;
+    bool closeBraceOnly = false;    // 整行只有 "}"，可与下一行的 else 合并
+    bool joinableBrace = false;     // 行尾可以接上下一行单独的 "{"
+};
+
+static bool IsBinaryOperator(std::string_view op)
+{
+    return std::find(std::begin(BINARY_OPERATORS), std::end(BINARY_OPERATORS), op) != std::end(BINARY_OPERATORS);
+}
+
+static bool EndsOperand(const FormatItem& item)
+{
+    switch (item.kind)
+    {
+    case TokenKind::Identifier:
+    case TokenKind::Number:
+    case TokenKind::String:
+    case TokenKind::RightParen:
+    case TokenKind::RightBracket:
+    case TokenKind::RightBrace:
+        return true;
+    case TokenKind::Keyword:
+        return item.text == "true" || item.text == "false" || item.text == "null";
+    default:
+        return false;
+    }
+}
+
+static OperatorRole GetRole(const FormatItem* previous, const FormatItem& item)
+{
+    if (item.kind != TokenKind::Operator)
+        return OperatorRole::None;
+    if (item.text == ".")
+        return OperatorRole::Tight;
+    if (item.text == "!")
+        return OperatorRole::Unary;
+    if ((item.text == "-" || item.text == "+") && (!previous || !EndsOperand(*previous)))
+        return OperatorRole::Unary;
+    if (IsBinaryOperator(item.text))
+        return OperatorRole::Binary;
+    return OperatorRole::Other;
+}
+
+// 行是否为 if (...)、func f(...)、} else 等语句块的开头，可以接上下一行单独的 "{"
+static bool EndsBlockHeader(const std::vector<FormatItem>& items)
+{
+    if (items.empty() || (items.front().kind != TokenKind::Keyword && items.front().kind != TokenKind::RightBrace))
+        return false;
+
+    const FormatItem& last = items.back();
+    return last.kind == TokenKind::RightParen || (last.kind == TokenKind::Keyword && last.text == "else");
+}
+
+static bool IsOpener(TokenKind kind)
+{
+    return kind == TokenKind::LeftParen || kind == TokenKind::LeftBracket || kind == TokenKind::LeftBrace;
+}
+
+static bool IsCloser(TokenKind kind)
+{
+    return kind == TokenKind::RightParen || kind == TokenKind::RightBracket || kind == TokenKind::RightBrace;
+}
+
+// 两个单元之间的空格数，-1 表示保留原来的空白
+static int GetSpacing(const FormatItem& a, const FormatItem& b, size_t originalGap)
+{
+    if (b.kind == TokenKind::Comment)
+        return originalGap > 0 ? -1 : 1;
+    if (b.kind == TokenKind::Comma || b.kind == TokenKind::Semicolon)
+        return 0;
+    if (a.kind == TokenKind::LeftParen || a.kind == TokenKind::LeftBracket)
+        return 0;
+    if (b.kind == TokenKind::RightParen || b.kind == TokenKind::RightBracket)
+        return 0;
+    if (a.kind == TokenKind::Comma || a.kind == TokenKind::Semicolon)
+        return 1;
+
+    switch (a.role)
+    {
+    case OperatorRole::Unary:
+    case OperatorRole::Tight:
+        return 0;
+    case OperatorRole::Binary:
+        return 1;
+    case OperatorRole::Other:
+        return -1;
+    default:
+        break;
+    }
+
+    switch (b.role)
+    {
+    case OperatorRole::Tight:
+        return 0;
+    case OperatorRole::Binary:
+        return 1;
+    case OperatorRole::Unary:
+    case OperatorRole::Other:
+        return -1;
+    default:
+        break;
+    }
+
+    if (b.kind == TokenKind::LeftBrace)
+        return 1;
+    if (a.kind == TokenKind::RightBrace && (b.kind == TokenKind::Keyword || b.kind == TokenKind::Identifier))
+        return 1;
+
+    if (b.kind == TokenKind::LeftParen)
+    {
+        // if (...) 与函数调用 f(...) 区分开
+        if (a.kind == TokenKind::Keyword && (a.text == "if" || a.text == "while" || a.text == "for"))
+            return 1;
+        if (a.kind == TokenKind::Identifier || a.kind == TokenKind::RightParen || a.kind == TokenKind::RightBracket)
+            return 0;
+        return -1;
+    }
+
+    if (b.kind == TokenKind::LeftBracket)
+    {
+        if (a.kind == TokenKind::Identifier || a.kind == TokenKind::RightParen ||
+            a.kind == TokenKind::RightBracket || a.kind == TokenKind::String)
+            return 0;
+        return -1;
+    }
+
+    // 其余相邻单元之间的多个空格压缩为一个
+    return originalGap > 0 ? 1 : -1;
+}
+
+static void TrimRight(std::string& text)
+{
+    size_t end = text.find_last_not_of(" \t");
+    text.erase(end == std::string::npos ? 0 : end + 1);
+}
+
+// 与原文比较，只替换首尾相同部分之间的内容
+static void FlushLine(std::string_view source, PendingLine& pending, std::vector<TextEdit>& edits)
+{
+    if (!pending.active)
+        return;
+    pending.active = false;
+
+    std::string_view original = source.substr(pending.start, pending.end - pending.start);
+    if (original == pending.text)
+        return;
+
+    size_t limit = std::min(original.size(), pending.text.size());
+    size_t prefix = 0;
+    while (prefix < limit && original[prefix] == pending.text[prefix])
+        ++prefix;
+
+    size_t suffix = 0;
+    while (suffix < limit - prefix &&
+           original[original.size() - 1 - suffix] == pending.text[pending.text.size() - 1 - suffix])
+        ++suffix;
+
+    edits.push_back(TextEdit{ pending.start + prefix, original.size() - prefix - suffix,
+                              pending.text.substr(prefix, pending.text.size() - prefix - suffix) });
+}
+
+std::vector<TextEdit> LaminaFormatter::Format(std::string_view source, const FormatOptions& options,
+                                              size_t firstLine, size_t lastLine)
+{
+    std::vector<TextEdit> edits;
+    std::vector<FormatItem> items;
+    PendingLine pending;
+    std::string text;
+
+    LaminaLexer lexer(source);
+    LaminaToken token;
+    bool hasToken = lexer.Next(token);
+
+    int depth = 0;
+    size_t continuationEnd = 0;     // 跨行注释覆盖到的最后一行
+    size_t lineStart = 0;
+
+    for (size_t line = 0; line <= lastLine; ++line)
+    {
+        size_t newline = source.find('\n', lineStart);
+        size_t lineEnd = newline == std::string_view::npos ? source.size() : newline;
+        size_t contentEnd = (lineEnd > lineStart && source[lineEnd - 1] == '\r') ? lineEnd - 1 : lineEnd;
+        bool continued = line > 0 && line <= continuationEnd;
+
+        // 本行的记号合并为格式化单元，同时计算括号层级
+        items.clear();
+        int indent = depth;
+        bool verbatim = false;      // 含无法识别的记号时只调整缩进
+        while (hasToken && token.line == line)
+        {
+            size_t tokenEnd = token.start + token.length;
+            if (tokenEnd > lineEnd)
+            {
+                continuationEnd = line + std::count(source.begin() + token.start, source.begin() + tokenEnd, '\n');
+                tokenEnd = contentEnd;
+            }
+
+            if (items.empty() && IsCloser(token.kind))
+                indent = std::max(depth - 1, 0);
+            if (IsOpener(token.kind))
+                ++depth;
+            else if (IsCloser(token.kind))
+                depth = std::max(depth - 1, 0);
+
+            if (token.kind == TokenKind::Unknown ||
+                (token.kind == TokenKind::String && (token.length < 2 || source[tokenEnd - 1] != '"')))
+                verbatim = true;
+
+            if (token.kind == TokenKind::Operator && !items.empty() &&
+                items.back().kind == TokenKind::Operator && items.back().end == token.start)
+            {
+                FormatItem& run = items.back();
+                run.end = tokenEnd;
+                run.text = source.substr(run.start, run.end - run.start);
+            }
+            else
+            {
+                items.push_back(FormatItem{ token.kind, token.start, tokenEnd,
+                                            source.substr(token.start, tokenEnd - token.start), OperatorRole::None });
+            }
+
+            hasToken = lexer.Next(token);
+        }
+
+        if (continued || line < firstLine)
+        {
+            // 注释内部的行与范围外的行保持原样
+            FlushLine(source, pending, edits);
+        }
+        else
+        {
+            text.clear();
+            if (!items.empty())
+            {
+                if (options.useTabs)
+                    text.append(indent, '\t');
+                else
+                    text.append(indent * options.indentWidth, ' ');
+
+                if (verbatim)
+                {
+                    text.append(source.substr(items.front().start, items.back().end - items.front().start));
+                }
+                else
+                {
+                    for (size_t i = 0; i < items.size(); ++i)
+                    {
+                        items[i].role = GetRole(i > 0 ? &items[i - 1] : nullptr, items[i]);
+                        if (i > 0)
+                        {
+                            size_t gap = items[i].start - items[i - 1].end;
+                            int spacing = GetSpacing(items[i - 1], items[i], gap);
+                            if (spacing < 0)
+                                text.append(source.substr(items[i - 1].end, gap));
+                            else
+                                text.append(spacing, ' ');
+                        }
+                        text.append(items[i].text);
+                    }
+                }
+                TrimRight(text);
+            }
+
+            bool adjacent = pending.active && pending.line + 1 == line && !verbatim;
+            bool braceOnly = items.size() == 1 && items[0].kind == TokenKind::LeftBrace;
+            bool startsWithElse = !items.empty() && items[0].kind == TokenKind::Keyword && items[0].text == "else";
+
+            if (adjacent && braceOnly && pending.joinableBrace)
+            {
+                // 单独一行的 "{" 接到上一行末尾
+                pending.text += " {";
+                pending.end = contentEnd;
+                pending.line = line;
+                pending.closeBraceOnly = false;
+                pending.joinableBrace = false;
+            }
+            else if (adjacent && startsWithElse && pending.closeBraceOnly)
+            {
+                // "}" 与下一行的 else 合并为 "} else"
+                pending.text += ' ';
+                pending.text.append(text, text.find_first_not_of(" \t"), std::string::npos);
+                pending.end = contentEnd;
+                pending.line = line;
+                pending.closeBraceOnly = false;
+                pending.joinableBrace = EndsBlockHeader(items);
+            }
+            else
+            {
+                FlushLine(source, pending, edits);
+                pending.active = true;
+                pending.line = line;
+                pending.start = lineStart;
+                pending.end = contentEnd;
+                pending.text = text;
+                pending.closeBraceOnly = items.size() == 1 && items[0].kind == TokenKind::RightBrace;
+                pending.joinableBrace = !verbatim && EndsBlockHeader(items);
+            }
+        }
+
+        if (newline == std::string_view::npos)
+            break;
+        lineStart = newline + 1;
+    }
+
+    FlushLine(source, pending, edits);
+    return edits;
+}
+
+std::string LaminaFormatter::FormatText(std::string_view source, const FormatOptions& options)
+{
+    return BulkEdit::Apply(source, Format(source, options));
+}
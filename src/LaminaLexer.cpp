@@ -0,0 +1,179 @@
+#include "LaminaLexer.h"
+#include <algorithm>
+#include <iterator>
+
+// 与 LaminaEditor::SetLexerKeywords 中的关键字及数据类型一致
+static const std::string_view KEYWORDS[] = {
+    "assert", "bool", "break", "continue", "else", "false", "float", "for",
+    "func", "if", "include", "input", "int", "irrational", "null", "print",
+    "rational", "return", "string", "true", "var", "while"
+};
+
+// 多字符运算符，按长度从长到短排列
+static const std::string_view OPERATORS[] = {
+    "==", "!=", "<=", ">=", "&&", "||", "**", "->", "+=", "-=", "*=", "/="
+};
+
+static bool IsIdentifierStart(unsigned char ch)
+{
+    // 非 ASCII 字节（如 π、√）视为标识符的一部分
+    return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || ch == '_' || ch >= 0x80;
+}
+
+static bool IsDigit(unsigned char ch)
+{
+    return ch >= '0' && ch <= '9';
+}
+
+static bool IsIdentifierChar(unsigned char ch)
+{
+    return IsIdentifierStart(ch) || IsDigit(ch);
+}
+
+LaminaLexer::LaminaLexer(std::string_view source, size_t startLine)
+    : m_source(source)
+    , m_pos(0)
+    , m_line(startLine)
+{
+}
+
+bool LaminaLexer::IsKeyword(std::string_view word)
+{
+    return std::binary_search(std::begin(KEYWORDS), std::end(KEYWORDS), word);
+}
+
+std::vector<LaminaToken> LaminaLexer::Tokenize(std::string_view source)
+{
+    std::vector<LaminaToken> tokens;
+    LaminaLexer lexer(source);
+    LaminaToken token;
+    while (lexer.Next(token))
+        tokens.push_back(token);
+    return tokens;
+}
+
+void LaminaLexer::SkipWhitespace()
+{
+    while (m_pos < m_source.size())
+    {
+        char ch = m_source[m_pos];
+        if (ch == '\n')
+            ++m_line;
+        else if (ch != ' ' && ch != '\t' && ch != '\r' && ch != '\f' && ch != '\v')
+            break;
+        ++m_pos;
+    }
+}
+
+size_t LaminaLexer::ScanOperator() const
+{
+    std::string_view rest = m_source.substr(m_pos);
+    for (std::string_view op : OPERATORS)
+    {
+        if (rest.substr(0, op.size()) == op)
+            return op.size();
+    }
+    return 1;
+}
+
+bool LaminaLexer::Next(LaminaToken& token)
+{
+    SkipWhitespace();
+    if (m_pos >= m_source.size())
+        return false;
+
+    const size_t size = m_source.size();
+    const size_t start = m_pos;
+    token.start = start;
+    token.line = m_line;
+
+    unsigned char ch = m_source[m_pos];
+    char next = m_pos + 1 < size ? m_source[m_pos + 1] : '\0';
+
+    if (ch == '/' && next == '/')
+    {
+        // 行注释
+        token.kind = TokenKind::Comment;
+        while (m_pos < size && m_source[m_pos] != '\n' && m_source[m_pos] != '\r')
+            ++m_pos;
+    }
+    else if (ch == '/' && next == '*')
+    {
+        // 块注释
+        token.kind = TokenKind::Comment;
+        m_pos += 2;
+        while (m_pos < size && !(m_source[m_pos] == '*' && m_pos + 1 < size && m_source[m_pos + 1] == '/'))
+        {
+            if (m_source[m_pos] == '\n')
+                ++m_line;
+            ++m_pos;
+        }
+        m_pos = std::min(m_pos + 2, size);
+    }
+    else if (ch == '"')
+    {
+        // 字符串，支持转义，不跨行
+        token.kind = TokenKind::String;
+        ++m_pos;
+        while (m_pos < size && m_source[m_pos] != '"' && m_source[m_pos] != '\n')
+        {
+            if (m_source[m_pos] == '\\' && m_pos + 1 < size && m_source[m_pos + 1] != '\n')
+                ++m_pos;
+            ++m_pos;
+        }
+        if (m_pos < size && m_source[m_pos] == '"')
+            ++m_pos;
+    }
+    else if (IsDigit(ch) || (ch == '.' && IsDigit(next)))
+    {
+        token.kind = TokenKind::Number;
+        while (m_pos < size && (IsDigit(m_source[m_pos]) || m_source[m_pos] == '.'))
+            ++m_pos;
+        if (m_pos < size && (m_source[m_pos] == 'e' || m_source[m_pos] == 'E'))
+        {
+            size_t exponent = m_pos + 1;
+            if (exponent < size && (m_source[exponent] == '+' || m_source[exponent] == '-'))
+                ++exponent;
+            if (exponent < size && IsDigit(m_source[exponent]))
+            {
+                m_pos = exponent;
+                while (m_pos < size && IsDigit(m_source[m_pos]))
+                    ++m_pos;
+            }
+        }
+    }
+    else if (IsIdentifierStart(ch))
+    {
+        while (m_pos < size && IsIdentifierChar(m_source[m_pos]))
+            ++m_pos;
+        token.kind = IsKeyword(m_source.substr(start, m_pos - start)) ? TokenKind::Keyword : TokenKind::Identifier;
+    }
+    else
+    {
+        size_t length = 1;
+        switch (ch)
+        {
+        case '(': token.kind = TokenKind::LeftParen; break;
+        case ')': token.kind = TokenKind::RightParen; break;
+        case '{': token.kind = TokenKind::LeftBrace; break;
+        case '}': token.kind = TokenKind::RightBrace; break;
+        case '[': token.kind = TokenKind::LeftBracket; break;
+        case ']': token.kind = TokenKind::RightBracket; break;
+        case ',': token.kind = TokenKind::Comma; break;
+        case ';': token.kind = TokenKind::Semicolon; break;
+        case '+': case '-': case '*': case '/': case '%': case '^': case '=':
+        case '<': case '>': case '!': case '&': case '|': case '.': case ':':
+        case '?':
+            token.kind = TokenKind::Operator;
+            length = ScanOperator();
+            break;
+        default:
+            token.kind = TokenKind::Unknown;
+            break;
+        }
+        m_pos += length;
+    }
+
+    token.length = m_pos - start;
+    return true;
+}
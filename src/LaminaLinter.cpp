@@ -0,0 +1,944 @@
+#include "LaminaLinter.h"
+#include "ContentHash.h"
+#include "LaminaLexer.h"
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+
+// 解释器提供的常量与函数，按字节序排列；不在表中又未定义的名称会被报告
+static const std::string_view BUILTINS[] = {
+    "abs", "acos", "asin", "atan", "ceil", "cos", "cross", "det", "dot", "e", "exp",
+    "floor", "len", "ln", "log", "max", "min", "pow", "range", "round", "sin",
+    "size", "sqrt", "tan", "\xCF\x80"     // π
+};
+
+// √ 是前缀运算符，词法分析器把 √2 之类当作一个标识符
+static const std::string_view SQRT_PREFIX = "\xE2\x88\x9A";
+
+static bool IsIdentifierChar(unsigned char ch)
+{
+    return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') || ch == '_' || ch >= 0x80;
+}
+
+static bool IsSplitDelimiter(char ch)
+{
+    return ch == '\n' || ch == '/' || ch == '"' || ch == '{' || ch == '}';
+}
+
+static bool IsBuiltin(std::string_view name)
+{
+    return std::binary_search(std::begin(BUILTINS), std::end(BUILTINS), name);
+}
+
+// ---------------------------------------------------------------------------
+// 顶层单元
+
+namespace
+{
+
+struct UnitSpan
+{
+    size_t offset;
+    size_t length;
+    size_t line;
+};
+
+// 按字节扫描切分顶层单元：每个顶层 func 从关键字到函数体的右花括号为一个单元，
+// 其间的顶层语句为一个单元。字符串与注释中的花括号和 func 不计
+std::vector<UnitSpan> SplitUnits(std::string_view source)
+{
+    std::vector<UnitSpan> units;
+    const size_t size = source.size();
+    size_t line = 0;
+    int depth = 0;
+
+    size_t unitStart = 0;
+    size_t unitLine = 0;
+    bool inFunc = false;
+    bool bodyOpened = false;
+
+    auto push = [&](size_t end) {
+        if (!inFunc && source.substr(unitStart, end - unitStart).find_first_not_of(" \t\r\n\f\v") == std::string_view::npos)
+            return;
+        units.push_back({ unitStart, end - unitStart, unitLine });
+    };
+
+    size_t i = 0;
+    while (i < size)
+    {
+        // 花括号内不会出现顶层的 func，只关心换行、注释、字符串与花括号
+        if (depth > 0)
+        {
+            while (i < size && !IsSplitDelimiter(source[i]))
+                ++i;
+            if (i >= size)
+                break;
+        }
+
+        char ch = source[i];
+        char next = i + 1 < size ? source[i + 1] : '\0';
+
+        if (ch == '\n')
+        {
+            ++line;
+            ++i;
+        }
+        else if (ch == '/' && next == '/')
+        {
+            while (i < size && source[i] != '\n')
+                ++i;
+        }
+        else if (ch == '/' && next == '*')
+        {
+            i += 2;
+            while (i < size && !(source[i] == '*' && i + 1 < size && source[i + 1] == '/'))
+            {
+                if (source[i] == '\n')
+                    ++line;
+                ++i;
+            }
+            i = std::min(i + 2, size);
+        }
+        else if (ch == '"')
+        {
+            ++i;
+            while (i < size && source[i] != '"' && source[i] != '\n')
+            {
+                if (source[i] == '\\' && i + 1 < size && source[i + 1] != '\n')
+                    ++i;
+                ++i;
+            }
+            if (i < size && source[i] == '"')
+                ++i;
+        }
+        else if (ch == '{')
+        {
+            ++depth;
+            bodyOpened = bodyOpened || inFunc;
+            ++i;
+        }
+        else if (ch == '}')
+        {
+            if (depth > 0)
+                --depth;
+            ++i;
+            if (inFunc && bodyOpened && depth == 0)
+            {
+                push(i);
+                inFunc = false;
+                unitStart = i;
+                unitLine = line;
+            }
+        }
+        else if (IsIdentifierChar(ch))
+        {
+            size_t start = i;
+            while (i < size && IsIdentifierChar(source[i]))
+                ++i;
+            if (depth == 0 && source.substr(start, i - start) == "func")
+            {
+                // 没有函数体的 func 到下一个 func 为止
+                push(start);
+                inFunc = true;
+                bodyOpened = false;
+                unitStart = start;
+                unitLine = line;
+            }
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    push(size);
+    return units;
+}
+
+// ---------------------------------------------------------------------------
+// 语句级语法树
+
+// 声明的名称
+struct LintName
+{
+    std::string_view text;
+    size_t start = 0;
+    size_t line = 0;
+};
+
+// 表达式中对名称的引用
+struct LintRef
+{
+    std::string_view name;
+    size_t start;
+    size_t line;
+    int arguments;          // 调用时的参数个数，不是调用时为 -1
+    bool read;              // 单纯赋值的目标不算读取
+};
+
+struct LintNode
+{
+    enum Kind
+    {
+        Block,
+        Var,
+        Func,
+        If,
+        While,
+        For,
+        Return,
+        Jump,               // break 与 continue
+        Include,
+        Expression
+    };
+
+    Kind kind = Block;
+    size_t start = 0;
+    size_t end = 0;
+    size_t line = 0;
+
+    LintName name;                      // Var 与 Func 的名称，Include 的路径（不含引号）
+    std::vector<LintName> params;       // Func 的参数
+    std::vector<LintRef> refs;          // 语句本身的表达式（条件、初值等）中的引用
+    std::vector<LintNode> children;     // 嵌套语句；For 为 [初始化, 循环体]，初始化可能缺省为空的 Block
+};
+
+class LintParser
+{
+public:
+    explicit LintParser(std::string_view source)
+        : m_source(source)
+        , m_pos(0)
+    {
+        LaminaLexer lexer(source);
+        LaminaToken token;
+        while (lexer.Next(token))
+        {
+            if (token.kind != TokenKind::Comment)
+                m_tokens.push_back(token);
+        }
+    }
+
+    LintNode ParseUnit()
+    {
+        LintNode unit;
+        unit.kind = LintNode::Block;
+        while (m_pos < m_tokens.size())
+        {
+            // 顶层多余的右花括号
+            if (m_tokens[m_pos].kind == TokenKind::RightBrace)
+                ++m_pos;
+            else
+                ParseStatement(unit.children);
+        }
+        unit.end = m_source.size();
+        return unit;
+    }
+
+private:
+    bool AtEnd() const { return m_pos >= m_tokens.size(); }
+    std::string_view Text(const LaminaToken& token) const { return m_source.substr(token.start, token.length); }
+
+    bool Is(TokenKind kind) const { return !AtEnd() && m_tokens[m_pos].kind == kind; }
+
+    bool IsKeyword(std::string_view word) const
+    {
+        return Is(TokenKind::Keyword) && Text(m_tokens[m_pos]) == word;
+    }
+
+    void Begin(LintNode& node, LintNode::Kind kind) const
+    {
+        const LaminaToken& token = m_tokens[m_pos];
+        node.kind = kind;
+        node.start = token.start;
+        node.end = token.start + token.length;
+        node.line = token.line;
+    }
+
+    LintName Name(const LaminaToken& token) const
+    {
+        return { Text(token), token.start, token.line };
+    }
+
+    void Finish(LintNode& node) const
+    {
+        if (m_pos > 0)
+            node.end = std::max(node.end, m_tokens[m_pos - 1].start + m_tokens[m_pos - 1].length);
+    }
+
+    // 缺少分号时，换行后出现的语句关键字开始新的语句
+    bool StartsStatement(const LaminaToken& token) const
+    {
+        if (token.kind != TokenKind::Keyword)
+            return false;
+        std::string_view word = Text(token);
+        return word == "var" || word == "func" || word == "if" || word == "while" || word == "for"
+            || word == "return" || word == "break" || word == "continue" || word == "include";
+    }
+
+    // 收集表达式中的引用直到分号（吃掉）、外层的右花括号或右括号（stopAtParen 时吃掉右括号）
+    void ParseExpression(LintNode& node, bool stopAtParen)
+    {
+        int depth = 0;
+        size_t first = m_pos;
+        while (!AtEnd())
+        {
+            const LaminaToken& token = m_tokens[m_pos];
+            if (depth == 0)
+            {
+                if (token.kind == TokenKind::Semicolon)
+                {
+                    ++m_pos;
+                    return;
+                }
+                if (token.kind == TokenKind::RightBrace)
+                    return;
+                // 外层的右括号属于包含表达式的语句（如 for 的括号）
+                if (token.kind == TokenKind::RightParen)
+                {
+                    if (stopAtParen)
+                        ++m_pos;
+                    return;
+                }
+                if (m_pos > first && token.line > m_tokens[m_pos - 1].line && StartsStatement(token))
+                    return;
+            }
+
+            switch (token.kind)
+            {
+            case TokenKind::LeftParen:
+            case TokenKind::LeftBracket:
+            case TokenKind::LeftBrace:
+                ++depth;
+                break;
+            case TokenKind::RightParen:
+            case TokenKind::RightBracket:
+            case TokenKind::RightBrace:
+                if (depth > 0)
+                    --depth;
+                break;
+            case TokenKind::Identifier:
+                AddRef(node);
+                break;
+            default:
+                break;
+            }
+            ++m_pos;
+        }
+    }
+
+    void AddRef(LintNode& node)
+    {
+        const LaminaToken& token = m_tokens[m_pos];
+        std::string_view name = Text(token);
+        if (name.substr(0, SQRT_PREFIX.size()) == SQRT_PREFIX)
+            return;
+
+        // 成员访问 a.b 中的 b 与对象字面量的键 { b: ... } 不是变量
+        if (m_pos > 0)
+        {
+            const LaminaToken& previous = m_tokens[m_pos - 1];
+            if (previous.kind == TokenKind::Operator && Text(previous) == ".")
+                return;
+        }
+        bool hasNext = m_pos + 1 < m_tokens.size();
+        const LaminaToken* next = hasNext ? &m_tokens[m_pos + 1] : nullptr;
+        if (next && next->kind == TokenKind::Operator && Text(*next) == ":"
+            && m_pos > 0 && (m_tokens[m_pos - 1].kind == TokenKind::LeftBrace || m_tokens[m_pos - 1].kind == TokenKind::Comma))
+            return;
+
+        LintRef ref{ name, token.start, token.line, -1, true };
+        if (next && next->kind == TokenKind::LeftParen)
+        {
+            // 统计外层逗号得到参数个数
+            int depth = 0;
+            int commas = 0;
+            bool empty = true;
+            for (size_t k = m_pos + 2; k < m_tokens.size(); ++k)
+            {
+                TokenKind kind = m_tokens[k].kind;
+                if (depth == 0 && kind == TokenKind::RightParen)
+                    break;
+                empty = false;
+                if (kind == TokenKind::LeftParen || kind == TokenKind::LeftBracket || kind == TokenKind::LeftBrace)
+                    ++depth;
+                else if ((kind == TokenKind::RightParen || kind == TokenKind::RightBracket || kind == TokenKind::RightBrace) && depth > 0)
+                    --depth;
+                else if (depth == 0 && kind == TokenKind::Comma)
+                    ++commas;
+                else if (depth == 0 && kind == TokenKind::Semicolon)
+                    break;
+            }
+            ref.arguments = empty ? 0 : commas + 1;
+        }
+        else if (next && next->kind == TokenKind::Operator && Text(*next) == "=")
+        {
+            ref.read = false;
+        }
+        node.refs.push_back(ref);
+    }
+
+    void ParseStatement(std::vector<LintNode>& out)
+    {
+        const LaminaToken& token = m_tokens[m_pos];
+
+        if (token.kind == TokenKind::Semicolon)
+        {
+            ++m_pos;
+            return;
+        }
+
+        LintNode node;
+        if (token.kind == TokenKind::LeftBrace)
+        {
+            Begin(node, LintNode::Block);
+            ++m_pos;
+            while (!AtEnd() && !Is(TokenKind::RightBrace))
+                ParseStatement(node.children);
+            if (!AtEnd())
+                ++m_pos;
+        }
+        else if (IsKeyword("var"))
+        {
+            Begin(node, LintNode::Var);
+            ++m_pos;
+            if (Is(TokenKind::Identifier))
+                node.name = Name(m_tokens[m_pos++]);
+            ParseExpression(node, false);
+        }
+        else if (IsKeyword("func"))
+        {
+            Begin(node, LintNode::Func);
+            ++m_pos;
+            if (Is(TokenKind::Identifier))
+                node.name = Name(m_tokens[m_pos++]);
+            if (Is(TokenKind::LeftParen))
+            {
+                // 参数：每段逗号分隔的第一个标识符，类型标注被跳过
+                ++m_pos;
+                int depth = 0;
+                bool expectName = true;
+                while (!AtEnd() && !(depth == 0 && Is(TokenKind::RightParen)))
+                {
+                    const LaminaToken& param = m_tokens[m_pos];
+                    if (param.kind == TokenKind::LeftParen || param.kind == TokenKind::LeftBracket)
+                        ++depth;
+                    else if ((param.kind == TokenKind::RightParen || param.kind == TokenKind::RightBracket) && depth > 0)
+                        --depth;
+                    else if (depth == 0 && param.kind == TokenKind::Comma)
+                        expectName = true;
+                    else if (param.kind == TokenKind::LeftBrace)
+                        break;
+                    else if (depth == 0 && expectName && param.kind == TokenKind::Identifier)
+                    {
+                        node.params.push_back(Name(param));
+                        expectName = false;
+                    }
+                    ++m_pos;
+                }
+                if (Is(TokenKind::RightParen))
+                    ++m_pos;
+            }
+            // 返回类型标注等，直到函数体
+            while (!AtEnd() && !Is(TokenKind::LeftBrace) && !Is(TokenKind::Semicolon) && !Is(TokenKind::RightBrace))
+                ++m_pos;
+            if (Is(TokenKind::LeftBrace))
+                ParseStatement(node.children);
+        }
+        else if (IsKeyword("if") || IsKeyword("while"))
+        {
+            bool isIf = IsKeyword("if");
+            Begin(node, isIf ? LintNode::If : LintNode::While);
+            ++m_pos;
+            if (Is(TokenKind::LeftParen))
+            {
+                ++m_pos;
+                ParseExpression(node, true);
+            }
+            ParseBody(node);
+            if (isIf && IsKeyword("else"))
+            {
+                ++m_pos;
+                ParseBody(node);
+            }
+        }
+        else if (IsKeyword("for"))
+        {
+            Begin(node, LintNode::For);
+            ++m_pos;
+            LintNode init;
+            init.kind = LintNode::Block;
+            if (Is(TokenKind::LeftParen))
+            {
+                ++m_pos;
+                std::vector<LintNode> initStatements;
+                if (!AtEnd() && !Is(TokenKind::RightParen))
+                    ParseStatement(initStatements);
+                if (!initStatements.empty())
+                    init = std::move(initStatements.front());
+                // 条件与步进
+                ParseExpression(node, true);
+                if (m_pos > 0 && m_tokens[m_pos - 1].kind == TokenKind::Semicolon)
+                    ParseExpression(node, true);
+            }
+            node.children.push_back(std::move(init));
+            ParseBody(node);
+        }
+        else if (IsKeyword("return"))
+        {
+            Begin(node, LintNode::Return);
+            ++m_pos;
+            ParseExpression(node, false);
+        }
+        else if (IsKeyword("break") || IsKeyword("continue"))
+        {
+            Begin(node, LintNode::Jump);
+            ++m_pos;
+            ParseExpression(node, false);
+        }
+        else if (IsKeyword("include"))
+        {
+            Begin(node, LintNode::Include);
+            ++m_pos;
+            if (Is(TokenKind::String))
+            {
+                const LaminaToken& path = m_tokens[m_pos];
+                std::string_view text = Text(path);
+                if (text.size() >= 2 && text.back() == '"')
+                    node.name = { text.substr(1, text.size() - 2), path.start, path.line };
+            }
+            ParseExpression(node, false);
+            node.refs.clear();
+        }
+        else
+        {
+            Begin(node, LintNode::Expression);
+            size_t before = m_pos;
+            ParseExpression(node, false);
+            // 无法开始表达式的记号（如多余的右括号）
+            if (m_pos == before)
+                ++m_pos;
+        }
+
+        Finish(node);
+        out.push_back(std::move(node));
+    }
+
+    void ParseBody(LintNode& node)
+    {
+        if (AtEnd() || Is(TokenKind::RightBrace))
+        {
+            LintNode empty;
+            empty.kind = LintNode::Block;
+            node.children.push_back(std::move(empty));
+            return;
+        }
+        std::vector<LintNode> body;
+        while (body.empty() && !AtEnd() && !Is(TokenKind::RightBrace))
+            ParseStatement(body);
+        if (body.empty())
+        {
+            body.emplace_back();
+            body.back().kind = LintNode::Block;
+        }
+        node.children.push_back(std::move(body.front()));
+    }
+
+private:
+    std::string_view m_source;
+    std::vector<LaminaToken> m_tokens;
+    size_t m_pos;
+};
+
+// ---------------------------------------------------------------------------
+// 检查
+
+using GlobalTable = std::unordered_map<std::string, int>;
+
+class LintChecker
+{
+public:
+    LintChecker(const GlobalTable& globals, std::vector<LintFinding>& findings)
+        : m_globals(globals)
+        , m_findings(findings)
+        , m_inFunction(false)
+    {
+    }
+
+    void CheckUnit(const LintNode& unit)
+    {
+        // 单元本身是全局作用域，其中的 var 与 func 已在全局名称表中
+        CheckStatements(unit.children, true);
+    }
+
+private:
+    struct Local
+    {
+        std::string_view name;
+        size_t start;
+        size_t line;
+        bool read;
+        bool report;
+    };
+
+    void PushScope() { m_scopes.emplace_back(); }
+
+    void PopScope()
+    {
+        for (const Local& local : m_scopes.back())
+        {
+            if (local.report && !local.read)
+                Add(LintRule::UnusedVariable, local.start, local.name.size(), local.line, local.name);
+        }
+        m_scopes.pop_back();
+    }
+
+    void Declare(const LintName& name, bool read, bool report)
+    {
+        if (!name.text.empty() && !m_scopes.empty())
+            m_scopes.back().push_back({ name.text, name.start, name.line, read, report });
+    }
+
+    void Add(LintRule rule, size_t start, size_t length, size_t line, std::string_view name, int expected = 0, int actual = 0)
+    {
+        LintFinding finding{ rule, start, length, line, std::string(name), expected, actual };
+        m_findings.push_back(std::move(finding));
+    }
+
+    void Resolve(const std::vector<LintRef>& refs)
+    {
+        for (const LintRef& ref : refs)
+            Resolve(ref);
+    }
+
+    void Resolve(const LintRef& ref)
+    {
+        for (auto scope = m_scopes.rbegin(); scope != m_scopes.rend(); ++scope)
+        {
+            for (auto local = scope->rbegin(); local != scope->rend(); ++local)
+            {
+                if (local->name == ref.name)
+                {
+                    local->read = local->read || ref.read;
+                    return;
+                }
+            }
+        }
+
+        auto global = m_globals.find(std::string(ref.name));
+        if (global != m_globals.end())
+        {
+            if (ref.arguments >= 0 && global->second >= 0 && ref.arguments != global->second)
+                Add(LintRule::ArityMismatch, ref.start, ref.name.size(), ref.line, ref.name, global->second, ref.arguments);
+            return;
+        }
+
+        if (!IsBuiltin(ref.name))
+            Add(LintRule::UndefinedName, ref.start, ref.name.size(), ref.line, ref.name);
+    }
+
+    void CheckStatements(const std::vector<LintNode>& statements, bool global)
+    {
+        bool terminated = false;
+        bool reported = false;
+        for (const LintNode& statement : statements)
+        {
+            // 报告一次，覆盖到块中最后一条语句；其后的语句仍然检查
+            if (terminated && !reported)
+            {
+                Add(LintRule::UnreachableCode, statement.start, statements.back().end - statement.start, statement.line, std::string_view());
+                reported = true;
+            }
+            CheckStatement(statement, global);
+            terminated = terminated || statement.kind == LintNode::Return || statement.kind == LintNode::Jump;
+        }
+    }
+
+    void CheckBody(const LintNode& body)
+    {
+        if (body.kind == LintNode::Block)
+        {
+            CheckStatement(body, false);
+            return;
+        }
+        // 单条语句的循环体或分支也有自己的作用域
+        PushScope();
+        CheckStatement(body, false);
+        PopScope();
+    }
+
+    void CheckStatement(const LintNode& node, bool global)
+    {
+        switch (node.kind)
+        {
+        case LintNode::Block:
+            PushScope();
+            CheckStatements(node.children, false);
+            PopScope();
+            break;
+
+        case LintNode::Var:
+            // 初值先于声明解析，var x = x + 1 引用外层的 x
+            Resolve(node.refs);
+            if (!global)
+                Declare(node.name, false, m_inFunction);
+            break;
+
+        case LintNode::Func:
+        {
+            if (!global)
+                Declare(node.name, true, false);
+            bool inFunction = m_inFunction;
+            m_inFunction = true;
+            PushScope();
+            for (const LintName& param : node.params)
+                Declare(param, true, false);
+            for (const LintNode& body : node.children)
+                CheckStatement(body, false);
+            PopScope();
+            m_inFunction = inFunction;
+            break;
+        }
+
+        case LintNode::If:
+        case LintNode::While:
+            Resolve(node.refs);
+            for (const LintNode& body : node.children)
+                CheckBody(body);
+            break;
+
+        case LintNode::For:
+            PushScope();
+            if (!node.children.empty())
+                CheckStatement(node.children.front(), false);
+            Resolve(node.refs);
+            for (size_t k = 1; k < node.children.size(); ++k)
+                CheckBody(node.children[k]);
+            PopScope();
+            break;
+
+        case LintNode::Include:
+            break;
+
+        default:
+            Resolve(node.refs);
+            break;
+        }
+    }
+
+private:
+    const GlobalTable& m_globals;
+    std::vector<LintFinding>& m_findings;
+    std::vector<std::vector<Local>> m_scopes;
+    bool m_inFunction;
+};
+
+// 单元中的全局定义
+void CollectDefines(const LintNode& unit, std::vector<LintSymbol>& symbols)
+{
+    for (const LintNode& statement : unit.children)
+    {
+        if (statement.name.text.empty())
+            continue;
+        if (statement.kind == LintNode::Func)
+            symbols.push_back({ std::string(statement.name.text), (int)statement.params.size() });
+        else if (statement.kind == LintNode::Var)
+            symbols.push_back({ std::string(statement.name.text), -1 });
+    }
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+
+struct LaminaLinter::UnitEntry
+{
+    struct IncludeRef
+    {
+        std::string path;
+        size_t start;
+        size_t length;
+        size_t line;
+    };
+
+    std::vector<LintSymbol> defines;
+    uint64_t definesHash = 0;
+    std::vector<IncludeRef> includes;
+    unsigned lastRun = 0;
+
+    // 检查结果（位置相对于单元开头）及检查时全局名称表的哈希
+    bool checked = false;
+    uint64_t checkedGlobals = 0;
+    std::vector<LintFinding> findings;
+};
+
+// 与顺序无关的名称哈希：各名称哈希之和，文档中单元的顺序变化不影响结果
+static uint64_t HashSymbols(const std::vector<LintSymbol>& symbols)
+{
+    uint64_t hash = 0;
+    for (const LintSymbol& symbol : symbols)
+        hash += ContentHash::Compute(symbol.name, (uint64_t)(int64_t)symbol.arity);
+    return hash;
+}
+
+LaminaLinter::LaminaLinter()
+    : m_run(0)
+    , m_globalsHash(0)
+{
+}
+
+LaminaLinter::~LaminaLinter() = default;
+
+void LaminaLinter::Clear()
+{
+    m_cache.clear();
+    m_globals.clear();
+    m_globalsHash = 0;
+}
+
+std::vector<LintFinding> LaminaLinter::Lint(std::string_view source, const IncludeResolver& resolveInclude)
+{
+    auto begin = std::chrono::steady_clock::now();
+    m_stats = LintStats();
+    const unsigned run = ++m_run;
+
+    std::vector<UnitSpan> spans = SplitUnits(source);
+    m_stats.units = spans.size();
+
+    // 1. 按内容哈希查找缓存，新的单元解析一次，语法树留到检查时使用
+    std::unordered_map<UnitEntry*, LintNode> parsed;
+    std::vector<UnitEntry*> entries;
+    entries.reserve(spans.size());
+    uint64_t globalsHash = 0;
+
+    for (const UnitSpan& span : spans)
+    {
+        std::string_view text = source.substr(span.offset, span.length);
+        std::unique_ptr<UnitEntry>& entry = m_cache[ContentHash::Compute(text)];
+        if (!entry)
+        {
+            entry = std::make_unique<UnitEntry>();
+            LintNode unit = LintParser(text).ParseUnit();
+            CollectDefines(unit, entry->defines);
+            entry->definesHash = HashSymbols(entry->defines);
+            for (const LintNode& statement : unit.children)
+            {
+                if (statement.kind == LintNode::Include)
+                    entry->includes.push_back({ std::string(statement.name.text), statement.start, statement.end - statement.start, statement.line });
+            }
+            parsed.emplace(entry.get(), std::move(unit));
+            ++m_stats.parsed;
+        }
+        // 内容相同的单元只计一次
+        if (entry->lastRun != run)
+            globalsHash += entry->definesHash;
+        entry->lastRun = run;
+        entries.push_back(entry.get());
+    }
+
+    // 不再出现的单元从缓存中移除
+    for (auto entry = m_cache.begin(); entry != m_cache.end();)
+    {
+        if (entry->second->lastRun != run)
+            entry = m_cache.erase(entry);
+        else
+            ++entry;
+    }
+
+    // 2. include 每次都重新解析，被包含的文件可能已经变化
+    std::vector<LintFinding> findings;
+    std::vector<LintSymbol> external;
+    std::unordered_map<std::string, bool> resolved;
+    for (size_t i = 0; i < spans.size(); ++i)
+    {
+        for (const UnitEntry::IncludeRef& include : entries[i]->includes)
+        {
+            auto known = resolved.find(include.path);
+            bool found = known != resolved.end() ? known->second
+                : (resolved[include.path] = !include.path.empty() && resolveInclude && resolveInclude(include.path, external));
+            if (!found)
+                findings.push_back({ LintRule::BadInclude, spans[i].offset + include.start, include.length, spans[i].line + include.line, include.path });
+        }
+    }
+    globalsHash += HashSymbols(external);
+
+    // 3. 全局名称表只在增删函数、改变参数个数等之后重建，这时所有单元重新检查
+    if (globalsHash != m_globalsHash || m_globals.empty())
+    {
+        m_globals.clear();
+        auto add = [this](const LintSymbol& symbol) {
+            // 同名时函数优先于变量
+            auto inserted = m_globals.emplace(symbol.name, symbol.arity);
+            if (!inserted.second && symbol.arity >= 0)
+                inserted.first->second = symbol.arity;
+        };
+        for (const auto& entry : m_cache)
+        {
+            for (const LintSymbol& symbol : entry.second->defines)
+                add(symbol);
+        }
+        for (const LintSymbol& symbol : external)
+            add(symbol);
+        m_globalsHash = globalsHash;
+    }
+
+    // 4. 只检查新单元与全局名称表变化后的单元
+    for (size_t i = 0; i < spans.size(); ++i)
+    {
+        UnitEntry* entry = entries[i];
+        if (!entry->checked || entry->checkedGlobals != globalsHash)
+        {
+            auto unit = parsed.find(entry);
+            if (unit == parsed.end())
+                unit = parsed.emplace(entry, LintParser(source.substr(spans[i].offset, spans[i].length)).ParseUnit()).first;
+
+            entry->findings.clear();
+            LintChecker(m_globals, entry->findings).CheckUnit(unit->second);
+            entry->checked = true;
+            entry->checkedGlobals = globalsHash;
+            ++m_stats.checked;
+        }
+
+        for (const LintFinding& finding : entry->findings)
+        {
+            findings.push_back(finding);
+            findings.back().start += spans[i].offset;
+            findings.back().line += spans[i].line;
+        }
+    }
+
+    std::stable_sort(findings.begin(), findings.end(), [](const LintFinding& a, const LintFinding& b) {
+        return a.start < b.start;
+    });
+
+    m_stats.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    return findings;
+}
+
+std::vector<LintSymbol> LaminaLinter::CollectSymbols(std::string_view source)
+{
+    std::vector<LintSymbol> symbols;
+    for (const UnitSpan& span : SplitUnits(source))
+        CollectDefines(LintParser(source.substr(span.offset, span.length)).ParseUnit(), symbols);
+    return symbols;
+}
+
+std::string LaminaLinter::Describe(const LintFinding& finding)
+{
+    switch (finding.rule)
+    {
+    case LintRule::UndefinedName:
+        return "'" + finding.name + "' is not defined";
+    case LintRule::UnusedVariable:
+        return "variable '" + finding.name + "' is never used";
+    case LintRule::UnreachableCode:
+        return "unreachable code";
+    case LintRule::BadInclude:
+        return "cannot find included file '" + finding.name + "'";
+    case LintRule::ArityMismatch:
+        return "'" + finding.name + "' expects " + std::to_string(finding.expected)
+            + " argument(s) but is called with " + std::to_string(finding.actual);
+    default:
+        return std::string();
+    }
+}
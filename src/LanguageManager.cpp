@@ -0,0 +1,92 @@
+#include "LanguageManager.h"
+#include <wx/config.h>
+
+// 每种语言一张文本表，下标为 MessageId
+static constexpr const char* MESSAGE_TABLE[LanguageManager::LANG_COUNT][MSG_COUNT] = {
+    {
+#define LAMINA_MESSAGE(id, english, chinese) english,
+#include "Messages.def"
+#undef LAMINA_MESSAGE
+    },
+    {
+#define LAMINA_MESSAGE(id, english, chinese) chinese,
+#include "Messages.def"
+#undef LAMINA_MESSAGE
+    },
+};
+
+static const char* const LANGUAGE_NAMES[LanguageManager::LANG_COUNT] = {
+    "English",
+    "简体中文"
+};
+
+// 英文是其他语言缺少译文时的后备，不能为空
+static constexpr bool HasEnglishText()
+{
+    for (const char* text : MESSAGE_TABLE[LanguageManager::LANG_ENGLISH])
+    {
+        if (!text || !*text)
+            return false;
+    }
+    return true;
+}
+static_assert(HasEnglishText(), "every message in Messages.def needs English text");
+
+LanguageManager& LanguageManager::GetInstance()
+{
+    static LanguageManager instance;
+    return instance;
+}
+
+bool LanguageManager::Initialize()
+{
+    LoadSettings();
+    return SetLanguage(m_currentLanguage);
+}
+
+bool LanguageManager::SetLanguage(Language lang)
+{
+    if (lang < 0 || lang >= LANG_COUNT)
+        return false;
+
+    // 只在切换语言时转换一次
+    for (int id = 0; id < MSG_COUNT; ++id)
+    {
+        const char* text = MESSAGE_TABLE[lang][id];
+        if (!*text)
+            text = MESSAGE_TABLE[LANG_ENGLISH][id];
+        m_texts[id] = wxString::FromUTF8(text);
+    }
+
+    m_currentLanguage = lang;
+    return true;
+}
+
+wxArrayString LanguageManager::GetAvailableLanguages() const
+{
+    wxArrayString languages;
+    for (int lang = 0; lang < LANG_COUNT; ++lang)
+        languages.Add(GetLanguageName(static_cast<Language>(lang)));
+    return languages;
+}
+
+wxString LanguageManager::GetLanguageName(Language lang) const
+{
+    if (lang < 0 || lang >= LANG_COUNT)
+        return wxEmptyString;
+    return wxString::FromUTF8(LANGUAGE_NAMES[lang]);
+}
+
+void LanguageManager::LoadSettings()
+{
+    wxConfig config("LaminaLabIDE");
+    long lang = config.ReadLong("Language", LANG_ENGLISH);
+    m_currentLanguage = (lang >= 0 && lang < LANG_COUNT) ? static_cast<Language>(lang) : LANG_ENGLISH;
+}
+
+void LanguageManager::SaveSettings()
+{
+    wxConfig config("LaminaLabIDE");
+    config.Write("Language", static_cast<long>(m_currentLanguage));
+    config.Flush();
+}
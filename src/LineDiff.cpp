@@ -0,0 +1,241 @@
+#include "LineDiff.h"
+#include "ContentHash.h"
+#include <algorithm>
+#include <cstring>
+
+// Myers 算法的编辑距离上限（按行），超出时把中间部分作为一处整体替换
+static const long MAX_DIFF_COST = 2000;
+
+// 块比较的大小，先用 memcmp 找到不同的块再逐字节比较
+static const size_t COMPARE_BLOCK = 4096;
+
+struct DiffLine
+{
+    uint64_t hash;
+    std::string_view text;
+
+    bool operator==(const DiffLine& other) const { return hash == other.hash && text == other.text; }
+};
+
+static size_t CommonPrefix(std::string_view a, std::string_view b)
+{
+    size_t limit = std::min(a.size(), b.size());
+    size_t pos = 0;
+    while (pos + COMPARE_BLOCK <= limit && memcmp(a.data() + pos, b.data() + pos, COMPARE_BLOCK) == 0)
+        pos += COMPARE_BLOCK;
+    while (pos < limit && a[pos] == b[pos])
+        ++pos;
+    return pos;
+}
+
+static size_t CommonSuffix(std::string_view a, std::string_view b, size_t limit)
+{
+    size_t length = 0;
+    while (length + COMPARE_BLOCK <= limit &&
+           memcmp(a.data() + a.size() - length - COMPARE_BLOCK, b.data() + b.size() - length - COMPARE_BLOCK, COMPARE_BLOCK) == 0)
+        length += COMPARE_BLOCK;
+    while (length < limit && a[a.size() - 1 - length] == b[b.size() - 1 - length])
+        ++length;
+    return length;
+}
+
+// 拆分为行，每行包含结尾的换行符
+static std::vector<DiffLine> SplitLines(std::string_view text)
+{
+    std::vector<DiffLine> lines;
+    size_t start = 0;
+    while (start < text.size())
+    {
+        size_t newline = text.find('\n', start);
+        size_t end = newline == std::string_view::npos ? text.size() : newline + 1;
+        std::string_view line = text.substr(start, end - start);
+        lines.push_back(DiffLine{ ContentHash::Compute(line), line });
+        start = end;
+    }
+    return lines;
+}
+
+// Myers 差异算法，输出两边相同的行对（按顺序），超过代价上限时返回 false
+static bool FindMatches(const std::vector<DiffLine>& a, const std::vector<DiffLine>& b,
+                        std::vector<std::pair<long, long>>& matches)
+{
+    const long n = (long)a.size();
+    const long m = (long)b.size();
+    const long limit = std::min(n + m, MAX_DIFF_COST);
+    const long offset = limit + 1;
+
+    std::vector<long> v(2 * limit + 3, 0);
+    std::vector<std::vector<long>> trace;   // trace[d] 为第 d 步结束时对角线 -d..d 的位置
+
+    for (long d = 0; d <= limit; ++d)
+    {
+        for (long k = -d; k <= d; k += 2)
+        {
+            long x;
+            if (k == -d || (k != d && v[offset + k - 1] < v[offset + k + 1]))
+                x = v[offset + k + 1];
+            else
+                x = v[offset + k - 1] + 1;
+            long y = x - k;
+            while (x < n && y < m && a[x] == b[y])
+            {
+                ++x;
+                ++y;
+            }
+            v[offset + k] = x;
+
+            if (x >= n && y >= m)
+            {
+                // 从终点回溯
+                for (long step = d; step > 0; --step)
+                {
+                    const std::vector<long>& previous = trace[step - 1];
+                    long current = x - y;
+                    long base = step - 1;
+                    long previousK;
+                    if (current == -step || (current != step && previous[base + current - 1] < previous[base + current + 1]))
+                        previousK = current + 1;
+                    else
+                        previousK = current - 1;
+
+                    long previousX = previous[base + previousK];
+                    long previousY = previousX - previousK;
+                    while (x > previousX && y > previousY)
+                    {
+                        --x;
+                        --y;
+                        matches.emplace_back(x, y);
+                    }
+                    x = previousX;
+                    y = previousY;
+                }
+                while (x > 0 && y > 0)
+                {
+                    --x;
+                    --y;
+                    matches.emplace_back(x, y);
+                }
+                std::reverse(matches.begin(), matches.end());
+                return true;
+            }
+        }
+        trace.emplace_back(v.begin() + offset - d, v.begin() + offset + d + 1);
+    }
+
+    return false;
+}
+
+static void AppendLines(std::string& text, const std::vector<DiffLine>& lines, long begin, long end)
+{
+    for (long i = begin; i < end; ++i)
+        text.append(lines[i].text);
+}
+
+// 去掉相同的开头和结尾之后的中间部分及其行的匹配结果
+struct DiffMiddle
+{
+    size_t prefix = 0;          // 相同开头的字节数（对齐到行边界）
+    std::string_view oldText;
+    std::string_view newText;
+    std::vector<DiffLine> a;
+    std::vector<DiffLine> b;
+    std::vector<std::pair<long, long>> matches;    // 末尾附加 (a.size(), b.size()) 作为结束标记
+    bool matched = false;       // 为 false 时中间部分作为一个整体
+};
+
+// 两段文本完全相同时返回 false
+static bool FindMiddle(std::string_view oldText, std::string_view newText, DiffMiddle& middle)
+{
+    // 相同的开头和结尾对齐到行边界
+    size_t prefix = CommonPrefix(oldText, newText);
+    if (prefix == oldText.size() && prefix == newText.size())
+        return false;
+    while (prefix > 0 && oldText[prefix - 1] != '\n')
+        --prefix;
+
+    size_t suffix = CommonSuffix(oldText, newText, std::min(oldText.size(), newText.size()) - prefix);
+    while (suffix > 0 && (oldText[oldText.size() - suffix - 1] != '\n' || newText[newText.size() - suffix - 1] != '\n'))
+        --suffix;
+
+    middle.prefix = prefix;
+    middle.oldText = oldText.substr(prefix, oldText.size() - prefix - suffix);
+    middle.newText = newText.substr(prefix, newText.size() - prefix - suffix);
+
+    middle.a = SplitLines(middle.oldText);
+    middle.b = SplitLines(middle.newText);
+    middle.matched = !middle.a.empty() && !middle.b.empty() && FindMatches(middle.a, middle.b, middle.matches);
+    middle.matches.emplace_back((long)middle.a.size(), (long)middle.b.size());
+    return true;
+}
+
+std::vector<TextEdit> LineDiff::Compute(std::string_view oldText, std::string_view newText)
+{
+    std::vector<TextEdit> edits;
+    DiffMiddle middle;
+    if (!FindMiddle(oldText, newText, middle))
+        return edits;
+
+    if (!middle.matched)
+    {
+        edits.push_back(TextEdit{ middle.prefix, middle.oldText.size(), std::string(middle.newText) });
+        return edits;
+    }
+
+    // 相邻两处相同行之间的部分为一处编辑
+    const std::vector<DiffLine>& a = middle.a;
+    const std::vector<DiffLine>& b = middle.b;
+    size_t position = middle.prefix;
+    long oldLine = 0;
+    long newLine = 0;
+    for (const auto& match : middle.matches)
+    {
+        if (match.first > oldLine || match.second > newLine)
+        {
+            TextEdit edit{ position, 0, std::string() };
+            for (long i = oldLine; i < match.first; ++i)
+                edit.length += a[i].text.size();
+            AppendLines(edit.text, b, newLine, match.second);
+            position += edit.length;
+            edits.push_back(std::move(edit));
+        }
+
+        if (match.first < (long)a.size())
+            position += a[match.first].text.size();
+        oldLine = match.first + 1;
+        newLine = match.second + 1;
+    }
+
+    return edits;
+}
+
+std::vector<LineHunk> LineDiff::ComputeHunks(std::string_view oldText, std::string_view newText)
+{
+    std::vector<LineHunk> hunks;
+    DiffMiddle middle;
+    if (!FindMiddle(oldText, newText, middle))
+        return hunks;
+
+    // 相同开头的行数，两边相同
+    size_t base = std::count(oldText.begin(), oldText.begin() + middle.prefix, '\n');
+
+    if (!middle.matched)
+    {
+        hunks.push_back(LineHunk{ base, middle.a.size(), base, middle.b.size() });
+        return hunks;
+    }
+
+    long oldLine = 0;
+    long newLine = 0;
+    for (const auto& match : middle.matches)
+    {
+        if (match.first > oldLine || match.second > newLine)
+        {
+            hunks.push_back(LineHunk{ base + oldLine, (size_t)(match.first - oldLine),
+                                      base + newLine, (size_t)(match.second - newLine) });
+        }
+        oldLine = match.first + 1;
+        newLine = match.second + 1;
+    }
+
+    return hunks;
+}
@@ -0,0 +1,215 @@
+#include "LintIndicators.h"
+#include "LaminaEditor.h"
+#include "LanguageManager.h"
+#include "IncludeIndex.h"
+#include "IncludeScanner.h"
+#include <wx/filename.h>
+#include <set>
+
+// 指示器编号，0-7 留给词法分析器
+static const int INDICATOR_ERROR = 8;
+static const int INDICATOR_WARNING = 9;
+
+// 停止输入后再检查，连续输入只检查一次
+static const int LINT_DELAY_MS = 200;
+
+static const int DWELL_TIME_MS = 500;
+
+LintIndicators::LintIndicators(LaminaEditor* editor)
+    : m_editor(editor)
+    , m_lintTimer(this)
+    , m_running(false)
+    , m_pending(false)
+{
+    m_editor->IndicatorSetStyle(INDICATOR_ERROR, wxSTC_INDIC_SQUIGGLE);
+    m_editor->IndicatorSetForeground(INDICATOR_ERROR, wxColour(220, 50, 50));
+    m_editor->IndicatorSetStyle(INDICATOR_WARNING, wxSTC_INDIC_SQUIGGLE);
+    m_editor->IndicatorSetForeground(INDICATOR_WARNING, wxColour(210, 150, 30));
+    m_editor->SetMouseDwellTime(DWELL_TIME_MS);
+
+    m_editor->Bind(wxEVT_STC_MODIFIED, &LintIndicators::OnEditorModified, this);
+    m_editor->Bind(wxEVT_STC_DWELLSTART, &LintIndicators::OnDwellStart, this);
+    m_editor->Bind(wxEVT_STC_DWELLEND, &LintIndicators::OnDwellEnd, this);
+    Bind(wxEVT_TIMER, &LintIndicators::OnLintTimer, this);
+}
+
+LintIndicators::~LintIndicators()
+{
+    m_editor->Unbind(wxEVT_STC_MODIFIED, &LintIndicators::OnEditorModified, this);
+    m_editor->Unbind(wxEVT_STC_DWELLSTART, &LintIndicators::OnDwellStart, this);
+    m_editor->Unbind(wxEVT_STC_DWELLEND, &LintIndicators::OnDwellEnd, this);
+
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+void LintIndicators::Recheck()
+{
+    m_lintTimer.Stop();
+    StartJob();
+}
+
+void LintIndicators::OnEditorModified(wxStyledTextEvent& event)
+{
+    if (event.GetModificationType() & (wxSTC_MOD_INSERTTEXT | wxSTC_MOD_DELETETEXT))
+        m_lintTimer.Start(LINT_DELAY_MS, wxTIMER_ONE_SHOT);
+
+    event.Skip();
+}
+
+void LintIndicators::OnLintTimer(wxTimerEvent& event)
+{
+    StartJob();
+}
+
+void LintIndicators::StartJob()
+{
+    if (m_running)
+    {
+        m_pending = true;
+        return;
+    }
+
+    // 大文件模式下不检查
+    if (m_editor->IsLargeFileMode())
+    {
+        m_findings.clear();
+        ApplyIndicators();
+        return;
+    }
+
+    if (m_thread.joinable())
+        m_thread.join();
+
+    std::string text(m_editor->GetCharacterPointer(), m_editor->GetTextLength());
+    wxString file = m_editor->GetCurrentFile();
+    unsigned long changeCount = m_editor->GetChangeCount();
+
+    m_pending = false;
+    m_running = true;
+    m_thread = std::thread([this, text = std::move(text), file, changeCount]() {
+        std::vector<LintFinding> findings = m_linter.Lint(text, [this, &file](const std::string& include, std::vector<LintSymbol>& symbols) {
+            return ResolveInclude(file, include, symbols);
+        });
+        CallAfter([this, changeCount, findings]() { FinishJob(changeCount, findings); });
+    });
+}
+
+void LintIndicators::FinishJob(unsigned long changeCount, std::vector<LintFinding> findings)
+{
+    m_running = false;
+    if (m_thread.joinable())
+        m_thread.join();
+
+    // 检查期间文档已变化时位置可能不再对应，等下一次的结果
+    if (changeCount == m_editor->GetChangeCount())
+    {
+        m_findings.swap(findings);
+        ApplyIndicators();
+    }
+
+    if (m_pending && !m_lintTimer.IsRunning())
+        StartJob();
+}
+
+void LintIndicators::ApplyIndicators()
+{
+    int length = m_editor->GetTextLength();
+    for (int indicator : { INDICATOR_ERROR, INDICATOR_WARNING })
+    {
+        m_editor->SetIndicatorCurrent(indicator);
+        m_editor->IndicatorClearRange(0, length);
+    }
+
+    std::vector<int> lines;
+    for (const LintFinding& finding : m_findings)
+    {
+        m_editor->SetIndicatorCurrent(finding.IsError() ? INDICATOR_ERROR : INDICATOR_WARNING);
+        m_editor->IndicatorFillRange(finding.start, std::max<size_t>(finding.length, 1));
+        if (lines.empty() || lines.back() != (int)finding.line)
+            lines.push_back(finding.line);
+    }
+
+    if (m_linesCallback)
+        m_linesCallback(lines);
+}
+
+void LintIndicators::OnDwellStart(wxStyledTextEvent& event)
+{
+    int position = event.GetPosition();
+    if (position >= 0)
+    {
+        // 指示器随编辑移动，按指示器找到范围后再对应到结果
+        for (int indicator : { INDICATOR_ERROR, INDICATOR_WARNING })
+        {
+            if (!m_editor->IndicatorValueAt(indicator, position))
+                continue;
+            int start = m_editor->IndicatorStart(indicator, position);
+            for (const LintFinding& finding : m_findings)
+            {
+                if ((int)finding.start == start && finding.IsError() == (indicator == INDICATOR_ERROR))
+                {
+                    m_editor->CallTipShow(position, Describe(finding));
+                    break;
+                }
+            }
+            break;
+        }
+    }
+
+    event.Skip();
+}
+
+void LintIndicators::OnDwellEnd(wxStyledTextEvent& event)
+{
+    if (m_editor->CallTipActive())
+        m_editor->CallTipCancel();
+    event.Skip();
+}
+
+bool LintIndicators::ResolveInclude(const wxString& fromFile, const std::string& include, std::vector<LintSymbol>& symbols)
+{
+    wxString path = IncludeScanner::Resolve(fromFile, include);
+    if (!wxFileName::FileExists(path))
+        return false;
+
+    // 递归包含的文件同样提供全局名称，缺失的间接包含由各自的文件报告
+    std::set<wxString> visited;
+    std::vector<wxString> pending{ path };
+    while (!pending.empty())
+    {
+        wxString current = pending.back();
+        pending.pop_back();
+        if (!visited.insert(current).second)
+            continue;
+
+        std::shared_ptr<const IncludedFileInfo> info = IncludeIndex::Get().GetFileInfo(current);
+        if (!info)
+            continue;
+
+        symbols.insert(symbols.end(), info->symbols.begin(), info->symbols.end());
+        for (const std::string& nested : info->includes)
+            pending.push_back(wxString::FromUTF8(nested.data(), nested.size()));
+    }
+    return true;
+}
+
+wxString LintIndicators::Describe(const LintFinding& finding)
+{
+    wxString name = wxString::FromUTF8(finding.name.data(), finding.name.size());
+    switch (finding.rule)
+    {
+    case LintRule::UndefinedName:
+        return wxString::Format(Tr(MSG_LINT_UNDEFINED), name);
+    case LintRule::UnusedVariable:
+        return wxString::Format(Tr(MSG_LINT_UNUSED), name);
+    case LintRule::UnreachableCode:
+        return Tr(MSG_LINT_UNREACHABLE);
+    case LintRule::BadInclude:
+        return wxString::Format(Tr(MSG_LINT_BAD_INCLUDE), name);
+    case LintRule::ArityMismatch:
+        return wxString::Format(Tr(MSG_LINT_ARITY), name, finding.expected, finding.actual);
+    default:
+        return wxEmptyString;
+    }
+}
@@ -1,12 +1,33 @@
 #include "MainFrame.h"
 #include "LaminaEditor.h"
 #include "ProcessManager.h"
+#include "BatchPanel.h"
+#include "MinimapPanel.h"
+#include "OutlinePanel.h"
+#include "ConsolePanel.h"
+#include "PlotPanel.h"
+#include "ReplSession.h"
+#include "FileWatcher.h"
+#include "IncludeIndex.h"
+#include "EditJournal.h"
+#include "FileUtils.h"
+#include "StartupTimeline.h"
 #include "ThemeConfig.h"
+#include "LanguageManager.h"
 #include <wx/filename.h>
+#include <wx/stdpaths.h>
 #include <wx/filedlg.h>
+#include <wx/numdlg.h>
 #include <wx/msgdlg.h>
+#include <wx/dirdlg.h>
 #include <wx/config.h>
 #include <wx/artprov.h>
+#include <algorithm>
+#include <fstream>
+
+#ifdef __LINUX__
+#include <unistd.h>
+#endif
 
 wxBEGIN_EVENT_TABLE(MainFrame, wxFrame)
     EVT_MENU(wxID_NEW, MainFrame::OnNew)
@@ -20,63 +41,309 @@ wxBEGIN_EVENT_TABLE(MainFrame, wxFrame)
     EVT_MENU(wxID_COPY, MainFrame::OnCopy)
     EVT_MENU(wxID_PASTE, MainFrame::OnPaste)
     EVT_MENU(wxID_FIND, MainFrame::OnFind)
+    EVT_MENU(wxID_REPLACE, MainFrame::OnReplace)
+    EVT_MENU(ID_GOTO_LINE, MainFrame::OnGotoLine)
+    EVT_FIND(wxID_ANY, MainFrame::OnFindDialogNext)
+    EVT_FIND_NEXT(wxID_ANY, MainFrame::OnFindDialogNext)
+    EVT_FIND_REPLACE(wxID_ANY, MainFrame::OnFindDialogReplace)
+    EVT_FIND_REPLACE_ALL(wxID_ANY, MainFrame::OnFindDialogReplaceAll)
+    EVT_FIND_CLOSE(wxID_ANY, MainFrame::OnFindDialogClose)
+    EVT_MENU(ID_MINIMAP, MainFrame::OnMinimap)
+    EVT_MENU(ID_OUTLINE, MainFrame::OnOutline)
+    EVT_MENU(ID_PLOT, MainFrame::OnPlot)
+    EVT_MENU(ID_MEMORY_USAGE, MainFrame::OnMemoryUsage)
+    EVT_MENU(ID_AFFECTED_SCRIPTS, MainFrame::OnAffectedScripts)
+    EVT_MENU(ID_FORMAT_DOCUMENT, MainFrame::OnFormatDocument)
+    EVT_MENU(ID_FORMAT_SELECTION, MainFrame::OnFormatSelection)
+    EVT_MENU(ID_FORMAT_ON_SAVE, MainFrame::OnFormatOnSave)
     EVT_MENU(ID_RUN, MainFrame::OnRun)
     EVT_MENU(ID_STOP, MainFrame::OnStop)
+    EVT_MENU(ID_RUN_DIRECTORY, MainFrame::OnRunDirectory)
+    EVT_MENU(ID_RUN_WITH_INPUT, MainFrame::OnRunWithInput)
+    EVT_MENU(ID_RUN_FORCE, MainFrame::OnRunForce)
+    EVT_MENU(ID_RUN_CACHE, MainFrame::OnRunCache)
+    EVT_MENU(ID_REPL_START, MainFrame::OnReplStart)
+    EVT_MENU(ID_REPL_EXECUTE, MainFrame::OnReplExecute)
+    EVT_MENU(ID_REPL_INTERRUPT, MainFrame::OnReplInterrupt)
+    EVT_MENU(ID_REPL_STOP, MainFrame::OnReplStop)
+    EVT_MENU(ID_WATCH_MODE, MainFrame::OnWatchMode)
+    EVT_TIMER(ID_WATCH_TIMER, MainFrame::OnWatchTimer)
+    EVT_TIMER(ID_DISK_CHANGE_TIMER, MainFrame::OnDiskChangeTimer)
+    EVT_TIMER(ID_THEME_RELOAD_TIMER, MainFrame::OnThemeReloadTimer)
+    EVT_TIMER(ID_SESSION_TIMER, MainFrame::OnSessionTimer)
+    EVT_TIMER(ID_STARTUP_TIMER, MainFrame::OnStartupTimer)
+    EVT_MENU_RANGE(ID_SESSION_FILE_START, ID_SESSION_FILE_END, MainFrame::OnSessionFile)
     EVT_MENU(ID_SETTINGS, MainFrame::OnSettings)
-    EVT_MENU(ID_THEME_START, MainFrame::OnTheme)
+    EVT_MENU_RANGE(ID_THEME_START, ID_THEME_END, MainFrame::OnTheme)
+    EVT_MENU_RANGE(ID_LANGUAGE_START, ID_LANGUAGE_END, MainFrame::OnLanguage)
     EVT_MENU(wxID_ABOUT, MainFrame::OnAbout)
     EVT_CLOSE(MainFrame::OnClose)
     EVT_STC_CHANGE(ID_EDITOR, MainFrame::OnTextChange)
     EVT_STC_UPDATEUI(ID_EDITOR, MainFrame::OnUpdateUI)
 wxEND_EVENT_TABLE()
 
+// 保存后等待文件写入完成再重新运行
+static const int WATCH_DEBOUNCE_MS = 150;
+
+// 外部程序写入文件时合并同一次写入产生的多个事件
+static const int DISK_CHANGE_DEBOUNCE_MS = 50;
+
+// 编辑器保存主题文件时可能先截断再写入，等写完再重新载入
+static const int THEME_RELOAD_DEBOUNCE_MS = 100;
+
+// 会话中光标、滚动等状态的保存间隔
+static const int SESSION_SAVE_INTERVAL_MS = 2000;
+// 显示后这么久仍没有绘制（最小化、在其他桌面上），不再等待第一次绘制
+static const int STARTUP_PAINT_TIMEOUT_MS = 2000;
+
+static const size_t MAX_SESSION_DOCUMENTS = SessionStore::MAX_DOCUMENTS;
+
+// 撤销历史的默认内存上限（MB），0 表示不限制
+static const long DEFAULT_UNDO_BUDGET_MB = 128;
+
+// 运行结果缓存的默认总大小（MB）
+static const long DEFAULT_RUN_CACHE_MB = 512;
+
+// 缩略图上最多标记的搜索结果数
+static const size_t MAX_SEARCH_MARKERS = 10000;
+
 MainFrame::MainFrame()
     : wxFrame(nullptr, wxID_ANY, "LaminaLab IDE v0.0.1-Alpha", wxDefaultPosition, wxSize(800, 600))
     , m_editor(nullptr)
+    , m_minimap(nullptr)
+    , m_outline(nullptr)
     , m_console(nullptr)
+    , m_plot(nullptr)
+    , m_formatOnSave(false)
     , m_processManager(nullptr)
+    , m_repl(nullptr)
+    , m_batchPanel(nullptr)
+    , m_runCacheEnabled(false)
+    , m_watchMode(false)
+    , m_watchTimer(this, ID_WATCH_TIMER)
+    , m_watchLatencyPending(false)
+    , m_fileWatchHandle(-1)
+    , m_diskChangeTimer(this, ID_DISK_CHANGE_TIMER)
+    , m_themeWatchHandle(-1)
+    , m_themeReloadTimer(this, ID_THEME_RELOAD_TIMER)
+    , m_diskPromptOpen(false)
+    , m_findData(wxFR_DOWN)
+    , m_findDialog(nullptr)
+    , m_replaceRunning(false)
+    , m_sessionTimer(this, ID_SESSION_TIMER)
+    , m_sessionDirty(false)
+    , m_sessionMenu(nullptr)
+    , m_themeMenu(nullptr)
+    , m_startupTask(0)
+    , m_firstPaintDone(false)
+    , m_startupStarted(false)
+    , m_startupTimer(this, ID_STARTUP_TIMER)
     , m_isModified(false)
 {
     // SetIcon(wxIcon(wxArtProvider::GetBitmap(wxART_EXECUTABLE_FILE, wxART_OTHER, wxSize(32, 32))));
     
-    // 确保主题配置已加载
-    ThemeConfig::Get();
+    // 设置与会话文件在后台线程中读取，主题文件已由 LaminaApp 开始解析，同时创建窗口
+    std::future<FrameSettings> settings = std::async(std::launch::async, &MainFrame::ReadSettings);
+    m_sessionLoad = std::async(std::launch::async, [this]() {
+        StartupStage stage("session file");
+        return m_sessionStore.Load(m_loadedSession);
+    });
     
-    CreateMenuBar();
-    CreateStatusBar();
-    CreateToolBar();
+    {
+        StartupStage stage("menus and toolbar");
+        CreateMenuBar();
+        CreateStatusBar();
+        CreateToolBar();
+    }
     
-    InitializeAUI();
-    CreateEditor();
-    CreateConsole();
+    {
+        StartupStage stage("panes");
+        InitializeAUI();
+        CreateEditor();
+        CreateConsole();
+        m_auiManager.Update();
+    }
     
-    LoadSettings();
+    // 窗口位置和大小要在显示之前设置
+    {
+        StartupStage stage("apply settings");
+        ApplySettings(settings.get());
+    }
     UpdateTitle();
+    
+    // 第一次绘制之后按顺序执行；监视在恢复会话之前注册，扫描完成的通知不会错过
+    m_startupTasks = {
+        { "theme", [this]() { ApplyLoadedTheme(); } },
+        { "watchers", [this]() { StartWatchers(); } },
+        { "crash recovery", [this]() { CheckRecovery(); } },
+        { "session restore", [this]() { RestoreSession(); } },
+    };
+    m_editor->Bind(wxEVT_PAINT, &MainFrame::OnStartupPaint, this);
+    Bind(wxEVT_IDLE, &MainFrame::OnStartupIdle, this);
+    m_startupTimer.StartOnce(STARTUP_PAINT_TIMEOUT_MS);
 }
 
 MainFrame::~MainFrame()
 {
+    if (m_replaceThread.joinable())
+        m_replaceThread.join();
+    if (m_sessionLoad.valid())
+        m_sessionLoad.wait();
+    
+    IncludeIndex::Get().Stop();
+    
+    for (int handle : m_watchHandles)
+        FileWatcher::Get().Unwatch(handle);
+    if (m_fileWatchHandle >= 0)
+        FileWatcher::Get().Unwatch(m_fileWatchHandle);
+    if (m_themeWatchHandle >= 0)
+        FileWatcher::Get().Unwatch(m_themeWatchHandle);
+    
+    delete m_repl;
+    
     m_auiManager.UnInit();
 }
 
-// 添加主题菜单
+void MainFrame::OnStartupPaint(wxPaintEvent& event)
+{
+    event.Skip();
+    m_firstPaintDone = true;
+    m_editor->Unbind(wxEVT_PAINT, &MainFrame::OnStartupPaint, this);
+    wxWakeUpIdle();
+}
+
+void MainFrame::OnStartupIdle(wxIdleEvent& event)
+{
+    event.Skip();
+    if (!m_firstPaintDone)
+        return;
+    
+    // 第一次绘制之后的第一个空闲事件：窗口已经可以响应输入
+    BeginStartupStages();
+}
+
+void MainFrame::OnStartupTimer(wxTimerEvent& event)
+{
+    // 崩溃恢复、会话自动保存等阶段不能依赖窗口被绘制
+    BeginStartupStages();
+}
+
+void MainFrame::BeginStartupStages()
+{
+    if (m_startupStarted)
+        return;
+    m_startupStarted = true;
+    
+    m_startupTimer.Stop();
+    Unbind(wxEVT_IDLE, &MainFrame::OnStartupIdle, this);
+    if (!m_firstPaintDone)
+        m_editor->Unbind(wxEVT_PAINT, &MainFrame::OnStartupPaint, this);
+    
+    StartupTimeline::Get().MarkFirstFrame();
+    CallAfter(&MainFrame::RunNextStartupStage);
+}
+
+void MainFrame::RunNextStartupStage()
+{
+    if (m_startupTask >= m_startupTasks.size())
+    {
+        FinishStartup();
+        return;
+    }
+    
+    const StartupTask& task = m_startupTasks[m_startupTask++];
+    {
+        StartupStage stage(task.name);
+        task.run();
+    }
+    
+    // 两个阶段之间处理输入和绘制
+    CallAfter(&MainFrame::RunNextStartupStage);
+}
+
+void MainFrame::FinishStartup()
+{
+    m_sessionTimer.Start(SESSION_SAVE_INTERVAL_MS);
+    
+    StartupTimeline& timeline = StartupTimeline::Get();
+    timeline.MarkReady();
+    
+    // 每次启动覆盖上一次的记录
+    wxString dir = wxStandardPaths::Get().GetUserDataDir();
+    wxFileName::Mkdir(dir, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+    FileUtils::WriteBytes(wxFileName(dir, "startup.log").GetFullPath(), timeline.Format());
+    
+    if (m_readyCallback)
+        m_readyCallback();
+}
+
+void MainFrame::ApplyLoadedTheme()
+{
+    // 解析通常在第一次绘制之前已经完成，编辑器创建时已应用，这里没有变化
+    if (m_editor->ApplyTheme() > 0)
+        m_minimap->Refresh();
+    if (m_themeMenu->GetMenuItemCount() == 0)
+        RebuildThemeMenu();
+}
+
+void MainFrame::StartWatchers()
+{
+    // 工作区扫描完成后检查当前文件是否处于包含环上，监视模式下按新的关系图更新监视的文件
+    IncludeIndex::Get().SetScanCallback([this]() {
+        CheckIncludeCycle(m_currentFile);
+        if (m_watchMode)
+            UpdateWatchedFiles();
+    });
+    
+    // 主题文件被外部修改后自动重新载入
+    m_themeWatchHandle = FileWatcher::Get().Watch(ThemeConfig::Get().GetConfigPath(), [this](const wxString&) {
+        m_themeReloadTimer.Start(THEME_RELOAD_DEBOUNCE_MS, wxTIMER_ONE_SHOT);
+    });
+}
+
+// 添加主题菜单，主题文件仍在解析时先留空
 void MainFrame::CreateThemeMenu(wxMenu* viewMenu)
 {
+    m_themeMenu = new wxMenu;
+    if (ThemeConfig::IsLoaded())
+        RebuildThemeMenu();
+    
+    viewMenu->AppendSeparator();
+    viewMenu->AppendSubMenu(m_themeMenu, Tr(MSG_MENU_THEME));
+}
+
+void MainFrame::RebuildThemeMenu()
+{
+    while (m_themeMenu->GetMenuItemCount() > 0)
+        m_themeMenu->Destroy(m_themeMenu->FindItemByPosition(0));
+    
     ThemeConfig& config = ThemeConfig::Get();
     const wxArrayString& themes = config.GetAvailableThemes();
-    
-    wxMenu* themeMenu = new wxMenu;
     for (size_t i = 0; i < themes.GetCount(); ++i)
     {
-        themeMenu->AppendRadioItem(ID_THEME_START + i, themes[i]);
+        m_themeMenu->AppendRadioItem(ID_THEME_START + i, themes[i]);
         if (themes[i] == config.GetCurrentTheme())
         {
-            themeMenu->Check(ID_THEME_START + i, true);
+            m_themeMenu->Check(ID_THEME_START + i, true);
         }
     }
+}
+
+// 添加语言菜单
+void MainFrame::CreateLanguageMenu(wxMenu* viewMenu)
+{
+    LanguageManager& languages = LanguageManager::GetInstance();
+    wxArrayString names = languages.GetAvailableLanguages();
+    
+    wxMenu* languageMenu = new wxMenu;
+    for (size_t i = 0; i < names.GetCount(); ++i)
+    {
+        languageMenu->AppendRadioItem(ID_LANGUAGE_START + i, names[i]);
+        if ((int)i == languages.GetCurrentLanguage())
+            languageMenu->Check(ID_LANGUAGE_START + i, true);
+    }
     
-    viewMenu->AppendSeparator();
-    viewMenu->AppendSubMenu(themeMenu, _("主题(&T)"));
+    viewMenu->AppendSubMenu(languageMenu, Tr(MSG_MENU_LANGUAGE));
 }
 
 void MainFrame::CreateMenuBar()
@@ -85,65 +352,105 @@ void MainFrame::CreateMenuBar()
     
     // 文件菜单
     wxMenu* fileMenu = new wxMenu();
-    fileMenu->Append(wxID_NEW, "&New\tCtrl+N", "Create a new file");
-    fileMenu->Append(wxID_OPEN, "&Open...\tCtrl+O", "Open an existing file");
+    fileMenu->Append(wxID_NEW, Tr(MSG_MENU_NEW) + "\tCtrl+N", Tr(MSG_HELP_NEW));
+    fileMenu->Append(wxID_OPEN, Tr(MSG_MENU_OPEN) + "\tCtrl+O", Tr(MSG_HELP_OPEN));
     fileMenu->AppendSeparator();
-    fileMenu->Append(wxID_SAVE, "&Save\tCtrl+S", "Save the current file");
-    fileMenu->Append(ID_SAVE_AS, "Save &As...\tCtrl+Shift+S", "Save the current file with a new name");
+    fileMenu->Append(wxID_SAVE, Tr(MSG_MENU_SAVE) + "\tCtrl+S", Tr(MSG_HELP_SAVE));
+    fileMenu->Append(ID_SAVE_AS, Tr(MSG_MENU_SAVE_AS) + "\tCtrl+Shift+S", Tr(MSG_HELP_SAVE_AS));
     fileMenu->AppendSeparator();
-    fileMenu->Append(wxID_EXIT, "E&xit\tAlt+F4", "Exit the application");
+    m_sessionMenu = new wxMenu();
+    fileMenu->AppendSubMenu(m_sessionMenu, Tr(MSG_MENU_SESSION_FILES), Tr(MSG_HELP_SESSION_FILES));
+    fileMenu->AppendSeparator();
+    fileMenu->Append(wxID_EXIT, Tr(MSG_MENU_EXIT) + "\tAlt+F4", Tr(MSG_HELP_EXIT));
     
     // 编辑菜单
     wxMenu* editMenu = new wxMenu();
-    editMenu->Append(wxID_UNDO, "&Undo\tCtrl+Z", "Undo the last action");
-    editMenu->Append(wxID_REDO, "&Redo\tCtrl+Y", "Redo the last action");
+    editMenu->Append(wxID_UNDO, Tr(MSG_MENU_UNDO) + "\tCtrl+Z", Tr(MSG_HELP_UNDO));
+    editMenu->Append(wxID_REDO, Tr(MSG_MENU_REDO) + "\tCtrl+Y", Tr(MSG_HELP_REDO));
+    editMenu->AppendSeparator();
+    editMenu->Append(wxID_CUT, Tr(MSG_MENU_CUT) + "\tCtrl+X", Tr(MSG_HELP_CUT));
+    editMenu->Append(wxID_COPY, Tr(MSG_MENU_COPY) + "\tCtrl+C", Tr(MSG_HELP_COPY));
+    editMenu->Append(wxID_PASTE, Tr(MSG_MENU_PASTE) + "\tCtrl+V", Tr(MSG_HELP_PASTE));
     editMenu->AppendSeparator();
-    editMenu->Append(wxID_CUT, "Cu&t\tCtrl+X", "Cut selected text");
-    editMenu->Append(wxID_COPY, "&Copy\tCtrl+C", "Copy selected text");
-    editMenu->Append(wxID_PASTE, "&Paste\tCtrl+V", "Paste text from clipboard");
+    editMenu->Append(wxID_FIND, Tr(MSG_MENU_FIND) + "\tCtrl+F", Tr(MSG_HELP_FIND));
+    editMenu->Append(wxID_REPLACE, Tr(MSG_MENU_REPLACE) + "\tCtrl+H", Tr(MSG_HELP_REPLACE));
+    editMenu->Append(ID_GOTO_LINE, Tr(MSG_MENU_GOTO_LINE) + "\tCtrl+G", Tr(MSG_HELP_GOTO_LINE));
     editMenu->AppendSeparator();
-    editMenu->Append(wxID_FIND, "&Find...\tCtrl+F", "Find text");
+    editMenu->Append(ID_FORMAT_DOCUMENT, Tr(MSG_MENU_FORMAT_DOCUMENT) + "\tCtrl+Shift+F", Tr(MSG_HELP_FORMAT_DOCUMENT));
+    editMenu->Append(ID_FORMAT_SELECTION, Tr(MSG_MENU_FORMAT_SELECTION) + "\tCtrl+Shift+G", Tr(MSG_HELP_FORMAT_SELECTION));
+    editMenu->AppendCheckItem(ID_FORMAT_ON_SAVE, Tr(MSG_MENU_FORMAT_ON_SAVE), Tr(MSG_HELP_FORMAT_ON_SAVE));
+    editMenu->Check(ID_FORMAT_ON_SAVE, m_formatOnSave);
+    
+    // 视图菜单
+    wxMenu* viewMenu = new wxMenu();
+    viewMenu->AppendCheckItem(ID_MINIMAP, Tr(MSG_MENU_MINIMAP), Tr(MSG_HELP_MINIMAP));
+    viewMenu->Check(ID_MINIMAP, !m_minimap || m_auiManager.GetPane("minimap").IsShown());
+    viewMenu->AppendCheckItem(ID_OUTLINE, Tr(MSG_MENU_OUTLINE), Tr(MSG_HELP_OUTLINE));
+    viewMenu->Check(ID_OUTLINE, !m_outline || m_auiManager.GetPane("outline").IsShown());
+    viewMenu->AppendCheckItem(ID_PLOT, Tr(MSG_MENU_PLOT), Tr(MSG_HELP_PLOT));
+    viewMenu->Check(ID_PLOT, m_plot && m_auiManager.GetPane("plot").IsShown());
+    viewMenu->Append(ID_MEMORY_USAGE, Tr(MSG_MENU_MEMORY_USAGE), Tr(MSG_HELP_MEMORY_USAGE));
+    viewMenu->AppendSeparator();
+    CreateThemeMenu(viewMenu);
+    CreateLanguageMenu(viewMenu);
     
     // 运行菜单
     wxMenu* runMenu = new wxMenu();
-    runMenu->Append(ID_RUN, "&Run Script\tF5", "Run the current script");
-    runMenu->Append(ID_STOP, "&Stop Script\tShift+F5", "Stop the running script");
+    runMenu->Append(ID_RUN, Tr(MSG_MENU_RUN_SCRIPT) + "\tF5", Tr(MSG_HELP_RUN_SCRIPT));
+    runMenu->Append(ID_STOP, Tr(MSG_MENU_STOP_SCRIPT) + "\tShift+F5", Tr(MSG_HELP_STOP_SCRIPT));
+    runMenu->Append(ID_RUN_DIRECTORY, Tr(MSG_MENU_RUN_DIRECTORY) + "\tCtrl+F5", Tr(MSG_HELP_RUN_DIRECTORY));
+    runMenu->Append(ID_RUN_WITH_INPUT, Tr(MSG_MENU_RUN_WITH_INPUT) + "\tAlt+F5", Tr(MSG_HELP_RUN_WITH_INPUT));
+    runMenu->Append(ID_RUN_FORCE, Tr(MSG_MENU_RUN_FORCE) + "\tCtrl+Shift+F5", Tr(MSG_HELP_RUN_FORCE));
+    runMenu->AppendCheckItem(ID_RUN_CACHE, Tr(MSG_MENU_RUN_CACHE), Tr(MSG_HELP_RUN_CACHE));
+    runMenu->Check(ID_RUN_CACHE, m_runCacheEnabled);
+    runMenu->AppendCheckItem(ID_WATCH_MODE, Tr(MSG_MENU_WATCH_MODE) + "\tCtrl+Shift+W", Tr(MSG_HELP_WATCH_MODE));
+    runMenu->Check(ID_WATCH_MODE, m_watchMode);
+    runMenu->Append(ID_AFFECTED_SCRIPTS, Tr(MSG_MENU_AFFECTED_SCRIPTS), Tr(MSG_HELP_AFFECTED_SCRIPTS));
     runMenu->AppendSeparator();
-    runMenu->Append(ID_SETTINGS, "&Interpreter Path...", "Configure interpreter settings");
+    runMenu->Append(ID_REPL_START, Tr(MSG_MENU_REPL_START), Tr(MSG_HELP_REPL_START));
+    runMenu->Append(ID_REPL_EXECUTE, Tr(MSG_MENU_REPL_EXECUTE) + "\tCtrl+Enter", Tr(MSG_HELP_REPL_EXECUTE));
+    runMenu->Append(ID_REPL_INTERRUPT, Tr(MSG_MENU_REPL_INTERRUPT) + "\tCtrl+Alt+C", Tr(MSG_HELP_REPL_INTERRUPT));
+    runMenu->Append(ID_REPL_STOP, Tr(MSG_MENU_REPL_STOP), Tr(MSG_HELP_REPL_STOP));
+    runMenu->AppendSeparator();
+    runMenu->Append(ID_SETTINGS, Tr(MSG_MENU_INTERPRETER), Tr(MSG_HELP_INTERPRETER));
     
     // 帮助菜单
     wxMenu* helpMenu = new wxMenu();
-    helpMenu->Append(wxID_ABOUT, "&About", "About this application");
+    helpMenu->Append(wxID_ABOUT, Tr(MSG_MENU_ABOUT), Tr(MSG_HELP_ABOUT));
     
-    menuBar->Append(fileMenu, "&File");
-    menuBar->Append(editMenu, "&Edit");
-    menuBar->Append(runMenu, "&Run");
-    menuBar->Append(helpMenu, "&Help");
+    menuBar->Append(fileMenu, Tr(MSG_MENU_FILE));
+    menuBar->Append(editMenu, Tr(MSG_MENU_EDIT));
+    menuBar->Append(viewMenu, Tr(MSG_MENU_VIEW));
+    menuBar->Append(runMenu, Tr(MSG_MENU_RUN));
+    menuBar->Append(helpMenu, Tr(MSG_MENU_HELP));
     
+    // 替换旧的菜单栏时旧菜单栏被删除
     SetMenuBar(menuBar);
 }
 
 void MainFrame::CreateStatusBar()
 {
-    wxFrame::CreateStatusBar(3);
-    SetStatusText("Ready", 0);
-    SetStatusText("Line 1, Column 1", 1);
+    wxFrame::CreateStatusBar(4);
+    SetStatusText(Tr(MSG_STATUS_READY), 0);
+    SetStatusText(wxString::Format(Tr(MSG_STATUS_LINE_COLUMN), 1, 1), 1);
     SetStatusText("", 2);
+    SetStatusText("", 3);
 }
 
 void MainFrame::CreateToolBar()
 {
     wxToolBar* toolBar = wxFrame::CreateToolBar();
     
-    toolBar->AddTool(wxID_NEW, "New", wxArtProvider::GetBitmap(wxART_NEW, wxART_TOOLBAR), "New file");
-    toolBar->AddTool(wxID_OPEN, "Open", wxArtProvider::GetBitmap(wxART_FILE_OPEN, wxART_TOOLBAR), "Open file");
-    toolBar->AddTool(wxID_SAVE, "Save", wxArtProvider::GetBitmap(wxART_FILE_SAVE, wxART_TOOLBAR), "Save file");
+    toolBar->AddTool(wxID_NEW, Tr(MSG_TOOL_NEW), wxArtProvider::GetBitmap(wxART_NEW, wxART_TOOLBAR), Tr(MSG_HELP_NEW));
+    toolBar->AddTool(wxID_OPEN, Tr(MSG_TOOL_OPEN), wxArtProvider::GetBitmap(wxART_FILE_OPEN, wxART_TOOLBAR), Tr(MSG_HELP_OPEN));
+    toolBar->AddTool(wxID_SAVE, Tr(MSG_TOOL_SAVE), wxArtProvider::GetBitmap(wxART_FILE_SAVE, wxART_TOOLBAR), Tr(MSG_HELP_SAVE));
     toolBar->AddSeparator();
-    toolBar->AddTool(wxID_CUT, "Cut", wxArtProvider::GetBitmap(wxART_CUT, wxART_TOOLBAR), "Cut");
-    toolBar->AddTool(wxID_COPY, "Copy", wxArtProvider::GetBitmap(wxART_COPY, wxART_TOOLBAR), "Copy");
-    toolBar->AddTool(wxID_PASTE, "Paste", wxArtProvider::GetBitmap(wxART_PASTE, wxART_TOOLBAR), "Paste");
+    toolBar->AddTool(wxID_CUT, Tr(MSG_TOOL_CUT), wxArtProvider::GetBitmap(wxART_CUT, wxART_TOOLBAR), Tr(MSG_HELP_CUT));
+    toolBar->AddTool(wxID_COPY, Tr(MSG_TOOL_COPY), wxArtProvider::GetBitmap(wxART_COPY, wxART_TOOLBAR), Tr(MSG_HELP_COPY));
+    toolBar->AddTool(wxID_PASTE, Tr(MSG_TOOL_PASTE), wxArtProvider::GetBitmap(wxART_PASTE, wxART_TOOLBAR), Tr(MSG_HELP_PASTE));
     toolBar->AddSeparator();
-    toolBar->AddTool(ID_RUN, "Run", wxArtProvider::GetBitmap(wxART_EXECUTABLE_FILE, wxART_TOOLBAR), "Run script");
+    toolBar->AddTool(ID_RUN, Tr(MSG_TOOL_RUN), wxArtProvider::GetBitmap(wxART_EXECUTABLE_FILE, wxART_TOOLBAR), Tr(MSG_HELP_RUN_SCRIPT));
+    toolBar->AddTool(ID_RUN_FORCE, Tr(MSG_TOOL_RUN_FORCE), wxArtProvider::GetBitmap(wxART_REDO, wxART_TOOLBAR), Tr(MSG_HELP_RUN_FORCE));
     
     toolBar->Realize();
 }
@@ -156,35 +463,48 @@ void MainFrame::InitializeAUI()
 void MainFrame::CreateEditor()
 {
     m_editor = new LaminaEditor(this, ID_EDITOR);
+    m_editor->SetDiskChangeCallback([this]() { OnDiskContentChanged(); });
     m_auiManager.AddPane(m_editor, wxAuiPaneInfo()
         .CenterPane()
         .Name("editor")
-        .Caption("Editor"));
+        .Caption(Tr(MSG_PANE_EDITOR)));
     
-    m_auiManager.Update();
+    m_minimap = new MinimapPanel(this, m_editor);
+    m_editor->SetLintCallback([this](const std::vector<int>& lines) { m_minimap->SetOverlay(MinimapOverlay::Diagnostic, lines); });
+    m_auiManager.AddPane(m_minimap, wxAuiPaneInfo()
+        .Right()
+        .Name("minimap")
+        .CaptionVisible(false)
+        .BestSize(m_minimap->GetMinSize()));
+    
+    m_outline = new OutlinePanel(this, m_editor);
+    m_auiManager.AddPane(m_outline, wxAuiPaneInfo()
+        .Left()
+        .Name("outline")
+        .Caption(Tr(MSG_PANE_OUTLINE))
+        .BestSize(220, -1));
 }
 
 void MainFrame::CreateConsole()
 {
-    m_console = new wxTextCtrl(this, wxID_ANY, "", wxDefaultPosition, wxDefaultSize,
-                              wxTE_MULTILINE | wxTE_READONLY | wxTE_RICH2);
-    
-    // 设置控制台字体为等宽字体
-    wxFont consoleFont(10, wxFONTFAMILY_TELETYPE, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-    m_console->SetFont(consoleFont);
-    
-    // 设置背景色为深色
-    m_console->SetBackgroundColour(wxColour(30, 30, 30));
-    m_console->SetForegroundColour(wxColour(200, 200, 200));
+    m_console = new ConsolePanel(this);
     
     m_auiManager.AddPane(m_console, wxAuiPaneInfo()
         .Bottom()
         .Name("console")
-        .Caption("Console")
+        .Caption(Tr(MSG_PANE_CONSOLE))
         .MinSize(wxSize(-1, 150))
         .BestSize(wxSize(-1, 200)));
     
-    m_auiManager.Update();
+    // 曲线与控制台并排，默认隐藏
+    m_plot = new PlotPanel(this);
+    m_auiManager.AddPane(m_plot, wxAuiPaneInfo()
+        .Bottom()
+        .Position(1)
+        .Name("plot")
+        .Caption(Tr(MSG_PANE_PLOT))
+        .BestSize(wxSize(400, 200))
+        .Hide());
 }
 
 void MainFrame::UpdateTitle()
@@ -199,22 +519,50 @@ void MainFrame::UpdateTitle()
     SetTitle(title);
 }
 
-void MainFrame::LoadSettings()
+void MainFrame::UpdateFileModeStatus()
+{
+    SetStatusText(m_editor->IsLargeFileMode() ? Tr(MSG_STATUS_LARGE_FILE) : wxString(), 3);
+}
+
+FrameSettings MainFrame::ReadSettings()
 {
+    StartupStage stage("settings file");
     wxConfig config("LaminaLabIDE");
+    FrameSettings settings;
     
-    // 加载窗口位置和大小
+    // 窗口位置和大小
     int x = config.Read("WindowX", -1);
     int y = config.Read("WindowY", -1);
-    int width = config.Read("WindowWidth", 800);
-    int height = config.Read("WindowHeight", 600);
-    
     if (x != -1 && y != -1)
-        SetPosition(wxPoint(x, y));
-    SetSize(width, height);
+        settings.position = wxPoint(x, y);
+    settings.size = wxSize(config.Read("WindowWidth", 800), config.Read("WindowHeight", 600));
+    
+    // 解释器路径
+    settings.interpreterPath = config.Read("InterpreterPath", "./laminalab %lmfilepath%");
+    
+    settings.formatOnSave = config.ReadBool("FormatOnSave", false);
+    settings.undoBudgetMB = std::max(0L, config.ReadLong("UndoBudgetMB", DEFAULT_UNDO_BUDGET_MB));
+    settings.runCache = config.ReadBool("RunCache", false);
+    settings.runCacheMB = std::max(1L, config.ReadLong("RunCacheMB", DEFAULT_RUN_CACHE_MB));
+    return settings;
+}
+
+void MainFrame::ApplySettings(const FrameSettings& settings)
+{
+    if (settings.position != wxDefaultPosition)
+        SetPosition(settings.position);
+    SetSize(settings.size);
+    
+    m_interpreterPath = settings.interpreterPath;
     
-    // 加载解释器路径
-    m_interpreterPath = config.Read("InterpreterPath", "./laminalab %lmfilepath%");
+    m_formatOnSave = settings.formatOnSave;
+    GetMenuBar()->Check(ID_FORMAT_ON_SAVE, m_formatOnSave);
+    
+    m_editor->SetUndoBudget((size_t)settings.undoBudgetMB * 1024 * 1024);
+    
+    m_runCacheEnabled = settings.runCache;
+    GetMenuBar()->Check(ID_RUN_CACHE, m_runCacheEnabled);
+    m_runCache.SetBudget((uint64_t)settings.runCacheMB * 1024 * 1024);
 }
 
 void MainFrame::SaveSettings()
@@ -231,6 +579,8 @@ void MainFrame::SaveSettings()
     
     // 保存解释器路径
     config.Write("InterpreterPath", m_interpreterPath);
+    config.Write("FormatOnSave", m_formatOnSave);
+    config.Write("RunCache", m_runCacheEnabled);
     config.Flush();
 }
 
@@ -239,10 +589,15 @@ void MainFrame::OnNew(wxCommandEvent& event)
 {
     if (CheckSaveChanges())
     {
-        m_editor->ClearAll();
+        CaptureSession();
+        m_session.activeIndex = -1;
+        
+        m_editor->NewDocument();
         m_currentFile.Clear();
         m_isModified = false;
         UpdateTitle();
+        UpdateFileModeStatus();
+        UpdateWatchedFiles();
     }
 }
 
@@ -251,26 +606,196 @@ void MainFrame::OnOpen(wxCommandEvent& event)
     if (!CheckSaveChanges())
         return;
     
-    wxFileDialog dialog(this, "Open Lamina file", "", "",
-                       "Lamina files (*.lm)|*.lm|All files (*.*)|*.*",
+    wxFileDialog dialog(this, Tr(MSG_OPEN_TITLE), "", "",
+                       Tr(MSG_FILE_FILTER),
                        wxFD_OPEN | wxFD_FILE_MUST_EXIST);
     
     if (dialog.ShowModal() == wxID_OK)
     {
-        wxString filename = dialog.GetPath();
-        if (m_editor->LoadFile(filename))
+        OpenFile(dialog.GetPath());
+    }
+}
+
+bool MainFrame::OpenFile(const wxString& filename)
+{
+    // 先记录当前文档的视图状态
+    CaptureSession();
+    
+    // 编辑器无法容纳的文件单独提示
+    wxULongLong size = wxFileName::GetSize(filename);
+    if (size != wxInvalidSize && LaminaEditor::IsFileTooLarge((wxFileOffset)size.GetValue()))
+    {
+        wxMessageBox(wxString::Format(Tr(MSG_ERROR_FILE_TOO_LARGE), wxFileName::GetHumanReadableSize(size)),
+                     Tr(MSG_ERROR_TITLE), wxOK | wxICON_ERROR);
+        return false;
+    }
+    
+    if (!m_editor->LoadFile(filename))
+    {
+        wxMessageBox(Tr(MSG_ERROR_OPEN_FAILED), Tr(MSG_ERROR_TITLE), wxOK | wxICON_ERROR);
+        return false;
+    }
+    
+    m_currentFile = filename;
+    m_isModified = false;
+    UpdateTitle();
+    UpdateFileModeStatus();
+    UpdateWatchedFiles();
+    IncludeIndex::Get().Open(filename);
+    
+    m_session.activeIndex = TrackSessionDocument(filename);
+    m_editor->RestoreViewState(m_session.documents[m_session.activeIndex]);
+    RebuildSessionMenu();
+    CaptureSession();
+    
+    return true;
+}
+
+void MainFrame::RestoreSession()
+{
+    // 会话文件在构造时已开始在后台读取
+    if (!m_sessionLoad.get())
+        return;
+    
+    SessionSnapshot snapshot = std::move(m_loadedSession);
+    int active = snapshot.activeIndex;
+    m_session = snapshot;
+    m_session.activeIndex = -1;
+    
+    if (!m_session.theme.IsEmpty() && m_session.theme != ThemeConfig::Get().GetCurrentTheme() &&
+        ThemeConfig::Get().GetAvailableThemes().Index(m_session.theme) != wxNOT_FOUND)
+    {
+        m_editor->ApplyTheme(m_session.theme);
+    }
+    
+    RebuildSessionMenu();
+    
+    // 其他文件在选中时才加载；已恢复未保存内容时不覆盖
+    if (active >= 0 && m_currentFile.IsEmpty() && !m_isModified && wxFileExists(m_session.documents[active].path))
+        OpenFile(m_session.documents[active].path);
+}
+
+void MainFrame::CheckRecovery()
+{
+    wxArrayString journals = EditJournal::FindJournals();
+    for (const wxString& journal : journals)
+    {
+        JournalHeader header;
+        if (!EditJournal::ReadHeader(journal, header))
         {
-            m_currentFile = filename;
-            m_isModified = false;
-            UpdateTitle();
+            wxRemoveFile(journal);
+            continue;
         }
-        else
+        
+        wxString name = header.documentPath.IsEmpty() ? Tr(MSG_RECOVER_UNTITLED) : header.documentPath;
+        int result = wxMessageBox(wxString::Format(Tr(MSG_RECOVER_PROMPT), name),
+                                  Tr(MSG_RECOVER_TITLE), wxYES_NO | wxCANCEL | wxICON_QUESTION);
+        if (result == wxCANCEL)
+            continue;
+        
+        if (result == wxYES && m_editor->RecoverFromJournal(journal))
         {
-            wxMessageBox("Failed to open file", "Error", wxOK | wxICON_ERROR);
+            m_currentFile = header.documentPath;
+            m_isModified = true;
+            UpdateTitle();
+            UpdateFileModeStatus();
+            UpdateWatchedFiles();
+            
+            if (!m_currentFile.IsEmpty())
+            {
+                m_session.activeIndex = TrackSessionDocument(m_currentFile);
+                RebuildSessionMenu();
+            }
+            SetStatusText(Tr(MSG_STATUS_RECOVERED), 0);
+            
+            // 编辑器一次只打开一个文档，其余日志留到下次启动
+            return;
         }
+        
+        if (result == wxYES)
+            wxMessageBox(Tr(MSG_RECOVER_CHANGED), Tr(MSG_RECOVER_TITLE), wxOK | wxICON_ERROR);
+        wxRemoveFile(journal);
+    }
+}
+
+void MainFrame::CaptureSession()
+{
+    m_session.theme = ThemeConfig::Get().GetCurrentTheme();
+    if (m_session.activeIndex >= 0 && m_session.activeIndex < (int)m_session.documents.size())
+        m_editor->SaveViewState(m_session.documents[m_session.activeIndex]);
+    
+    m_sessionStore.Submit(m_session);
+    m_sessionDirty = false;
+}
+
+int MainFrame::TrackSessionDocument(const wxString& filename)
+{
+    for (size_t i = 0; i < m_session.documents.size(); ++i)
+    {
+        if (m_session.documents[i].path == filename)
+            return i;
+    }
+    
+    // 超出上限时移除最早加入的文件
+    if (m_session.documents.size() >= MAX_SESSION_DOCUMENTS)
+    {
+        m_session.documents.erase(m_session.documents.begin());
+        if (m_session.activeIndex >= 0)
+            --m_session.activeIndex;
+    }
+    
+    DocumentState state;
+    state.path = filename;
+    m_session.documents.push_back(state);
+    return m_session.documents.size() - 1;
+}
+
+void MainFrame::RebuildSessionMenu()
+{
+    if (!m_sessionMenu)
+        return;
+    
+    while (m_sessionMenu->GetMenuItemCount() > 0)
+        m_sessionMenu->Destroy(m_sessionMenu->FindItemByPosition(0));
+    
+    for (size_t i = 0; i < m_session.documents.size(); ++i)
+    {
+        wxString label = wxFileName(m_session.documents[i].path).GetFullName();
+        label.Replace("&", "&&");
+        m_sessionMenu->Append(ID_SESSION_FILE_START + i, label, m_session.documents[i].path);
     }
 }
 
+void MainFrame::OnSessionFile(wxCommandEvent& event)
+{
+    size_t index = event.GetId() - ID_SESSION_FILE_START;
+    if (index >= m_session.documents.size() || (int)index == m_session.activeIndex)
+        return;
+    
+    if (!CheckSaveChanges())
+        return;
+    
+    wxString filename = m_session.documents[index].path;
+    if (!wxFileExists(filename))
+    {
+        wxMessageBox(Tr(MSG_ERROR_FILE_MISSING), Tr(MSG_ERROR_TITLE), wxOK | wxICON_ERROR);
+        m_session.documents.erase(m_session.documents.begin() + index);
+        if (m_session.activeIndex > (int)index)
+            --m_session.activeIndex;
+        RebuildSessionMenu();
+        CaptureSession();
+        return;
+    }
+    
+    OpenFile(filename);
+}
+
+void MainFrame::OnSessionTimer(wxTimerEvent& event)
+{
+    if (m_sessionDirty)
+        CaptureSession();
+}
+
 void MainFrame::OnSave(wxCommandEvent& event)
 {
     if (m_currentFile.IsEmpty())
@@ -279,42 +804,122 @@ void MainFrame::OnSave(wxCommandEvent& event)
     }
     else
     {
-        if (m_editor->SaveFile(m_currentFile))
+        // 磁盘上的文件在打开后被其他程序修改过；监视器刚报告的变化可能还在等待合并
+        if (m_editor->IsDiskContentChanged(m_diskChangeTimer.IsRunning()) &&
+            wxMessageBox(wxString::Format(Tr(MSG_FILE_CHANGED_OVERWRITE), m_currentFile),
+                         Tr(MSG_FILE_CHANGED_TITLE), wxYES_NO | wxICON_WARNING) != wxYES)
+            return;
+        
+        if (SaveEditorFile(m_currentFile))
         {
             m_isModified = false;
             UpdateTitle();
-            SetStatusText("File saved", 0);
+            SetStatusText(Tr(MSG_STATUS_FILE_SAVED), 0);
         }
         else
         {
-            wxMessageBox("Failed to save file", "Error", wxOK | wxICON_ERROR);
+            wxMessageBox(Tr(MSG_ERROR_SAVE_FAILED), Tr(MSG_ERROR_TITLE), wxOK | wxICON_ERROR);
         }
     }
 }
 
 void MainFrame::OnSaveAs(wxCommandEvent& event)
 {
-    wxFileDialog dialog(this, "Save Lamina file", "", "",
-                       "Lamina files (*.lm)|*.lm|All files (*.*)|*.*",
+    wxFileDialog dialog(this, Tr(MSG_SAVE_TITLE), "", "",
+                       Tr(MSG_FILE_FILTER),
                        wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
     
     if (dialog.ShowModal() == wxID_OK)
     {
         wxString filename = dialog.GetPath();
-        if (m_editor->SaveFile(filename))
+        if (SaveEditorFile(filename))
         {
             m_currentFile = filename;
             m_isModified = false;
             UpdateTitle();
-            SetStatusText("File saved", 0);
+            UpdateWatchedFiles();
+            
+            m_session.activeIndex = TrackSessionDocument(filename);
+            RebuildSessionMenu();
+            CaptureSession();
+            SetStatusText(Tr(MSG_STATUS_FILE_SAVED), 0);
         }
         else
         {
-            wxMessageBox("Failed to save file", "Error", wxOK | wxICON_ERROR);
+            wxMessageBox(Tr(MSG_ERROR_SAVE_FAILED), Tr(MSG_ERROR_TITLE), wxOK | wxICON_ERROR);
         }
     }
 }
 
+bool MainFrame::SaveEditorFile(const wxString& filename)
+{
+    if (m_formatOnSave && wxFileName(filename).GetExt().IsSameAs("lm", false))
+        m_editor->FormatDocument();
+    
+    if (!m_editor->SaveFile(filename))
+        return false;
+    
+    // 只更新这个文件的出边
+    if (wxFileName(filename).GetExt().IsSameAs("lm", false))
+    {
+        IncludeIndex::Get().Update(filename, std::string_view(m_editor->GetCharacterPointer(), m_editor->GetTextLength()));
+        CheckIncludeCycle(filename);
+    }
+    return true;
+}
+
+void MainFrame::CheckIncludeCycle(const wxString& file)
+{
+    wxArrayString cycle = IncludeIndex::Get().FindCycle(file);
+    wxString text;
+    for (const wxString& path : cycle)
+    {
+        if (!text.IsEmpty())
+            text += " -> ";
+        text += wxFileName(path).GetFullName();
+    }
+    
+    if (text == m_lastIncludeCycle)
+        return;
+    m_lastIncludeCycle = text;
+    if (text.IsEmpty())
+        return;
+    
+    wxString message = wxString::Format(Tr(MSG_STATUS_INCLUDE_CYCLE), text);
+    SetStatusText(message, 0);
+    m_console->AppendText(ConsoleStream::Info, message + "\n");
+}
+
+void MainFrame::OnAffectedScripts(wxCommandEvent& event)
+{
+    if (m_currentFile.IsEmpty())
+        return;
+    
+    IncludeIndex& index = IncludeIndex::Get();
+    wxArrayString affected = index.GetAffected(m_currentFile);
+    m_console->AppendText(ConsoleStream::Info, wxString::Format(Tr(MSG_AFFECTED_HEADER),
+        wxFileName(m_currentFile).GetFullName(), (int)affected.size(), (int)index.GetFileCount()) + "\n");
+    for (const wxString& path : affected)
+        m_console->AppendText(ConsoleStream::Info, "  " + path + "\n");
+    if (index.IsScanning())
+        m_console->AppendText(ConsoleStream::Info, Tr(MSG_AFFECTED_SCANNING) + "\n");
+}
+
+void MainFrame::OnFormatDocument(wxCommandEvent& event)
+{
+    m_editor->FormatDocument();
+}
+
+void MainFrame::OnFormatSelection(wxCommandEvent& event)
+{
+    m_editor->FormatSelection();
+}
+
+void MainFrame::OnFormatOnSave(wxCommandEvent& event)
+{
+    m_formatOnSave = event.IsChecked();
+}
+
 void MainFrame::OnExit(wxCommandEvent& event)
 {
     Close();
@@ -354,10 +959,22 @@ void MainFrame::OnFind(wxCommandEvent& event)
 {
     if (m_editor)
     {
-        wxString findText = wxGetTextFromUser("Find:", "Find Text", "", this);
+        wxString findText = wxGetTextFromUser(Tr(MSG_FIND_PROMPT), Tr(MSG_FIND_TEXT_TITLE), "", this);
         if (!findText.IsEmpty())
         {
             int pos = m_editor->FindText(m_editor->GetCurrentPos(), m_editor->GetTextLength(), findText, 0);
+            
+            // 在缩略图上标记所有匹配所在的行
+            std::vector<int> hitLines;
+            m_editor->SetSearchFlags(0);
+            m_editor->SetTargetRange(0, m_editor->GetTextLength());
+            while (hitLines.size() < MAX_SEARCH_MARKERS && m_editor->SearchInTarget(findText) != -1)
+            {
+                hitLines.push_back(m_editor->LineFromPosition(m_editor->GetTargetStart()));
+                m_editor->SetTargetRange(std::max(m_editor->GetTargetEnd(), m_editor->GetTargetStart() + 1), m_editor->GetTextLength());
+            }
+            m_minimap->SetOverlay(MinimapOverlay::SearchHit, hitLines);
+            
             if (pos != -1)
             {
                 m_editor->SetSelection(pos, pos + findText.Length());
@@ -365,17 +982,208 @@ void MainFrame::OnFind(wxCommandEvent& event)
             }
             else
             {
-                wxMessageBox("Text not found", "Find", wxOK | wxICON_INFORMATION);
+                wxMessageBox(Tr(MSG_STATUS_TEXT_NOT_FOUND), Tr(MSG_FIND_TITLE), wxOK | wxICON_INFORMATION);
             }
         }
     }
 }
 
+void MainFrame::OnReplace(wxCommandEvent& event)
+{
+    if (m_findDialog)
+    {
+        m_findDialog->Raise();
+        return;
+    }
+    
+    if (!m_editor->GetSelectedText().IsEmpty())
+        m_findData.SetFindString(m_editor->GetSelectedText());
+    
+    m_findDialog = new wxFindReplaceDialog(this, &m_findData, Tr(MSG_REPLACE_TITLE), wxFR_REPLACEDIALOG);
+    m_findDialog->Show();
+}
+
+bool MainFrame::FindNextMatch()
+{
+    int flags = 0;
+    if (m_findData.GetFlags() & wxFR_MATCHCASE)
+        flags |= wxSTC_FIND_MATCHCASE;
+    if (m_findData.GetFlags() & wxFR_WHOLEWORD)
+        flags |= wxSTC_FIND_WHOLEWORD;
+    
+    bool down = (m_findData.GetFlags() & wxFR_DOWN) != 0;
+    int start = down ? m_editor->GetSelectionEnd() : m_editor->GetSelectionStart();
+    int end = down ? m_editor->GetTextLength() : 0;
+    
+    int matchEnd = 0;
+    int pos = m_editor->FindText(start, end, m_findData.GetFindString(), flags, &matchEnd);
+    if (pos == -1)
+    {
+        SetStatusText(Tr(MSG_STATUS_TEXT_NOT_FOUND), 0);
+        return false;
+    }
+    
+    m_editor->SetSelection(pos, matchEnd);
+    m_editor->EnsureCaretVisible();
+    return true;
+}
+
+void MainFrame::OnFindDialogNext(wxFindDialogEvent& event)
+{
+    FindNextMatch();
+}
+
+void MainFrame::OnFindDialogReplace(wxFindDialogEvent& event)
+{
+    // 当前选中的正是匹配内容时才替换，然后跳到下一处
+    wxString selected = m_editor->GetSelectedText();
+    bool matchCase = (event.GetFlags() & wxFR_MATCHCASE) != 0;
+    if (!selected.IsEmpty() && selected.IsSameAs(event.GetFindString(), matchCase))
+        m_editor->ReplaceSelection(event.GetReplaceString());
+    
+    FindNextMatch();
+}
+
+void MainFrame::OnFindDialogReplaceAll(wxFindDialogEvent& event)
+{
+    if (m_replaceRunning || event.GetFindString().IsEmpty())
+        return;
+    
+    if (m_replaceThread.joinable())
+        m_replaceThread.join();
+    
+    // 在文档副本上查找，界面在计算期间保持响应
+    std::string text(m_editor->GetCharacterPointer(), m_editor->GetTextLength());
+    wxScopedCharBuffer find = event.GetFindString().ToUTF8();
+    wxScopedCharBuffer replacement = event.GetReplaceString().ToUTF8();
+    std::string findText(find.data(), find.length());
+    std::string replacementText(replacement.data(), replacement.length());
+    bool matchCase = (event.GetFlags() & wxFR_MATCHCASE) != 0;
+    bool wholeWord = (event.GetFlags() & wxFR_WHOLEWORD) != 0;
+    unsigned long changeCount = m_editor->GetChangeCount();
+    
+    m_replaceRunning = true;
+    SetStatusText(Tr(MSG_STATUS_REPLACING), 0);
+    
+    m_replaceThread = std::thread([this, text = std::move(text), findText, replacementText, matchCase, wholeWord, changeCount]() {
+        auto edits = std::make_shared<std::vector<TextEdit>>(
+            BulkEdit::FindReplace(text, findText, replacementText, matchCase, wholeWord));
+        CallAfter([this, edits, changeCount]() { FinishReplaceAll(*edits, changeCount); });
+    });
+}
+
+void MainFrame::FinishReplaceAll(const std::vector<TextEdit>& edits, unsigned long changeCount)
+{
+    m_replaceRunning = false;
+    if (m_replaceThread.joinable())
+        m_replaceThread.join();
+    
+    // 计算期间文档被修改过，编辑位置已失效
+    if (changeCount != m_editor->GetChangeCount())
+    {
+        SetStatusText(Tr(MSG_STATUS_REPLACE_CANCELLED), 0);
+        return;
+    }
+    
+    if (edits.empty())
+    {
+        SetStatusText(Tr(MSG_STATUS_TEXT_NOT_FOUND), 0);
+        return;
+    }
+    
+    m_editor->ApplyEdits(edits);
+    SetStatusText(wxString::Format(Tr(MSG_STATUS_REPLACED), (unsigned long)edits.size()), 0);
+}
+
+void MainFrame::OnFindDialogClose(wxFindDialogEvent& event)
+{
+    m_findDialog->Destroy();
+    m_findDialog = nullptr;
+}
+
+void MainFrame::OnGotoLine(wxCommandEvent& event)
+{
+    if (m_editor)
+    {
+        int lineCount = m_editor->GetLineCount();
+        long line = wxGetNumberFromUser(wxString::Format(Tr(MSG_GOTO_LINE_PROMPT), lineCount), Tr(MSG_GOTO_LINE_LABEL), Tr(MSG_GOTO_LINE_TITLE),
+                                        m_editor->GetCurrentLine() + 1, 1, lineCount, this);
+        if (line > 0)
+        {
+            // 跳转只涉及目标行附近的布局，大文件中同样即时完成
+            m_editor->EnsureVisible(line - 1);
+            m_editor->GotoLine(line - 1);
+            m_editor->VerticalCentreCaret();
+        }
+    }
+}
+
+void MainFrame::OnMinimap(wxCommandEvent& event)
+{
+    m_auiManager.GetPane("minimap").Show(event.IsChecked());
+    m_auiManager.Update();
+}
+
+void MainFrame::OnOutline(wxCommandEvent& event)
+{
+    m_auiManager.GetPane("outline").Show(event.IsChecked());
+    m_auiManager.Update();
+}
+
+void MainFrame::OnPlot(wxCommandEvent& event)
+{
+    m_auiManager.GetPane("plot").Show(event.IsChecked());
+    m_auiManager.Update();
+}
+
 void MainFrame::OnRun(wxCommandEvent& event)
 {
     if (m_currentFile.IsEmpty())
     {
-        wxMessageBox("No file is currently open", "Error", wxOK | wxICON_ERROR);
+        wxMessageBox(Tr(MSG_ERROR_NO_FILE), Tr(MSG_ERROR_TITLE), wxOK | wxICON_ERROR);
+        return;
+    }
+    
+    if (m_isModified)
+    {
+        OnSave(event);
+    }
+    
+    StartScript();
+}
+
+void MainFrame::OnRunWithInput(wxCommandEvent& event)
+{
+    if (m_currentFile.IsEmpty())
+    {
+        wxMessageBox(Tr(MSG_ERROR_NO_FILE), Tr(MSG_ERROR_TITLE), wxOK | wxICON_ERROR);
+        return;
+    }
+    
+    wxFileDialog dialog(this, Tr(MSG_RUN_INPUT_TITLE), "", "", Tr(MSG_RUN_INPUT_FILTER),
+                        wxFD_OPEN | wxFD_FILE_MUST_EXIST);
+    if (dialog.ShowModal() != wxID_OK)
+        return;
+    
+    if (!wxFile::Access(dialog.GetPath(), wxFile::read))
+    {
+        wxMessageBox(Tr(MSG_RUN_INPUT_UNREADABLE), Tr(MSG_ERROR_TITLE), wxOK | wxICON_ERROR);
+        return;
+    }
+    
+    if (m_isModified)
+    {
+        OnSave(event);
+    }
+    
+    StartScript(dialog.GetPath());
+}
+
+void MainFrame::OnRunForce(wxCommandEvent& event)
+{
+    if (m_currentFile.IsEmpty())
+    {
+        wxMessageBox(Tr(MSG_ERROR_NO_FILE), Tr(MSG_ERROR_TITLE), wxOK | wxICON_ERROR);
         return;
     }
     
@@ -384,68 +1192,436 @@ void MainFrame::OnRun(wxCommandEvent& event)
         OnSave(event);
     }
     
+    // 重新运行，结果替换缓存中的记录
+    StartScript(wxEmptyString, false);
+}
+
+void MainFrame::OnRunCache(wxCommandEvent& event)
+{
+    m_runCacheEnabled = event.IsChecked();
+    if (!m_runCacheEnabled)
+        m_runCache.CancelRecording();
+}
+
+void MainFrame::StartScript(const wxString& inputFile, bool useCache)
+{
     if (!m_processManager)
     {
         m_processManager = new ProcessManager();
+        m_console->SetProcessManager(m_processManager);
+        
+        // 标准输入队列腾出空间后继续发送控制台中等待的输入
+        m_processManager->SetInputSpaceCallback([this]() {
+            m_console->FeedInput();
+        });
+        
+        // 输入文件的进度显示在状态栏
+        m_processManager->SetInputFileCallback([this](const InputFileProgress& progress) {
+            double megabytes = progress.sent / (1024.0 * 1024.0);
+            double rate = progress.seconds > 0 ? megabytes / progress.seconds : 0;
+            wxString status;
+            if (!progress.done)
+                status = wxString::Format(Tr(MSG_STATUS_INPUT_PROGRESS),
+                                          progress.total ? 100.0 * progress.sent / progress.total : 100.0, megabytes, rate);
+            else if (progress.failed)
+                status = wxString::Format(Tr(MSG_STATUS_INPUT_STOPPED), megabytes);
+            else
+                status = wxString::Format(Tr(MSG_STATUS_INPUT_SENT), megabytes, progress.seconds, rate);
+            SetStatusText(status, 2);
+        });
         
         // 设置输出回调
         m_processManager->SetOutputCallback([this](const wxString& output) {
+            if (m_watchLatencyPending) {
+                m_watchLatencyPending = false;
+                SetStatusText(wxString::Format(Tr(MSG_STATUS_WATCH_LATENCY), m_watchLatency.Time()), 2);
+            }
             if (m_console) {
-                m_console->SetDefaultStyle(wxTextAttr(wxColour(200, 200, 200)));
-                m_console->AppendText(output);
+                m_console->AppendText(ConsoleStream::Output, output);
             }
+            m_runCache.Record(ConsoleStream::Output, output);
+        });
+        
+        // 原始输出整块交给曲线面板解析，不经过按行的字符串转换
+        m_processManager->SetOutputDataCallback([this](const char* data, size_t size) {
+            m_plot->AppendData(data, size);
         });
         
         m_processManager->SetErrorCallback([this](const wxString& error) {
+            if (m_watchLatencyPending) {
+                m_watchLatencyPending = false;
+                SetStatusText(wxString::Format(Tr(MSG_STATUS_WATCH_LATENCY), m_watchLatency.Time()), 2);
+            }
             if (m_console) {
-                m_console->SetDefaultStyle(wxTextAttr(wxColour(255, 100, 100)));
-                m_console->AppendText("ERROR: " + error);
+                m_console->AppendText(ConsoleStream::Error, Tr(MSG_CONSOLE_ERROR_PREFIX) + error);
             }
+            m_runCache.Record(ConsoleStream::Error, error);
         });
         
         m_processManager->SetFinishedCallback([this](int exitCode) {
+            // 被信号结束或读取过控制台输入的运行不缓存
+            if (exitCode >= 0 && !m_processManager->HasReceivedInput())
+                m_runCache.Commit(exitCode);
+            else
+                m_runCache.CancelRecording();
+            m_plot->Finish();
             if (m_console) {
-                m_console->SetDefaultStyle(wxTextAttr(wxColour(100, 255, 100)));
-                m_console->AppendText(wxString::Format("\n--- Process finished with exit code %d ---\n", exitCode));
+                m_console->SetInputEnabled(false);
+                m_console->AppendText(ConsoleStream::Info, "\n" + wxString::Format(Tr(MSG_CONSOLE_PROCESS_FINISHED), exitCode) + "\n");
             }
-            SetStatusText("Script finished", 0);
+            m_watchLatencyPending = false;
+            SetStatusText(Tr(MSG_STATUS_SCRIPT_FINISHED), 0);
         });
     }
     
     // 清空控制台
     if (m_console) {
         m_console->Clear();
-        m_console->SetDefaultStyle(wxTextAttr(wxColour(150, 150, 255)));
-        m_console->AppendText(wxString::Format("Running: %s\n", m_currentFile));
-        m_console->SetDefaultStyle(wxTextAttr(wxColour(200, 200, 200)));
+        m_console->AppendText(ConsoleStream::Info, wxString::Format(Tr(MSG_CONSOLE_RUNNING), m_currentFile) + "\n");
+        if (!inputFile.IsEmpty())
+            m_console->AppendText(ConsoleStream::Info, wxString::Format(Tr(MSG_CONSOLE_INPUT_FILE), inputFile) + "\n");
+    }
+    
+    SetStatusText("", 2);
+    m_plot->Clear();
+    
+    // 输入来自文件的运行不使用缓存
+    m_runCache.CancelRecording();
+    uint64_t runKey = 0;
+    bool cacheable = m_runCacheEnabled && inputFile.IsEmpty()
+        && m_runCache.ComputeKey(m_interpreterPath, m_currentFile, wxEmptyString, runKey);
+    if (cacheable && useCache && ReplayCachedRun(runKey))
+    {
+        UpdateWatchedFiles();
+        return;
+    }
+    
+    if (!m_processManager->RunCommand(m_interpreterPath, m_currentFile, wxEmptyString, inputFile) && !inputFile.IsEmpty())
+    {
+        wxMessageBox(Tr(MSG_RUN_INPUT_UNREADABLE), Tr(MSG_ERROR_TITLE), wxOK | wxICON_ERROR);
+        return;
+    }
+    if (cacheable && m_processManager->IsRunning())
+        m_runCache.BeginRecording(runKey);
+    // 从文件读取输入时控制台输入不可用
+    m_console->SetInputEnabled(m_processManager->IsInputOpen());
+    SetStatusText(Tr(MSG_STATUS_SCRIPT_RUNNING), 0);
+    
+    // include 关系可能已变化
+    UpdateWatchedFiles();
+}
+
+bool MainFrame::StartRepl()
+{
+    if (!m_repl)
+    {
+        m_repl = new ReplSession();
+        
+        // 输出直接追加到控制台，请求的开始和结束各有一行说明
+        m_repl->SetOutputCallback([this](uint64_t id, ConsoleStream stream, const wxString& text) {
+            m_console->AppendText(stream, text);
+        });
+        
+        m_repl->SetDoneCallback([this](uint64_t id, long milliseconds, bool interrupted) {
+            if (interrupted)
+                m_console->AppendText(ConsoleStream::Info, wxString::Format(Tr(MSG_REPL_REQUEST_INTERRUPTED), (unsigned long long)id) + "\n");
+            else
+                m_console->AppendText(ConsoleStream::Info, wxString::Format(Tr(MSG_REPL_REQUEST_DONE), (unsigned long long)id, milliseconds) + "\n");
+            SetStatusText(wxString::Format(Tr(MSG_STATUS_REPL_DONE), milliseconds), 2);
+        });
+        
+        m_repl->SetEndedCallback([this](int exitCode) {
+            m_console->AppendText(ConsoleStream::Info, "\n" + wxString::Format(Tr(MSG_REPL_SESSION_ENDED), exitCode) + "\n");
+            SetStatusText(Tr(MSG_STATUS_REPL_STOPPED), 0);
+        });
+    }
+    
+    wxString workingDir;
+    if (!m_currentFile.IsEmpty())
+        workingDir = wxFileName(m_currentFile).GetPath();
+    
+    // 解释器命令中的 %lmfilepath% 参数被去掉
+    if (!m_repl->Start(m_interpreterPath, workingDir))
+    {
+        wxMessageBox(Tr(MSG_REPL_START_FAILED), Tr(MSG_ERROR_TITLE), wxOK | wxICON_ERROR);
+        return false;
     }
     
-    // 替换占位符
-    wxString command = m_interpreterPath;
-    command.Replace("%lmfilepath%", m_currentFile);
+    m_console->AppendText(ConsoleStream::Info, Tr(MSG_REPL_SESSION_STARTED) + "\n");
+    SetStatusText(Tr(MSG_STATUS_REPL_STARTED), 0);
+    return true;
+}
+
+void MainFrame::OnReplStart(wxCommandEvent& event)
+{
+    StartRepl();
+}
+
+void MainFrame::OnReplExecute(wxCommandEvent& event)
+{
+    // 没有选中时执行光标所在行，并把光标移到下一行以便连续执行
+    wxString code = m_editor->GetSelectedText();
+    if (code.IsEmpty())
+    {
+        code = m_editor->GetLine(m_editor->GetCurrentLine());
+        m_editor->LineDown();
+    }
+    if (code.Strip(wxString::both).IsEmpty())
+        return;
+    
+    if ((!m_repl || !m_repl->IsRunning()) && !StartRepl())
+        return;
+    
+    uint64_t id = m_repl->Execute(code);
+    if (id == 0)
+    {
+        wxMessageBox(Tr(MSG_REPL_NOT_ACCEPTING), Tr(MSG_ERROR_TITLE), wxOK | wxICON_ERROR);
+        return;
+    }
     
-    m_processManager->RunCommand(command);
-    SetStatusText("Script is running...", 0);
+    wxString firstLine = code.Strip(wxString::leading).BeforeFirst('\n');
+    firstLine.Trim();
+    if (code.Strip(wxString::both).Find('\n') != wxNOT_FOUND)
+        firstLine += " ...";
+    m_console->AppendText(ConsoleStream::Info, wxString::Format(Tr(MSG_REPL_REQUEST), (unsigned long long)id, firstLine) + "\n");
+}
+
+void MainFrame::OnReplInterrupt(wxCommandEvent& event)
+{
+    if (!m_repl || !m_repl->IsRunning())
+        return;
+    
+    if (!m_repl->Interrupt())
+        wxMessageBox(Tr(MSG_REPL_INTERRUPT_UNSUPPORTED), Tr(MSG_ERROR_TITLE), wxOK | wxICON_ERROR);
+}
+
+void MainFrame::OnReplStop(wxCommandEvent& event)
+{
+    if (m_repl && m_repl->IsRunning())
+    {
+        m_repl->Stop();
+        m_console->AppendText(ConsoleStream::Info, "\n" + Tr(MSG_REPL_SESSION_STOPPED) + "\n");
+        SetStatusText(Tr(MSG_STATUS_REPL_STOPPED), 0);
+    }
+}
+
+bool MainFrame::ReplayCachedRun(uint64_t key)
+{
+    if (m_processManager->IsRunning())
+        m_processManager->StopProcess();
+    
+    CachedRun run;
+    bool replayed = m_runCache.Replay(key, [this](ConsoleStream stream, std::string_view text) {
+        wxString line = wxString::FromUTF8(text.data(), text.size());
+        m_console->AppendText(stream, stream == ConsoleStream::Error ? Tr(MSG_CONSOLE_ERROR_PREFIX) + line : line);
+        if (stream == ConsoleStream::Output)
+            m_plot->AppendData(text.data(), text.size());
+    }, run);
+    if (!replayed)
+        return false;
+    m_plot->Finish();
+    
+    m_console->SetInputEnabled(false);
+    m_console->AppendText(ConsoleStream::Info, "\n" + wxString::Format(Tr(MSG_CONSOLE_PROCESS_FINISHED_CACHED), run.exitCode) + "\n");
+    m_watchLatencyPending = false;
+    SetStatusText(wxString::Format(Tr(MSG_STATUS_RUN_CACHED), run.recorded.Format("%Y-%m-%d %H:%M")), 0);
+    return true;
 }
 
 void MainFrame::OnStop(wxCommandEvent& event)
 {
     if (m_processManager)
     {
+        m_runCache.CancelRecording();
         m_processManager->StopProcess();
-        SetStatusText("Script stopped", 0);
+        m_console->SetInputEnabled(false);
+        SetStatusText(Tr(MSG_STATUS_SCRIPT_STOPPED), 0);
+    }
+}
+
+void MainFrame::OnWatchMode(wxCommandEvent& event)
+{
+    if (event.IsChecked() && m_currentFile.IsEmpty())
+    {
+        wxMessageBox(Tr(MSG_ERROR_NO_FILE), Tr(MSG_ERROR_TITLE), wxOK | wxICON_ERROR);
+        GetMenuBar()->Check(ID_WATCH_MODE, false);
+        return;
+    }
+    
+    m_watchMode = event.IsChecked();
+    UpdateWatchedFiles();
+    
+    if (!m_watchMode)
+    {
+        m_watchTimer.Stop();
+        m_watchLatencyPending = false;
+        SetStatusText("", 2);
+    }
+    SetStatusText(Tr(m_watchMode ? MSG_STATUS_WATCH_ON : MSG_STATUS_WATCH_OFF), 0);
+}
+
+void MainFrame::UpdateWatchedFiles()
+{
+    std::vector<int> handles;
+    if (m_watchMode && !m_currentFile.IsEmpty())
+    {
+        // 包含的文件取自后台维护的关系图，不在主线程中读取；扫描完成后会再次更新
+        wxArrayString files = IncludeIndex::Get().GetDependencies(m_currentFile);
+        files.Insert(m_currentFile, 0);
+        for (const wxString& file : files)
+        {
+            handles.push_back(FileWatcher::Get().Watch(file, [this](const wxString&) {
+                OnWatchedFileChanged();
+            }));
+        }
+    }
+    
+    // 先注册新的再注销旧的，避免目录监视被短暂移除
+    for (int handle : m_watchHandles)
+        FileWatcher::Get().Unwatch(handle);
+    m_watchHandles.swap(handles);
+    
+    // 当前文件始终监视，用于发现外部修改
+    int fileHandle = -1;
+    if (!m_currentFile.IsEmpty())
+    {
+        fileHandle = FileWatcher::Get().Watch(m_currentFile, [this](const wxString&) {
+            m_diskChangeTimer.Start(DISK_CHANGE_DEBOUNCE_MS, wxTIMER_ONE_SHOT);
+        });
+    }
+    if (m_fileWatchHandle >= 0)
+        FileWatcher::Get().Unwatch(m_fileWatchHandle);
+    m_fileWatchHandle = fileHandle;
+    m_diskChangeTimer.Stop();
+}
+
+void MainFrame::OnDiskChangeTimer(wxTimerEvent& event)
+{
+    // 哈希比较与差异计算都在编辑器的后台线程中进行
+    m_editor->CheckDiskChange();
+}
+
+void MainFrame::OnThemeReloadTimer(wxTimerEvent& event)
+{
+    ThemeConfig& themes = ThemeConfig::Get();
+    wxArrayString oldThemes = themes.GetAvailableThemes();
+    if (!themes.Reload() || !m_editor)
+        return;
+    
+    // 切换主题时 ThemeConfig 自己也会写文件，这时没有样式变化，不提示
+    size_t changed = m_editor->ApplyTheme();
+    if (changed > 0)
+    {
+        m_minimap->Refresh();
+        SetStatusText(wxString::Format(Tr(MSG_STATUS_THEME_RELOADED), (unsigned long)changed), 0);
+    }
+    
+    // 主题列表变化时重建主题菜单
+    if (oldThemes != themes.GetAvailableThemes())
+        RebuildThemeMenu();
+}
+
+void MainFrame::OnDiskContentChanged()
+{
+    if (m_diskPromptOpen)
+        return;
+    
+    if (!m_isModified)
+    {
+        if (m_editor->ApplyDiskChange())
+        {
+            m_isModified = false;
+            UpdateTitle();
+            UpdateFileModeStatus();
+            SetStatusText(Tr(MSG_STATUS_RELOADED), 0);
+        }
+        return;
+    }
+    
+    m_diskPromptOpen = true;
+    int result = wxMessageBox(wxString::Format(Tr(MSG_FILE_CHANGED_RELOAD), m_currentFile),
+                              Tr(MSG_FILE_CHANGED_TITLE), wxYES_NO | wxICON_QUESTION);
+    m_diskPromptOpen = false;
+    
+    if (result == wxYES && m_editor->ApplyDiskChange())
+    {
+        m_isModified = false;
+        UpdateTitle();
+        UpdateFileModeStatus();
+        SetStatusText(Tr(MSG_STATUS_RELOADED), 0);
+    }
+    else if (result != wxYES)
+    {
+        m_editor->DiscardDiskChange();
+    }
+}
+
+void MainFrame::OnWatchedFileChanged()
+{
+    // 一次保存会产生多个事件，从第一个事件开始计时
+    if (!m_watchTimer.IsRunning())
+        m_watchLatency.Start();
+    m_watchTimer.Start(WATCH_DEBOUNCE_MS, wxTIMER_ONE_SHOT);
+}
+
+void MainFrame::OnWatchTimer(wxTimerEvent& event)
+{
+    if (!m_watchMode || m_currentFile.IsEmpty())
+        return;
+    
+    // 取消正在运行的旧进程，其残留输出不会进入控制台
+    if (m_processManager && m_processManager->IsRunning())
+        m_processManager->StopProcess();
+    
+    m_watchLatencyPending = true;
+    StartScript();
+}
+
+void MainFrame::OnRunDirectory(wxCommandEvent& event)
+{
+    if (m_batchPanel && m_batchPanel->IsRunning())
+    {
+        wxMessageBox(Tr(MSG_BATCH_IN_PROGRESS), Tr(MSG_ERROR_TITLE), wxOK | wxICON_ERROR);
+        return;
+    }
+    
+    wxString defaultDir = m_currentFile.IsEmpty() ? wxGetCwd() : wxFileName(m_currentFile).GetPath();
+    wxDirDialog dialog(this, Tr(MSG_BATCH_DIR_TITLE), defaultDir, wxDD_DEFAULT_STYLE | wxDD_DIR_MUST_EXIST);
+    if (dialog.ShowModal() != wxID_OK)
+        return;
+    
+    if (!m_batchPanel)
+    {
+        m_batchPanel = new BatchPanel(this);
+        m_batchPanel->SetStatusCallback([this](const wxString& status) {
+            SetStatusText(status, 0);
+        });
+        
+        m_auiManager.AddPane(m_batchPanel, wxAuiPaneInfo()
+            .Bottom()
+            .Name("batch")
+            .Caption(Tr(MSG_PANE_BATCH))
+            .MinSize(wxSize(-1, 150))
+            .BestSize(wxSize(-1, 250)));
+    }
+    
+    m_auiManager.GetPane(m_batchPanel).Show();
+    m_auiManager.Update();
+    
+    if (!m_batchPanel->RunDirectory(dialog.GetPath(), m_interpreterPath))
+    {
+        wxMessageBox(Tr(MSG_BATCH_NO_SCRIPTS), Tr(MSG_ERROR_TITLE), wxOK | wxICON_ERROR);
     }
 }
 
 void MainFrame::OnSettings(wxCommandEvent& event)
 {
-    wxDialog dialog(this, wxID_ANY, "Interpreter Configuration", wxDefaultPosition, wxSize(400, 200));
+    wxDialog dialog(this, wxID_ANY, Tr(MSG_SETTINGS_TITLE), wxDefaultPosition, wxSize(400, 200));
     
     wxBoxSizer* mainSizer = new wxBoxSizer(wxVERTICAL);
     
     // 说明文本
-    wxStaticText* label = new wxStaticText(&dialog, wxID_ANY, 
-        "Configure the path to the LaminaLab interpreter.\nUse %lmfilepath% as placeholder for the current file path.");
+    wxStaticText* label = new wxStaticText(&dialog, wxID_ANY, Tr(MSG_SETTINGS_HINT));
     mainSizer->Add(label, 0, wxALL | wxEXPAND, 10);
     
     // 路径输入
@@ -455,8 +1631,9 @@ void MainFrame::OnSettings(wxCommandEvent& event)
     
     // 按钮
     wxBoxSizer* buttonSizer = new wxBoxSizer(wxHORIZONTAL);
-    wxButton* okBtn = new wxButton(&dialog, wxID_OK, "OK");
-    wxButton* cancelBtn = new wxButton(&dialog, wxID_CANCEL, "Cancel");
+    // 标准按钮的文字由 wxWidgets 按系统语言翻译
+    wxButton* okBtn = new wxButton(&dialog, wxID_OK);
+    wxButton* cancelBtn = new wxButton(&dialog, wxID_CANCEL);
     buttonSizer->Add(okBtn, 0, wxRIGHT, 5);
     buttonSizer->Add(cancelBtn, 0, 0, 0);
     mainSizer->Add(buttonSizer, 0, wxALL | wxALIGN_RIGHT, 10);
@@ -470,6 +1647,40 @@ void MainFrame::OnSettings(wxCommandEvent& event)
     }
 }
 
+void MainFrame::OnLanguage(wxCommandEvent& event)
+{
+    LanguageManager& languages = LanguageManager::GetInstance();
+    LanguageManager::Language language = static_cast<LanguageManager::Language>(event.GetId() - ID_LANGUAGE_START);
+    if (language == languages.GetCurrentLanguage() || !languages.SetLanguage(language))
+        return;
+    languages.SaveSettings();
+    
+    // 重新创建菜单栏和工具栏，会话文件列表与勾选状态随之恢复
+    CreateMenuBar();
+    RebuildSessionMenu();
+    
+    wxToolBar* toolBar = GetToolBar();
+    SetToolBar(nullptr);
+    delete toolBar;
+    CreateToolBar();
+    
+    m_outline->UpdateLabels();
+    m_console->UpdateLabels();
+    if (m_batchPanel)
+        m_batchPanel->UpdateLabels();
+    m_auiManager.GetPane("editor").Caption(Tr(MSG_PANE_EDITOR));
+    m_auiManager.GetPane("console").Caption(Tr(MSG_PANE_CONSOLE));
+    m_auiManager.GetPane("outline").Caption(Tr(MSG_PANE_OUTLINE));
+    m_auiManager.GetPane("plot").Caption(Tr(MSG_PANE_PLOT));
+    m_auiManager.GetPane("batch").Caption(Tr(MSG_PANE_BATCH));
+    m_auiManager.Update();
+    
+    SetStatusText(Tr(MSG_STATUS_READY), 0);
+    UpdateFileModeStatus();
+    wxStyledTextEvent updateEvent;
+    OnUpdateUI(updateEvent);
+}
+
 void MainFrame::OnTheme(wxCommandEvent& event)
 {
     if (m_editor)
@@ -481,20 +1692,66 @@ void MainFrame::OnTheme(wxCommandEvent& event)
         {
             wxString themeName = ThemeConfig::Get().GetAvailableThemes()[themeIndex];
             m_editor->ApplyTheme(themeName);
+            m_minimap->Refresh();
+            m_sessionDirty = true;
         }
     }
 }
 
+// 进程的常驻内存（字节），无法获得时返回 0
+static size_t GetResidentMemory()
+{
+#ifdef __LINUX__
+    // /proc/self/statm 的第二项是常驻内存页数
+    std::ifstream statm("/proc/self/statm");
+    size_t pages = 0;
+    size_t resident = 0;
+    if (statm >> pages >> resident)
+        return resident * sysconf(_SC_PAGESIZE);
+#endif
+    return 0;
+}
+
+static wxString FormatBytes(size_t bytes)
+{
+    return wxFileName::GetHumanReadableSize(wxULongLong(bytes));
+}
+
+void MainFrame::OnMemoryUsage(wxCommandEvent& event)
+{
+    EditorMemoryUsage usage = m_editor->GetMemoryUsage();
+    size_t budget = m_editor->GetUndoBudget();
+    size_t resident = GetResidentMemory();
+    
+    wxString report = wxString::Format(Tr(MSG_MEMORY_REPORT),
+        m_currentFile.IsEmpty() ? Tr(MSG_MEMORY_UNTITLED) : wxFileName(m_currentFile).GetFullName(),
+        FormatBytes(usage.text),
+        FormatBytes(usage.styles),
+        FormatBytes(usage.undo),
+        budget > 0 ? FormatBytes(budget) : Tr(MSG_MEMORY_UNLIMITED),
+        FormatBytes(usage.markers),
+        FormatBytes(m_console->GetMemoryUsage()),
+        FormatBytes(m_plot->GetMemoryUsage()),
+        resident > 0 ? FormatBytes(resident) : wxString("-"));
+    wxMessageBox(report, Tr(MSG_MEMORY_TITLE), wxOK | wxICON_INFORMATION, this);
+}
+
 void MainFrame::OnAbout(wxCommandEvent& event)
 {
-    wxMessageBox("LaminaLab IDE v0.0.1-Alpha\n\nA simple IDE for the Lamina programming language.",
-                 "About LaminaLab IDE", wxOK | wxICON_INFORMATION);
+    wxMessageBox(Tr(MSG_ABOUT_TEXT), Tr(MSG_ABOUT_TITLE), wxOK | wxICON_INFORMATION);
 }
 
 void MainFrame::OnClose(wxCloseEvent& event)
 {
     if (CheckSaveChanges())
     {
+        if (m_batchPanel)
+            m_batchPanel->Cancel();
+        
+        m_sessionTimer.Stop();
+        CaptureSession();
+        m_sessionStore.Flush();
+        
         SaveSettings();
         event.Skip();
     }
@@ -519,7 +1776,8 @@ void MainFrame::OnUpdateUI(wxStyledTextEvent& event)
     {
         int line = m_editor->GetCurrentLine() + 1;
         int col = m_editor->GetColumn(m_editor->GetCurrentPos()) + 1;
-        SetStatusText(wxString::Format("Line %d, Column %d", line, col), 1);
+        SetStatusText(wxString::Format(Tr(MSG_STATUS_LINE_COLUMN), line, col), 1);
+        m_sessionDirty = true;
     }
 }
 
@@ -527,7 +1785,7 @@ bool MainFrame::CheckSaveChanges()
 {
     if (m_isModified)
     {
-        int result = wxMessageBox("Save changes?", "Confirm", 
+        int result = wxMessageBox(Tr(MSG_CONFIRM_SAVE), Tr(MSG_CONFIRM_TITLE),
                                  wxYES_NO | wxCANCEL | wxICON_QUESTION);
         
         if (result == wxYES)
@@ -0,0 +1,439 @@
+#include "MinimapPanel.h"
+#include "LaminaEditor.h"
+#include <wx/dcbuffer.h>
+#include <wx/dcgraph.h>
+#include <algorithm>
+#include <climits>
+
+// 每个图块覆盖的行数，编辑时只重绘受影响的图块
+static const int TILE_LINES = 256;
+
+// 每行占两个像素（一行字形加一行间隔），每个字符占一个像素
+static const int LINE_PIXELS = 2;
+static const int MINIMAP_COLUMNS = 120;
+static const int TILE_HEIGHT = TILE_LINES * LINE_PIXELS;
+
+// 每行最多取多少字节参与渲染，超长行只显示开头
+static const int MAX_LINE_BYTES = MINIMAP_COLUMNS * 4;
+
+// 缓存的图块上限，超出时丢弃最久未显示的图块
+static const size_t MAX_CACHED_TILES = 48;
+
+// 编辑后延迟刷新，连续输入只渲染一次
+static const int UPDATE_DELAY_MS = 100;
+
+// 字形颜色与背景的混合比例（百分比）
+static const int GLYPH_OPACITY = 70;
+
+static const uint32_t OVERLAY_COLOURS[] = {
+    0xFFA000,   // 搜索结果
+    0xE63232    // 诊断信息
+};
+
+static uint32_t PackColour(const wxColour& colour)
+{
+    return (colour.Red() << 16) | (colour.Green() << 8) | colour.Blue();
+}
+
+static wxColour UnpackColour(uint32_t colour)
+{
+    return wxColour((colour >> 16) & 0xFF, (colour >> 8) & 0xFF, colour & 0xFF);
+}
+
+wxBEGIN_EVENT_TABLE(MinimapPanel, wxWindow)
+    EVT_PAINT(MinimapPanel::OnPaint)
+    EVT_SIZE(MinimapPanel::OnSize)
+    EVT_LEFT_DOWN(MinimapPanel::OnMouseDown)
+    EVT_MOTION(MinimapPanel::OnMouseMove)
+    EVT_LEFT_UP(MinimapPanel::OnMouseUp)
+    EVT_MOUSE_CAPTURE_LOST(MinimapPanel::OnCaptureLost)
+    EVT_TIMER(wxID_ANY, MinimapPanel::OnUpdateTimer)
+wxEND_EVENT_TABLE()
+
+MinimapPanel::MinimapPanel(wxWindow* parent, LaminaEditor* editor, wxWindowID id)
+    : wxWindow(parent, id, wxDefaultPosition, wxSize(MINIMAP_COLUMNS, -1), wxFULL_REPAINT_ON_RESIZE)
+    , m_editor(editor)
+    , m_useCounter(0)
+    , m_background(0xFFFFFF)
+    , m_updateTimer(this)
+    , m_dragging(false)
+    , m_colourising(false)
+    , m_stop(false)
+{
+    SetBackgroundStyle(wxBG_STYLE_PAINT);
+    SetMinSize(wxSize(MINIMAP_COLUMNS, -1));
+    SetCursor(wxCursor(wxCURSOR_HAND));
+
+    // 编辑器事件先经过缩略图，再交给编辑器和主窗口处理
+    m_editor->Bind(wxEVT_STC_MODIFIED, &MinimapPanel::OnEditorModified, this);
+    m_editor->Bind(wxEVT_STC_UPDATEUI, &MinimapPanel::OnEditorUpdateUI, this);
+
+    UpdatePalette();
+    SyncTileCount();
+
+    m_worker = std::thread(&MinimapPanel::WorkerLoop, this);
+}
+
+MinimapPanel::~MinimapPanel()
+{
+    m_editor->Unbind(wxEVT_STC_MODIFIED, &MinimapPanel::OnEditorModified, this);
+    m_editor->Unbind(wxEVT_STC_UPDATEUI, &MinimapPanel::OnEditorUpdateUI, this);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+        m_jobs.clear();
+    }
+    m_condition.notify_all();
+    if (m_worker.joinable())
+        m_worker.join();
+}
+
+void MinimapPanel::SetOverlay(MinimapOverlay overlay, std::vector<int> lines)
+{
+    std::sort(lines.begin(), lines.end());
+    lines.erase(std::unique(lines.begin(), lines.end()), lines.end());
+    m_overlays[(int)overlay].swap(lines);
+    Refresh();
+}
+
+void MinimapPanel::SyncTileCount()
+{
+    size_t count = (m_editor->GetLineCount() + TILE_LINES - 1) / TILE_LINES;
+    m_tiles.resize(std::max<size_t>(count, 1));
+}
+
+void MinimapPanel::InvalidateLines(int firstLine, int lastLine)
+{
+    SyncTileCount();
+
+    size_t first = std::max(firstLine, 0) / TILE_LINES;
+    size_t last = std::min<size_t>(std::max(lastLine, 0) / TILE_LINES, m_tiles.size() - 1);
+    for (size_t i = first; i <= last; ++i)
+    {
+        m_tiles[i].dirty = true;
+        ++m_tiles[i].generation;
+    }
+}
+
+void MinimapPanel::InvalidateAll()
+{
+    InvalidateLines(0, INT_MAX);
+}
+
+bool MinimapPanel::UpdatePalette()
+{
+    // 颜色取自编辑器当前的样式，即 ThemeConfig 所应用的主题
+    std::vector<uint32_t> palette;
+    for (int style = 0; style < wxSTC_STYLE_DEFAULT; ++style)
+        palette.push_back(PackColour(m_editor->StyleGetForeground(style)));
+    uint32_t background = PackColour(m_editor->StyleGetBackground(wxSTC_STYLE_DEFAULT));
+
+    if (palette == m_palette && background == m_background)
+        return false;
+
+    m_palette.swap(palette);
+    m_background = background;
+    return true;
+}
+
+void MinimapPanel::OnEditorModified(wxStyledTextEvent& event)
+{
+    int type = event.GetModificationType();
+    int position = event.GetPosition();
+
+    if (type & (wxSTC_MOD_INSERTTEXT | wxSTC_MOD_DELETETEXT))
+    {
+        // 行数变化时后面的图块整体移位，只标记失效，渲染仍只针对可见图块
+        int line = m_editor->LineFromPosition(position);
+        InvalidateLines(line, event.GetLinesAdded() == 0 ? line : INT_MAX);
+    }
+    else if ((type & wxSTC_MOD_CHANGESTYLE) && !m_colourising)
+    {
+        InvalidateLines(m_editor->LineFromPosition(position),
+                        m_editor->LineFromPosition(position + event.GetLength()));
+    }
+    else
+    {
+        event.Skip();
+        return;
+    }
+
+    if (IsShownOnScreen() && !m_updateTimer.IsRunning())
+        m_updateTimer.StartOnce(UPDATE_DELAY_MS);
+
+    event.Skip();
+}
+
+void MinimapPanel::OnEditorUpdateUI(wxStyledTextEvent& event)
+{
+    if (event.GetUpdated() & wxSTC_UPDATE_V_SCROLL)
+        Refresh();
+    event.Skip();
+}
+
+void MinimapPanel::OnUpdateTimer(wxTimerEvent& event)
+{
+    Refresh();
+}
+
+void MinimapPanel::OnSize(wxSizeEvent& event)
+{
+    Refresh();
+    event.Skip();
+}
+
+int MinimapPanel::GetScrollOffset() const
+{
+    int contentHeight = m_editor->GetLineCount() * LINE_PIXELS;
+    int height = GetClientSize().y;
+    if (contentHeight <= height)
+        return 0;
+
+    // 文档高于面板时，缩略图随编辑器按比例滚动
+    int firstLine = m_editor->DocLineFromVisible(m_editor->GetFirstVisibleLine());
+    int maxFirstLine = std::max(1, m_editor->GetLineCount() - m_editor->LinesOnScreen());
+    double ratio = std::min(1.0, (double)firstLine / maxFirstLine);
+    return (int)((contentHeight - height) * ratio);
+}
+
+void MinimapPanel::ScrollToPoint(int y)
+{
+    int line = (y + GetScrollOffset()) / LINE_PIXELS;
+    int firstLine = std::max(0, line - m_editor->LinesOnScreen() / 2);
+    m_editor->SetFirstVisibleLine(m_editor->VisibleFromDocLine(firstLine));
+    Refresh();
+}
+
+void MinimapPanel::OnPaint(wxPaintEvent& event)
+{
+    wxAutoBufferedPaintDC dc(this);
+
+    if (UpdatePalette())
+        InvalidateAll();
+    SyncTileCount();
+
+    wxSize size = GetClientSize();
+    dc.SetBackground(wxBrush(UnpackColour(m_background)));
+    dc.Clear();
+
+    int offset = GetScrollOffset();
+    size_t firstTile = offset / TILE_HEIGHT;
+    size_t lastTile = std::min<size_t>((offset + size.y) / TILE_HEIGHT, m_tiles.size() - 1);
+
+    // 先画旧位图，失效的图块在后台重新渲染后再替换
+    for (size_t i = firstTile; i <= lastTile; ++i)
+    {
+        Tile& tile = m_tiles[i];
+        tile.lastUsed = ++m_useCounter;
+        if (tile.bitmap.IsOk())
+            dc.DrawBitmap(tile.bitmap, 0, (int)(i * TILE_HEIGHT) - offset);
+        if (tile.dirty && !tile.pending)
+            RequestTile(i);
+    }
+
+    // 叠加标记画在右侧边缘
+    int firstLine = offset / LINE_PIXELS;
+    int lastLine = (offset + size.y) / LINE_PIXELS;
+    dc.SetPen(*wxTRANSPARENT_PEN);
+    for (int overlay = 0; overlay < (int)MinimapOverlay::Count; ++overlay)
+    {
+        const std::vector<int>& lines = m_overlays[overlay];
+        dc.SetBrush(wxBrush(UnpackColour(OVERLAY_COLOURS[overlay])));
+        for (auto it = std::lower_bound(lines.begin(), lines.end(), firstLine);
+             it != lines.end() && *it <= lastLine; ++it)
+        {
+            dc.DrawRectangle(size.x - 4, *it * LINE_PIXELS - offset, 4, std::max(LINE_PIXELS, 2));
+        }
+    }
+
+    // 编辑器当前可见区域
+    int viewTop = m_editor->DocLineFromVisible(m_editor->GetFirstVisibleLine()) * LINE_PIXELS - offset;
+    int viewHeight = std::max(m_editor->LinesOnScreen() * LINE_PIXELS, 4);
+    wxGCDC gcdc(dc);
+    gcdc.SetPen(wxPen(wxColour(128, 128, 128, 160)));
+    gcdc.SetBrush(wxBrush(wxColour(128, 128, 128, 60)));
+    gcdc.DrawRectangle(0, viewTop, size.x, viewHeight);
+}
+
+void MinimapPanel::RequestTile(size_t tile)
+{
+    int firstLine = (int)(tile * TILE_LINES);
+    int lastLine = std::min(m_editor->GetLineCount(), firstLine + TILE_LINES);
+    if (firstLine >= lastLine)
+        return;
+
+    // 确保图块范围已着色，自身触发的样式变化不再使图块失效
+    m_colourising = true;
+    m_editor->Colourise(m_editor->PositionFromLine(firstLine), m_editor->GetLineEndPosition(lastLine - 1));
+    m_colourising = false;
+
+    MinimapJob job;
+    job.tile = tile;
+    job.generation = m_tiles[tile].generation;
+    job.palette = m_palette;
+    job.background = m_background;
+    job.tabWidth = std::max(1, m_editor->GetTabWidth());
+
+    for (int line = firstLine; line < lastLine; ++line)
+    {
+        int start = m_editor->PositionFromLine(line);
+        int end = std::min(m_editor->GetLineEndPosition(line), start + MAX_LINE_BYTES);
+        job.lineStarts.push_back(job.cells.size());
+        if (end > start)
+        {
+            wxMemoryBuffer styled = m_editor->GetStyledText(start, end);
+            job.cells.append(static_cast<const char*>(styled.GetData()), styled.GetDataLen());
+        }
+    }
+
+    m_tiles[tile].dirty = false;
+    m_tiles[tile].pending = true;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(std::move(job));
+    }
+    m_condition.notify_one();
+}
+
+void MinimapPanel::OnTileRendered(size_t tile, unsigned generation, const std::vector<unsigned char>& pixels)
+{
+    if (tile >= m_tiles.size())
+        return;
+
+    // 渲染期间图块又被修改时仍先显示结果，随后再次渲染
+    Tile& entry = m_tiles[tile];
+    entry.pending = false;
+    if (generation != entry.generation)
+        entry.dirty = true;
+
+    wxImage image(MINIMAP_COLUMNS, TILE_HEIGHT, false);
+    std::copy(pixels.begin(), pixels.end(), image.GetData());
+    entry.bitmap = wxBitmap(image);
+
+    EvictTiles();
+    Refresh();
+}
+
+void MinimapPanel::EvictTiles()
+{
+    size_t cached = std::count_if(m_tiles.begin(), m_tiles.end(),
+                                  [](const Tile& tile) { return tile.bitmap.IsOk(); });
+
+    while (cached > MAX_CACHED_TILES)
+    {
+        Tile* oldest = nullptr;
+        for (Tile& tile : m_tiles)
+        {
+            if (tile.bitmap.IsOk() && (!oldest || tile.lastUsed < oldest->lastUsed))
+                oldest = &tile;
+        }
+        oldest->bitmap = wxNullBitmap;
+        oldest->dirty = true;
+        --cached;
+    }
+}
+
+void MinimapPanel::OnMouseDown(wxMouseEvent& event)
+{
+    m_dragging = true;
+    CaptureMouse();
+    ScrollToPoint(event.GetY());
+}
+
+void MinimapPanel::OnMouseMove(wxMouseEvent& event)
+{
+    if (m_dragging && event.LeftIsDown())
+        ScrollToPoint(event.GetY());
+}
+
+void MinimapPanel::OnMouseUp(wxMouseEvent& event)
+{
+    if (m_dragging)
+    {
+        m_dragging = false;
+        if (HasCapture())
+            ReleaseMouse();
+    }
+}
+
+void MinimapPanel::OnCaptureLost(wxMouseCaptureLostEvent& event)
+{
+    m_dragging = false;
+}
+
+void MinimapPanel::WorkerLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;)
+    {
+        m_condition.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+        if (m_stop)
+            break;
+
+        MinimapJob job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+        lock.unlock();
+
+        std::vector<unsigned char> pixels = RenderTile(job);
+        size_t tile = job.tile;
+        unsigned generation = job.generation;
+        CallAfter([this, tile, generation, pixels]() { OnTileRendered(tile, generation, pixels); });
+
+        lock.lock();
+    }
+}
+
+std::vector<unsigned char> MinimapPanel::RenderTile(const MinimapJob& job)
+{
+    std::vector<unsigned char> pixels(MINIMAP_COLUMNS * TILE_HEIGHT * 3);
+    unsigned char bgRed = (job.background >> 16) & 0xFF;
+    unsigned char bgGreen = (job.background >> 8) & 0xFF;
+    unsigned char bgBlue = job.background & 0xFF;
+    for (size_t i = 0; i < pixels.size(); i += 3)
+    {
+        pixels[i] = bgRed;
+        pixels[i + 1] = bgGreen;
+        pixels[i + 2] = bgBlue;
+    }
+
+    auto blend = [](int background, int foreground) {
+        return static_cast<unsigned char>(background + (foreground - background) * GLYPH_OPACITY / 100);
+    };
+
+    for (size_t line = 0; line < job.lineStarts.size(); ++line)
+    {
+        size_t begin = job.lineStarts[line];
+        size_t end = line + 1 < job.lineStarts.size() ? job.lineStarts[line + 1] : job.cells.size();
+        unsigned char* row = &pixels[line * LINE_PIXELS * MINIMAP_COLUMNS * 3];
+
+        int column = 0;
+        for (size_t i = begin; i + 1 < end && column < MINIMAP_COLUMNS; i += 2)
+        {
+            unsigned char ch = job.cells[i];
+            unsigned char style = job.cells[i + 1];
+
+            // UTF-8 后续字节不占列
+            if ((ch & 0xC0) == 0x80 || ch == '\r' || ch == '\n')
+                continue;
+            if (ch == '\t')
+            {
+                column = (column / job.tabWidth + 1) * job.tabWidth;
+                continue;
+            }
+
+            if (ch != ' ')
+            {
+                uint32_t colour = job.palette[style < job.palette.size() ? style : 0];
+                unsigned char* pixel = row + column * 3;
+                pixel[0] = blend(bgRed, (colour >> 16) & 0xFF);
+                pixel[1] = blend(bgGreen, (colour >> 8) & 0xFF);
+                pixel[2] = blend(bgBlue, colour & 0xFF);
+            }
+            ++column;
+        }
+    }
+
+    return pixels;
+}
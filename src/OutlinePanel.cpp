@@ -0,0 +1,258 @@
+#include "OutlinePanel.h"
+#include "LaminaEditor.h"
+#include "LanguageManager.h"
+#include <algorithm>
+
+// 块注释状态变化时继续向后扫描，每次多扫描的行数
+static const size_t SCAN_CHUNK_LINES = 4096;
+
+// 重新扫描的行数超过该值时（如载入文件）暂停树的绘制
+static const size_t BULK_UPDATE_LINES = 1000;
+
+static const MessageId GROUP_LABELS[] = {
+    MSG_OUTLINE_INCLUDES,
+    MSG_OUTLINE_FUNCTIONS,
+    MSG_OUTLINE_VARIABLES
+};
+
+wxBEGIN_EVENT_TABLE(OutlinePanel, wxPanel)
+    EVT_TREE_SEL_CHANGED(wxID_ANY, OutlinePanel::OnSelectionChanged)
+    EVT_TREE_ITEM_ACTIVATED(wxID_ANY, OutlinePanel::OnItemActivated)
+wxEND_EVENT_TABLE()
+
+OutlinePanel::OutlinePanel(wxWindow* parent, LaminaEditor* editor, wxWindowID id)
+    : wxPanel(parent, id)
+    , m_editor(editor)
+    , m_dirty(true)
+    , m_dirtyFirst(0)
+    , m_dirtyEnd(0)
+    , m_dirtyDelta(0)
+    , m_patching(false)
+{
+    m_tree = new wxTreeCtrl(this, wxID_ANY, wxDefaultPosition, wxDefaultSize,
+                            wxTR_HIDE_ROOT | wxTR_HAS_BUTTONS | wxTR_LINES_AT_ROOT | wxTR_SINGLE);
+    wxTreeItemId root = m_tree->AddRoot(wxEmptyString);
+    for (int kind = 0; kind < (int)OutlineKind::Count; ++kind)
+        m_groups[kind] = m_tree->AppendItem(root, Tr(GROUP_LABELS[kind]));
+
+    wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
+    sizer->Add(m_tree, 1, wxEXPAND);
+    SetSizer(sizer);
+
+    // 首次更新扫描整个文档
+    m_lineStates.assign(m_editor->GetLineCount(), 0);
+    m_dirtyEnd = m_lineStates.size();
+
+    m_editor->Bind(wxEVT_STC_MODIFIED, &OutlinePanel::OnEditorModified, this);
+    m_editor->Bind(wxEVT_STC_UPDATEUI, &OutlinePanel::OnEditorUpdateUI, this);
+
+    Update();
+    for (const wxTreeItemId& group : m_groups)
+        m_tree->Expand(group);
+}
+
+OutlinePanel::~OutlinePanel()
+{
+    m_editor->Unbind(wxEVT_STC_MODIFIED, &OutlinePanel::OnEditorModified, this);
+    m_editor->Unbind(wxEVT_STC_UPDATEUI, &OutlinePanel::OnEditorUpdateUI, this);
+}
+
+void OutlinePanel::UpdateLabels()
+{
+    for (int kind = 0; kind < (int)OutlineKind::Count; ++kind)
+        m_tree->SetItemText(m_groups[kind], Tr(GROUP_LABELS[kind]));
+}
+
+void OutlinePanel::OnEditorModified(wxStyledTextEvent& event)
+{
+    int type = event.GetModificationType();
+    if (type & (wxSTC_MOD_INSERTTEXT | wxSTC_MOD_DELETETEXT))
+    {
+        // 编辑前的 [line, endLine)，删除时包括被删除的行
+        size_t line = m_editor->LineFromPosition(event.GetPosition());
+        long added = event.GetLinesAdded();
+        size_t endLine = line + 1 + (added < 0 ? -added : 0);
+
+        if (!m_dirty)
+        {
+            m_dirty = true;
+            m_dirtyFirst = line;
+            m_dirtyEnd = endLine;
+            m_dirtyDelta = 0;
+        }
+        else
+        {
+            m_dirtyFirst = std::min(m_dirtyFirst, line);
+            m_dirtyEnd = std::max(m_dirtyEnd, endLine);
+        }
+        m_dirtyEnd = (size_t)((long)m_dirtyEnd + added);
+        m_dirtyDelta += added;
+    }
+
+    event.Skip();
+}
+
+void OutlinePanel::OnEditorUpdateUI(wxStyledTextEvent& event)
+{
+    // 编辑之后、绘制之前更新，连续的多处修改只处理一次
+    if (event.GetUpdated() & wxSTC_UPDATE_CONTENT)
+        Update();
+    event.Skip();
+}
+
+void OutlinePanel::Update()
+{
+    if (!m_dirty)
+        return;
+    m_dirty = false;
+
+    size_t lineCount = m_editor->GetLineCount();
+    size_t previousLines = m_lineStates.size();
+    size_t previousEnd = std::min((size_t)((long)m_dirtyEnd - m_dirtyDelta), previousLines);
+    size_t first = std::min(m_dirtyFirst, previousEnd);
+    long delta = (long)lineCount - (long)previousLines;
+
+    // 编辑区域之前的行不受影响，区域开头的注释状态仍然有效
+    bool state = first < previousLines && m_lineStates[first];
+    m_lineStates.erase(m_lineStates.begin() + first, m_lineStates.begin() + previousEnd);
+    m_lineStates.insert(m_lineStates.begin() + first, lineCount - m_lineStates.size(), 0);
+
+    // 重新扫描改动的行，之后的行开头的注释状态改变时继续向后扫描
+    std::vector<OutlineSymbol> symbols;
+    std::vector<uint8_t> states;
+    size_t scanFirst = first;
+    size_t scanEnd = std::min(std::max((size_t)((long)previousEnd + delta), first + 1), lineCount);
+    while (true)
+    {
+        int startPos = m_editor->PositionFromLine(scanFirst);
+        int endPos = scanEnd >= lineCount ? m_editor->GetTextLength() : m_editor->PositionFromLine(scanEnd);
+        wxCharBuffer text = m_editor->GetTextRangeRaw(startPos, endPos);
+        OutlineScanner::Scan(std::string_view(text.data(), endPos - startPos), scanFirst, state, symbols, states);
+
+        std::copy_n(states.begin(), std::min(states.size(), scanEnd - scanFirst), m_lineStates.begin() + scanFirst);
+        if (scanEnd >= lineCount)
+            break;
+
+        state = states[scanEnd - scanFirst];
+        if (m_lineStates[scanEnd] == state)
+            break;
+
+        scanFirst = scanEnd;
+        scanEnd = std::min(scanEnd + SCAN_CHUNK_LINES, lineCount);
+    }
+
+    bool bulk = scanEnd - first > BULK_UPDATE_LINES;
+    if (bulk)
+        m_tree->Freeze();
+    m_patching = true;
+
+    for (int kind = 0; kind < (int)OutlineKind::Count; ++kind)
+    {
+        std::vector<Entry>& entries = m_entries[kind];
+        auto byLine = [](const Entry& entry, size_t line) { return entry.line < line; };
+
+        // 编辑区域内的旧符号被替换，之后的符号随行号移动
+        size_t begin = std::lower_bound(entries.begin(), entries.end(), first, byLine) - entries.begin();
+        size_t end = std::lower_bound(entries.begin() + begin, entries.end(), previousEnd, byLine) - entries.begin();
+        for (size_t i = end; i < entries.size(); ++i)
+            entries[i].line = (size_t)((long)entries[i].line + delta);
+        end = std::lower_bound(entries.begin() + end, entries.end(), scanEnd, byLine) - entries.begin();
+
+        std::vector<Entry> replacement;
+        for (OutlineSymbol& symbol : symbols)
+        {
+            if ((int)symbol.kind == kind)
+                replacement.push_back(Entry{ symbol.line, std::move(symbol.name), wxTreeItemId() });
+        }
+
+        PatchKind(static_cast<OutlineKind>(kind), begin, end, replacement);
+    }
+
+    m_patching = false;
+    if (bulk)
+        m_tree->Thaw();
+}
+
+void OutlinePanel::PatchKind(OutlineKind kind, size_t first, size_t last, std::vector<Entry>& replacement)
+{
+    std::vector<Entry>& entries = m_entries[(int)kind];
+
+    // 开头和结尾名字相同的节点保留，只更新行号
+    size_t count = last - first;
+    size_t prefix = 0;
+    while (prefix < count && prefix < replacement.size() && entries[first + prefix].name == replacement[prefix].name)
+    {
+        entries[first + prefix].line = replacement[prefix].line;
+        ++prefix;
+    }
+
+    size_t suffix = 0;
+    while (suffix < count - prefix && suffix < replacement.size() - prefix &&
+           entries[last - 1 - suffix].name == replacement[replacement.size() - 1 - suffix].name)
+    {
+        entries[last - 1 - suffix].line = replacement[replacement.size() - 1 - suffix].line;
+        ++suffix;
+    }
+
+    if (prefix + suffix == count && prefix + suffix == replacement.size())
+        return;
+
+    // 删除中间的旧节点，在相同位置插入新节点
+    for (size_t i = first + prefix; i < last - suffix; ++i)
+        m_tree->Delete(entries[i].item);
+
+    wxTreeItemId group = m_groups[(int)kind];
+    wxTreeItemId previous = first + prefix > 0 ? entries[first + prefix - 1].item : wxTreeItemId();
+    for (size_t i = prefix; i < replacement.size() - suffix; ++i)
+    {
+        wxString label = wxString::FromUTF8(replacement[i].name.data(), replacement[i].name.size());
+        replacement[i].item = previous.IsOk() ? m_tree->InsertItem(group, previous, label) : m_tree->PrependItem(group, label);
+        previous = replacement[i].item;
+    }
+
+    entries.erase(entries.begin() + first + prefix, entries.begin() + last - suffix);
+    entries.insert(entries.begin() + first + prefix,
+                   std::make_move_iterator(replacement.begin() + prefix),
+                   std::make_move_iterator(replacement.end() - suffix));
+}
+
+bool OutlinePanel::FindEntry(const wxTreeItemId& item, size_t& line) const
+{
+    wxTreeItemId parent = m_tree->GetItemParent(item);
+    for (int kind = 0; kind < (int)OutlineKind::Count; ++kind)
+    {
+        if (parent != m_groups[kind])
+            continue;
+
+        for (const Entry& entry : m_entries[kind])
+        {
+            if (entry.item == item)
+            {
+                line = entry.line;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void OutlinePanel::OnSelectionChanged(wxTreeEvent& event)
+{
+    size_t line;
+    if (m_patching || !event.GetItem().IsOk() || !FindEntry(event.GetItem(), line))
+        return;
+
+    m_editor->GotoLine(line);
+    m_editor->EnsureVisibleEnforcePolicy(line);
+}
+
+void OutlinePanel::OnItemActivated(wxTreeEvent& event)
+{
+    size_t line;
+    if (!FindEntry(event.GetItem(), line))
+        return;
+
+    m_editor->GotoLine(line);
+    m_editor->EnsureVisibleEnforcePolicy(line);
+    m_editor->SetFocus();
+}
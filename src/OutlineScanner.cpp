@@ -0,0 +1,92 @@
+#include "OutlineScanner.h"
+#include "LaminaLexer.h"
+#include <algorithm>
+
+// 记号所在的行中，之后的换行符使接下来的行位于块注释中
+static void MarkCommentLines(std::string_view text, size_t begin, size_t end, size_t line, std::vector<uint8_t>& lineStates)
+{
+    for (size_t pos = text.find('\n', begin); pos != std::string_view::npos && pos < end; pos = text.find('\n', pos + 1))
+        lineStates[++line] = 1;
+}
+
+void OutlineScanner::Scan(std::string_view text, size_t firstLine, bool startsInComment,
+                          std::vector<OutlineSymbol>& symbols, std::vector<uint8_t>& lineStates)
+{
+    lineStates.assign(std::count(text.begin(), text.end(), '\n') + 1, 0);
+    lineStates[0] = startsInComment ? 1 : 0;
+
+    // 从块注释中间开始时先跳到注释结束处
+    size_t offset = 0;
+    size_t line = 0;
+    if (startsInComment)
+    {
+        size_t close = text.find("*/");
+        offset = close == std::string_view::npos ? text.size() : close + 2;
+        MarkCommentLines(text, 0, offset, 0, lineStates);
+        line = std::count(text.begin(), text.begin() + offset, '\n');
+    }
+
+    LaminaLexer lexer(text.substr(offset), line);
+    LaminaToken token;
+    size_t lineStart = offset > 0 ? text.rfind('\n', offset - 1) + 1 : 0;  // 当前记号所在行的开头
+    size_t currentLine = line;
+    size_t statementLine = SIZE_MAX;    // 已经处理过第一个记号的行
+    OutlineKind pendingKind = OutlineKind::Count;
+    size_t pendingLine = 0;
+
+    while (lexer.Next(token))
+    {
+        size_t start = token.start + offset;
+        std::string_view tokenText = text.substr(start, token.length);
+
+        if (token.kind == TokenKind::Comment)
+        {
+            if (tokenText.compare(0, 2, "/*") == 0)
+                MarkCommentLines(text, start, start + token.length, token.line, lineStates);
+            continue;
+        }
+
+        if (token.line != currentLine)
+        {
+            size_t newline = text.rfind('\n', start);
+            lineStart = newline == std::string_view::npos ? 0 : newline + 1;
+            currentLine = token.line;
+        }
+
+        // 关键字之后的名字
+        if (pendingKind != OutlineKind::Count)
+        {
+            OutlineKind kind = pendingKind;
+            pendingKind = OutlineKind::Count;
+            if (token.line == pendingLine)
+            {
+                if (kind == OutlineKind::Include && token.kind == TokenKind::String)
+                {
+                    std::string_view name = tokenText.substr(1);
+                    if (!name.empty() && name.back() == '"')
+                        name.remove_suffix(1);
+                    symbols.push_back(OutlineSymbol{ kind, firstLine + pendingLine, std::string(name) });
+                }
+                else if (kind != OutlineKind::Include && token.kind == TokenKind::Identifier)
+                {
+                    symbols.push_back(OutlineSymbol{ kind, firstLine + pendingLine, std::string(tokenText) });
+                }
+            }
+        }
+
+        // 只看每行的第一个记号
+        if (token.line == statementLine)
+            continue;
+        statementLine = token.line;
+
+        if (token.kind != TokenKind::Keyword)
+            continue;
+        if (tokenText == "func")
+            pendingKind = OutlineKind::Function;
+        else if (tokenText == "include")
+            pendingKind = OutlineKind::Include;
+        else if (tokenText == "var" && start == lineStart)
+            pendingKind = OutlineKind::Variable;
+        pendingLine = token.line;
+    }
+}
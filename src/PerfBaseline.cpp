@@ -0,0 +1,290 @@
+#include "PerfBaseline.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+
+namespace
+{
+
+// 只支持基准文件用到的 JSON：对象、字符串和数字；数组、布尔值和 null 视为错误
+class JsonReader
+{
+public:
+    using NumberHandler = std::function<void(const std::vector<std::string>& path, double value)>;
+
+    JsonReader(std::string_view text, const NumberHandler& handler)
+        : m_text(text), m_position(0), m_handler(handler)
+    {
+    }
+
+    bool Read(std::string& error)
+    {
+        std::vector<std::string> path;
+        if (!ReadValue(path))
+        {
+            error = m_error + " at offset " + std::to_string(m_position);
+            return false;
+        }
+        SkipSpace();
+        if (m_position != m_text.size())
+        {
+            error = "unexpected data after the top-level value at offset " + std::to_string(m_position);
+            return false;
+        }
+        return true;
+    }
+
+private:
+    void SkipSpace()
+    {
+        while (m_position < m_text.size() && (m_text[m_position] == ' ' || m_text[m_position] == '\t'
+               || m_text[m_position] == '\n' || m_text[m_position] == '\r'))
+            ++m_position;
+    }
+
+    bool Fail(const char* message)
+    {
+        m_error = message;
+        return false;
+    }
+
+    bool ReadValue(std::vector<std::string>& path)
+    {
+        SkipSpace();
+        if (m_position >= m_text.size())
+            return Fail("unexpected end of input");
+
+        char ch = m_text[m_position];
+        if (ch == '{')
+            return ReadObject(path);
+        if (ch == '"')
+        {
+            std::string ignored;
+            return ReadString(ignored);
+        }
+        if (ch == '-' || (ch >= '0' && ch <= '9'))
+            return ReadNumber(path);
+        return Fail("unsupported value");
+    }
+
+    bool ReadObject(std::vector<std::string>& path)
+    {
+        ++m_position;
+        SkipSpace();
+        if (m_position < m_text.size() && m_text[m_position] == '}')
+        {
+            ++m_position;
+            return true;
+        }
+
+        while (true)
+        {
+            SkipSpace();
+            std::string key;
+            if (m_position >= m_text.size() || m_text[m_position] != '"' || !ReadString(key))
+                return m_error.empty() ? Fail("expected a key") : false;
+
+            SkipSpace();
+            if (m_position >= m_text.size() || m_text[m_position] != ':')
+                return Fail("expected ':'");
+            ++m_position;
+
+            path.push_back(key);
+            if (!ReadValue(path))
+                return false;
+            path.pop_back();
+
+            SkipSpace();
+            if (m_position >= m_text.size())
+                return Fail("unterminated object");
+            if (m_text[m_position] == '}')
+            {
+                ++m_position;
+                return true;
+            }
+            if (m_text[m_position] != ',')
+                return Fail("expected ',' or '}'");
+            ++m_position;
+        }
+    }
+
+    // 名称只会是 ASCII，转义序列中只处理单字符的转义，\u 原样保留
+    bool ReadString(std::string& value)
+    {
+        ++m_position;
+        while (m_position < m_text.size())
+        {
+            char ch = m_text[m_position++];
+            if (ch == '"')
+                return true;
+            if (ch == '\\' && m_position < m_text.size())
+            {
+                char escaped = m_text[m_position++];
+                switch (escaped)
+                {
+                case 'n': value += '\n'; break;
+                case 't': value += '\t'; break;
+                case 'r': value += '\r'; break;
+                case 'u': value += "\\u"; break;
+                default: value += escaped; break;
+                }
+                continue;
+            }
+            value += ch;
+        }
+        return Fail("unterminated string");
+    }
+
+    bool ReadNumber(const std::vector<std::string>& path)
+    {
+        size_t start = m_position;
+        while (m_position < m_text.size() && strchr("+-0123456789.eE", m_text[m_position]))
+            ++m_position;
+
+        std::string number(m_text.substr(start, m_position - start));
+        char* end = nullptr;
+        double value = strtod(number.c_str(), &end);
+        if (end != number.c_str() + number.size())
+        {
+            m_position = start;
+            return Fail("invalid number");
+        }
+        m_handler(path, value);
+        return true;
+    }
+
+private:
+    std::string_view m_text;
+    size_t m_position;
+    NumberHandler m_handler;
+    std::string m_error;
+};
+
+std::string FormatNumber(double value)
+{
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.3f", value);
+
+    // 去掉多余的 0，整数不带小数点
+    std::string text(buffer);
+    text.erase(text.find_last_not_of('0') + 1);
+    if (text.back() == '.')
+        text.pop_back();
+    return text;
+}
+
+}
+
+bool PerfBaseline::Parse(std::string_view json, std::string& error)
+{
+    m_tolerance.clear();
+    m_scenarios.clear();
+
+    JsonReader reader(json, [this](const std::vector<std::string>& path, double value) {
+        if (path.size() == 3 && path[0] == "tolerance")
+        {
+            if (path[2] == "ratio")
+                m_tolerance[path[1]].ratio = value;
+            else if (path[2] == "slack")
+                m_tolerance[path[1]].slack = value;
+        }
+        else if (path.size() == 3 && path[0] == "scenarios")
+        {
+            m_scenarios[path[1]][path[2]] = value;
+        }
+    });
+    return reader.Read(error);
+}
+
+std::string PerfBaseline::ToJson() const
+{
+    std::string json = "{\n    \"tolerance\": {";
+    const char* separator = "\n";
+    for (const auto& [metric, tolerance] : m_tolerance)
+    {
+        json += separator;
+        json += "        \"" + metric + "\": { \"ratio\": " + FormatNumber(tolerance.ratio)
+              + ", \"slack\": " + FormatNumber(tolerance.slack) + " }";
+        separator = ",\n";
+    }
+    json += "\n    },\n    \"scenarios\": {";
+
+    separator = "\n";
+    for (const auto& [scenario, metrics] : m_scenarios)
+    {
+        json += separator;
+        json += "        \"" + scenario + "\": {";
+        const char* metricSeparator = "\n";
+        for (const auto& [metric, value] : metrics)
+        {
+            json += metricSeparator;
+            json += "            \"" + metric + "\": " + FormatNumber(value);
+            metricSeparator = ",\n";
+        }
+        json += "\n        }";
+        separator = ",\n";
+    }
+    json += "\n    }\n}\n";
+    return json;
+}
+
+void PerfBaseline::Update(const std::vector<PerfResult>& results)
+{
+    for (const PerfResult& result : results)
+        m_scenarios[result.scenario] = result.metrics;
+}
+
+std::vector<std::string> PerfBaseline::Compare(const std::vector<PerfResult>& results) const
+{
+    std::vector<std::string> regressions;
+    for (const PerfResult& result : results)
+    {
+        for (const auto& [metric, value] : result.metrics)
+        {
+            double baseline = 0;
+            if (!GetValue(result.scenario, metric, baseline))
+                continue;
+
+            PerfTolerance tolerance = GetTolerance(metric);
+            double limit = baseline * tolerance.ratio + tolerance.slack;
+            if (value > limit)
+            {
+                regressions.push_back(result.scenario + " " + metric + ": " + FormatNumber(value)
+                                      + " exceeds " + FormatNumber(limit) + " (baseline " + FormatNumber(baseline) + ")");
+            }
+        }
+    }
+    return regressions;
+}
+
+bool PerfBaseline::GetValue(const std::string& scenario, const std::string& metric, double& value) const
+{
+    auto metrics = m_scenarios.find(scenario);
+    if (metrics == m_scenarios.end())
+        return false;
+    auto entry = metrics->second.find(metric);
+    if (entry == metrics->second.end())
+        return false;
+    value = entry->second;
+    return true;
+}
+
+PerfTolerance PerfBaseline::GetTolerance(const std::string& metric) const
+{
+    auto tolerance = m_tolerance.find(metric);
+    return tolerance != m_tolerance.end() ? tolerance->second : PerfTolerance();
+}
+
+double PerfBaseline::Percentile(std::vector<double> samples, double percentile)
+{
+    if (samples.empty())
+        return 0;
+
+    size_t rank = (size_t)std::ceil(percentile / 100.0 * samples.size());
+    size_t index = std::min(samples.size() - 1, rank > 0 ? rank - 1 : 0);
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
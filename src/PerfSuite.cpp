@@ -0,0 +1,355 @@
+#include "PerfSuite.h"
+#include "MainFrame.h"
+#include "LaminaEditor.h"
+#include "ProcessManager.h"
+#include "ThemeConfig.h"
+#include "FileUtils.h"
+#include <wx/file.h>
+#include <wx/filename.h>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+// 心跳间隔；相邻两次心跳之间超出间隔的部分即事件循环的停顿
+static const int HEARTBEAT_MS = 2;
+
+// 操作完成后继续观察的时间，后台任务（差异、大纲、缩略图）完成时的停顿也计入该场景
+static const int SETTLE_MS = 500;
+
+static const size_t TYPE_COUNT = 10000;
+static const int MAX_SCROLL_FRAMES = 2000;
+static const size_t THEME_ROUNDS = 5;
+
+// 输出一千万行的脚本；脚本路径作为 sh 的 $0 传入，不被使用
+static const char RUN_COMMAND[] = "sh -c \"seq 1 10000000\" %lmfilepath%";
+
+static const int FILE_SIZES_MB[] = { 1, 100, 500 };
+
+// 生成测试文件时重复的代码块
+static const char SOURCE_BLOCK[] =
+    "// accumulate the partial sums of a rational series\n"
+    "func partial(n) {\n"
+    "    var total = 0;\n"
+    "    for (var i = 1; i <= n; i = i + 1) {\n"
+    "        total = total + 1 / (i * i);   /* exact rational arithmetic */\n"
+    "    }\n"
+    "    return total;\n"
+    "}\n"
+    "print(\"partial sum: \", partial(100), \" and \", dot([1, 2, 3], [4, 5, 6]));\n"
+    "\n";
+
+// 逐个字符输入的文本，换行以 Enter 键输入
+static const char TYPING_TEXT[] = "var total = total + value * 2;  // running sum\n";
+
+static double Milliseconds(std::chrono::steady_clock::duration duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+// 把进程的峰值常驻内存重置为当前值（Linux 4.0 起支持），之后读到的是本场景的峰值
+static void ResetPeakMemory()
+{
+#ifdef __LINUX__
+    std::ofstream("/proc/self/clear_refs") << "5";
+#endif
+}
+
+static double ReadPeakMemoryMegabytes()
+{
+#ifdef __LINUX__
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line))
+    {
+        if (line.compare(0, 6, "VmHWM:") == 0)
+            return strtod(line.c_str() + 6, nullptr) / 1024.0;
+    }
+#endif
+    return 0;
+}
+
+static wxString GetFilePath(const wxString& workDir, int megabytes)
+{
+    return wxFileName(workDir, wxString::Format("perf_%dmb.lm", megabytes)).GetFullPath();
+}
+
+PerfSuite::PerfSuite(MainFrame* frame, const PerfSuiteOptions& options)
+    : m_frame(frame)
+    , m_options(options)
+    , m_heartbeat(this)
+    , m_exitCode(0)
+    , m_current(0)
+    , m_settling(false)
+    , m_stallMax(0)
+{
+    Bind(wxEVT_TIMER, &PerfSuite::OnHeartbeat, this);
+}
+
+PerfSuite::~PerfSuite()
+{
+    m_heartbeat.Stop();
+}
+
+void PerfSuite::Start()
+{
+    // 等主窗口显示并恢复完会话之后再开始
+    CallAfter([this]() {
+        m_originalTheme = ThemeConfig::Get().GetCurrentTheme();
+        if (!GenerateFiles())
+        {
+            wxPrintf("Cannot write the test files to %s\n", m_options.workDir);
+            m_exitCode = 2;
+            m_frame->Destroy();
+            return;
+        }
+        
+        AddScenarios();
+        BeginScenario();
+        m_heartbeat.Start(HEARTBEAT_MS);
+    });
+}
+
+bool PerfSuite::GenerateFiles()
+{
+    std::string chunk;
+    while (chunk.size() < 1024 * 1024)
+        chunk += SOURCE_BLOCK;
+    
+    for (int megabytes : FILE_SIZES_MB)
+    {
+        wxFile file(GetFilePath(m_options.workDir, megabytes), wxFile::write);
+        if (!file.IsOpened())
+            return false;
+        
+        size_t remaining = (size_t)megabytes * 1024 * 1024;
+        while (remaining > 0)
+        {
+            size_t length = std::min(remaining, chunk.size());
+            if (file.Write(chunk.data(), length) != length)
+                return false;
+            remaining -= length;
+        }
+    }
+    return true;
+}
+
+void PerfSuite::AddScenarios()
+{
+    auto open = [this](int megabytes) {
+        wxString path = GetFilePath(m_options.workDir, megabytes);
+        return [this, path]() {
+            m_frame->OpenFile(path);
+            m_frame->m_editor->Update();
+            return true;
+        };
+    };
+    
+    m_scenarios.push_back({ "open_1mb", open(1) });
+    m_scenarios.push_back({ "type_10k", [this, index = (size_t)0]() mutable { return TypeCharacter(index++); } });
+    m_scenarios.push_back({ "scroll_1mb", [this, line = 0]() mutable { return ScrollFrame(line); } });
+    m_scenarios.push_back({ "theme_switch", [this, index = (size_t)0]() mutable { return SwitchTheme(index++); } });
+    m_scenarios.push_back({ "open_100mb", open(100) });
+    m_scenarios.push_back({ "scroll_100mb", [this, line = 0]() mutable { return ScrollFrame(line); } });
+    m_scenarios.push_back({ "open_500mb", open(500) });
+    
+    // 经过 ProcessManager 与控制台的完整输出路径
+    m_scenarios.push_back({ "run_10m_lines", [this, started = false]() mutable {
+        if (!started)
+        {
+            started = true;
+            m_frame->m_interpreterPath = RUN_COMMAND;
+            m_frame->StartScript();
+            return false;
+        }
+        return !m_frame->m_processManager->IsRunning();
+    } });
+}
+
+void PerfSuite::OnHeartbeat(wxTimerEvent& event)
+{
+    // 本次心跳之前的停顿，包括上一次心跳中执行操作的时间
+    Clock::time_point now = Clock::now();
+    m_stallMax = std::max(m_stallMax, Milliseconds(now - m_lastBeat) - HEARTBEAT_MS);
+    m_lastBeat = now;
+    
+    if (!m_settling)
+    {
+        if (m_scenarios[m_current].step())
+        {
+            m_settling = true;
+            m_stepsDone = Clock::now();
+        }
+        return;
+    }
+    
+    if (Milliseconds(now - m_stepsDone) < SETTLE_MS)
+        return;
+    
+    EndScenario();
+    if (++m_current < m_scenarios.size())
+        BeginScenario();
+    else
+        Finish();
+}
+
+void PerfSuite::BeginScenario()
+{
+    ResetPeakMemory();
+    m_settling = false;
+    m_stallMax = 0;
+    m_latencies.clear();
+    m_scenarioStart = Clock::now();
+    m_lastBeat = m_scenarioStart;
+}
+
+void PerfSuite::EndScenario()
+{
+    PerfResult result;
+    result.scenario = m_scenarios[m_current].name;
+    result.metrics["duration_ms"] = Milliseconds(m_stepsDone - m_scenarioStart);
+    result.metrics["stall_max_ms"] = m_stallMax;
+    
+    wxString line = wxString::Format("%-14s %10.1f ms  stall %8.1f ms", result.scenario,
+                                     result.metrics["duration_ms"], m_stallMax);
+    if (!m_latencies.empty())
+    {
+        double p50 = PerfBaseline::Percentile(m_latencies, 50);
+        double p95 = PerfBaseline::Percentile(m_latencies, 95);
+        double p99 = PerfBaseline::Percentile(m_latencies, 99);
+        result.metrics["latency_p50_ms"] = p50;
+        result.metrics["latency_p95_ms"] = p95;
+        result.metrics["latency_p99_ms"] = p99;
+        line += wxString::Format("  p50 %.2f  p95 %.2f  p99 %.2f ms", p50, p95, p99);
+    }
+    
+    double peak = ReadPeakMemoryMegabytes();
+    if (peak > 0)
+    {
+        result.metrics["peak_rss_mb"] = peak;
+        line += wxString::Format("  peak %.0f MB", peak);
+    }
+    
+    wxPrintf("%s\n", line);
+    fflush(stdout);
+    m_results.push_back(result);
+}
+
+void PerfSuite::Finish()
+{
+    m_heartbeat.Stop();
+    
+    PerfBaseline baseline;
+    std::string json;
+    std::string error;
+    bool loaded = FileUtils::ReadBytes(m_options.baselinePath, json) && baseline.Parse(json, error);
+    
+    if (m_options.updateBaseline)
+    {
+        baseline.Update(m_results);
+        if (FileUtils::WriteBytes(m_options.baselinePath, baseline.ToJson()))
+            wxPrintf("Baseline updated: %s\n", m_options.baselinePath);
+        else
+            m_exitCode = 2;
+    }
+    else if (!loaded)
+    {
+        wxPrintf("Cannot read the baseline %s %s\n", m_options.baselinePath, error);
+        m_exitCode = 2;
+    }
+    else
+    {
+        std::vector<std::string> regressions = baseline.Compare(m_results);
+        for (const std::string& regression : regressions)
+            wxPrintf("REGRESSION %s\n", regression);
+        if (regressions.empty())
+            wxPrintf("All scenarios within tolerance\n");
+        else
+            wxPrintf("%lu metrics exceed the baseline\n", (unsigned long)regressions.size());
+        m_exitCode = regressions.empty() ? 0 : 1;
+    }
+    
+    if (!m_options.outputPath.IsEmpty())
+    {
+        PerfBaseline output = baseline;
+        output.Update(m_results);
+        FileUtils::WriteBytes(m_options.outputPath, output.ToJson());
+    }
+    
+    // 恢复原来的主题，themes.xml 不受测试影响
+    int themeIndex = ThemeConfig::Get().GetAvailableThemes().Index(m_originalTheme);
+    if (themeIndex != wxNOT_FOUND)
+    {
+        wxCommandEvent event(wxEVT_MENU, ID_THEME_START + themeIndex);
+        m_frame->ProcessWindowEvent(event);
+    }
+    
+    // 不经过 OnClose：文档已被修改，关闭时不询问也不保存会话
+    wxFileName::Rmdir(m_options.workDir, wxPATH_RMDIR_RECURSIVE);
+    m_frame->Destroy();
+}
+
+void PerfSuite::Measure(const std::function<void()>& action)
+{
+    Clock::time_point start = Clock::now();
+    action();
+    m_latencies.push_back(Milliseconds(Clock::now() - start));
+}
+
+bool PerfSuite::TypeCharacter(size_t index)
+{
+    LaminaEditor* editor = m_frame->m_editor;
+    if (index == 0)
+        editor->GotoLine(editor->GetLineCount() / 2);
+    
+    // 与键盘输入相同，先是按键事件，可打印字符再有字符事件
+    char ch = TYPING_TEXT[index % (sizeof(TYPING_TEXT) - 1)];
+    Measure([editor, ch]() {
+        wxKeyEvent keyDown(wxEVT_KEY_DOWN);
+        keyDown.SetEventObject(editor);
+        keyDown.m_keyCode = ch == '\n' ? WXK_RETURN : wxToupper(ch);
+        editor->ProcessWindowEvent(keyDown);
+        
+        if (ch != '\n')
+        {
+            wxKeyEvent key(wxEVT_CHAR);
+            key.SetEventObject(editor);
+            key.m_keyCode = ch;
+            key.m_uniChar = ch;
+            editor->ProcessWindowEvent(key);
+        }
+        editor->Update();
+    });
+    return index + 1 >= TYPE_COUNT;
+}
+
+bool PerfSuite::ScrollFrame(int& line)
+{
+    // 行数很多时按固定帧数跳跃滚动，每帧仍是一次完整的重绘
+    LaminaEditor* editor = m_frame->m_editor;
+    int lineCount = editor->GetLineCount();
+    int page = std::max(1, editor->LinesOnScreen());
+    int stride = std::max(page, lineCount / MAX_SCROLL_FRAMES);
+    
+    Measure([editor, line]() {
+        editor->SetFirstVisibleLine(line);
+        editor->Update();
+    });
+    line += stride;
+    return line >= lineCount - page;
+}
+
+bool PerfSuite::SwitchTheme(size_t index)
+{
+    // 通过菜单命令切换，包括缩略图的刷新
+    size_t themeCount = ThemeConfig::Get().GetAvailableThemes().GetCount();
+    if (themeCount == 0)
+        return true;
+    
+    wxCommandEvent event(wxEVT_MENU, ID_THEME_START + (int)(index % themeCount));
+    Measure([this, &event]() {
+        m_frame->ProcessWindowEvent(event);
+        m_frame->m_editor->Update();
+    });
+    return index + 1 >= themeCount * THEME_ROUNDS;
+}
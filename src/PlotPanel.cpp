@@ -0,0 +1,302 @@
+#include "PlotPanel.h"
+#include "LanguageManager.h"
+#include <wx/dcbuffer.h>
+#include <wx/settings.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// 新数据到达后的重绘间隔，输出再快也最多每秒重绘约 30 次
+static const int REFRESH_INTERVAL_MS = 33;
+
+// 绘图区四周的留白，左侧与底部放坐标标签
+static const int MARGIN_LEFT = 64;
+static const int MARGIN_BOTTOM = 20;
+static const int MARGIN = 8;
+
+// 放大时至少显示的样本数
+static const uint64_t MIN_VIEW_SAMPLES = 16;
+
+static const double WHEEL_ZOOM = 0.8;
+
+static const wxColour SERIES_COLOURS[PlotParser::MAX_COLUMNS] = {
+    wxColour(31, 119, 180),
+    wxColour(255, 127, 14),
+    wxColour(44, 160, 44),
+    wxColour(214, 39, 40),
+    wxColour(148, 103, 189),
+    wxColour(140, 86, 75),
+    wxColour(227, 119, 194),
+    wxColour(127, 127, 127)
+};
+
+wxBEGIN_EVENT_TABLE(PlotPanel, wxWindow)
+    EVT_PAINT(PlotPanel::OnPaint)
+    EVT_SIZE(PlotPanel::OnSize)
+    EVT_TIMER(wxID_ANY, PlotPanel::OnRefreshTimer)
+    EVT_MOUSEWHEEL(PlotPanel::OnMouseWheel)
+    EVT_LEFT_DOWN(PlotPanel::OnMouseDown)
+    EVT_MOTION(PlotPanel::OnMouseMove)
+    EVT_LEFT_UP(PlotPanel::OnMouseUp)
+    EVT_MOUSE_CAPTURE_LOST(PlotPanel::OnCaptureLost)
+    EVT_LEFT_DCLICK(PlotPanel::OnDoubleClick)
+wxEND_EVENT_TABLE()
+
+PlotPanel::PlotPanel(wxWindow* parent, wxWindowID id)
+    : wxWindow(parent, id, wxDefaultPosition, wxDefaultSize, wxFULL_REPAINT_ON_RESIZE)
+    , m_refreshTimer(this)
+    , m_dirty(false)
+    , m_follow(true)
+    , m_viewFirst(0)
+    , m_viewLast(0)
+    , m_dragging(false)
+    , m_dragX(0)
+    , m_dragFirst(0)
+{
+    SetBackgroundStyle(wxBG_STYLE_PAINT);
+}
+
+void PlotPanel::AppendData(const char* data, size_t size)
+{
+    m_parser.Feed(data, size);
+    ScheduleRefresh();
+}
+
+void PlotPanel::Finish()
+{
+    m_parser.Finish();
+    ScheduleRefresh();
+}
+
+void PlotPanel::Clear()
+{
+    m_parser.Clear();
+    m_follow = true;
+    ScheduleRefresh();
+}
+
+void PlotPanel::ScheduleRefresh()
+{
+    m_dirty = true;
+    if (!m_refreshTimer.IsRunning())
+        m_refreshTimer.StartOnce(REFRESH_INTERVAL_MS);
+}
+
+void PlotPanel::OnRefreshTimer(wxTimerEvent& event)
+{
+    if (m_dirty)
+    {
+        m_dirty = false;
+        Refresh();
+    }
+}
+
+void PlotPanel::OnSize(wxSizeEvent& event)
+{
+    Refresh();
+    event.Skip();
+}
+
+wxRect PlotPanel::GetPlotArea() const
+{
+    wxSize size = GetClientSize();
+    return wxRect(MARGIN_LEFT, MARGIN, size.x - MARGIN_LEFT - MARGIN, size.y - MARGIN - MARGIN_BOTTOM);
+}
+
+void PlotPanel::GetView(uint64_t& first, uint64_t& last) const
+{
+    uint64_t rows = m_parser.GetRowCount();
+    if (m_follow)
+    {
+        first = 0;
+        last = rows;
+        return;
+    }
+    last = std::min(m_viewLast, rows);
+    first = std::min(m_viewFirst, last);
+}
+
+void PlotPanel::OnPaint(wxPaintEvent& event)
+{
+    wxAutoBufferedPaintDC dc(this);
+    dc.SetBackground(wxBrush(wxSystemSettings::GetColour(wxSYS_COLOUR_WINDOW)));
+    dc.Clear();
+    dc.SetFont(GetFont());
+    dc.SetTextForeground(wxSystemSettings::GetColour(wxSYS_COLOUR_GRAYTEXT));
+
+    const std::vector<PlotSeries>& series = m_parser.GetSeries();
+    wxRect area = GetPlotArea();
+    if (series.empty() || area.width <= 0 || area.height <= 0)
+    {
+        dc.DrawText(Tr(MSG_PLOT_EMPTY), MARGIN, MARGIN);
+        return;
+    }
+
+    // 每个像素列的范围，同时求出可见部分的纵轴范围
+    uint64_t first, last;
+    GetView(first, last);
+    float low = std::numeric_limits<float>::infinity();
+    float high = -low;
+    for (size_t i = 0; i < series.size(); ++i)
+    {
+        series[i].Decimate(first, last, area.width, m_columns[i]);
+        for (const PlotRange& column : m_columns[i])
+        {
+            low = std::min(low, column.min);
+            high = std::max(high, column.max);
+        }
+    }
+    if (low > high)
+    {
+        low = 0;
+        high = 1;
+    }
+    else if (low == high)
+    {
+        float pad = std::max(std::fabs(low) * 0.5f, 1.0f);
+        low -= pad;
+        high += pad;
+    }
+
+    double scale = (area.height - 1) / ((double)high - low);
+    int bottom = area.GetBottom();
+    auto toY = [&](float value) { return bottom - (int)std::lround((value - low) * scale); };
+
+    dc.SetPen(wxPen(wxSystemSettings::GetColour(wxSYS_COLOUR_3DSHADOW)));
+    dc.SetBrush(*wxTRANSPARENT_BRUSH);
+    dc.DrawRectangle(area.x - 1, area.y - 1, area.width + 2, area.height + 2);
+
+    wxString top = wxString::Format("%g", high);
+    wxString base = wxString::Format("%g", low);
+    int textHeight = dc.GetCharHeight();
+    dc.DrawText(top, MARGIN_LEFT - MARGIN - dc.GetTextExtent(top).x, area.y);
+    dc.DrawText(base, MARGIN_LEFT - MARGIN - dc.GetTextExtent(base).x, bottom - textHeight);
+    wxString right = wxString::Format("%llu", (unsigned long long)(last > 0 ? last - 1 : 0));
+    dc.DrawText(wxString::Format("%llu", (unsigned long long)first), area.x, bottom + 2);
+    dc.DrawText(right, area.GetRight() - dc.GetTextExtent(right).x, bottom + 2);
+
+    // 每列画一条从最小值到最大值的竖线，并延伸到与前一列相接；
+    // 放大到一列不足一桶时中间的空列用直线连接
+    for (size_t i = 0; i < series.size(); ++i)
+    {
+        dc.SetPen(wxPen(SERIES_COLOURS[i]));
+        const std::vector<PlotRange>& columns = m_columns[i];
+        int previousX = -1;
+        PlotRange previous = { 0, 0 };
+        for (int x = 0; x < area.width; ++x)
+        {
+            const PlotRange& column = columns[x];
+            if (column.IsEmpty())
+                continue;
+
+            int px = area.x + x;
+            float columnLow = column.min;
+            float columnHigh = column.max;
+            if (previousX >= 0)
+            {
+                if (px - previousX > 1)
+                {
+                    dc.DrawLine(previousX, toY((previous.min + previous.max) / 2), px, toY((columnLow + columnHigh) / 2));
+                }
+                else
+                {
+                    columnLow = std::min(columnLow, previous.max);
+                    columnHigh = std::max(columnHigh, previous.min);
+                }
+            }
+            dc.DrawLine(px, toY(columnHigh), px, toY(columnLow) + 1);
+            previousX = px;
+            previous = column;
+        }
+    }
+
+    // 图例：列号与行数
+    wxString rows = wxString::Format(Tr(MSG_PLOT_ROWS), (unsigned long long)m_parser.GetRowCount());
+    int legendX = area.GetRight() - dc.GetTextExtent(rows).x - MARGIN;
+    dc.DrawText(rows, legendX, area.y + 2);
+    for (size_t i = series.size(); i-- > 0;)
+    {
+        wxString label = wxString::Format("%d", (int)(i + 1));
+        legendX -= dc.GetTextExtent(label).x + MARGIN;
+        dc.SetTextForeground(SERIES_COLOURS[i]);
+        dc.DrawText(label, legendX, area.y + 2);
+    }
+}
+
+void PlotPanel::OnMouseWheel(wxMouseEvent& event)
+{
+    wxRect area = GetPlotArea();
+    uint64_t first, last;
+    GetView(first, last);
+    if (area.width <= 0 || last <= first)
+        return;
+
+    // 以鼠标所在的样本为中心缩放
+    double span = (double)(last - first);
+    double ratio = std::clamp((double)(event.GetX() - area.x) / area.width, 0.0, 1.0);
+    double anchor = first + span * ratio;
+    double zoom = event.GetWheelRotation() > 0 ? WHEEL_ZOOM : 1 / WHEEL_ZOOM;
+    double newSpan = std::max(span * zoom, (double)MIN_VIEW_SAMPLES);
+
+    uint64_t rows = m_parser.GetRowCount();
+    if (newSpan >= rows)
+    {
+        m_follow = true;
+    }
+    else
+    {
+        double newFirst = std::clamp(anchor - newSpan * ratio, 0.0, rows - newSpan);
+        m_viewFirst = (uint64_t)newFirst;
+        m_viewLast = (uint64_t)(newFirst + newSpan);
+        m_follow = false;
+    }
+    Refresh();
+}
+
+void PlotPanel::OnMouseDown(wxMouseEvent& event)
+{
+    if (m_follow)
+        return;
+
+    m_dragging = true;
+    m_dragX = event.GetX();
+    m_dragFirst = m_viewFirst;
+    CaptureMouse();
+}
+
+void PlotPanel::OnMouseMove(wxMouseEvent& event)
+{
+    wxRect area = GetPlotArea();
+    if (!m_dragging || area.width <= 0)
+        return;
+
+    // 拖动平移，范围不超出已有的样本
+    uint64_t span = m_viewLast - m_viewFirst;
+    uint64_t rows = m_parser.GetRowCount();
+    double offset = (double)(m_dragX - event.GetX()) * span / area.width;
+    double newFirst = std::clamp((double)m_dragFirst + offset, 0.0, (double)(rows > span ? rows - span : 0));
+    m_viewFirst = (uint64_t)newFirst;
+    m_viewLast = m_viewFirst + span;
+    Refresh();
+}
+
+void PlotPanel::OnMouseUp(wxMouseEvent& event)
+{
+    if (m_dragging)
+    {
+        m_dragging = false;
+        ReleaseMouse();
+    }
+}
+
+void PlotPanel::OnCaptureLost(wxMouseCaptureLostEvent& event)
+{
+    m_dragging = false;
+}
+
+void PlotPanel::OnDoubleClick(wxMouseEvent& event)
+{
+    // 恢复显示全部样本并跟随新数据
+    m_follow = true;
+    Refresh();
+}
@@ -0,0 +1,220 @@
+#include "PlotSeries.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+// 每列最多保存的桶数，每桶 8 字节
+static const size_t MAX_BUCKETS = 1 << 18;
+
+static const PlotRange EMPTY_RANGE = { std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity() };
+
+static void Include(PlotRange& range, const PlotRange& other)
+{
+    range.min = std::min(range.min, other.min);
+    range.max = std::max(range.max, other.max);
+}
+
+PlotSeries::PlotSeries()
+    : m_bucketSize(1)
+    , m_count(0)
+    , m_bounds(EMPTY_RANGE)
+{
+}
+
+void PlotSeries::Clear()
+{
+    std::vector<PlotRange>().swap(m_buckets);
+    m_bucketSize = 1;
+    m_count = 0;
+    m_bounds = EMPTY_RANGE;
+}
+
+void PlotSeries::OpenBucket()
+{
+    if (m_buckets.size() == MAX_BUCKETS)
+    {
+        for (size_t i = 0; i < MAX_BUCKETS / 2; ++i)
+        {
+            m_buckets[i] = m_buckets[2 * i];
+            Include(m_buckets[i], m_buckets[2 * i + 1]);
+        }
+        m_buckets.resize(MAX_BUCKETS / 2);
+        m_bucketSize *= 2;
+    }
+    else if (m_buckets.size() == m_buckets.capacity())
+    {
+        // 按倍数增长到上限，之后不再重新分配
+        m_buckets.reserve(std::min(MAX_BUCKETS, std::max<size_t>(m_buckets.size() * 2, 1024)));
+    }
+    m_buckets.push_back(EMPTY_RANGE);
+}
+
+void PlotSeries::Append(double value)
+{
+    if (m_count % m_bucketSize == 0)
+        OpenBucket();
+    ++m_count;
+
+    if (!std::isfinite(value))
+        return;
+    float sample = (float)value;
+    PlotRange& bucket = m_buckets.back();
+    bucket.min = std::min(bucket.min, sample);
+    bucket.max = std::max(bucket.max, sample);
+    m_bounds.min = std::min(m_bounds.min, sample);
+    m_bounds.max = std::max(m_bounds.max, sample);
+}
+
+void PlotSeries::AppendEmpty(uint64_t count)
+{
+    while (count > 0)
+    {
+        if (m_count % m_bucketSize == 0)
+            OpenBucket();
+        uint64_t room = m_bucketSize - m_count % m_bucketSize;
+        uint64_t step = std::min(room, count);
+        m_count += step;
+        count -= step;
+    }
+}
+
+void PlotSeries::Decimate(uint64_t first, uint64_t last, size_t columns, std::vector<PlotRange>& ranges) const
+{
+    ranges.assign(columns, EMPTY_RANGE);
+    last = std::min(last, m_count);
+    if (columns == 0 || first >= last)
+        return;
+
+    // 桶的起始样本决定它落在哪一列：按列找出落入的桶再合并，不对每个桶做除法
+    uint64_t span = last - first;
+    size_t bucket = (size_t)(first / m_bucketSize);
+    size_t lastBucket = (size_t)std::min<uint64_t>((last + m_bucketSize - 1) / m_bucketSize, m_buckets.size());
+    for (size_t column = 0; column < columns && bucket < lastBucket; ++column)
+    {
+        uint64_t columnEnd = first + span * (column + 1) / columns;
+        size_t endBucket = (size_t)std::min<uint64_t>((columnEnd + m_bucketSize - 1) / m_bucketSize, lastBucket);
+        PlotRange range = EMPTY_RANGE;
+        for (; bucket < endBucket; ++bucket)
+            Include(range, m_buckets[bucket]);
+        ranges[column] = range;
+    }
+}
+
+PlotParser::PlotParser()
+    : m_fieldLength(0)
+    , m_fieldTooLong(false)
+    , m_valueCount(0)
+    , m_lineValid(true)
+    , m_rows(0)
+{
+}
+
+void PlotParser::Clear()
+{
+    m_fieldLength = 0;
+    m_fieldTooLong = false;
+    m_valueCount = 0;
+    m_lineValid = true;
+    m_series.clear();
+    m_rows = 0;
+}
+
+size_t PlotParser::GetMemoryUsage() const
+{
+    size_t bytes = 0;
+    for (const PlotSeries& series : m_series)
+        bytes += series.GetMemoryUsage();
+    return bytes;
+}
+
+void PlotParser::Feed(const char* data, size_t size)
+{
+    const char* end = data + size;
+    for (const char* p = data; p < end; ++p)
+    {
+        char c = *p;
+        switch (c)
+        {
+        case '\n':
+            EndField();
+            EndLine();
+            break;
+        case ' ':
+        case '\t':
+        case '\r':
+        case ',':
+        case ';':
+            EndField();
+            break;
+        default:
+            // 已经不是数据行时跳到行尾
+            if (!m_lineValid)
+            {
+                const char* newline = static_cast<const char*>(memchr(p, '\n', end - p));
+                if (!newline)
+                    return;
+                EndLine();
+                p = newline;
+                break;
+            }
+            if (m_fieldLength < MAX_FIELD)
+                m_field[m_fieldLength++] = c;
+            else
+                m_fieldTooLong = true;
+            break;
+        }
+    }
+}
+
+void PlotParser::Finish()
+{
+    EndField();
+    EndLine();
+}
+
+void PlotParser::EndField()
+{
+    if (m_fieldLength == 0 && !m_fieldTooLong)
+        return;
+
+    double value;
+    const char* begin = m_field;
+    const char* end = m_field + m_fieldLength;
+    if (begin < end && *begin == '+')
+        ++begin;
+    std::from_chars_result result = std::from_chars(begin, end, value);
+    // 超出的列只检查是否为数字
+    if (m_fieldTooLong || result.ec != std::errc() || result.ptr != end)
+        m_lineValid = false;
+    else if (m_valueCount < MAX_COLUMNS)
+        m_values[m_valueCount++] = value;
+
+    m_fieldLength = 0;
+    m_fieldTooLong = false;
+}
+
+void PlotParser::EndLine()
+{
+    if (m_lineValid && m_valueCount > 0)
+    {
+        // 新出现的列从第一行起补空缺，较短的行缺少的列为空缺
+        while (m_series.size() < m_valueCount)
+        {
+            m_series.emplace_back();
+            m_series.back().AppendEmpty(m_rows);
+        }
+        for (size_t i = 0; i < m_series.size(); ++i)
+        {
+            if (i < m_valueCount)
+                m_series[i].Append(m_values[i]);
+            else
+                m_series[i].AppendEmpty(1);
+        }
+        ++m_rows;
+    }
+
+    m_valueCount = 0;
+    m_lineValid = true;
+}
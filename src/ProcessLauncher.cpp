@@ -0,0 +1,527 @@
+#include "ProcessLauncher.h"
+
+#if defined(__linux__) && defined(__GLIBC__) \
+    && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 29))
+// posix_spawn_file_actions_addchdir_np 从 glibc 2.29 开始提供
+#define LAMINA_HAVE_SPAWN 1
+#include <spawn.h>
+#include <dirent.h>
+#include <cstdlib>
+#endif
+
+#ifdef _WIN32
+#include <windows.h>
+#include <thread>
+#else
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+static const char FILE_PATH_PLACEHOLDER[] = "%lmfilepath%";
+
+std::vector<std::string> ProcessLauncher::SplitCommand(std::string_view command)
+{
+    std::vector<std::string> args;
+    std::string current;
+    bool inArgument = false;
+    char quote = 0;
+
+    for (size_t i = 0; i < command.size(); ++i)
+    {
+        char ch = command[i];
+        if (quote == 0 && (ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r'))
+        {
+            if (inArgument)
+                args.push_back(std::move(current));
+            current.clear();
+            inArgument = false;
+            continue;
+        }
+
+        inArgument = true;
+        if (ch == '\\' && quote != '\'' && i + 1 < command.size() && command[i + 1] == '"')
+        {
+            current += '"';
+            ++i;
+        }
+        else if (quote == 0 && (ch == '"' || ch == '\''))
+        {
+            quote = ch;
+        }
+        else if (ch == quote)
+        {
+            quote = 0;
+        }
+        else
+        {
+            current += ch;
+        }
+    }
+    if (inArgument)
+        args.push_back(std::move(current));
+    return args;
+}
+
+std::vector<std::string> ProcessLauncher::ExpandCommand(std::string_view commandTemplate, std::string_view filePath)
+{
+    std::vector<std::string> args;
+    for (std::string& arg : SplitCommand(commandTemplate))
+    {
+        if (filePath.empty() && arg == FILE_PATH_PLACEHOLDER)
+            continue;
+
+        size_t position = 0;
+        while ((position = arg.find(FILE_PATH_PLACEHOLDER, position)) != std::string::npos)
+        {
+            arg.replace(position, sizeof(FILE_PATH_PLACEHOLDER) - 1, filePath);
+            position += filePath.size();
+        }
+        args.push_back(std::move(arg));
+    }
+    return args;
+}
+
+bool ProcessLauncher::IsSpawnSupported()
+{
+#ifdef LAMINA_HAVE_SPAWN
+    return true;
+#else
+    return false;
+#endif
+}
+
+#ifndef _WIN32
+
+static void ClosePipe(int pipe[2])
+{
+    for (int i = 0; i < 2; ++i)
+    {
+        if (pipe[i] >= 0)
+            close(pipe[i]);
+        pipe[i] = -1;
+    }
+}
+
+#endif
+
+#ifdef LAMINA_HAVE_SPAWN
+
+// 其他库打开时没有设置 O_CLOEXEC 的描述符不留给子进程
+static void AddCloseInherited(posix_spawn_file_actions_t* actions)
+{
+#if __GLIBC__ > 2 || __GLIBC_MINOR__ >= 34
+    posix_spawn_file_actions_addclosefrom_np(actions, STDERR_FILENO + 1);
+#else
+    // 关闭子进程中已不存在的描述符时 glibc 忽略错误
+    DIR* dir = opendir("/proc/self/fd");
+    if (!dir)
+        return;
+    while (dirent* entry = readdir(dir))
+    {
+        int fd = atoi(entry->d_name);
+        if (fd > STDERR_FILENO && fd != dirfd(dir))
+            posix_spawn_file_actions_addclose(actions, fd);
+    }
+    closedir(dir);
+#endif
+}
+
+bool ProcessLauncher::Spawn(const std::vector<std::string>& args, const std::string& workingDir,
+                            LaunchedProcess& process, int& errorCode)
+{
+    if (args.empty())
+    {
+        errorCode = ENOENT;
+        return false;
+    }
+
+    // 管道都带 O_CLOEXEC，子进程只通过 dup2 得到的 0、1、2 继承它们
+    int input[2] = { -1, -1 };
+    int output[2] = { -1, -1 };
+    int error[2] = { -1, -1 };
+    if (pipe2(input, O_CLOEXEC) != 0 || pipe2(output, O_CLOEXEC) != 0 || pipe2(error, O_CLOEXEC) != 0)
+    {
+        errorCode = errno;
+        ClosePipe(input);
+        ClosePipe(output);
+        ClosePipe(error);
+        return false;
+    }
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, input[0], STDIN_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, output[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, error[1], STDERR_FILENO);
+    AddCloseInherited(&actions);
+    if (!workingDir.empty())
+        posix_spawn_file_actions_addchdir_np(&actions, workingDir.c_str());
+
+    // IDE 忽略了 SIGPIPE，忽略的信号会被子进程继承，这里恢复默认处理并清空信号掩码
+    posix_spawnattr_t attributes;
+    posix_spawnattr_init(&attributes);
+    sigset_t defaults;
+    sigemptyset(&defaults);
+    sigaddset(&defaults, SIGPIPE);
+    sigaddset(&defaults, SIGINT);
+    posix_spawnattr_setsigdefault(&attributes, &defaults);
+    sigset_t mask;
+    sigemptyset(&mask);
+    posix_spawnattr_setsigmask(&attributes, &mask);
+    posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK);
+
+    std::vector<char*> argv;
+    for (const std::string& arg : args)
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    argv.push_back(nullptr);
+
+    // glibc 以 CLONE_VM | CLONE_VFORK 创建子进程，耗时与父进程占用的内存无关；
+    // exec 失败时 posix_spawnp 直接返回错误码
+    pid_t pid = 0;
+    int result = posix_spawnp(&pid, argv[0], &actions, &attributes, argv.data(), environ);
+    posix_spawnattr_destroy(&attributes);
+    posix_spawn_file_actions_destroy(&actions);
+
+    close(input[0]);
+    close(output[1]);
+    close(error[1]);
+    if (result != 0)
+    {
+        errorCode = result;
+        close(input[1]);
+        close(output[0]);
+        close(error[0]);
+        return false;
+    }
+
+    // 与 wxExecute 一致：标准输入非阻塞，写满时由写入线程稍后重试
+    fcntl(input[1], F_SETFL, fcntl(input[1], F_GETFL) | O_NONBLOCK);
+
+    process.pid = pid;
+    process.input = input[1];
+    process.output = output[0];
+    process.error = error[0];
+    errorCode = 0;
+    return true;
+}
+
+#else
+
+bool ProcessLauncher::Spawn(const std::vector<std::string>&, const std::string&, LaunchedProcess&, int& errorCode)
+{
+    errorCode = 0;
+    return false;
+}
+
+#endif
+
+#ifdef _WIN32
+
+static std::wstring Widen(const std::string& text)
+{
+    if (text.empty())
+        return std::wstring();
+    int length = MultiByteToWideChar(CP_UTF8, 0, text.data(), (int)text.size(), nullptr, 0);
+    std::wstring wide(length, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, text.data(), (int)text.size(), &wide[0], length);
+    return wide;
+}
+
+// 按 CommandLineToArgvW 的规则加引号，子进程得到的参数与 args 相同
+static void AppendQuoted(std::wstring& commandLine, const std::wstring& arg)
+{
+    if (!commandLine.empty())
+        commandLine += L' ';
+    if (!arg.empty() && arg.find_first_of(L" \t\n\v\"") == std::wstring::npos)
+    {
+        commandLine += arg;
+        return;
+    }
+
+    commandLine += L'"';
+    for (size_t i = 0; ; ++i)
+    {
+        size_t backslashes = 0;
+        while (i < arg.size() && arg[i] == L'\\')
+        {
+            ++i;
+            ++backslashes;
+        }
+        if (i == arg.size())
+        {
+            commandLine.append(backslashes * 2, L'\\');
+            break;
+        }
+        if (arg[i] == L'"')
+            commandLine.append(backslashes * 2 + 1, L'\\');
+        else
+            commandLine.append(backslashes, L'\\');
+        commandLine += arg[i];
+    }
+    commandLine += L'"';
+}
+
+static void ReadHandle(HANDLE handle, std::string& target)
+{
+    char buffer[65536];
+    DWORD count = 0;
+    while (ReadFile(handle, buffer, sizeof(buffer), &count, nullptr) && count > 0)
+        target.append(buffer, count);
+}
+
+bool ProcessLauncher::Run(const std::vector<std::string>& args, const std::string& workingDir,
+                          ProcessOutput& result, int& errorCode)
+{
+    if (args.empty())
+    {
+        errorCode = ERROR_FILE_NOT_FOUND;
+        return false;
+    }
+
+    SECURITY_ATTRIBUTES inherit = { sizeof(inherit), nullptr, TRUE };
+    HANDLE outputRead = nullptr;
+    HANDLE outputWrite = nullptr;
+    HANDLE errorRead = nullptr;
+    HANDLE errorWrite = nullptr;
+    if (!CreatePipe(&outputRead, &outputWrite, &inherit, 0))
+    {
+        errorCode = GetLastError();
+        return false;
+    }
+    if (!CreatePipe(&errorRead, &errorWrite, &inherit, 0))
+    {
+        errorCode = GetLastError();
+        CloseHandle(outputRead);
+        CloseHandle(outputWrite);
+        return false;
+    }
+    SetHandleInformation(outputRead, HANDLE_FLAG_INHERIT, 0);
+    SetHandleInformation(errorRead, HANDLE_FLAG_INHERIT, 0);
+    HANDLE input = CreateFileW(L"NUL", GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, &inherit, OPEN_EXISTING, 0, nullptr);
+
+    // 子进程只继承这三个句柄，其他线程同时创建的管道不会泄漏给它
+    HANDLE handles[3] = { input, outputWrite, errorWrite };
+    SIZE_T size = 0;
+    InitializeProcThreadAttributeList(nullptr, 1, 0, &size);
+    std::vector<char> attributeBuffer(size);
+    LPPROC_THREAD_ATTRIBUTE_LIST attributes = reinterpret_cast<LPPROC_THREAD_ATTRIBUTE_LIST>(attributeBuffer.data());
+    InitializeProcThreadAttributeList(attributes, 1, 0, &size);
+    UpdateProcThreadAttribute(attributes, 0, PROC_THREAD_ATTRIBUTE_HANDLE_LIST, handles, sizeof(handles), nullptr, nullptr);
+
+    STARTUPINFOEXW startup = {};
+    startup.StartupInfo.cb = sizeof(startup);
+    startup.StartupInfo.dwFlags = STARTF_USESTDHANDLES;
+    startup.StartupInfo.hStdInput = input;
+    startup.StartupInfo.hStdOutput = outputWrite;
+    startup.StartupInfo.hStdError = errorWrite;
+    startup.lpAttributeList = attributes;
+
+    std::wstring commandLine;
+    for (const std::string& arg : args)
+        AppendQuoted(commandLine, Widen(arg));
+    std::wstring directory = Widen(workingDir);
+
+    PROCESS_INFORMATION info = {};
+    BOOL created = CreateProcessW(nullptr, &commandLine[0], nullptr, nullptr, TRUE,
+                                  EXTENDED_STARTUPINFO_PRESENT | CREATE_NO_WINDOW, nullptr,
+                                  directory.empty() ? nullptr : directory.c_str(), &startup.StartupInfo, &info);
+    DWORD createError = GetLastError();
+    DeleteProcThreadAttributeList(attributes);
+    if (input != INVALID_HANDLE_VALUE)
+        CloseHandle(input);
+    CloseHandle(outputWrite);
+    CloseHandle(errorWrite);
+    if (!created)
+    {
+        CloseHandle(outputRead);
+        CloseHandle(errorRead);
+        errorCode = createError;
+        return false;
+    }
+    CloseHandle(info.hThread);
+
+    // 两个管道同时读取，任何一个写满都不会让子进程阻塞
+    std::thread errorReader([&]() { ReadHandle(errorRead, result.errors); });
+    ReadHandle(outputRead, result.output);
+    errorReader.join();
+    CloseHandle(outputRead);
+    CloseHandle(errorRead);
+
+    WaitForSingleObject(info.hProcess, INFINITE);
+    DWORD exitCode = 0;
+    GetExitCodeProcess(info.hProcess, &exitCode);
+    CloseHandle(info.hProcess);
+
+    result.exitCode = (int)exitCode;
+    errorCode = 0;
+    return true;
+}
+
+#else
+
+#ifndef LAMINA_HAVE_SPAWN
+
+// 没有 posix_spawn_file_actions_addchdir_np 时用 fork 启动，子进程中只调用异步信号安全的函数
+static bool ForkChild(const std::vector<std::string>& args, const std::string& workingDir,
+                      LaunchedProcess& process, int& errorCode)
+{
+    if (args.empty())
+    {
+        errorCode = ENOENT;
+        return false;
+    }
+
+    // 第四个管道在 exec 失败时把 errno 传回父进程
+    int pipes[4][2] = { { -1, -1 }, { -1, -1 }, { -1, -1 }, { -1, -1 } };
+    for (int i = 0; i < 4; ++i)
+    {
+        if (pipe(pipes[i]) != 0)
+        {
+            errorCode = errno;
+            for (int j = 0; j < 4; ++j)
+                ClosePipe(pipes[j]);
+            return false;
+        }
+        fcntl(pipes[i][0], F_SETFD, FD_CLOEXEC);
+        fcntl(pipes[i][1], F_SETFD, FD_CLOEXEC);
+    }
+    int* input = pipes[0];
+    int* output = pipes[1];
+    int* error = pipes[2];
+    int* status = pipes[3];
+
+    std::vector<char*> argv;
+    for (const std::string& arg : args)
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    argv.push_back(nullptr);
+    long maxDescriptor = sysconf(_SC_OPEN_MAX);
+    if (maxDescriptor < 0 || maxDescriptor > 65536)
+        maxDescriptor = 65536;
+
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        dup2(input[0], STDIN_FILENO);
+        dup2(output[1], STDOUT_FILENO);
+        dup2(error[1], STDERR_FILENO);
+        for (int fd = STDERR_FILENO + 1; fd < maxDescriptor; ++fd)
+        {
+            if (fd != status[1])
+                close(fd);
+        }
+
+        signal(SIGPIPE, SIG_DFL);
+        signal(SIGINT, SIG_DFL);
+        sigset_t mask;
+        sigemptyset(&mask);
+        sigprocmask(SIG_SETMASK, &mask, nullptr);
+
+        if (workingDir.empty() || chdir(workingDir.c_str()) == 0)
+            execvp(argv[0], argv.data());
+        int code = errno;
+        ssize_t written = write(status[1], &code, sizeof(code));
+        (void)written;
+        _exit(127);
+    }
+
+    int forkError = errno;
+    close(input[0]);
+    close(output[1]);
+    close(error[1]);
+    close(status[1]);
+    int code = 0;
+    bool failed = pid < 0;
+    if (failed)
+        code = forkError;
+    else
+        failed = read(status[0], &code, sizeof(code)) == sizeof(code);
+    close(status[0]);
+    if (failed)
+    {
+        if (pid > 0)
+            waitpid(pid, nullptr, 0);
+        close(input[1]);
+        close(output[0]);
+        close(error[0]);
+        errorCode = code;
+        return false;
+    }
+
+    process.pid = pid;
+    process.input = input[1];
+    process.output = output[0];
+    process.error = error[0];
+    errorCode = 0;
+    return true;
+}
+
+#endif
+
+// 同时读取两个管道直到子进程关闭它们
+static void ReadPipes(int output, int error, ProcessOutput& result)
+{
+    pollfd fds[2] = { { output, POLLIN, 0 }, { error, POLLIN, 0 } };
+    std::string* targets[2] = { &result.output, &result.errors };
+    char buffer[65536];
+    int open = 2;
+    while (open > 0)
+    {
+        if (poll(fds, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        for (int i = 0; i < 2; ++i)
+        {
+            if (fds[i].fd < 0 || fds[i].revents == 0)
+                continue;
+            ssize_t count = read(fds[i].fd, buffer, sizeof(buffer));
+            if (count > 0)
+            {
+                targets[i]->append(buffer, count);
+            }
+            else if (count == 0 || errno != EINTR)
+            {
+                close(fds[i].fd);
+                fds[i].fd = -1;
+                --open;
+            }
+        }
+    }
+    for (pollfd& fd : fds)
+    {
+        if (fd.fd >= 0)
+            close(fd.fd);
+    }
+}
+
+bool ProcessLauncher::Run(const std::vector<std::string>& args, const std::string& workingDir,
+                          ProcessOutput& result, int& errorCode)
+{
+    LaunchedProcess child;
+#ifdef LAMINA_HAVE_SPAWN
+    if (!Spawn(args, workingDir, child, errorCode))
+        return false;
+#else
+    if (!ForkChild(args, workingDir, child, errorCode))
+        return false;
+#endif
+
+    // 子进程的标准输入为空
+    close(child.input);
+    ReadPipes(child.output, child.error, result);
+
+    int status = 0;
+    while (waitpid(child.pid, &status, 0) < 0 && errno == EINTR)
+    {
+    }
+    result.exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : -WTERMSIG(status);
+    return true;
+}
+
+#endif
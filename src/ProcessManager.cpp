@@ -1,6 +1,238 @@
 #include "ProcessManager.h"
+#include "ProcessLauncher.h"
 #include <wx/stream.h>
-#include <wx/txtstrm.h>
+#include <wx/wfstream.h>
+#include <wx/log.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef __LINUX__
+#include <wx/unix/pipe.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/wait.h>
+#endif
+
+// 标准输入队列的上限，超过时 WriteInput 只接受一部分
+static const size_t INPUT_QUEUE_LIMIT = 4 * 1024 * 1024;
+
+// 每次从输出管道读取的字节数
+static const size_t OUTPUT_BLOCK_SIZE = 64 * 1024;
+
+// 发送输入文件时每次读取或 splice 的字节数
+static const size_t INPUT_FILE_CHUNK = 1024 * 1024;
+
+// 写入线程与 ProcessManager 共享的标准输入状态
+struct InputChannel
+{
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<std::string> chunks;
+    size_t pending = 0;                     // 队列中和正在写入的字节数
+    bool closing = false;                   // 写完后关闭管道
+    bool stopped = false;                   // 进程已结束或被停止，丢弃剩余数据
+    bool broken = false;                    // 子进程关闭了标准输入
+    bool waitingForSpace = false;           // 有数据被拒绝，腾出空间后通知
+    ProcessManager* owner = nullptr;
+    std::unique_ptr<wxOutputStream> stream;
+
+    // 作为标准输入的文件，只由写入线程访问。
+    // fileFailed 和 fileEnd 在 fileDone 置位之前写入
+    std::unique_ptr<wxFile> file;
+    uint64_t fileSize = 0;
+    std::atomic<uint64_t> fileSent{0};
+    std::atomic<bool> fileDone{false};
+    bool fileFailed = false;
+    std::chrono::steady_clock::time_point fileStart;
+    std::chrono::steady_clock::time_point fileEnd;
+};
+
+static bool IsStopped(InputChannel& channel)
+{
+    std::lock_guard<std::mutex> lock(channel.mutex);
+    return channel.stopped;
+}
+
+// 管道写满后等待子进程读取的最长时间，超时后检查进程是否已停止
+static const int INPUT_WAIT_MS = 100;
+
+#ifdef __LINUX__
+// 标准输入管道的描述符，无法取得时为 -1
+static int GetPipeFd(InputChannel& channel)
+{
+    // Unix 上 wxProcess 的标准输入流是基于管道描述符的 wxFileOutputStream
+    wxFileOutputStream* pipe = dynamic_cast<wxFileOutputStream*>(channel.stream.get());
+    if (pipe && pipe->GetFile() && pipe->GetFile()->IsOpened())
+        return pipe->GetFile()->fd();
+    return -1;
+}
+#endif
+
+// 写入整块数据，非阻塞管道写满时 LastWrite 为 0 但没有错误，等管道可写后重试。
+// 返回 false 表示管道已损坏
+static bool WriteAll(InputChannel& channel, const char* data, size_t size)
+{
+#ifdef __LINUX__
+    int pipeFd = GetPipeFd(channel);
+#endif
+    size_t written = 0;
+    while (written < size)
+    {
+        channel.stream->Write(data + written, size - written);
+        size_t count = channel.stream->LastWrite();
+        written += count;
+        if (count > 0)
+            continue;
+        if (channel.stream->GetLastError() != wxSTREAM_NO_ERROR)
+            return false;
+        if (IsStopped(channel))
+            break;
+#ifdef __LINUX__
+        if (pipeFd >= 0)
+        {
+            // 阻塞到子进程读走数据；管道损坏时 poll 同样返回，下一次写入报告错误
+            pollfd poller = { pipeFd, POLLOUT, 0 };
+            poll(&poller, 1, INPUT_WAIT_MS);
+            continue;
+        }
+#endif
+        // 无法等待管道可写的平台
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+#ifdef __LINUX__
+// 用 splice 把文件页直接移入管道，数据不经过用户空间。
+// 返回 false 表示文件系统不支持 splice，调用方改为读写
+static bool SpliceInputFile(InputChannel& channel, int pipeFd, bool& failed)
+{
+    // 更大的管道缓冲减少系统调用和子进程的唤醒次数，失败时保持默认大小
+    fcntl(pipeFd, F_SETPIPE_SZ, (int)INPUT_FILE_CHUNK);
+
+    int fileFd = channel.file->fd();
+    off64_t offset = 0;
+    while (!IsStopped(channel))
+    {
+        ssize_t count = splice(fileFd, &offset, pipeFd, nullptr, INPUT_FILE_CHUNK,
+                               SPLICE_F_MOVE | SPLICE_F_MORE | SPLICE_F_NONBLOCK);
+        if (count > 0)
+        {
+            channel.fileSent += count;
+            continue;
+        }
+        if (count == 0)
+            return true;
+        if (errno == EINTR)
+            continue;
+        if (errno == EAGAIN)
+        {
+            // 管道已满，等子进程读取；定时醒来检查进程是否已停止
+            pollfd poller = { pipeFd, POLLOUT, 0 };
+            poll(&poller, 1, INPUT_WAIT_MS);
+            continue;
+        }
+        if (offset == 0 && (errno == EINVAL || errno == ENOSYS))
+            return false;
+        failed = true;
+        return true;
+    }
+    return true;
+}
+#endif
+
+// 分块读取文件再写入管道
+static void CopyInputFile(InputChannel& channel, bool& failed)
+{
+    std::vector<char> buffer(INPUT_FILE_CHUNK);
+    while (!IsStopped(channel))
+    {
+        ssize_t count = channel.file->Read(buffer.data(), buffer.size());
+        if (count == wxInvalidOffset)
+        {
+            failed = true;
+            return;
+        }
+        if (count == 0)
+            return;
+        if (!WriteAll(channel, buffer.data(), count))
+        {
+            failed = true;
+            return;
+        }
+        channel.fileSent += count;
+    }
+}
+
+static void SendInputFile(InputChannel& channel)
+{
+    bool failed = false;
+    bool sent = false;
+#ifdef __LINUX__
+    int pipeFd = GetPipeFd(channel);
+    if (pipeFd >= 0)
+        sent = SpliceInputFile(channel, pipeFd, failed);
+#endif
+    if (!sent)
+        CopyInputFile(channel, failed);
+
+    channel.file.reset();
+    channel.fileFailed = failed;
+    channel.fileEnd = std::chrono::steady_clock::now();
+    channel.fileDone = true;
+}
+
+// 写入线程可能阻塞在子进程不读取的管道上，因此不等待它结束：
+// 进程结束时写入失败，线程随之退出并释放共享状态
+static void InputWriterLoop(std::shared_ptr<InputChannel> channel, std::function<void(ProcessManager*)> notify)
+{
+    // 输入文件就是全部输入，发送完后直接关闭管道
+    if (channel->file)
+        SendInputFile(*channel);
+
+    std::unique_lock<std::mutex> lock(channel->mutex);
+    for (;;)
+    {
+        channel->ready.wait(lock, [&]() { return channel->stopped || channel->closing || !channel->chunks.empty(); });
+        if (channel->stopped || channel->chunks.empty())
+            break;
+
+        std::string chunk = std::move(channel->chunks.front());
+        channel->chunks.pop_front();
+        lock.unlock();
+
+        bool failed = !WriteAll(*channel, chunk.data(), chunk.size());
+
+        lock.lock();
+        channel->pending -= chunk.size();
+        if (failed)
+        {
+            // 让等待空间的一方发现输入已关闭
+            channel->broken = true;
+            if (channel->owner)
+                notify(channel->owner);
+            break;
+        }
+        if (channel->waitingForSpace && channel->owner && channel->pending <= INPUT_QUEUE_LIMIT / 2)
+        {
+            channel->waitingForSpace = false;
+            notify(channel->owner);
+        }
+    }
+
+    // 关闭管道，子进程读到 EOF
+    channel->stream.reset();
+    channel->chunks.clear();
+    channel->pending = 0;
+}
 
 wxBEGIN_EVENT_TABLE(ProcessManager, wxEvtHandler)
     EVT_END_PROCESS(wxID_ANY, ProcessManager::OnProcessTerminate)
@@ -10,6 +242,10 @@ wxEND_EVENT_TABLE()
 ProcessManager::ProcessManager()
     : m_pid(0)
     , m_timer(this)
+    , m_pollInterval(100)
+    , m_spawned(false)
+    , m_inputFileReported(true)
+    , m_inputReceived(false)
 {
 }
 
@@ -18,63 +254,170 @@ ProcessManager::~ProcessManager()
     StopProcess();
 }
 
-bool ProcessManager::RunCommand(const wxString& command, const wxString& workingDir)
+static std::string ToUtf8(const wxString& text)
+{
+    wxScopedCharBuffer buffer = text.utf8_str();
+    return std::string(buffer.data(), buffer.length());
+}
+
+bool ProcessManager::RunCommand(const wxString& commandTemplate, const wxString& filePath,
+                                const wxString& workingDir, const wxString& inputFile)
 {
     if (IsRunning())
     {
         StopProcess();
     }
     
-    m_process = std::make_unique<wxProcess>(this);
-    m_process->Redirect();
-    
-    // 设置工作目录
-    wxString currentDir;
-    if (!workingDir.IsEmpty())
+    // 先打开输入文件，打不开时不启动进程
+    std::unique_ptr<wxFile> input;
+    if (!inputFile.IsEmpty())
     {
-        currentDir = wxGetCwd();
-        wxSetWorkingDirectory(workingDir);
+        wxLogNull noLog;
+        input = std::make_unique<wxFile>();
+        if (!input->Open(inputFile, wxFile::read))
+            return false;
     }
     
-    m_pid = wxExecute(command, wxEXEC_ASYNC, m_process.get());
-    
-    // 恢复工作目录
-    if (!workingDir.IsEmpty() && !currentDir.IsEmpty())
-    {
-        wxSetWorkingDirectory(currentDir);
-    }
+    std::vector<std::string> args = ProcessLauncher::ExpandCommand(ToUtf8(commandTemplate), ToUtf8(filePath));
+    if (args.empty())
+        return false;
     
-    if (m_pid == 0)
+    m_process = std::make_unique<wxProcess>(this);
+    if (!Launch(args, workingDir))
     {
         m_process.reset();
+        m_pid = 0;
         return false;
     }
     
+    m_inputReceived = false;
+    StartInput(std::move(input));
+    
     // 启动定时器读取输出
-    m_timer.Start(100, false);
+    m_timer.Start(m_pollInterval, false);
     
     return true;
 }
 
+bool ProcessManager::Launch(const std::vector<std::string>& args, const wxString& workingDir)
+{
+    m_spawned = false;
+    
+#ifdef __LINUX__
+    // posix_spawn 不复制 IDE 的地址空间，工作目录只在子进程中切换
+    if (ProcessLauncher::IsSpawnSupported())
+    {
+        LaunchedProcess child;
+        int errorCode;
+        if (!ProcessLauncher::Spawn(args, ToUtf8(workingDir), child, errorCode))
+            return false;
+        
+        m_process->SetPipeStreams(new wxPipeInputStream(child.output), new wxPipeOutputStream(child.input),
+                                  new wxPipeInputStream(child.error));
+        m_pid = child.pid;
+        m_spawned = true;
+        return true;
+    }
+#endif
+    
+    // 其他平台由 wxExecute 启动，工作目录通过 wxExecuteEnv 设置，不修改 IDE 的工作目录
+    m_process->Redirect();
+    wxExecuteEnv env;
+    env.cwd = workingDir;
+    
+    std::vector<wxWCharBuffer> buffers;
+    std::vector<const wchar_t*> argv;
+    buffers.reserve(args.size());
+    for (const std::string& arg : args)
+    {
+        buffers.push_back(wxString::FromUTF8(arg.data(), arg.size()).wc_str());
+        argv.push_back(buffers.back().data());
+    }
+    argv.push_back(nullptr);
+    
+    m_pid = wxExecute(argv.data(), wxEXEC_ASYNC, m_process.get(), &env);
+    return m_pid != 0;
+}
+
+void ProcessManager::CheckSpawnedExit()
+{
+#ifdef __LINUX__
+    // 自行启动的进程没有 wx 的结束事件，轮询它的状态。
+    // 被信号终止时与 wxProcess 和 ProcessLauncher 一样报告负的信号编号
+    int status;
+    if (!m_spawned || waitpid(m_pid, &status, WNOHANG) != m_pid)
+        return;
+    
+    int exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : -WTERMSIG(status);
+    wxProcessEvent event(wxID_ANY, m_pid, exitCode);
+    OnProcessTerminate(event);
+#endif
+}
+
 void ProcessManager::StopProcess()
 {
     if (m_process)
     {
         m_timer.Stop();
+        StopInput();
         
-        if (m_pid > 0)
+        if (m_spawned)
         {
             wxProcess::Kill(m_pid, wxSIGTERM);
+            
+            // 关闭管道丢弃未读取的输出，在后台回收进程，避免留下僵尸进程
+#ifdef __LINUX__
+            int pid = m_pid;
+            std::thread([pid]() { waitpid(pid, nullptr, 0); }).detach();
+#endif
+            m_process.reset();
+            m_spawned = false;
+        }
+        else
+        {
+            // 分离旧进程：它结束时自行释放且不再发送结束事件，
+            // 未读取的输出随之丢弃，不会混入下一次运行
+            m_process->Detach();
+            
+            if (m_pid > 0)
+            {
+                wxProcess::Kill(m_pid, wxSIGTERM);
+            }
+            
+            m_process.release();
         }
-        
-        m_process.reset();
         m_pid = 0;
     }
 }
 
+void ProcessManager::SetPollInterval(int milliseconds)
+{
+    if (milliseconds == m_pollInterval)
+        return;
+    
+    m_pollInterval = milliseconds;
+    if (m_timer.IsRunning())
+        m_timer.Start(m_pollInterval, false);
+}
+
+bool ProcessManager::Interrupt()
+{
+    if (!m_process || m_pid <= 0)
+        return false;
+    
+    wxLogNull noLog;
+    return wxProcess::Kill(m_pid, wxSIGINT) == wxKILL_OK;
+}
+
 void ProcessManager::OnProcessTerminate(wxProcessEvent& event)
 {
+    // 忽略已被取消的旧进程
+    if (event.GetPid() != m_pid)
+        return;
+    
     m_timer.Stop();
+    ReportInputFile(true);
+    StopInput();
     
     // 读取剩余的输出
     ReadOutput();
@@ -87,6 +430,7 @@ void ProcessManager::OnProcessTerminate(wxProcessEvent& event)
     
     m_process.reset();
     m_pid = 0;
+    m_spawned = false;
 }
 
 void ProcessManager::OnTimer(wxTimerEvent& WXUNUSED(event))
@@ -95,79 +439,213 @@ void ProcessManager::OnTimer(wxTimerEvent& WXUNUSED(event))
     {
         ReadOutput();
         ReadError();
+        ReportInputFile(false);
+        CheckSpawnedExit();
     }
 }
 
-void ProcessManager::ReadOutput()
+// 按行交给回调：UTF-8 解码（不是合法的 UTF-8 时按字节），去掉 \r
+static void DeliverLine(const char* data, size_t size, bool newline, const std::function<void(const wxString&)>& callback)
 {
-    if (!m_process)
+    if (!callback)
         return;
     
-    wxInputStream* stream = m_process->GetInputStream();
+    wxString line = wxString::FromUTF8(data, size);
+    if (line.IsEmpty() && size > 0)
+        line = wxString::From8BitData(data, size);
+    if (memchr(data, '\r', size))
+        line.Replace("\r", "");
+    if (newline)
+        line += '\n';
+    callback(line);
+}
+
+void ProcessManager::ReadStream(wxInputStream* stream, const std::function<void(const wxString&)>& callback,
+                                const std::function<void(const char*, size_t)>& dataCallback)
+{
     if (!stream || !stream->CanRead())
         return;
     
-    wxTextInputStream text(*stream);
-    wxString line;
-    
+    // 整块读取再按行切分，读到的字节数不足一块时 Read 不会等待
+    m_readBuffer.resize(OUTPUT_BLOCK_SIZE);
+    std::string partial;
     while (stream->CanRead())
     {
-        wxChar ch = stream->GetC();
-        if (stream->LastRead() == 0)
+        stream->Read(m_readBuffer.data(), m_readBuffer.size());
+        size_t count = stream->LastRead();
+        if (count == 0)
             break;
         
-        if (ch == '\n')
-        {
-            if (m_outputCallback)
-                m_outputCallback(line + "\n");
-            line.Clear();
-        }
-        else if (ch != '\r')
+        const char* data = m_readBuffer.data();
+        if (dataCallback)
+            dataCallback(data, count);
+        
+        const char* end = data + count;
+        while (data < end)
         {
-            line += ch;
+            const char* newline = static_cast<const char*>(memchr(data, '\n', end - data));
+            if (!newline)
+            {
+                partial.append(data, end);
+                break;
+            }
+            if (partial.empty())
+            {
+                DeliverLine(data, newline - data, true, callback);
+            }
+            else
+            {
+                partial.append(data, newline);
+                DeliverLine(partial.data(), partial.size(), true, callback);
+                partial.clear();
+            }
+            data = newline + 1;
         }
     }
     
     // 处理剩余的字符
-    if (!line.IsEmpty() && m_outputCallback)
+    if (!partial.empty())
+        DeliverLine(partial.data(), partial.size(), false, callback);
+}
+
+void ProcessManager::ReadOutput()
+{
+    if (m_process)
+        ReadStream(m_process->GetInputStream(), m_outputCallback, m_outputDataCallback);
+}
+
+void ProcessManager::ReadError()
+{
+    if (m_process)
+        ReadStream(m_process->GetErrorStream(), m_errorCallback, nullptr);
+}
+
+void ProcessManager::StartInput(std::unique_ptr<wxFile> inputFile)
+{
+    m_input = std::make_shared<InputChannel>();
+    m_input->owner = this;
+    m_inputFileReported = !inputFile;
+    if (inputFile)
     {
-        m_outputCallback(line);
+        m_input->fileSize = inputFile->Length();
+        m_input->file = std::move(inputFile);
+        m_input->fileStart = std::chrono::steady_clock::now();
+        m_input->closing = true;
     }
+
+    // 从 wxProcess 接管标准输入流，进程被分离后写入线程仍可安全使用它
+    m_input->stream.reset(m_process->GetOutputStream());
+    m_process->SetPipeStreams(m_process->GetInputStream(), nullptr, m_process->GetErrorStream());
+    if (!m_input->stream)
+    {
+        m_input->broken = true;
+        if (m_input->file)
+        {
+            m_input->file.reset();
+            m_input->fileFailed = true;
+            m_input->fileEnd = m_input->fileStart;
+            m_input->fileDone = true;
+        }
+        return;
+    }
+
+    std::thread(InputWriterLoop, m_input, [](ProcessManager* owner) {
+        owner->CallAfter(&ProcessManager::OnInputSpace);
+    }).detach();
 }
 
-void ProcessManager::ReadError()
+void ProcessManager::StopInput()
 {
-    if (!m_process)
+    if (!m_input)
         return;
-    
-    wxInputStream* stream = m_process->GetErrorStream();
-    if (!stream || !stream->CanRead())
+
+    {
+        std::lock_guard<std::mutex> lock(m_input->mutex);
+        m_input->stopped = true;
+        m_input->owner = nullptr;
+    }
+    m_input->ready.notify_one();
+    m_input.reset();
+}
+
+size_t ProcessManager::WriteInput(const char* data, size_t size)
+{
+    if (!m_input || size == 0)
+        return 0;
+
+    size_t accepted;
+    {
+        std::lock_guard<std::mutex> lock(m_input->mutex);
+        if (m_input->closing || m_input->broken || !m_input->stream)
+            return 0;
+
+        accepted = std::min(size, INPUT_QUEUE_LIMIT - std::min(m_input->pending, INPUT_QUEUE_LIMIT));
+        if (accepted < size)
+            m_input->waitingForSpace = true;
+        if (accepted == 0)
+            return 0;
+
+        m_input->chunks.emplace_back(data, accepted);
+        m_input->pending += accepted;
+    }
+    m_inputReceived = true;
+    m_input->ready.notify_one();
+    return accepted;
+}
+
+void ProcessManager::CloseInput()
+{
+    if (!m_input)
         return;
-    
-    wxTextInputStream text(*stream);
-    wxString line;
-    
-    while (stream->CanRead())
+
     {
-        wxChar ch = stream->GetC();
-        if (stream->LastRead() == 0)
-            break;
-        
-        if (ch == '\n')
-        {
-            if (m_errorCallback)
-                m_errorCallback(line + "\n");
-            line.Clear();
-        }
-        else if (ch != '\r')
-        {
-            line += ch;
-        }
+        std::lock_guard<std::mutex> lock(m_input->mutex);
+        m_input->closing = true;
     }
-    
-    // 处理剩余的字符
-    if (!line.IsEmpty() && m_errorCallback)
+    m_input->ready.notify_one();
+}
+
+bool ProcessManager::IsInputOpen() const
+{
+    if (!m_input)
+        return false;
+
+    std::lock_guard<std::mutex> lock(m_input->mutex);
+    return !m_input->closing && !m_input->broken && m_input->stream;
+}
+
+void ProcessManager::OnInputSpace()
+{
+    if (m_inputSpaceCallback)
+        m_inputSpaceCallback();
+}
+
+void ProcessManager::ReportInputFile(bool finished)
+{
+    if (!m_input || m_inputFileReported)
+        return;
+
+    InputFileProgress progress;
+    progress.done = m_input->fileDone;
+    progress.sent = m_input->fileSent;
+    progress.total = m_input->fileSize;
+    if (progress.done)
     {
-        m_errorCallback(line);
+        progress.failed = m_input->fileFailed;
+        progress.seconds = std::chrono::duration<double>(m_input->fileEnd - m_input->fileStart).count();
     }
+    else
+    {
+        progress.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_input->fileStart).count();
+        // 进程在文件发送完之前就结束了
+        if (finished)
+        {
+            progress.done = true;
+            progress.failed = true;
+        }
+    }
+
+    m_inputFileReported = progress.done;
+    if (m_inputFileCallback)
+        m_inputFileCallback(progress);
 }
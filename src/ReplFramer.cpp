@@ -0,0 +1,107 @@
+#include "ReplFramer.h"
+#include <algorithm>
+
+// 哨兵行的格式：__lamlab_repl_<标记>_<编号>__
+static const char MARKER_PREFIX[] = "__lamlab_repl_";
+static const char MARKER_SUFFIX[] = "__";
+
+ReplFramer::ReplFramer(std::string token)
+    : m_marker(MARKER_PREFIX + token + "_")
+{
+}
+
+std::string ReplFramer::Frame(uint64_t id, std::string_view code)
+{
+    m_pending.push_back(id);
+
+    std::string framed(code);
+    if (framed.empty() || framed.back() != '\n')
+        framed += '\n';
+    framed += "print(\"" + m_marker + std::to_string(id) + MARKER_SUFFIX + "\");\n";
+    return framed;
+}
+
+void ReplFramer::Feed(std::string_view text, std::vector<ReplEvent>& events)
+{
+    m_partial.append(text);
+
+    size_t start = 0;
+    for (size_t newline = m_partial.find('\n'); newline != std::string::npos; newline = m_partial.find('\n', start))
+    {
+        ProcessLine(std::string_view(m_partial).substr(start, newline + 1 - start), events);
+        start = newline + 1;
+    }
+    m_partial.erase(0, start);
+
+    // 未结束的行（如提示符）立即输出，只保留可能是哨兵开头的结尾部分
+    if (m_partial.find(m_marker) != std::string::npos)
+        return;
+    size_t keep = std::min(m_partial.size(), m_marker.size() - 1);
+    while (keep > 0 && m_partial.compare(m_partial.size() - keep, keep, m_marker, 0, keep) != 0)
+        --keep;
+    if (keep < m_partial.size())
+    {
+        AddOutput(std::string_view(m_partial).substr(0, m_partial.size() - keep), events);
+        m_partial.erase(0, m_partial.size() - keep);
+    }
+}
+
+void ReplFramer::Reset()
+{
+    m_partial.clear();
+    m_pending.clear();
+}
+
+void ReplFramer::ProcessLine(std::string_view line, std::vector<ReplEvent>& events)
+{
+    // 解释器可能在哨兵前输出提示符，因此在整行中查找
+    size_t position = line.find(m_marker);
+    while (position != std::string_view::npos)
+    {
+        size_t digits = position + m_marker.size();
+        size_t end = digits;
+        uint64_t id = 0;
+        while (end < line.size() && line[end] >= '0' && line[end] <= '9')
+            id = id * 10 + (line[end++] - '0');
+
+        if (end > digits && line.compare(end, sizeof(MARKER_SUFFIX) - 1, MARKER_SUFFIX) == 0
+            && std::find(m_pending.begin(), m_pending.end(), id) != m_pending.end())
+        {
+            // 哨兵之前的文字属于该请求；只有空白时是哨兵语句本身的换行，丢弃
+            std::string_view before = line.substr(0, position);
+            if (before.find_first_not_of(" \t\r") != std::string_view::npos)
+                AddOutput(before, events);
+
+            // 先前的请求没有输出哨兵（如语法错误吞掉了它），一并结束
+            while (!m_pending.empty())
+            {
+                uint64_t done = m_pending.front();
+                m_pending.pop_front();
+                events.push_back({ ReplEvent::Done, done, std::string() });
+                if (done == id)
+                    break;
+            }
+
+            line.remove_prefix(end + sizeof(MARKER_SUFFIX) - 1);
+            if (line == "\n" || line == "\r\n")
+                return;
+            position = line.find(m_marker);
+        }
+        else
+        {
+            position = line.find(m_marker, position + 1);
+        }
+    }
+
+    if (!line.empty())
+        AddOutput(line, events);
+}
+
+void ReplFramer::AddOutput(std::string_view text, std::vector<ReplEvent>& events)
+{
+    uint64_t id = GetCurrentId();
+    if (!events.empty() && events.back().kind == ReplEvent::Output && events.back().id == id)
+        events.back().text.append(text);
+    else
+        events.push_back({ ReplEvent::Output, id, std::string(text) });
+}
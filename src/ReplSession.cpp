@@ -0,0 +1,153 @@
+#include "ReplSession.h"
+#include "ProcessManager.h"
+#include <wx/time.h>
+#include <cstdio>
+#include <random>
+
+// 等待结果时读取输出的间隔（毫秒），空闲时恢复为默认的 100
+static const int REPL_POLL_INTERVAL = 5;
+static const int IDLE_POLL_INTERVAL = 100;
+
+// 每个会话不同的哨兵标记
+static std::string MakeToken()
+{
+    std::random_device device;
+    std::mt19937_64 generator(((uint64_t)device() << 32) ^ device() ^ (uint64_t)wxGetLocalTimeMillis().GetValue());
+    char token[17];
+    snprintf(token, sizeof(token), "%016llx", (unsigned long long)generator());
+    return token;
+}
+
+static std::string ToUtf8(const wxString& text)
+{
+    wxScopedCharBuffer buffer = text.utf8_str();
+    return std::string(buffer.data(), buffer.length());
+}
+
+ReplSession::ReplSession()
+    : m_framer(MakeToken())
+    , m_nextId(1)
+{
+}
+
+ReplSession::~ReplSession()
+{
+    Stop();
+}
+
+bool ReplSession::Start(const wxString& commandTemplate, const wxString& workingDir)
+{
+    Stop();
+
+    if (!m_process)
+    {
+        m_process = std::make_unique<ProcessManager>();
+        m_process->SetOutputCallback([this](const wxString& text) { OnOutput(text); });
+        m_process->SetErrorCallback([this](const wxString& text) { OnError(text); });
+        m_process->SetFinishedCallback([this](int exitCode) { OnFinished(exitCode); });
+        m_process->SetInputSpaceCallback([this]() { FeedInput(); });
+    }
+
+    m_process->SetPollInterval(IDLE_POLL_INTERVAL);
+    return m_process->RunCommand(commandTemplate, wxEmptyString, workingDir);
+}
+
+void ReplSession::Stop()
+{
+    if (m_process)
+        m_process->StopProcess();
+    m_framer.Reset();
+    m_requests.clear();
+    m_pendingInput.clear();
+}
+
+bool ReplSession::IsRunning() const
+{
+    return m_process && m_process->IsRunning();
+}
+
+uint64_t ReplSession::Execute(const wxString& code)
+{
+    if (!IsRunning() || !m_process->IsInputOpen())
+        return 0;
+
+    uint64_t id = m_nextId++;
+    m_requests[id].start = wxGetLocalTimeMillis();
+    m_pendingInput += m_framer.Frame(id, ToUtf8(code));
+    FeedInput();
+    UpdatePollInterval();
+    return id;
+}
+
+bool ReplSession::Interrupt()
+{
+    if (!IsRunning() || !m_process->Interrupt())
+        return false;
+
+    // 解释器放弃当前的代码后仍会执行其后的哨兵语句，会话随之重新同步
+    auto request = m_requests.find(m_framer.GetCurrentId());
+    if (request != m_requests.end())
+        request->second.interrupted = true;
+    return true;
+}
+
+void ReplSession::OnOutput(const wxString& text)
+{
+    std::vector<ReplEvent> events;
+    m_framer.Feed(ToUtf8(text), events);
+
+    for (const ReplEvent& event : events)
+    {
+        if (event.kind == ReplEvent::Output)
+        {
+            if (m_outputCallback)
+                m_outputCallback(event.id, ConsoleStream::Output, wxString::FromUTF8(event.text.data(), event.text.size()));
+            continue;
+        }
+
+        auto request = m_requests.find(event.id);
+        if (request == m_requests.end())
+            continue;
+        long elapsed = (wxGetLocalTimeMillis() - request->second.start).ToLong();
+        bool interrupted = request->second.interrupted;
+        m_requests.erase(request);
+        if (m_doneCallback)
+            m_doneCallback(event.id, elapsed, interrupted);
+    }
+
+    UpdatePollInterval();
+}
+
+void ReplSession::OnError(const wxString& text)
+{
+    // 标准错误没有哨兵，归属当前正在执行的请求
+    if (m_outputCallback)
+        m_outputCallback(m_framer.GetCurrentId(), ConsoleStream::Error, text);
+}
+
+void ReplSession::OnFinished(int exitCode)
+{
+    m_framer.Reset();
+    m_requests.clear();
+    m_pendingInput.clear();
+
+    if (m_endedCallback)
+        m_endedCallback(exitCode);
+}
+
+void ReplSession::FeedInput()
+{
+    while (!m_pendingInput.empty() && IsRunning())
+    {
+        size_t accepted = m_process->WriteInput(m_pendingInput.data(), m_pendingInput.size());
+        if (accepted == 0)
+            break;
+        m_pendingInput.erase(0, accepted);
+    }
+}
+
+void ReplSession::UpdatePollInterval()
+{
+    if (m_process)
+        m_process->SetPollInterval(m_requests.empty() ? IDLE_POLL_INTERVAL : REPL_POLL_INTERVAL);
+}
@@ -0,0 +1,429 @@
+#include "RunCache.h"
+#include "ContentHash.h"
+#include "FileUtils.h"
+#include "IncludeScanner.h"
+#include "ProcessLauncher.h"
+#include <wx/dir.h>
+#include <wx/file.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/log.h>
+#include <wx/stdpaths.h>
+#include <wx/utils.h>
+#include <algorithm>
+#include <set>
+#include <vector>
+
+#ifdef __LINUX__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// 文件格式：魔数、版本、退出码、记录时间（Unix 秒），
+// 随后为输出片段：流编号、长度与原始字节，整数为小端序
+static const char RUN_MAGIC[4] = { 'L', 'M', 'R', 'C' };
+static const uint32_t RUN_VERSION = 1;
+static const size_t RUN_HEADER_SIZE = sizeof(RUN_MAGIC) + 4 + 4 + 8;
+static const size_t SEGMENT_HEADER_SIZE = 1 + 4;
+
+// 默认的总大小上限
+static const uint64_t DEFAULT_BUDGET = 512ULL * 1024 * 1024;
+
+// 单条记录最多占总大小的比例（分母），输出过多的运行不值得缓存
+static const uint64_t MAX_ENTRY_DIVISOR = 4;
+
+static void PutU32(std::string& data, size_t offset, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i)
+        data[offset + i] = static_cast<char>((value >> (i * 8)) & 0xFF);
+}
+
+static void PutU64(std::string& data, size_t offset, uint64_t value)
+{
+    for (int i = 0; i < 8; ++i)
+        data[offset + i] = static_cast<char>((value >> (i * 8)) & 0xFF);
+}
+
+static uint64_t GetUInt(std::string_view data, size_t offset, int bytes)
+{
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i)
+        value |= static_cast<uint64_t>(static_cast<unsigned char>(data[offset + i])) << (i * 8);
+    return value;
+}
+
+static void AppendHash(std::string& material, uint64_t hash)
+{
+    material.append(8, '\0');
+    PutU64(material, material.size() - 8, hash);
+}
+
+static std::string ToUtf8(const wxString& text)
+{
+    wxScopedCharBuffer buffer = text.utf8_str();
+    return std::string(buffer.data(), buffer.length());
+}
+
+// 只读映射的文件，平台不支持时整个读入
+class MappedFile
+{
+public:
+    MappedFile() : m_address(nullptr), m_size(0) {}
+
+    ~MappedFile()
+    {
+#ifdef __LINUX__
+        if (m_address)
+            munmap(m_address, m_size);
+#endif
+    }
+
+    bool Open(const wxString& path)
+    {
+#ifdef __LINUX__
+        int fd = open(path.fn_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return false;
+
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0)
+        {
+            m_size = static_cast<size_t>(info.st_size);
+            void* address = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (address != MAP_FAILED)
+            {
+                // 回放按顺序读取一遍
+                madvise(address, m_size, MADV_SEQUENTIAL);
+                m_address = address;
+            }
+        }
+        close(fd);
+        if (m_address)
+            return true;
+        m_size = 0;
+#endif
+        return FileUtils::ReadBytes(path, m_buffer);
+    }
+
+    std::string_view GetData() const
+    {
+        if (m_address)
+            return std::string_view(static_cast<const char*>(m_address), m_size);
+        return m_buffer;
+    }
+
+private:
+    void* m_address;
+    size_t m_size;
+    std::string m_buffer;
+};
+
+RunCache::RunCache(const wxString& dir)
+    : m_dir(dir)
+    , m_budget(DEFAULT_BUDGET)
+    , m_totalSize(0)
+    , m_loaded(false)
+    , m_recording(false)
+    , m_recordingKey(0)
+{
+}
+
+wxString RunCache::GetDefaultDir()
+{
+    wxFileName dir = wxFileName::DirName(wxStandardPaths::Get().GetUserDataDir());
+    dir.AppendDir("runcache");
+    return dir.GetPath();
+}
+
+wxString RunCache::GetEntryPath(uint64_t key) const
+{
+    wxString name = wxString::Format("%08x%08x.run", (unsigned)(key >> 32), (unsigned)(key & 0xFFFFFFFF));
+    return wxFileName(m_dir, name).GetFullPath();
+}
+
+uint64_t RunCache::HashProgram(const std::string& program)
+{
+    // 不含路径的命令按 PATH 查找，相对路径相对于 IDE 的工作目录
+    wxString name = wxString::FromUTF8(program.data(), program.size());
+    wxString path;
+    if (name.find_first_of(wxFileName::GetPathSeparators()) == wxString::npos)
+    {
+        wxPathList paths;
+        paths.AddEnvList("PATH");
+        path = paths.FindAbsoluteValidPath(name);
+    }
+    else
+    {
+        wxFileName file(name);
+        file.MakeAbsolute();
+        path = file.GetFullPath();
+    }
+
+    wxFileName file(path);
+    if (path.IsEmpty() || !file.FileExists())
+        return 0;
+
+    ProgramHash& cached = m_programs[path];
+    wxULongLong size = file.GetSize();
+    wxDateTime modified = file.GetModificationTime();
+    if (cached.modified.IsValid() && cached.modified == modified && cached.size == size)
+        return cached.hash;
+
+    std::string data;
+    if (!FileUtils::ReadBytes(path, data))
+        return 0;
+    cached.size = size;
+    cached.modified = modified;
+    cached.hash = ContentHash::Compute(data);
+    return cached.hash;
+}
+
+bool RunCache::ComputeKey(const wxString& commandTemplate, const wxString& filePath, const wxString& workingDir, uint64_t& key)
+{
+    std::vector<std::string> args = ProcessLauncher::ExpandCommand(ToUtf8(commandTemplate), ToUtf8(filePath));
+    if (args.empty())
+        return false;
+
+    std::string material(RUN_MAGIC, sizeof(RUN_MAGIC));
+    for (const std::string& arg : args)
+    {
+        material += arg;
+        material.push_back('\0');
+    }
+    material += ToUtf8(workingDir.IsEmpty() ? wxGetCwd() : workingDir);
+    material.push_back('\0');
+    AppendHash(material, HashProgram(args[0]));
+
+    // 脚本及其递归包含的文件，读取的同时计算哈希。缺失的 include 由包含者的内容体现
+    std::set<wxString> visited;
+    std::vector<wxString> pending{ filePath };
+    bool first = true;
+    while (!pending.empty())
+    {
+        wxString current = pending.back();
+        pending.pop_back();
+        if (!visited.insert(current).second)
+            continue;
+
+        std::string source;
+        if (!FileUtils::ReadBytes(current, source))
+        {
+            if (first)
+                return false;
+            continue;
+        }
+        first = false;
+
+        material += ToUtf8(current);
+        material.push_back('\0');
+        AppendHash(material, ContentHash::Compute(source));
+        for (const std::string& include : IncludeScanner::Scan(source))
+            pending.push_back(IncludeScanner::Resolve(current, include));
+    }
+
+    key = ContentHash::Compute(material);
+    return true;
+}
+
+void RunCache::LoadEntries()
+{
+    if (m_loaded)
+        return;
+    m_loaded = true;
+
+    wxArrayString files;
+    if (wxDirExists(m_dir))
+        wxDir::GetAllFiles(m_dir, &files, "*.run", wxDIR_FILES);
+
+    struct Found
+    {
+        uint64_t key;
+        uint64_t size;
+        time_t used;
+    };
+    std::vector<Found> found;
+    for (const wxString& path : files)
+    {
+        wxFileName file(path);
+        unsigned long long key;
+        if (file.GetName().length() != 16 || !file.GetName().ToULongLong(&key, 16))
+            continue;
+        found.push_back({ (uint64_t)key, file.GetSize().GetValue(), file.GetModificationTime().GetTicks() });
+    }
+
+    // 记录被回放时会更新修改时间，最近使用的在前
+    std::sort(found.begin(), found.end(), [](const Found& a, const Found& b) { return a.used > b.used; });
+    for (const Found& entry : found)
+    {
+        m_uses.push_back(entry.key);
+        m_entries[entry.key] = { entry.size, std::prev(m_uses.end()) };
+        m_totalSize += entry.size;
+    }
+    Evict();
+}
+
+void RunCache::Touch(uint64_t key)
+{
+    auto entry = m_entries.find(key);
+    if (entry == m_entries.end())
+        return;
+
+    m_uses.splice(m_uses.begin(), m_uses, entry->second.use);
+    wxLogNull noLog;
+    wxFileName(GetEntryPath(key)).Touch();
+}
+
+void RunCache::Remove(uint64_t key)
+{
+    auto entry = m_entries.find(key);
+    if (entry == m_entries.end())
+        return;
+
+    wxLogNull noLog;
+    wxRemoveFile(GetEntryPath(key));
+    m_totalSize -= entry->second.size;
+    m_uses.erase(entry->second.use);
+    m_entries.erase(entry);
+}
+
+void RunCache::Evict()
+{
+    while (m_totalSize > m_budget && !m_uses.empty())
+        Remove(m_uses.back());
+}
+
+void RunCache::SetBudget(uint64_t bytes)
+{
+    m_budget = bytes;
+    if (m_loaded)
+        Evict();
+}
+
+void RunCache::Clear()
+{
+    LoadEntries();
+    while (!m_uses.empty())
+        Remove(m_uses.back());
+}
+
+bool RunCache::Replay(uint64_t key, const std::function<void(ConsoleStream, std::string_view)>& sink, CachedRun& run)
+{
+    LoadEntries();
+    if (m_entries.find(key) == m_entries.end())
+        return false;
+
+    MappedFile file;
+    if (!file.Open(GetEntryPath(key)))
+    {
+        Remove(key);
+        return false;
+    }
+
+    // 先完整检查一遍，损坏的记录不回放任何内容
+    std::string_view data = file.GetData();
+    bool valid = data.size() >= RUN_HEADER_SIZE && data.compare(0, sizeof(RUN_MAGIC), std::string_view(RUN_MAGIC, sizeof(RUN_MAGIC))) == 0
+        && GetUInt(data, sizeof(RUN_MAGIC), 4) == RUN_VERSION;
+    size_t offset = RUN_HEADER_SIZE;
+    while (valid && offset < data.size())
+    {
+        if (offset + SEGMENT_HEADER_SIZE > data.size())
+        {
+            valid = false;
+            break;
+        }
+        uint8_t stream = static_cast<uint8_t>(data[offset]);
+        size_t length = static_cast<size_t>(GetUInt(data, offset + 1, 4));
+        offset += SEGMENT_HEADER_SIZE;
+        valid = stream < (uint8_t)ConsoleStream::Count && length <= data.size() - offset;
+        offset += length;
+    }
+    if (!valid)
+    {
+        Remove(key);
+        return false;
+    }
+
+    run.exitCode = static_cast<int32_t>(GetUInt(data, sizeof(RUN_MAGIC) + 4, 4));
+    run.recorded = wxDateTime(static_cast<time_t>(GetUInt(data, sizeof(RUN_MAGIC) + 8, 8)));
+    for (offset = RUN_HEADER_SIZE; offset < data.size();)
+    {
+        ConsoleStream stream = static_cast<ConsoleStream>(data[offset]);
+        size_t length = static_cast<size_t>(GetUInt(data, offset + 1, 4));
+        offset += SEGMENT_HEADER_SIZE;
+        sink(stream, data.substr(offset, length));
+        offset += length;
+    }
+
+    Touch(key);
+    return true;
+}
+
+void RunCache::BeginRecording(uint64_t key)
+{
+    m_recording = true;
+    m_recordingKey = key;
+    m_data.assign(RUN_HEADER_SIZE, '\0');
+}
+
+void RunCache::Record(ConsoleStream stream, const wxString& text)
+{
+    if (!m_recording)
+        return;
+
+    wxScopedCharBuffer utf8 = text.utf8_str();
+    size_t offset = m_data.size();
+    m_data.resize(offset + SEGMENT_HEADER_SIZE);
+    m_data[offset] = static_cast<char>(stream);
+    PutU32(m_data, offset + 1, static_cast<uint32_t>(utf8.length()));
+    m_data.append(utf8.data(), utf8.length());
+
+    if (m_data.size() > m_budget / MAX_ENTRY_DIVISOR)
+        CancelRecording();
+}
+
+void RunCache::CancelRecording()
+{
+    m_recording = false;
+    std::string().swap(m_data);
+}
+
+void RunCache::Commit(int exitCode)
+{
+    if (!m_recording)
+        return;
+    m_recording = false;
+
+    LoadEntries();
+    std::copy(RUN_MAGIC, RUN_MAGIC + sizeof(RUN_MAGIC), m_data.begin());
+    PutU32(m_data, sizeof(RUN_MAGIC), RUN_VERSION);
+    PutU32(m_data, sizeof(RUN_MAGIC) + 4, static_cast<uint32_t>(exitCode));
+    PutU64(m_data, sizeof(RUN_MAGIC) + 8, static_cast<uint64_t>(wxDateTime::Now().GetTicks()));
+
+    if (!wxDirExists(m_dir))
+        wxFileName::Mkdir(m_dir, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+
+    // 先写临时文件再替换，写到一半时退出不会留下被当作有效记录的文件
+    Remove(m_recordingKey);
+    wxString path = GetEntryPath(m_recordingKey);
+    wxString tempPath = path + ".tmp";
+    wxLogNull noLog;
+    bool written;
+    {
+        wxFile file(tempPath, wxFile::write);
+        written = file.IsOpened() && file.Write(m_data.data(), m_data.size()) == m_data.size();
+    }
+    if (written && wxRenameFile(tempPath, path, true))
+    {
+        m_uses.push_front(m_recordingKey);
+        m_entries[m_recordingKey] = { m_data.size(), m_uses.begin() };
+        m_totalSize += m_data.size();
+        Evict();
+    }
+    else
+    {
+        wxRemoveFile(tempPath);
+    }
+    std::string().swap(m_data);
+}
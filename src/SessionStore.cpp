@@ -0,0 +1,233 @@
+#include "SessionStore.h"
+#include "FileUtils.h"
+#include <wx/file.h>
+#include <wx/filename.h>
+#include <wx/stdpaths.h>
+#include <cstdint>
+
+// 文件格式：魔数、版本，随后为小端序的定长整数与带长度前缀的 UTF-8 字符串
+static const char SESSION_MAGIC[4] = { 'L', 'M', 'S', 'S' };
+static const uint32_t SESSION_VERSION = 1;
+
+static void PutU32(std::string& data, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i)
+        data.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+}
+
+static void PutString(std::string& data, const wxString& value)
+{
+    wxScopedCharBuffer utf8 = value.ToUTF8();
+    PutU32(data, static_cast<uint32_t>(utf8.length()));
+    data.append(utf8.data(), utf8.length());
+}
+
+// 带边界检查的顺序读取
+class SessionReader
+{
+public:
+    SessionReader(const std::string& data, size_t offset) : m_data(data), m_pos(offset), m_ok(true) {}
+
+    uint32_t GetU32()
+    {
+        if (m_pos + 4 > m_data.size())
+        {
+            m_ok = false;
+            return 0;
+        }
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i)
+            value |= static_cast<uint32_t>(static_cast<unsigned char>(m_data[m_pos++])) << (i * 8);
+        return value;
+    }
+
+    int GetI32() { return static_cast<int>(static_cast<int32_t>(GetU32())); }
+
+    wxString GetString()
+    {
+        uint32_t length = GetU32();
+        if (!m_ok || m_pos + length > m_data.size())
+        {
+            m_ok = false;
+            return wxEmptyString;
+        }
+        wxString value = wxString::FromUTF8(m_data.data() + m_pos, length);
+        m_pos += length;
+        return value;
+    }
+
+    bool IsOk() const { return m_ok; }
+
+private:
+    const std::string& m_data;
+    size_t m_pos;
+    bool m_ok;
+};
+
+SessionStore::SessionStore()
+    : m_path(GetSessionPath())
+    , m_hasPending(false)
+    , m_writing(false)
+    , m_stop(false)
+{
+    m_writer = std::thread(&SessionStore::WriterLoop, this);
+}
+
+SessionStore::~SessionStore()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_condition.notify_all();
+    if (m_writer.joinable())
+        m_writer.join();
+}
+
+wxString SessionStore::GetSessionPath()
+{
+    wxFileName path(wxStandardPaths::Get().GetUserDataDir(), "session.bin");
+    return path.GetFullPath();
+}
+
+bool SessionStore::Load(SessionSnapshot& snapshot) const
+{
+    std::string data;
+    if (!FileUtils::ReadBytes(m_path, data))
+        return false;
+
+    return Decode(data, snapshot);
+}
+
+void SessionStore::Submit(const SessionSnapshot& snapshot)
+{
+    std::string data;
+    Encode(snapshot, data);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending.swap(data);
+        m_hasPending = true;
+    }
+    m_condition.notify_all();
+}
+
+void SessionStore::Flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this] { return !m_hasPending && !m_writing; });
+}
+
+void SessionStore::WriterLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;)
+    {
+        m_condition.wait(lock, [this] { return m_hasPending || m_stop; });
+
+        // 退出前先写完最后一次提交
+        if (m_hasPending)
+        {
+            std::string data;
+            data.swap(m_pending);
+            m_hasPending = false;
+
+            if (data != m_written)
+            {
+                m_writing = true;
+                lock.unlock();
+                bool written = WriteFile(data);
+                lock.lock();
+                m_writing = false;
+                if (written)
+                    m_written.swap(data);
+            }
+
+            m_condition.notify_all();
+            continue;
+        }
+
+        if (m_stop)
+            break;
+    }
+}
+
+bool SessionStore::WriteFile(const std::string& data) const
+{
+    wxFileName path(m_path);
+    if (!path.DirExists())
+        path.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+
+    // 先写临时文件再替换，避免中途退出留下损坏的会话
+    wxString tempPath = m_path + ".tmp";
+    {
+        wxFile file(tempPath, wxFile::write);
+        if (!file.IsOpened() || file.Write(data.data(), data.size()) != data.size())
+            return false;
+    }
+
+    return wxRenameFile(tempPath, m_path, true);
+}
+
+void SessionStore::Encode(const SessionSnapshot& snapshot, std::string& data)
+{
+    data.clear();
+    data.append(SESSION_MAGIC, sizeof(SESSION_MAGIC));
+    PutU32(data, SESSION_VERSION);
+    PutString(data, snapshot.theme);
+    PutU32(data, static_cast<uint32_t>(snapshot.activeIndex));
+    PutU32(data, static_cast<uint32_t>(snapshot.documents.size()));
+
+    for (const DocumentState& document : snapshot.documents)
+    {
+        PutString(data, document.path);
+        PutU32(data, static_cast<uint32_t>(document.caretPos));
+        PutU32(data, static_cast<uint32_t>(document.anchorPos));
+        PutU32(data, static_cast<uint32_t>(document.firstVisibleLine));
+        PutU32(data, static_cast<uint32_t>(document.foldedLines.size()));
+        for (int line : document.foldedLines)
+            PutU32(data, static_cast<uint32_t>(line));
+    }
+}
+
+bool SessionStore::Decode(const std::string& data, SessionSnapshot& snapshot)
+{
+    if (data.size() < sizeof(SESSION_MAGIC) || data.compare(0, sizeof(SESSION_MAGIC), SESSION_MAGIC, sizeof(SESSION_MAGIC)) != 0)
+        return false;
+
+    SessionReader reader(data, sizeof(SESSION_MAGIC));
+    if (reader.GetU32() != SESSION_VERSION)
+        return false;
+
+    SessionSnapshot result;
+    result.theme = reader.GetString();
+    result.activeIndex = reader.GetI32();
+
+    // 写入时不会超过上限，更大的数目说明文件已损坏
+    uint32_t count = reader.GetU32();
+    if (count > MAX_DOCUMENTS)
+        return false;
+    for (uint32_t i = 0; i < count && reader.IsOk(); ++i)
+    {
+        DocumentState document;
+        document.path = reader.GetString();
+        document.caretPos = reader.GetI32();
+        document.anchorPos = reader.GetI32();
+        document.firstVisibleLine = reader.GetI32();
+
+        uint32_t folds = reader.GetU32();
+        for (uint32_t j = 0; j < folds && reader.IsOk(); ++j)
+            document.foldedLines.push_back(reader.GetI32());
+
+        result.documents.push_back(document);
+    }
+
+    if (!reader.IsOk())
+        return false;
+
+    if (result.activeIndex >= (int)result.documents.size())
+        result.activeIndex = -1;
+
+    snapshot = result;
+    return true;
+}
@@ -0,0 +1,82 @@
+#include "StartupTimeline.h"
+#include <algorithm>
+#include <cstdio>
+
+// 静态初始化在 main 之前进行，作为进程开始的近似时间
+static const StartupTimeline::Clock::time_point s_processStart = StartupTimeline::Clock::now();
+
+StartupTimeline* StartupTimeline::s_instance = nullptr;
+
+StartupTimeline& StartupTimeline::Get()
+{
+    if (!s_instance)
+        s_instance = new StartupTimeline();
+    return *s_instance;
+}
+
+StartupTimeline::StartupTimeline()
+    : m_mainThread(std::this_thread::get_id())
+{
+}
+
+void StartupTimeline::Record(const char* stage, Clock::time_point start, Clock::time_point end)
+{
+    bool background = std::this_thread::get_id() != m_mainThread;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stages.push_back({ stage, start, end, background });
+}
+
+void StartupTimeline::MarkFirstFrame()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_firstFrame = Clock::now();
+}
+
+void StartupTimeline::MarkReady()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_ready = Clock::now();
+}
+
+double StartupTimeline::ToMs(Clock::time_point time) const
+{
+    if (time == Clock::time_point())
+        return -1;
+    return std::chrono::duration<double, std::milli>(time - s_processStart).count();
+}
+
+double StartupTimeline::GetFirstFrameMs() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return ToMs(m_firstFrame);
+}
+
+double StartupTimeline::GetReadyMs() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return ToMs(m_ready);
+}
+
+std::string StartupTimeline::Format() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<Stage> stages = m_stages;
+    std::stable_sort(stages.begin(), stages.end(), [](const Stage& a, const Stage& b) { return a.start < b.start; });
+
+    std::string text;
+    char line[160];
+    snprintf(line, sizeof(line), "%-24s %10s %10s\n", "stage", "start ms", "took ms");
+    text += line;
+    for (const Stage& stage : stages)
+    {
+        snprintf(line, sizeof(line), "%-24s %10.2f %10.2f%s\n", stage.name.c_str(), ToMs(stage.start),
+                 std::chrono::duration<double, std::milli>(stage.end - stage.start).count(),
+                 stage.background ? "  (background)" : "");
+        text += line;
+    }
+    snprintf(line, sizeof(line), "%-24s %10.2f\n", "first interactive frame", ToMs(m_firstFrame));
+    text += line;
+    snprintf(line, sizeof(line), "%-24s %10.2f\n", "startup complete", ToMs(m_ready));
+    text += line;
+    return text;
+}
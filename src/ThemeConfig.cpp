@@ -4,16 +4,51 @@
 #include <wx/file.h>
 #include <wx/sstream.h>
 #include <wx/dir.h>
+#include <wx/log.h>
+#include "StartupTimeline.h"
+#include <mutex>
+#include <thread>
 
 ThemeConfig* ThemeConfig::s_instance = nullptr;
+std::atomic<bool> ThemeConfig::s_loaded(false);
+std::thread ThemeConfig::s_preloadThread;
+
+static std::once_flag s_loadOnce;
 
 ThemeConfig& ThemeConfig::Get()
 {
-    if (!s_instance)
-        s_instance = new ThemeConfig();
+    // 预加载仍在进行时 call_once 等待它完成
+    Load();
     return *s_instance;
 }
 
+void ThemeConfig::Preload()
+{
+    if (!s_preloadThread.joinable())
+        s_preloadThread = std::thread(&ThemeConfig::Load);
+}
+
+void ThemeConfig::WaitForPreload()
+{
+    // 线程使用 wxStandardPaths 等全局对象，必须在 wx 清理之前结束
+    if (s_preloadThread.joinable())
+        s_preloadThread.join();
+}
+
+bool ThemeConfig::IsLoaded()
+{
+    return s_loaded;
+}
+
+void ThemeConfig::Load()
+{
+    std::call_once(s_loadOnce, []() {
+        StartupStage stage("theme config");
+        s_instance = new ThemeConfig();
+        s_loaded = true;
+    });
+}
+
 ThemeConfig::ThemeConfig()
 {   
     // 设置配置文件路径
@@ -123,12 +158,19 @@ bool ThemeConfig::LoadConfigFile()
     if (!root || root->GetName() != "themes")
         return false;
 
-    return ParseThemeConfig(root);
+    wxString currentTheme = m_currentTheme;
+    wxArrayString themes;
+    if (!ParseThemeConfig(root, currentTheme, themes))
+        return false;
+
+    m_currentTheme = currentTheme;
+    m_availableThemes = themes;
+    return true;
 }
 
-bool ThemeConfig::ParseThemeConfig(wxXmlNode* root)
+bool ThemeConfig::ParseThemeConfig(wxXmlNode* root, wxString& currentTheme, wxArrayString& themes) const
 {
-    m_availableThemes.Clear();
+    themes.Clear();
 
     // 读取当前主题
     wxXmlNode* currentNode = root->GetChildren();
@@ -136,7 +178,7 @@ bool ThemeConfig::ParseThemeConfig(wxXmlNode* root)
         currentNode = currentNode->GetNext();
 
     if (currentNode)
-        m_currentTheme = currentNode->GetNodeContent();
+        currentTheme = currentNode->GetNodeContent();
 
     // 读取主题列表
     wxXmlNode* themeNode = root->GetChildren();
@@ -146,15 +188,15 @@ bool ThemeConfig::ParseThemeConfig(wxXmlNode* root)
         {
             wxString themeName = themeNode->GetAttribute("name");
             if (!themeName.IsEmpty())
-                m_availableThemes.Add(themeName);
+                themes.Add(themeName);
         }
         themeNode = themeNode->GetNext();
     }
 
-    if (m_currentTheme.IsEmpty() && !m_availableThemes.IsEmpty())
-        m_currentTheme = m_availableThemes[0];
+    if (currentTheme.IsEmpty() && !themes.IsEmpty())
+        currentTheme = themes[0];
 
-    return !m_availableThemes.IsEmpty();
+    return !themes.IsEmpty();
 }
 
 bool ThemeConfig::LoadTheme(const wxString& themeName)
@@ -189,6 +231,37 @@ bool ThemeConfig::LoadTheme(const wxString& themeName)
     return true;
 }
 
+bool ThemeConfig::Reload()
+{
+    // 编辑器保存时文件可能暂时不完整，不弹出解析错误
+    wxXmlDocument config;
+    {
+        wxLogNull noLog;
+        if (!wxFile::Exists(m_configPath) || !config.Load(m_configPath))
+            return false;
+    }
+    
+    wxXmlNode* root = config.GetRoot();
+    if (!root || root->GetName() != "themes")
+        return false;
+    
+    // 先解析到临时变量，没有可用的主题时当前主题、主题列表和文档都保持不变，
+    // 之后保存时也不会把无效的文件写回磁盘
+    wxString currentTheme = m_currentTheme;
+    wxArrayString themes;
+    if (!ParseThemeConfig(root, currentTheme, themes))
+        return false;
+    
+    // 文件中指定的当前主题已被删除时退回第一个主题
+    if (themes.Index(currentTheme) == wxNOT_FOUND)
+        currentTheme = themes[0];
+    
+    m_config = config;
+    m_currentTheme = currentTheme;
+    m_availableThemes = themes;
+    return true;
+}
+
 bool ThemeConfig::SaveTheme()
 {
     return m_config.Save(m_configPath);
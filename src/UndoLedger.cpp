@@ -0,0 +1,65 @@
+#include "UndoLedger.h"
+
+// Scintilla 为每一步保存文本副本和一条记录（类型、位置、长度、数据指针），组之间另有一条分隔记录
+static const size_t STEP_OVERHEAD_BYTES = 32;
+static const size_t GROUP_OVERHEAD_BYTES = 32;
+
+void UndoLedger::BeginGroup()
+{
+    while (m_groups.size() > m_current)
+    {
+        m_totalBytes -= m_groups.back();
+        m_groups.pop_back();
+    }
+    m_groups.push_back(GROUP_OVERHEAD_BYTES);
+    m_undoBytes += GROUP_OVERHEAD_BYTES;
+    m_totalBytes += GROUP_OVERHEAD_BYTES;
+    ++m_current;
+}
+
+void UndoLedger::AddStep(size_t length)
+{
+    if (m_current == 0 || m_current < m_groups.size())
+        BeginGroup();
+
+    size_t bytes = length + STEP_OVERHEAD_BYTES;
+    m_groups.back() += bytes;
+    m_undoBytes += bytes;
+    m_totalBytes += bytes;
+}
+
+void UndoLedger::Undo()
+{
+    if (m_current == 0)
+        return;
+    --m_current;
+    m_undoBytes -= m_groups[m_current];
+}
+
+void UndoLedger::Redo()
+{
+    if (m_current == m_groups.size())
+        return;
+    m_undoBytes += m_groups[m_current];
+    ++m_current;
+}
+
+void UndoLedger::Reset()
+{
+    m_groups.clear();
+    m_current = 0;
+    m_undoBytes = 0;
+    m_totalBytes = 0;
+}
+
+size_t UndoLedger::GroupsToKeep(size_t budget) const
+{
+    size_t keep = 0;
+    size_t bytes = 0;
+    while (keep < m_current && bytes + m_groups[m_current - keep - 1] <= budget / 2)
+        bytes += m_groups[m_current - ++keep];
+
+    if (keep == 0 && m_current > 0 && m_groups[m_current - 1] <= budget)
+        keep = 1;
+    return keep;
+}
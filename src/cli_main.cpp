@@ -0,0 +1,791 @@
+// LaminaLab 命令行工具，复用 IDE 的无界面核心
+#include "BatchRunner.h"
+#include "ConsoleBuffer.h"
+#include "FileUtils.h"
+#include "IncludeGraph.h"
+#include "IncludeScanner.h"
+#include "LaminaLinter.h"
+#include "LaminaFormatter.h"
+#include "PlotSeries.h"
+#include "ProcessLauncher.h"
+#include <wx/init.h>
+#include <wx/cmdline.h>
+#include <wx/config.h>
+#include <wx/filename.h>
+#include <wx/dir.h>
+#include <wx/file.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include <set>
+
+#ifdef __LINUX__
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+static void PrintUsage()
+{
+    wxPrintf("Usage: LaminaCLI <command> [options]\n\n"
+             "Commands:\n"
+             "  batch <directory>   Run every .lm script in a directory\n"
+             "  format <files>      Format .lm files (indentation, braces, spacing)\n"
+             "  search <pattern> <files>\n"
+             "                      Find lines in output logs with the console's search engine\n"
+             "  launch <script>     Show the arguments the interpreter command expands to\n"
+             "  lint <files>        Check .lm files for undefined names, unused variables and other problems\n"
+             "  graph <directory>   Show which scripts include a file and find include cycles\n"
+             "  plot <files>        Summarize the numeric columns the plot pane would draw from output logs\n"
+             "\n"
+             "Run 'LaminaCLI <command> --help' for command options.\n");
+}
+
+// 默认使用 IDE 中配置的解释器
+static wxString GetDefaultInterpreter()
+{
+    wxConfig config("LaminaLabIDE");
+    return config.Read("InterpreterPath", "./laminalab %lmfilepath%");
+}
+
+static int RunBatch(int argc, char** argv)
+{
+    wxCmdLineParser parser(argc, argv);
+    parser.AddParam("directory");
+    parser.AddOption("j", "jobs", "number of parallel jobs (default: CPU count)", wxCMD_LINE_VAL_NUMBER);
+    parser.AddOption("i", "interpreter", "interpreter command, %lmfilepath% is replaced by the script path");
+    parser.AddSwitch("v", "verbose", "print the output of failed scripts");
+    if (parser.Parse() != 0)
+        return 2;
+
+    wxString directory = wxFileName::DirName(parser.GetParam(0)).GetAbsolutePath();
+    long jobs = 0;
+    parser.Found("jobs", &jobs);
+    wxString interpreter;
+    if (!parser.Found("interpreter", &interpreter))
+        interpreter = GetDefaultInterpreter();
+    bool verbose = parser.Found("verbose");
+
+    std::mutex printMutex;
+    size_t passed = 0;
+    size_t total = 0;
+
+    BatchRunner runner;
+    runner.SetResultCallback([&](const BatchResult& result) {
+        std::lock_guard<std::mutex> lock(printMutex);
+        wxFileName name(result.script);
+        name.MakeRelativeTo(directory);
+
+        ++total;
+        if (result.passed)
+            ++passed;
+
+        wxPrintf("%-8s %8.3fs  exit %-4d %s\n", result.passed ? "PASS" : "FAIL",
+                 result.seconds, result.exitCode, name.GetFullPath());
+        if (verbose && !result.passed)
+        {
+            wxPrintf("%s", result.output);
+            wxPrintf("%s", result.errors);
+        }
+    });
+
+    wxLongLong start = wxGetLocalTimeMillis();
+    if (!runner.Start(directory, interpreter, (int)jobs))
+    {
+        wxFprintf(stderr, "No .lm scripts found in %s\n", directory);
+        return 2;
+    }
+    runner.Wait();
+
+    double elapsed = (wxGetLocalTimeMillis() - start).ToDouble() / 1000.0;
+    wxPrintf("\n%zu/%zu passed (%.3f s)\n", passed, total, elapsed);
+    return passed == total ? 0 : 1;
+}
+
+// 生成格式混乱的测试源码，用于格式化吞吐量测试
+static std::string GenerateBenchmarkSource(long lines)
+{
+    static const char* const TEMPLATE[] = {
+        "func compute_%ld(a,b)\n",
+        "{\n",
+        "var x=a*b+  %ld;\n",
+        "      if(x>10)\n",
+        "{\n",
+        "print( \"large\" , x );   // 注释\n",
+        "}\n",
+        "else {\n",
+        "  x = -x ;\n",
+        "}\n",
+        "   return x;\n",
+        "}\n",
+    };
+    const long templateLines = sizeof(TEMPLATE) / sizeof(TEMPLATE[0]);
+
+    std::string source;
+    char buffer[128];
+    for (long i = 0; i < lines; ++i)
+    {
+        snprintf(buffer, sizeof(buffer), TEMPLATE[i % templateLines], i / templateLines);
+        source += buffer;
+    }
+    return source;
+}
+
+static int RunFormatBenchmark(long lines)
+{
+    std::string source = GenerateBenchmarkSource(lines);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<TextEdit> edits = LaminaFormatter::Format(source);
+    double formatSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::string formatted = BulkEdit::Apply(source, edits);
+    double totalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // 已格式化的文本应当不再产生编辑
+    start = std::chrono::steady_clock::now();
+    size_t remaining = LaminaFormatter::Format(formatted).size();
+    double cleanSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    wxPrintf("%ld lines, %.1f MB, %zu edits\n", lines, source.size() / (1024.0 * 1024.0), edits.size());
+    wxPrintf("format:          %8.3f s  %12.0f lines/s\n", formatSeconds, lines / formatSeconds);
+    wxPrintf("format + apply:  %8.3f s  %12.0f lines/s\n", totalSeconds, lines / totalSeconds);
+    wxPrintf("already clean:   %8.3f s  %12.0f lines/s\n", cleanSeconds, lines / cleanSeconds);
+    if (remaining != 0)
+    {
+        wxFprintf(stderr, "Formatting is not idempotent: %zu edits on the second pass\n", remaining);
+        return 1;
+    }
+    return 0;
+}
+
+static int RunFormat(int argc, char** argv)
+{
+    wxCmdLineParser parser(argc, argv);
+    parser.AddParam("files", wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL | wxCMD_LINE_PARAM_MULTIPLE);
+    parser.AddSwitch("w", "write", "write the result back to the files instead of printing it");
+    parser.AddSwitch("c", "check", "list files that need formatting and exit with status 1 if any do");
+    parser.AddOption("", "indent", "indentation width (default: 4)", wxCMD_LINE_VAL_NUMBER);
+    parser.AddSwitch("", "tabs", "indent with tabs");
+    parser.AddOption("", "benchmark", "format N generated lines and report throughput", wxCMD_LINE_VAL_NUMBER);
+    if (parser.Parse() != 0)
+        return 2;
+
+    long benchmarkLines = 0;
+    if (parser.Found("benchmark", &benchmarkLines))
+        return RunFormatBenchmark(benchmarkLines > 0 ? benchmarkLines : 1000000);
+
+    if (parser.GetParamCount() == 0)
+    {
+        parser.Usage();
+        return 2;
+    }
+
+    FormatOptions options;
+    long indent = 0;
+    if (parser.Found("indent", &indent) && indent > 0)
+        options.indentWidth = (int)indent;
+    options.useTabs = parser.Found("tabs");
+    bool write = parser.Found("write");
+    bool check = parser.Found("check");
+
+    int status = 0;
+    for (size_t i = 0; i < parser.GetParamCount(); ++i)
+    {
+        wxString path = parser.GetParam(i);
+        std::string source;
+        if (!FileUtils::ReadBytes(path, source))
+        {
+            wxFprintf(stderr, "Cannot read %s\n", path);
+            status = 2;
+            continue;
+        }
+
+        std::vector<TextEdit> edits = LaminaFormatter::Format(source, options);
+        if (check)
+        {
+            if (!edits.empty())
+            {
+                wxPrintf("%s: %zu lines need formatting\n", path, edits.size());
+                status = std::max(status, 1);
+            }
+        }
+        else if (write)
+        {
+            if (!edits.empty() && !FileUtils::WriteBytes(path, BulkEdit::Apply(source, edits)))
+            {
+                wxFprintf(stderr, "Cannot write %s\n", path);
+                status = 2;
+            }
+        }
+        else
+        {
+            std::string formatted = BulkEdit::Apply(source, edits);
+            fwrite(formatted.data(), 1, formatted.size(), stdout);
+        }
+    }
+
+    return status;
+}
+
+// 模拟脚本输出，每 1000 行有一行标准错误
+static int RunSearchBenchmark(long lines)
+{
+    ConsoleBuffer buffer;
+    char line[128];
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < lines; ++i)
+    {
+        bool error = i % 1000 == 999;
+        int length = snprintf(line, sizeof(line), error ? "warning: step %ld value=%ld out of range\n" : "step %ld: value=%ld ok\n",
+                              i, i * 7 % 1000);
+        buffer.Append(error ? ConsoleStream::Error : ConsoleStream::Output, std::string_view(line, length));
+    }
+    double indexSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    wxPrintf("%ld lines, %.1f MB\n", lines, buffer.GetTextSize() / (1024.0 * 1024.0));
+    wxPrintf("%-22s %8.3f s  %12.0f lines/s\n", "append + index:", indexSeconds, lines / indexSeconds);
+
+    auto measure = [&](const char* name, const ConsoleQuery& query) {
+        std::vector<size_t> matches;
+        auto start = std::chrono::steady_clock::now();
+        buffer.Find(query, 0, buffer.GetLineCount(), matches);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        wxPrintf("%-22s %8.3f s  %12.0f lines/s  %zu matches\n", name, seconds, lines / seconds, matches.size());
+    };
+
+    ConsoleQuery query;
+    query.text = "value=999 ";
+    query.matchCase = true;
+    measure("text:", query);
+    query.text = "VALUE=999 ";
+    query.matchCase = false;
+    measure("text, ignore case:", query);
+    query.text = "value=99[0-9] ";
+    query.regex = true;
+    measure("regex:", query);
+
+    ConsoleQuery errors;
+    errors.streams = ConsoleQuery::StreamBit(ConsoleStream::Error);
+    measure("stderr only:", errors);
+    return 0;
+}
+
+static int RunSearch(int argc, char** argv)
+{
+    wxCmdLineParser parser(argc, argv);
+    parser.AddParam("pattern", wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL);
+    parser.AddParam("files", wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL | wxCMD_LINE_PARAM_MULTIPLE);
+    parser.AddSwitch("e", "regex", "treat the pattern as an ECMAScript regular expression");
+    parser.AddSwitch("i", "ignore-case", "ignore ASCII case");
+    parser.AddOption("", "benchmark", "search N generated output lines and report throughput", wxCMD_LINE_VAL_NUMBER);
+    if (parser.Parse() != 0)
+        return 2;
+
+    long benchmarkLines = 0;
+    if (parser.Found("benchmark", &benchmarkLines))
+        return RunSearchBenchmark(benchmarkLines > 0 ? benchmarkLines : 10000000);
+
+    if (parser.GetParamCount() < 2)
+    {
+        parser.Usage();
+        return 2;
+    }
+
+    ConsoleQuery query;
+    query.text = parser.GetParam(0).utf8_str().data();
+    query.regex = parser.Found("regex");
+    query.matchCase = !parser.Found("ignore-case");
+
+    int status = 1;
+    for (size_t i = 1; i < parser.GetParamCount(); ++i)
+    {
+        wxString path = parser.GetParam(i);
+        std::string data;
+        if (!FileUtils::ReadBytes(path, data))
+        {
+            wxFprintf(stderr, "Cannot read %s\n", path);
+            return 2;
+        }
+
+        ConsoleBuffer buffer;
+        buffer.Append(ConsoleStream::Output, data);
+        std::vector<size_t> matches;
+        if (!buffer.Find(query, 0, buffer.GetLineCount(), matches))
+        {
+            wxFprintf(stderr, "Invalid regular expression: %s\n", parser.GetParam(0));
+            return 2;
+        }
+
+        for (size_t line : matches)
+        {
+            std::string_view text = buffer.GetLine(line);
+            wxPrintf("%s:%zu: ", path, line + 1);
+            fwrite(text.data(), 1, text.size(), stdout);
+            fputc('\n', stdout);
+        }
+        if (!matches.empty())
+            status = 0;
+    }
+    return status;
+}
+
+// 比较 posix_spawn 与 wxExecute 启动子进程的耗时：先占用并写入 holdMegabytes 内存，
+// 模拟打开了大文档的 IDE；两种方式都重定向标准输入输出并等待进程结束
+static int RunLaunchBenchmark(long runs, long holdMegabytes, const wxString& command)
+{
+    std::vector<char> held((size_t)holdMegabytes * 1024 * 1024);
+    for (size_t i = 0; i < held.size(); i += 4096)
+        held[i] = 1;
+    wxPrintf("holding %ld MB, %ld runs of '%s'\n", holdMegabytes, runs, command);
+
+    std::vector<std::string> args = ProcessLauncher::SplitCommand(command.utf8_str().data());
+    auto report = [&](const char* name, double seconds) {
+        wxPrintf("%-14s %8.3f s  %8.3f ms/run\n", name, seconds, seconds * 1000.0 / runs);
+    };
+
+#ifdef __LINUX__
+    if (ProcessLauncher::IsSpawnSupported())
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (long i = 0; i < runs; ++i)
+        {
+            LaunchedProcess child;
+            int errorCode;
+            if (!ProcessLauncher::Spawn(args, std::string(), child, errorCode))
+            {
+                wxFprintf(stderr, "posix_spawn failed: %s\n", strerror(errorCode));
+                return 1;
+            }
+            close(child.input);
+            close(child.output);
+            close(child.error);
+            waitpid(child.pid, nullptr, 0);
+        }
+        report("posix_spawn:", std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+#endif
+    if (!ProcessLauncher::IsSpawnSupported())
+        wxPrintf("posix_spawn:   not available on this platform\n");
+
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < runs; ++i)
+    {
+        wxArrayString output;
+        wxArrayString errors;
+        wxExecute(command, output, errors, wxEXEC_SYNC | wxEXEC_NOEVENTS);
+    }
+    report("wxExecute:", std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+    // 防止占用的内存被优化掉
+    return held[0] == 1 ? 0 : 1;
+}
+
+static int RunLaunch(int argc, char** argv)
+{
+    wxCmdLineParser parser(argc, argv);
+    parser.AddParam("script", wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL);
+    parser.AddOption("i", "interpreter", "interpreter command, %lmfilepath% is replaced by the script path");
+    parser.AddOption("", "benchmark", "launch a command N times with posix_spawn and with wxExecute", wxCMD_LINE_VAL_NUMBER);
+    parser.AddOption("", "hold", "memory in MB to hold while benchmarking (default: 2048)", wxCMD_LINE_VAL_NUMBER);
+    parser.AddOption("", "command", "command to launch while benchmarking (default: true)");
+    if (parser.Parse() != 0)
+        return 2;
+
+    long runs = 0;
+    if (parser.Found("benchmark", &runs))
+    {
+        long holdMegabytes = 2048;
+        parser.Found("hold", &holdMegabytes);
+        wxString command = "true";
+        parser.Found("command", &command);
+        return RunLaunchBenchmark(runs > 0 ? runs : 200, std::max(0L, holdMegabytes), command);
+    }
+
+    if (parser.GetParamCount() < 1)
+    {
+        parser.Usage();
+        return 2;
+    }
+
+    wxString interpreter = GetDefaultInterpreter();
+    parser.Found("interpreter", &interpreter);
+    for (const std::string& arg : ProcessLauncher::ExpandCommand(interpreter.utf8_str().data(), parser.GetParam(0).utf8_str().data()))
+        wxPrintf("%s\n", wxString::FromUTF8(arg.data(), arg.size()));
+    return 0;
+}
+
+// 被包含的文件及其递归包含的文件中的全局名称
+static bool ResolveLintInclude(const wxString& fromFile, const std::string& include, std::vector<LintSymbol>& symbols)
+{
+    wxString path = IncludeScanner::Resolve(fromFile, include);
+    if (!wxFileName::FileExists(path))
+        return false;
+
+    for (const wxString& file : IncludeScanner::CollectTransitive(path))
+    {
+        std::string source;
+        if (FileUtils::ReadBytes(file, source))
+        {
+            std::vector<LintSymbol> defined = LaminaLinter::CollectSymbols(source);
+            symbols.insert(symbols.end(), defined.begin(), defined.end());
+        }
+    }
+    return true;
+}
+
+// 完整检查一次，再模拟编辑器中的单次编辑：修改一个函数体、修改一个函数的参数个数
+static int RunLintBenchmark(long lines)
+{
+    std::string source = GenerateBenchmarkSource(lines);
+    LaminaLinter linter;
+    LaminaLinter::IncludeResolver noIncludes;
+
+    auto measure = [&](const char* name) {
+        std::vector<LintFinding> findings = linter.Lint(source, noIncludes);
+        const LintStats& stats = linter.GetStats();
+        wxPrintf("%-22s %9.2f ms  %6zu of %zu units checked  %zu findings\n",
+                 name, stats.milliseconds, stats.checked, stats.units, findings.size());
+    };
+
+    wxPrintf("%ld lines, %.1f MB\n", lines, source.size() / (1024.0 * 1024.0));
+    measure("full:");
+    measure("unchanged:");
+
+    size_t middle = source.find("var x=a*b+", source.size() / 2);
+    if (middle == std::string::npos)
+    {
+        wxFprintf(stderr, "Benchmark source is too short\n");
+        return 1;
+    }
+    source.insert(middle + 4, "y = 1; var ");
+    measure("edit in a function:");
+
+    size_t signature = source.find("(a,b)", middle - std::min<size_t>(middle, 200));
+    source.insert(signature + 4, ",c");
+    measure("signature change:");
+    return 0;
+}
+
+static int RunLint(int argc, char** argv)
+{
+    wxCmdLineParser parser(argc, argv);
+    parser.AddParam("files", wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL | wxCMD_LINE_PARAM_MULTIPLE);
+    parser.AddOption("", "benchmark", "lint N generated lines, then re-lint after single edits", wxCMD_LINE_VAL_NUMBER);
+    if (parser.Parse() != 0)
+        return 2;
+
+    long benchmarkLines = 0;
+    if (parser.Found("benchmark", &benchmarkLines))
+        return RunLintBenchmark(benchmarkLines > 0 ? benchmarkLines : 100000);
+
+    if (parser.GetParamCount() == 0)
+    {
+        parser.Usage();
+        return 2;
+    }
+
+    // 有错误时退出码为 1，只有警告时为 0
+    int status = 0;
+    LaminaLinter linter;
+    for (size_t i = 0; i < parser.GetParamCount(); ++i)
+    {
+        wxString path = parser.GetParam(i);
+        std::string source;
+        if (!FileUtils::ReadBytes(path, source))
+        {
+            wxFprintf(stderr, "Cannot read %s\n", path);
+            status = 2;
+            continue;
+        }
+
+        std::vector<LintFinding> findings = linter.Lint(source, [&path](const std::string& include, std::vector<LintSymbol>& symbols) {
+            return ResolveLintInclude(path, include, symbols);
+        });
+        for (const LintFinding& finding : findings)
+        {
+            size_t lineStart = finding.start == 0 ? std::string::npos : source.rfind('\n', finding.start - 1);
+            size_t column = finding.start - (lineStart == std::string::npos ? 0 : lineStart + 1) + 1;
+            wxPrintf("%s:%zu:%zu: %s: %s\n", path, finding.line + 1, column,
+                     finding.IsError() ? "error" : "warning", wxString::FromUTF8(LaminaLinter::Describe(finding)));
+            if (finding.IsError())
+                status = std::max(status, 1);
+        }
+    }
+
+    return status;
+}
+
+// 生成 files 个文件的关系图：每个文件包含几个编号更小的文件，少数文件反向包含形成环
+static void BuildBenchmarkGraph(IncludeGraph& graph, long files, int variant)
+{
+    for (long i = 0; i < files; ++i)
+    {
+        std::vector<std::string> includes;
+        for (long k = 1; k <= 4 && k <= i; ++k)
+            includes.push_back("/bench/" + std::to_string((i * 7919 + k * 104729 + variant) % i) + ".lm");
+        if (i % 1000 == 0 && i > 0)
+            includes.push_back("/bench/" + std::to_string(i - 1) + ".lm");
+        if (i % 1000 == 999)
+            includes.push_back("/bench/" + std::to_string(i + 1) + ".lm");
+        graph.SetIncludes("/bench/" + std::to_string(i) + ".lm", includes);
+    }
+}
+
+static int RunGraphBenchmark(long files)
+{
+    IncludeGraph graph;
+    auto start = std::chrono::steady_clock::now();
+    BuildBenchmarkGraph(graph, files, 0);
+    auto elapsed = [&start]() {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+    wxPrintf("%zu files, %zu includes, built in %.2f ms\n", graph.GetFileCount(), graph.GetEdgeCount(), elapsed());
+
+    // 查询重复多次取平均
+    const int repeats = 100;
+    size_t affected = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; ++i)
+        affected = graph.GetAffected("/bench/0.lm").size();
+    wxPrintf("%-22s %9.3f ms  %zu files\n", "affected by root:", elapsed() / repeats, affected);
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; ++i)
+        affected = graph.GetAffected("/bench/" + std::to_string(files / 2) + ".lm").size();
+    wxPrintf("%-22s %9.3f ms  %zu files\n", "affected by middle:", elapsed() / repeats, affected);
+
+    size_t cycle = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; ++i)
+        cycle = graph.FindCycle("/bench/999.lm").size();
+    wxPrintf("%-22s %9.3f ms  %zu steps\n", "cycle query:", elapsed() / repeats, cycle);
+
+    // 修改一个文件的 include 只替换它自己的出边
+    std::string middle = "/bench/" + std::to_string(files / 2) + ".lm";
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; ++i)
+        graph.SetIncludes(middle, { "/bench/" + std::to_string(i) + ".lm", "/bench/1.lm" });
+    wxPrintf("%-22s %9.3f ms\n", "update one file:", elapsed() / repeats);
+    return 0;
+}
+
+static std::string ToUtf8Path(const wxString& path)
+{
+    wxScopedCharBuffer buffer = wxFileName(path).GetAbsolutePath().utf8_str();
+    return std::string(buffer.data(), buffer.length());
+}
+
+static int RunGraph(int argc, char** argv)
+{
+    wxCmdLineParser parser(argc, argv);
+    parser.AddParam("directory", wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL);
+    parser.AddOption("", "affected", "list the scripts that directly or indirectly include this file");
+    parser.AddSwitch("", "cycles", "list the include cycles in the directory");
+    parser.AddOption("", "benchmark", "build a generated graph of N files and time queries and updates", wxCMD_LINE_VAL_NUMBER);
+    if (parser.Parse() != 0)
+        return 2;
+
+    long benchmarkFiles = 0;
+    if (parser.Found("benchmark", &benchmarkFiles))
+        return RunGraphBenchmark(benchmarkFiles > 0 ? benchmarkFiles : 10000);
+
+    if (parser.GetParamCount() < 1)
+    {
+        parser.Usage();
+        return 2;
+    }
+
+    wxArrayString files;
+    wxDir::GetAllFiles(parser.GetParam(0), &files, "*.lm");
+    files.Sort();
+
+    IncludeGraph graph;
+    for (const wxString& file : files)
+    {
+        std::string source;
+        if (!FileUtils::ReadBytes(file, source))
+        {
+            wxFprintf(stderr, "Cannot read %s\n", file);
+            continue;
+        }
+        std::vector<std::string> includes;
+        for (const std::string& include : IncludeScanner::Scan(source))
+            includes.push_back(ToUtf8Path(IncludeScanner::Resolve(file, include)));
+        graph.SetIncludes(ToUtf8Path(file), includes);
+    }
+    wxPrintf("%zu files, %zu includes\n", graph.GetFileCount(), graph.GetEdgeCount());
+
+    wxString target;
+    if (parser.Found("affected", &target))
+    {
+        for (std::string_view path : graph.GetAffected(ToUtf8Path(target)))
+            wxPrintf("%s\n", wxString::FromUTF8(path.data(), path.size()));
+    }
+
+    // 每个环只报告一次：环上的文件都已报告过的不再重复
+    int status = 0;
+    if (parser.Found("cycles"))
+    {
+        std::set<std::string> reported;
+        for (const wxString& file : files)
+        {
+            std::string path = ToUtf8Path(file);
+            if (reported.count(path))
+                continue;
+            std::vector<std::string_view> cycle = graph.FindCycle(path);
+            if (cycle.empty())
+                continue;
+
+            wxString text;
+            for (std::string_view step : cycle)
+            {
+                reported.insert(std::string(step));
+                if (!text.IsEmpty())
+                    text += " -> ";
+                text += wxString::FromUTF8(step.data(), step.size());
+            }
+            wxPrintf("cycle: %s\n", text);
+            status = 1;
+        }
+    }
+
+    return status;
+}
+
+// 生成 rows 行三列的数值输出，按管道读取的块大小送入解析器，再按 2000 个像素列抽取
+static int RunPlotBenchmark(long rows)
+{
+    const size_t blockSize = 64 * 1024;
+    const size_t columns = 2000;
+    PlotParser parser;
+    std::string block;
+    block.reserve(blockSize + 128);
+    size_t bytes = 0;
+    double parseSeconds = 0;
+
+    char line[128];
+    for (long i = 0; i < rows; ++i)
+    {
+        int length = snprintf(line, sizeof(line), "%ld %.6f %.6f\n", i, std::sin(i * 1e-5), std::cos(i * 3e-6) * 100);
+        block.append(line, length);
+        if (block.size() >= blockSize || i + 1 == rows)
+        {
+            auto start = std::chrono::steady_clock::now();
+            parser.Feed(block.data(), block.size());
+            parseSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            bytes += block.size();
+            block.clear();
+        }
+    }
+    parser.Finish();
+
+    wxPrintf("%llu rows, %.1f MB parsed in %.2f s (%.0f MB/s)\n", (unsigned long long)parser.GetRowCount(),
+             bytes / (1024.0 * 1024.0), parseSeconds, bytes / (1024.0 * 1024.0) / parseSeconds);
+    wxPrintf("memory: %.1f MB for %zu columns (bucket size %llu)\n", parser.GetMemoryUsage() / (1024.0 * 1024.0),
+             parser.GetSeries().size(), (unsigned long long)parser.GetSeries()[0].GetBucketSize());
+
+    // 绘制一帧需要的抽取，重复多次取平均
+    const int repeats = 20;
+    std::vector<PlotRange> ranges;
+    uint64_t count = parser.GetRowCount();
+    auto measure = [&](const char* name, uint64_t first, uint64_t last) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < repeats; ++i)
+        {
+            for (const PlotSeries& series : parser.GetSeries())
+                series.Decimate(first, last, columns, ranges);
+        }
+        double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / repeats;
+        wxPrintf("%-22s %9.3f ms per frame\n", name, milliseconds);
+    };
+    measure("decimate all:", 0, count);
+    measure("decimate 1%:", count / 2, count / 2 + count / 100);
+    return 0;
+}
+
+static int RunPlot(int argc, char** argv)
+{
+    wxCmdLineParser parser(argc, argv);
+    parser.AddParam("files", wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL | wxCMD_LINE_PARAM_MULTIPLE);
+    parser.AddOption("", "benchmark", "parse N generated rows of output and time drawing a frame", wxCMD_LINE_VAL_NUMBER);
+    if (parser.Parse() != 0)
+        return 2;
+
+    long benchmarkRows = 0;
+    if (parser.Found("benchmark", &benchmarkRows))
+        return RunPlotBenchmark(benchmarkRows > 0 ? benchmarkRows : 100000000);
+
+    if (parser.GetParamCount() == 0)
+    {
+        parser.Usage();
+        return 2;
+    }
+
+    int status = 0;
+    for (size_t i = 0; i < parser.GetParamCount(); ++i)
+    {
+        wxString path = parser.GetParam(i);
+        wxFile file(path);
+        if (!file.IsOpened())
+        {
+            wxFprintf(stderr, "Cannot read %s\n", path);
+            status = 2;
+            continue;
+        }
+
+        // 与面板一样分块送入
+        PlotParser plot;
+        std::vector<char> block(64 * 1024);
+        ssize_t count;
+        while ((count = file.Read(block.data(), block.size())) > 0)
+            plot.Feed(block.data(), count);
+        plot.Finish();
+
+        wxPrintf("%s: %llu rows\n", path, (unsigned long long)plot.GetRowCount());
+        for (size_t column = 0; column < plot.GetSeries().size(); ++column)
+        {
+            PlotRange bounds = plot.GetSeries()[column].GetBounds();
+            if (bounds.IsEmpty())
+                wxPrintf("  column %zu: no values\n", column + 1);
+            else
+                wxPrintf("  column %zu: %g .. %g\n", column + 1, bounds.min, bounds.max);
+        }
+    }
+    return status;
+}
+
+int main(int argc, char** argv)
+{
+    wxInitializer initializer;
+    if (!initializer)
+    {
+        fprintf(stderr, "Failed to initialize wxWidgets\n");
+        return 1;
+    }
+
+    if (argc < 2)
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    // 子命令自己解析剩余参数
+    wxString command(argv[1]);
+    if (command == "batch")
+        return RunBatch(argc - 1, argv + 1);
+    if (command == "format")
+        return RunFormat(argc - 1, argv + 1);
+    if (command == "search")
+        return RunSearch(argc - 1, argv + 1);
+    if (command == "launch")
+        return RunLaunch(argc - 1, argv + 1);
+    if (command == "lint")
+        return RunLint(argc - 1, argv + 1);
+    if (command == "graph")
+        return RunGraph(argc - 1, argv + 1);
+    if (command == "plot")
+        return RunPlot(argc - 1, argv + 1);
+
+    PrintUsage();
+    return 2;
+}